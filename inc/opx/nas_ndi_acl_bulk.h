@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_acl_bulk.h
+ *
+ * Bulk variants of the ACL entry APIs of nas_ndi_acl.h, for callers that
+ * program a whole policy at once.
+ */
+
+#ifndef __NAS_NDI_ACL_BULK_H
+#define __NAS_NDI_ACL_BULK_H
+
+#include "std_error_codes.h"
+#include "nas_ndi_common.h"
+#include "nas_ndi_acl.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create entries with one attribute list and arena reused across the batch.
+ *
+ * @param entry_id_list gets the NDI id of each entry, 0 for entries that failed
+ * @param rc_list optional, per entry status
+ * @return STD_ERR_OK if all the entries are created, else error of the first
+ *  entry that failed
+ */
+t_std_error ndi_acl_entries_create_bulk (npu_id_t npu_id,
+                                         const ndi_acl_entry_t* entry_list,
+                                         size_t count,
+                                         ndi_obj_id_t* entry_id_list,
+                                         t_std_error* rc_list);
+
+/**
+ * Delete a list of entries created by ndi_acl_entry_create or
+ * ndi_acl_entries_create_bulk.
+ *
+ * @param rc_list optional, per entry status
+ * @return STD_ERR_OK if all the entries are deleted, else error of the first
+ *  entry that failed
+ */
+t_std_error ndi_acl_entries_delete_bulk (npu_id_t npu_id,
+                                         const ndi_obj_id_t* entry_id_list,
+                                         size_t count,
+                                         t_std_error* rc_list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
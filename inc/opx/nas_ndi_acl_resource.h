@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_acl_resource.h
+ *
+ * Cached model of the ACL TCAM slices. Slice usage is read from SAI by
+ * ndi_acl_resource_sync and kept up to date in between by the NDI ACL
+ * table and entry create/delete APIs, so that the room left for a table
+ * can be checked before a large policy is programmed.
+ */
+
+#ifndef __NAS_NDI_ACL_RESOURCE_H
+#define __NAS_NDI_ACL_RESOURCE_H
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+#include "nas_ndi_common.h"
+#include "dell-base-acl.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    ndi_obj_id_t slice_id;
+    BASE_ACL_STAGE_t stage;
+    uint32_t pipeline_index;
+    uint32_t used_count;
+    uint32_t avail_count;
+    /* ACL tables using the slice */
+    const ndi_obj_id_t *table_list;
+    size_t table_count;
+} ndi_acl_resource_slice_t;
+
+/**
+ * @brief Replace the slices of the model with a fresh copy read from SAI
+ */
+void ndi_acl_resource_slices_set(npu_id_t npu_id, const ndi_acl_resource_slice_t *slice_list,
+                                 size_t count);
+
+/**
+ * @brief Mark the model out of date, e.g. after SAI ran out of entries
+ */
+void ndi_acl_resource_invalidate(npu_id_t npu_id);
+
+/**
+ * @brief Check if the slices were never read, were invalidated or were
+ *        read more than max_age_ms ago
+ */
+bool ndi_acl_resource_sync_needed(npu_id_t npu_id, uint32_t max_age_ms);
+
+/**
+ * @brief Track a table created by NDI. size is the table size, 0 if not set
+ */
+void ndi_acl_resource_table_add(npu_id_t npu_id, ndi_obj_id_t table_id,
+                                BASE_ACL_STAGE_t stage, size_t size);
+
+void ndi_acl_resource_table_del(npu_id_t npu_id, ndi_obj_id_t table_id);
+
+/**
+ * @brief Account entries added to or removed from a table. An entry takes
+ *        one slot in a slice of the table in every pipeline of the stage,
+ *        a free slice of the stage is given to the table when its slices
+ *        are full.
+ */
+void ndi_acl_resource_entry_add(npu_id_t npu_id, ndi_obj_id_t table_id, size_t count);
+
+void ndi_acl_resource_entry_del(npu_id_t npu_id, ndi_obj_id_t table_id, size_t count);
+
+/**
+ * @brief Check if entries fit in a table
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] stage - stage of the table, only used if table_id is 0
+ *
+ * @param[in] table_id - table to add to, 0 for a table not created yet
+ *
+ * @param[in] entry_count - number of entries to add
+ *
+ * @param[out] fit_count - number of entries that fit, may be NULL. SIZE_MAX
+ *                         if the table is not tracked or there is no slice
+ *                         of the stage in the model
+ *
+ * @return STD_ERR_OK if entry_count entries fit, STD_ERR(ACL, NORESOURCE, 0)
+ *  otherwise
+ */
+t_std_error ndi_acl_resource_admit(npu_id_t npu_id, BASE_ACL_STAGE_t stage,
+                                   ndi_obj_id_t table_id, size_t entry_count,
+                                   size_t *fit_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
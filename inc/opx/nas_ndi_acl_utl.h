@@ -24,10 +24,59 @@
 #include "saiaclextensions.h"
 #include "saiextensions.h"
 #include <list>
+#include <memory>
+#include <vector>
 #include <stdlib.h>
 
 const sai_acl_api_t* ndi_acl_utl_api_get (const nas_ndi_db_t* ndi_db_ptr);
 
+////////////////////////////////////////////////////////////////////////////
+// Bump allocator for SAI attribute buffers (port lists, byte lists).
+// Memory is zeroed and valid until reset or destruction. reset keeps the
+// blocks so a batch of entries can be filled without a malloc per entry.
+// Shared objects referenced by the attributes are held until reset too.
+////////////////////////////////////////////////////////////////////////////
+class ndi_acl_utl_arena_t {
+  public:
+    template <typename T> T* alloc (size_t num_elem) {
+        return static_cast<T*> (alloc_bytes (num_elem * sizeof (T), alignof (T)));
+    }
+    void hold (std::shared_ptr<const void> ref) { _refs.push_back (std::move (ref)); }
+    void reset () { _cur_block = 0; _cur_used = 0; _refs.clear (); }
+
+  private:
+    void* alloc_bytes (size_t size, size_t align);
+
+    static const size_t BLOCK_SIZE = 4096;
+    std::vector<std::unique_ptr<uint8_t[]>> _blocks;
+    std::vector<size_t> _block_sizes;
+    size_t _cur_block = 0;
+    size_t _cur_used = 0;
+    std::vector<std::shared_ptr<const void>> _refs;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Interned SAI port lists used by port/portlist filters and redirect actions.
+// A list of NDI ports is translated once and the same SAI list is shared by
+// all the entries using it. The list is translated again on the first use
+// after a port map change, handles taken earlier keep the old translation.
+////////////////////////////////////////////////////////////////////////////
+struct ndi_acl_utl_portlist_t {
+    std::vector<sai_object_id_t> sai_port_list;
+    uint64_t                     port_map_gen;
+};
+
+typedef std::shared_ptr<const ndi_acl_utl_portlist_t> ndi_acl_utl_portlist_ref_t;
+
+// Throws std::out_of_range if a port has no SAI port
+ndi_acl_utl_portlist_ref_t ndi_acl_utl_portlist_get (const ndi_port_t* port_list,
+                                                     size_t port_count);
+
+// False if the port map changed since the list was translated. The filter
+// and action fill functions use it to translate a list again that went
+// stale while it was translated.
+bool ndi_acl_utl_portlist_is_current (const ndi_acl_utl_portlist_ref_t& ref);
+
 //////////////////////////////////////////////////////////
 //Utilities to convert IDs from NDI to SAI and vice-versa
 /////////////////////////////////////////////////////////
@@ -63,11 +112,11 @@ t_std_error ndi_acl_utl_ndi2sai_tbl_filter_type (BASE_ACL_MATCH_TYPE_t ndi_filte
 
 t_std_error   ndi_acl_utl_fill_sai_filter (sai_attribute_t *sai_attr_p,
                                            const ndi_acl_entry_filter_t *ndi_filter_p,
-                                           nas::mem_alloc_helper_t& malloc_tracker);
+                                           ndi_acl_utl_arena_t& arena);
 
 t_std_error   ndi_acl_utl_fill_sai_action (sai_attribute_t* sai_attr_p,
                                            const ndi_acl_entry_action_t* ndi_action_p,
-                                           nas::mem_alloc_helper_t& malloc_tracker);
+                                           ndi_acl_utl_arena_t& arena);
 
 ///////////////////////////////////////////////////////
 // Utilities to Set/Get counter attributes to/from SAI
@@ -81,4 +130,114 @@ t_std_error ndi_acl_utl_get_counter_attr (npu_id_t npu_id,
                                           sai_attribute_t* sai_counter_attr_p,
                                           size_t attr_cnt);
 
+//////////////////////////////////////////////////////////////////////////////
+// Entry update, admission, table swap, counters (bulk create/delete of
+// entries is in nas_ndi_acl_bulk.h)
+//////////////////////////////////////////////////////////////////////////////
+extern "C" {
+
+/*
+ * Bring an entry to the given priority, filters and actions. Only what
+ * differs from the programmed entry is sent to SAI, filters and actions
+ * not in the list are disabled. table_id of the entry is not used.
+ */
+t_std_error ndi_acl_entry_update (npu_id_t npu_id,
+                                  ndi_obj_id_t ndi_entry_id,
+                                  const ndi_acl_entry_t* ndi_entry_p);
+
+/*
+ * Read a list of ACL counters. byte_count_list or pkt_count_list may be
+ * NULL, counters that failed are returned as 0. rc_list may be NULL.
+ */
+t_std_error ndi_acl_counters_get_bulk (npu_id_t npu_id,
+                                       const ndi_obj_id_t* counter_id_list,
+                                       size_t count,
+                                       uint64_t* byte_count_list,
+                                       uint64_t* pkt_count_list,
+                                       t_std_error* rc_list);
+
+/*
+ * Read the usage of all the ACL slices from SAI into the resource model.
+ * Admission checks do this on their own when the model is out of date.
+ */
+t_std_error ndi_acl_resource_sync (npu_id_t npu_id);
+
+/*
+ * Check if entry_count more entries fit in an existing table, before any
+ * of them is programmed. fit_count_p, if not NULL, gets the number of
+ * entries that fit. Returns STD_ERR(ACL, NORESOURCE, 0) if they do not.
+ */
+t_std_error ndi_acl_entries_admit (npu_id_t npu_id,
+                                   ndi_obj_id_t ndi_tbl_id,
+                                   size_t entry_count,
+                                   size_t* fit_count_p);
+
+/*
+ * Same for a table not created yet, described by its stage and size.
+ */
+t_std_error ndi_acl_table_admit (npu_id_t npu_id,
+                                 const ndi_acl_table_t* ndi_tbl_p,
+                                 size_t entry_count,
+                                 size_t* fit_count_p);
+
+typedef struct {
+    uint64_t build_usec;      // Create the new table and its entries
+    uint64_t swap_usec;       // Enable the new entries, make the new table active
+    uint64_t teardown_usec;   // Delete the old entries and table
+    size_t   entry_count;     // Entries in the new table
+    size_t   old_entry_count; // Entries deleted with the old table
+} ndi_acl_table_swap_stats_t;
+
+/* Called once the old table of a swap is deleted */
+typedef void (*ndi_acl_table_swap_cmpl_fn) (t_std_error rc,
+                                            const ndi_acl_table_swap_stats_t* stats,
+                                            void* cookie);
+
+/*
+ * Replace the policy of an ACL table, make before break. The new table is
+ * created at the priority in new_tbl_p, which must rank below the old
+ * table, and filled with the entries of entry_list (their table_id is not
+ * used), created admin-disabled. The entries are then enabled in one pass
+ * and the table raised to swap_priority, which must rank above the old
+ * table; a higher priority value ranks higher and STD_ERR(ACL, PARAM, 0)
+ * is returned, with nothing created, if either priority does not.
+ * The old table and all its entries, those in the NDI entry shadow and
+ * those SAI lists for the table, are then deleted through the ACL async
+ * queue and cmpl_fn, if not NULL, is called with the build/swap/teardown
+ * timing. The teardown runs in the background only once ndi_async_init
+ * has started the async workers, until then it is done before this call
+ * returns. Once the new table is live the swap returns STD_ERR_OK, a
+ * failed teardown is only reported to cmpl_fn.
+ * If build or swap fails the new table is removed and the old one is kept.
+ */
+t_std_error ndi_acl_table_swap (npu_id_t npu_id,
+                                ndi_obj_id_t old_tbl_id,
+                                const ndi_acl_table_t* new_tbl_p,
+                                ndi_acl_priority_t swap_priority,
+                                const ndi_acl_entry_t* entry_list,
+                                size_t entry_count,
+                                ndi_obj_id_t* new_tbl_id_p,
+                                ndi_obj_id_t* entry_id_list,
+                                ndi_acl_table_swap_cmpl_fn cmpl_fn,
+                                void* cookie);
+
+typedef struct {
+    ndi_obj_id_t counter_id;
+    uint64_t     byte_count;
+    uint64_t     pkt_count;
+} ndi_acl_counter_value_t;
+
+/*
+ * Delta mode read. Only counters whose values changed since the previous
+ * delta read of the same counter are copied to changed_list, which must
+ * have room for count entries. The first read of a counter is a change.
+ * Only the counts enabled on a counter are read, the others are 0.
+ */
+t_std_error ndi_acl_counters_get_changed (npu_id_t npu_id,
+                                          const ndi_obj_id_t* counter_id_list,
+                                          size_t count,
+                                          ndi_acl_counter_value_t* changed_list,
+                                          size_t* changed_count_p);
+}
+
 #endif
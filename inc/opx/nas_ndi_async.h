@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_async.h
+ *
+ * Optional asynchronous submission of NDI requests. Requests are queued on
+ * per object class submission queues and executed by worker threads.
+ * Requests with the same object key are always executed in submission order.
+ */
+
+#ifndef __NAS_NDI_ASYNC_H
+#define __NAS_NDI_ASYNC_H
+
+#include "std_error_codes.h"
+#include "nas_ndi_common.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    NDI_ASYNC_OBJ_CLASS_ROUTE = 0,
+    NDI_ASYNC_OBJ_CLASS_NEIGHBOR,
+    NDI_ASYNC_OBJ_CLASS_ACL,
+    NDI_ASYNC_OBJ_CLASS_QOS,
+    NDI_ASYNC_OBJ_CLASS_L2,
+    NDI_ASYNC_OBJ_CLASS_OTHER,
+    NDI_ASYNC_OBJ_CLASS_MAX,
+} ndi_async_obj_class_t;
+
+typedef struct {
+    /* Max number of pending requests per queue before submit blocks or fails */
+    size_t queue_depth;
+    /* Max number of requests a worker drains from its queue in one go */
+    size_t batch_size;
+    /* Number of queues and worker threads per object class */
+    size_t workers_per_class;
+} ndi_async_cfg_t;
+
+/* Request handler, runs in worker thread context and calls the NDI API */
+typedef t_std_error (*ndi_async_req_fn)(void *req_data, ndi_obj_id_t *obj_id);
+
+/* Completion callback, runs in worker thread context */
+typedef void (*ndi_async_cmpl_fn)(t_std_error rc, ndi_obj_id_t obj_id, void *cookie);
+
+/*
+ * Bulk request handler. Called instead of the request handler for a run of
+ * consecutive requests in a batch using the same request handler.
+ */
+typedef void (*ndi_async_batch_fn)(size_t count, void **req_data_list,
+                                   t_std_error *rc_list, ndi_obj_id_t *obj_id_list);
+
+/**
+ * @brief Start the asynchronous mode worker threads
+ *
+ * @param[in] cfg - queue configuration, NULL for defaults
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_async_init(const ndi_async_cfg_t *cfg);
+
+/**
+ * @brief Drain all the queues and stop the worker threads. Must not be
+ *        called while other threads are still submitting requests, does
+ *        nothing if called from a request handler or completion callback.
+ */
+void ndi_async_deinit(void);
+
+/**
+ * @brief Check if asynchronous mode is started
+ *
+ * @return true if ndi_async_init was called
+ */
+bool ndi_async_is_enabled(void);
+
+/**
+ * @brief Register bulk handler used to combine requests using req_fn
+ *
+ * @param[in] req_fn - request handler
+ *
+ * @param[in] batch_fn - bulk handler, NULL to unregister
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_async_register_batch_fn(ndi_async_req_fn req_fn, ndi_async_batch_fn batch_fn);
+
+/**
+ * @brief Submit request. If asynchronous mode is not started, the request is
+ *        executed and completed in the caller context.
+ *
+ * @param[in] obj_class - object class, selects the submission queue
+ *
+ * @param[in] obj_key - object key, requests with same key are executed in order
+ *
+ * @param[in] req_fn - request handler
+ *
+ * @param[in] req_data - request data passed to handler, owned by caller
+ *                       until completion callback is called
+ *
+ * @param[in] cmpl_fn - completion callback, can be NULL
+ *
+ * @param[in] cookie - passed to completion callback
+ *
+ * @param[in] wait - if queue is full, wait for room instead of failing.
+ *                   Called from a request handler or completion callback
+ *                   the request is queued past the queue depth instead.
+ *
+ * @return STD_ERR_OK if request is queued, STD_ERR(NPU, NORESOURCE, 0) if
+ *  queue is full and wait is false
+ */
+t_std_error ndi_async_submit(ndi_async_obj_class_t obj_class, uint64_t obj_key,
+                             ndi_async_req_fn req_fn, void *req_data,
+                             ndi_async_cmpl_fn cmpl_fn, void *cookie, bool wait);
+
+/**
+ * @brief Wait until all the requests queued for object class are completed.
+ *        Fails without waiting if called from a request handler or
+ *        completion callback.
+ *
+ * @param[in] obj_class - object class
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_async_flush(ndi_async_obj_class_t obj_class);
+
+/**
+ * @brief Get number of requests pending for object class
+ *
+ * @param[in] obj_class - object class
+ *
+ * @return number of queued and in progress requests
+ */
+size_t ndi_async_pending_count(ndi_async_obj_class_t obj_class);
+
+#ifdef __cplusplus
+}
+
+#include <future>
+
+typedef struct {
+    t_std_error rc;
+    ndi_obj_id_t obj_id;
+} ndi_async_result_t;
+
+/* Submit request and return future completed with status and object id. The
+ * future must not be waited on from a request handler or completion callback */
+std::future<ndi_async_result_t> ndi_async_submit_future(ndi_async_obj_class_t obj_class,
+                                                        uint64_t obj_key,
+                                                        ndi_async_req_fn req_fn,
+                                                        void *req_data);
+#endif
+
+#endif
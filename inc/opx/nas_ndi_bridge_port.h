@@ -25,6 +25,7 @@
 #include "nas_ndi_common.h"
 #include "saitypes.h"
 #include "nas_ndi_obj_cache.h"
+#include "nas_ndi_utils.h"
 
 #ifdef __cplusplus
 extern "C"{
@@ -56,6 +57,20 @@ t_std_error ndi_1d_router_bridge_port_add(npu_id_t npu_id, bridge_id_t br_oid, n
                                           ndi_obj_id_t *br_port_id);
 t_std_error ndi_1d_router_bridge_port_delete(npu_id_t npu_id, ndi_obj_id_t brport_oid);
 t_std_error ndi_1d_get_l2mc_id(npu_id_t npu_id, ndi_obj_id_t br_oid, ndi_obj_id_t *l2mc_id);
+
+/*
+ * Read the same counters from a list of .1D bridges or bridge ports, handle is
+ * created for NDI_STAT_OBJ_BRIDGE_1D or NDI_STAT_OBJ_BRIDGE_PORT, or for
+ * NDI_STAT_OBJ_TUNNEL_BRIDGE_PORT to read tunnel bridge ports. stats_val has
+ * one row of ndi_stat_handle_len(handle) counters per object, zeroed for an
+ * object that failed. rc_list may be NULL.
+ */
+t_std_error ndi_bridge_1d_stats_bulk_get(npu_id_t npu_id, const bridge_id_t *br_list,
+                                         size_t br_count, const ndi_stat_handle_t *handle,
+                                         uint64_t *stats_val, t_std_error *rc_list);
+t_std_error ndi_bridge_port_stats_bulk_get(npu_id_t npu_id, const ndi_obj_id_t *brport_list,
+                                           size_t brport_count, const ndi_stat_handle_t *handle,
+                                           uint64_t *stats_val, t_std_error *rc_list);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_checkpoint.h
+ */
+
+#ifndef __NAS_NDI_CHECKPOINT_H
+#define __NAS_NDI_CHECKPOINT_H
+
+#include "std_error_codes.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default checkpoint file, can be overridden with OPX_NDI_CHECKPOINT_FILE */
+#define NDI_CHECKPOINT_DEFAULT_FILE "/var/run/opx/nas_ndi_cache.ckpt"
+
+/* Periodic save interval in seconds used when SAI is configured for warm
+ * boot. OPX_NDI_CHECKPOINT_INTERVAL overrides it and also enables the
+ * periodic save on cold boot, 0 disables the periodic save */
+#define NDI_CHECKPOINT_DEFAULT_INTERVAL 60
+
+#define NDI_CHECKPOINT_MAGIC   0x4e444943 /* "NDIC" */
+#define NDI_CHECKPOINT_VERSION 2
+
+/*
+ * Checkpoint file layout. All records are fixed size so the file can be
+ * mmap'ed and indexed in place:
+ *
+ *   ndi_checkpoint_hdr_t
+ *   ndi_checkpoint_section_t[section_count]
+ *   section records, each section 8 byte aligned
+ */
+typedef enum {
+    NDI_CHECKPOINT_SECTION_VIRT_OBJ = 1,
+    NDI_CHECKPOINT_SECTION_BRPORT,
+    NDI_CHECKPOINT_SECTION_NDI_MAP,
+    NDI_CHECKPOINT_SECTION_RIF,
+    NDI_CHECKPOINT_SECTION_REPL_GRP,
+    NDI_CHECKPOINT_SECTION_REPL_GRP_MBR,
+    NDI_CHECKPOINT_SECTION_REPL_GRP_MBR_PORT,
+    NDI_CHECKPOINT_SECTION_IPMC_ENTRY,
+    NDI_CHECKPOINT_SECTION_TUNNEL,
+    NDI_CHECKPOINT_SECTION_TUNNEL_MAP,
+    NDI_CHECKPOINT_SECTION_VLAN_MBR,
+    NDI_CHECKPOINT_SECTION_MAX,
+} ndi_checkpoint_section_type_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t section_count;
+    uint32_t reserved;
+    uint64_t total_len;
+} ndi_checkpoint_hdr_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t rec_size;
+    uint64_t rec_count;
+    uint64_t offset;
+} ndi_checkpoint_section_t;
+
+/**
+ * @brief Save the NDI object caches (bridge port, virtual object, NDI map,
+ *        RIF, replication group, tunnel and VLAN member caches) to checkpoint
+ *        file.
+ *        File is written to a temporary file and renamed in place.
+ *
+ * @param[in] file_name - checkpoint file, NULL for the default file
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error nas_ndi_checkpoint_save(const char *file_name);
+
+/**
+ * @brief Restore the NDI object caches from checkpoint file. Expected to be
+ *        called once during nas_ndi_init, before the caches are populated.
+ *        The file is removed once read. If any record fails to restore, the
+ *        records already restored are removed again so that the caller can
+ *        fall back to cold discovery with empty caches.
+ *
+ * @param[in] file_name - checkpoint file, NULL for the default file
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error nas_ndi_checkpoint_restore(const char *file_name);
+
+/**
+ * @brief Start saving the checkpoint to the default file periodically. A
+ *        period in which the caches did not change does not rewrite the file.
+ *        The saver thread is stopped by nas_ndi_checkpoint_shutdown or at
+ *        process exit.
+ *
+ * @param[in] interval_sec - save interval, 0 for OPX_NDI_CHECKPOINT_INTERVAL
+ *                           or, on warm boot only, NDI_CHECKPOINT_DEFAULT_INTERVAL.
+ *                           Nothing is started otherwise.
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error nas_ndi_checkpoint_start(uint32_t interval_sec);
+
+/**
+ * @brief Orderly shutdown for warm restart. Stops the periodic save and
+ *        writes the final checkpoint to the default file. Called from the
+ *        SAI switch shutdown request, once no more NDI configuration is done.
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error nas_ndi_checkpoint_shutdown(void);
+
+/**
+ * @brief Check if SAI is configured for warm boot in the switch profile
+ *
+ * @return true if boot type is warm boot
+ */
+bool nas_ndi_checkpoint_is_warm_boot(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
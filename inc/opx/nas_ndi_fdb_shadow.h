@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_fdb_shadow.h
+ *
+ * Optional NDI copy of the FDB table. Entries are keyed by (bv_id, mac) and
+ * linked in per bridge port and per bv_id lists, so that lookups, counts and
+ * flush filters can be answered without SAI calls. The shadow is updated
+ * from the FDB event callback and from the NDI MAC create/delete/flush APIs.
+ */
+
+#ifndef __NAS_NDI_FDB_SHADOW_H
+#define __NAS_NDI_FDB_SHADOW_H
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+#include "nas_ndi_common.h"
+#include "saitypes.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    sai_object_id_t bv_id;
+    hal_mac_addr_t mac;
+    sai_object_id_t brport_id;
+    sai_packet_action_t action;
+    bool is_static;
+    /* Remote endpoint, valid if is_remote is set */
+    bool is_remote;
+    sai_ip_address_t endpoint_ip;
+} ndi_fdb_shadow_entry_t;
+
+typedef enum {
+    NDI_FDB_SHADOW_TYPE_DYNAMIC = 0,
+    NDI_FDB_SHADOW_TYPE_STATIC,
+    NDI_FDB_SHADOW_TYPE_ALL,
+} ndi_fdb_shadow_type_t;
+
+/* Entry filter, same semantics as SAI FDB flush attributes */
+typedef struct {
+    /* SAI_NULL_OBJECT_ID matches any bridge port */
+    sai_object_id_t brport_id;
+    /* SAI_NULL_OBJECT_ID matches any VLAN or bridge */
+    sai_object_id_t bv_id;
+    ndi_fdb_shadow_type_t type;
+} ndi_fdb_shadow_filter_t;
+
+/* Walk callback, return false to stop the walk. Must not update the shadow */
+typedef bool (*ndi_fdb_shadow_walk_fn)(const ndi_fdb_shadow_entry_t *entry, void *ctx);
+
+/*
+ * Seed callback, adds the entries already in SAI with ndi_fdb_shadow_add.
+ * Returns false if the SAI FDB table could not be read.
+ */
+typedef bool (*ndi_fdb_shadow_seed_fn)(void);
+
+/**
+ * @brief Set the function used to seed the shadow when it is enabled
+ */
+void ndi_fdb_shadow_seed_fn_set(ndi_fdb_shadow_seed_fn fn);
+
+/**
+ * @brief Enable or disable the shadow. Disabling removes all the entries.
+ *        Enabling starts tracking FDB updates and then seeds the shadow
+ *        with the entries already in SAI. Entries that age out while
+ *        seeding may be left in the shadow, no entry is missed.
+ */
+void ndi_fdb_shadow_enable(bool enable);
+
+/**
+ * @brief Check if the shadow is enabled
+ */
+bool ndi_fdb_shadow_is_enabled(void);
+
+/**
+ * @brief Check if the shadow is enabled and seeding has finished, that is
+ *        the shadow has every SAI entry. Only then can FDB flushes with no
+ *        matching shadow entry skip SAI.
+ */
+bool ndi_fdb_shadow_is_seeded(void);
+
+/**
+ * @brief Add entry or update existing entry with the same (bv_id, mac)
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_fdb_shadow_add(const ndi_fdb_shadow_entry_t *entry);
+
+/**
+ * @brief Remove entry
+ *
+ * @return true if the entry was found
+ */
+bool ndi_fdb_shadow_del(sai_object_id_t bv_id, const hal_mac_addr_t mac);
+
+/**
+ * @brief Update bridge port and packet action of an existing entry, the
+ *        entry is moved to the list of the new bridge port
+ *
+ * @param[in] brport_id - new bridge port, NULL to keep the current one
+ *
+ * @param[in] action - new packet action, NULL to keep the current one
+ *
+ * @return true if the entry was found
+ */
+bool ndi_fdb_shadow_update(sai_object_id_t bv_id, const hal_mac_addr_t mac,
+                           const sai_object_id_t *brport_id, const sai_packet_action_t *action);
+
+/**
+ * @brief Get entry
+ *
+ * @param[inout] entry - bv_id and mac are used as key, rest is filled in
+ *
+ * @return true if the entry was found
+ */
+bool ndi_fdb_shadow_get(ndi_fdb_shadow_entry_t *entry);
+
+/**
+ * @brief Remove all the entries matching the filter
+ *
+ * @return number of entries removed
+ */
+size_t ndi_fdb_shadow_flush(const ndi_fdb_shadow_filter_t *filter);
+
+/**
+ * @brief Count the entries matching the filter
+ */
+size_t ndi_fdb_shadow_count(const ndi_fdb_shadow_filter_t *filter);
+
+/**
+ * @brief Copy entries matching the filter in storage order, starting at the
+ *        cursor. Entries added or removed between calls may or may not be
+ *        returned, the other entries are returned once.
+ *
+ * @param[in] filter - entry filter, NULL matches all
+ *
+ * @param[inout] cursor - 0 for the first call, updated for the next call
+ *
+ * @param[out] entries - entry buffer
+ *
+ * @param[in] max_count - size of entry buffer
+ *
+ * @return number of entries copied, 0 at the end of the table
+ */
+size_t ndi_fdb_shadow_get_next(const ndi_fdb_shadow_filter_t *filter, size_t *cursor,
+                               ndi_fdb_shadow_entry_t *entries, size_t max_count);
+
+/**
+ * @brief Call fn for each entry matching the filter
+ *
+ * @return number of entries visited
+ */
+size_t ndi_fdb_shadow_walk(const ndi_fdb_shadow_filter_t *filter,
+                           ndi_fdb_shadow_walk_fn fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
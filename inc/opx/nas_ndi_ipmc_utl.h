@@ -26,6 +26,7 @@
 #include "nas_ndi_utils.h"
 #include "nas_ndi_mcast.h"
 #include "nas_ndi_ipmc.h"
+#include "std_rw_lock.h"
 
 #include <unordered_map>
 #include <unordered_set>
@@ -428,10 +429,28 @@ private:
     std::unordered_set<key_type> _entry_list;
 };
 
+/* Mutex of a cached object, not copied along with the object */
+class ndi_cache_obj_lock_t
+{
+public:
+    ndi_cache_obj_lock_t() = default;
+    ndi_cache_obj_lock_t(const ndi_cache_obj_lock_t&) {}
+    ndi_cache_obj_lock_t& operator=(const ndi_cache_obj_lock_t&) {return *this;}
+
+    std::mutex& mutex() const {return _mutex;}
+private:
+    mutable std::mutex _mutex;
+};
+
 struct ndi_cache_repl_grp_t
 {
     using mbr_list_t = std::unordered_map<ndi_rif_id_t, ndi_cache_grp_mbr_t, std::hash<unsigned long>>;
 
+    /* Protects member lists, entry sets and deleted flag of the group */
+    ndi_cache_obj_lock_t grp_lock;
+    /* Set when group is removed from cache, no entry could be added after that */
+    bool deleted = false;
+
     ndi_obj_id_t repl_grp_id;
     ndi_obj_id_t rpf_grp_id;
     mbr_list_t rpf_mbr_list;
@@ -533,15 +552,36 @@ public:
         return _entry_list.at(key);
     }
 
+    void walk(const std::function<void(npu_id_t, const ndi_ipmc_entry_t&)>& fn) const
+    {
+        for (auto& entry: _entry_list) {
+            ndi_ipmc_entry_t ndi_entry;
+            memset(&ndi_entry, 0, sizeof(ndi_entry));
+            fn(entry.first.first, entry.first.second.to_ndi_entry(ndi_entry));
+        }
+    }
+
     operator std::string() const;
 
 private:
     std::unordered_map<key_type, value_type> _entry_list;
 };
 
+/*
+ * Replication groups and IPMC entries are kept in shards selected by key hash,
+ * each shard with its own read-write lock, so that lookups of different keys
+ * or lookups only do not block each other. Member lists and entry sets of a
+ * group are protected by the group lock. Locks are taken in the order entry
+ * shard, group shard, group lock.
+ */
 class repl_group_cache
 {
 public:
+    using grp_walk_fn = std::function<void(npu_id_t, const ndi_cache_repl_grp_t&)>;
+    using entry_walk_fn = std::function<void(npu_id_t, const ndi_ipmc_entry_t&)>;
+
+    static const size_t SHARD_COUNT = 64;
+
     bool add_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
                         ndi_obj_id_t rpf_grp_id, ndi_obj_id_t ipmc_grp_id);
     bool add_rpf_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_obj_id_t mbr_id,
@@ -553,10 +593,8 @@ public:
     bool update_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_mc_grp_mbr_type_t mbr_type,
                              ndi_rif_id_t rif_id, const ndi_sw_port_list_t& port_list);
     bool del_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id);
-    const ndi_cache_repl_grp_t& get_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id) const
-    {
-        return *_repl_grp_list.at(std::make_pair(npu_id, repl_grp_id));
-    }
+    /* Copy of the group, throws std::out_of_range if not found */
+    ndi_cache_repl_grp_t get_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id) const;
     bool is_repl_group_used(npu_id_t npu_id, ndi_obj_id_t repl_grp_id);
 
     bool get_sub_group_id(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
@@ -565,30 +603,77 @@ public:
                                                     ndi_mc_grp_mbr_type_t mbr_type) const;
     bool get_group_rif_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_mc_grp_mbr_type_t mbr_type,
                               ndi_rif_id_t rif_id, ndi_obj_id_t& mbr_id);
+    bool get_group_member_info(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_mc_grp_mbr_type_t mbr_type,
+                               ndi_cache_repl_grp_t::mbr_list_t& mbr_list) const;
+    /* Remove members of del_rif_list, then add or replace members of set_mbr_list,
+       with one group lock */
+    bool update_group_member_list(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_mc_grp_mbr_type_t mbr_type,
+                                  const std::vector<ndi_rif_id_t>& del_rif_list,
+                                  const std::vector<ndi_cache_grp_mbr_t>& set_mbr_list);
     bool add_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry);
     bool del_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry);
     bool update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
                            ndi_ipmc_update_type_t upd_type);
     bool get_ipmc_entry(npu_id_t npu_id, ndi_ipmc_entry_t& ipmc_entry);
 
-    base_ipmc_entry_map& get_cached_entry_list(int af_index)
-    {
-        if (af_index == HAL_INET4_FAMILY) {
-            return _ipmc_ipv4_entry_list;
-        } else {
-            return _ipmc_ipv6_entry_list;
-        }
-    }
+    /* Batch add/delete/update, each entry shard is locked once per batch and
+       each replication group looked up once. Return number of entries done */
+    size_t add_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list);
+    size_t del_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list);
+    size_t update_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list,
+                               ndi_ipmc_update_type_t upd_type);
+
+    void walk_repl_group(const grp_walk_fn& fn) const;
+    void walk_ipmc_entry(const entry_walk_fn& fn) const;
 
     void dump_ipmc_group() const;
     void dump_ipmc_entry(int af_index) const;
 private:
-    std::unordered_map<std::pair<npu_id_t, ndi_obj_id_t>, std::shared_ptr<ndi_cache_repl_grp_t>>
-            _repl_grp_list;
-    cached_ipmc_entry_map<dn_ipv4_addr_t> _ipmc_ipv4_entry_list;
-    cached_ipmc_entry_map<dn_ipv6_addr_t> _ipmc_ipv6_entry_list;
+    using grp_ptr_t = std::shared_ptr<ndi_cache_repl_grp_t>;
 
-    mutable std::mutex _mutex;
+    struct grp_shard_t
+    {
+        grp_shard_t();
+
+        std::unordered_map<std::pair<npu_id_t, ndi_obj_id_t>, grp_ptr_t> repl_grp_list;
+        std_rw_lock_t rw_lock;
+    };
+
+    struct entry_shard_t
+    {
+        entry_shard_t();
+
+        base_ipmc_entry_map& get_cached_entry_list(int af_index)
+        {
+            if (af_index == HAL_INET4_FAMILY) {
+                return ipmc_ipv4_entry_list;
+            } else {
+                return ipmc_ipv6_entry_list;
+            }
+        }
+
+        cached_ipmc_entry_map<dn_ipv4_addr_t> ipmc_ipv4_entry_list;
+        cached_ipmc_entry_map<dn_ipv6_addr_t> ipmc_ipv6_entry_list;
+        mutable std_rw_lock_t rw_lock;
+    };
+
+    grp_shard_t& get_grp_shard(npu_id_t npu_id, ndi_obj_id_t repl_grp_id) const;
+    entry_shard_t& get_entry_shard(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry);
+    grp_ptr_t find_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id) const;
+    std::unordered_map<ndi_obj_id_t, grp_ptr_t> find_repl_group_list(npu_id_t npu_id,
+                                    const std::vector<ndi_ipmc_entry_t>& entry_list) const;
+
+    /* Entry update helpers, caller holds the write lock of entry shard */
+    bool add_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
+                               const grp_ptr_t& repl_grp);
+    bool del_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry);
+    bool update_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
+                                  ndi_ipmc_update_type_t upd_type, const grp_ptr_t& new_grp);
+    template<typename F>
+    size_t walk_entry_shard(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list, F fn);
+
+    mutable grp_shard_t _grp_shard[SHARD_COUNT];
+    entry_shard_t _entry_shard[SHARD_COUNT];
 };
 
 t_std_error ndi_ipmc_get_repl_subgrp_id(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
@@ -599,7 +684,44 @@ t_std_error ndi_ipmc_cache_del_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ip
 t_std_error ndi_ipmc_cache_update_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
                                         ndi_ipmc_update_type_t upd_type);
 t_std_error ndi_ipmc_cache_get_entry(npu_id_t npu_id, ndi_ipmc_entry_t& ipmc_entry);
-const ndi_cache_repl_grp_t& ndi_ipmc_cache_get_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id);
+t_std_error ndi_ipmc_cache_add_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list);
+t_std_error ndi_ipmc_cache_del_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list);
+t_std_error ndi_ipmc_cache_update_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list,
+                                          ndi_ipmc_update_type_t upd_type);
+ndi_cache_repl_grp_t ndi_ipmc_cache_get_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id);
+
+/* Walk/restore the replication group cache, used to checkpoint the cache for warm restart */
+void ndi_ipmc_cache_walk_repl_grp(const repl_group_cache::grp_walk_fn& fn);
+void ndi_ipmc_cache_walk_entry(const repl_group_cache::entry_walk_fn& fn);
+t_std_error ndi_ipmc_cache_restore_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                            ndi_obj_id_t rpf_grp_id, ndi_obj_id_t ipmc_grp_id);
+t_std_error ndi_ipmc_cache_discard_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id);
+t_std_error ndi_ipmc_cache_restore_grp_mbr(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                           ndi_mc_grp_mbr_type_t mbr_type, ndi_obj_id_t mbr_id,
+                                           const ndi_mc_grp_mbr_t& grp_mbr);
+
+/*
+ * Bulk IPMC entry create/delete/update. Sub group IDs are resolved once per
+ * replication group and the cache is updated once per batch. rc_list may be
+ * NULL, returns the error of the first entry that failed.
+ */
+t_std_error ndi_ipmc_entries_create(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    t_std_error *rc_list);
+t_std_error ndi_ipmc_entries_delete(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    t_std_error *rc_list);
+t_std_error ndi_ipmc_entries_update(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    ndi_ipmc_update_type_t upd_type, t_std_error *rc_list);
+
+/*
+ * Bring the members of given type of a replication group to grp_mbr_list.
+ * Members are compared with cached members of the same RIF: members of RIFs
+ * not in the list are removed, members of new RIFs are added and members with
+ * a different port set get their port list set. Other members are not sent
+ * to SAI. Returns the error of the first member change that failed.
+ */
+t_std_error ndi_set_repl_group_members(npu_id_t npu_id, ndi_obj_id_t repl_group_id,
+                                       ndi_mc_grp_mbr_type_t mbr_type,
+                                       size_t grp_mbr_cnt, ndi_mc_grp_mbr_t *grp_mbr_list);
 
 std::string ndi_ipmc_ip_to_string(const hal_ip_addr_t& ip_addr);
 #endif
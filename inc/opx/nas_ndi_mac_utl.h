@@ -25,6 +25,8 @@
 #include "std_error_codes.h"
 #include "ds_common_types.h"
 #include "nas_ndi_common.h"
+#include "nas_ndi_mac.h"
+#include "nas_ndi_async.h"
 #include "nas_ndi_int.h"
 #include "nas_ndi_port_map.h"
 #include "saitypes.h"
@@ -43,6 +45,192 @@ bool ndi_mac_flush_vlan(hal_vlan_id_t vlan_id);
 
 void ndi_fdb_event_cb (uint32_t count,sai_fdb_event_notification_data_t *data);
 
+/* FDB shadow seed function, adds the SAI FDB entries to the shadow */
+bool ndi_mac_fdb_shadow_seed(void);
+
+/**
+ * @brief Create a list of MAC entries. VLAN and bridge port lookups are done
+ *        once per distinct VLAN/port in the list and entries are programmed
+ *        with one SAI bulk call when supported.
+ *
+ * @param[in] entries - MAC entries
+ *
+ * @param[in] count - number of entries
+ *
+ * @param[out] rc_list - per entry status, may be NULL
+ *
+ * @return STD_ERR_OK if all the entries are created, otherwise error of the
+ *  first failed entry
+ */
+t_std_error ndi_create_mac_entries(ndi_mac_entry_t *entries, size_t count, t_std_error *rc_list);
+
+/**
+ * @brief Delete a list of MAC entries, same as NDI_MAC_DEL_SINGLE_ENTRY delete
+ *        of each entry
+ *
+ * @param[in] entries - MAC entries
+ *
+ * @param[in] count - number of entries
+ *
+ * @param[out] rc_list - per entry status, may be NULL
+ *
+ * @return STD_ERR_OK if all the entries are deleted, otherwise error of the
+ *  first failed entry
+ */
+t_std_error ndi_delete_mac_entries(ndi_mac_entry_t *entries, size_t count, t_std_error *rc_list);
+
+/**
+ * @brief Register the MAC entry bulk handlers with the NDI async queues, so
+ *        that queued creates and deletes are programmed with one list call
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_mac_async_init(void);
+
+/**
+ * @brief Create a MAC entry on the NDI L2 async queue. Consecutive queued
+ *        creates are combined into one ndi_create_mac_entries call.
+ *
+ * @param[in] entry - MAC entry, owned by caller until completion
+ *
+ * @param[in] cmpl_fn - completion callback, can be NULL
+ *
+ * @param[in] cookie - passed to completion callback
+ *
+ * @return STD_ERR_OK if the request is queued otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_create_mac_entry_async(ndi_mac_entry_t *entry, ndi_async_cmpl_fn cmpl_fn,
+                                       void *cookie);
+
+/**
+ * @brief Delete a MAC entry on the NDI L2 async queue. Consecutive queued
+ *        deletes are combined into one ndi_delete_mac_entries call.
+ *
+ * @param[in] entry - MAC entry, owned by caller until completion
+ *
+ * @param[in] cmpl_fn - completion callback, can be NULL
+ *
+ * @param[in] cookie - passed to completion callback
+ *
+ * @return STD_ERR_OK if the request is queued otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_delete_mac_entry_async(ndi_mac_entry_t *entry, ndi_async_cmpl_fn cmpl_fn,
+                                       void *cookie);
+
+/* MAC table iterator filter, fields are used when the match flag is set */
+typedef struct {
+    bool match_vlan;
+    hal_vlan_id_t vlan_id;
+    bool match_bridge;
+    ndi_obj_id_t bridge_id;
+    bool match_port;
+    /* LAG if ndi_lag_id is not 0, otherwise port_info */
+    ndi_obj_id_t ndi_lag_id;
+    ndi_port_t port_info;
+} ndi_mac_iter_filter_t;
+
+typedef struct ndi_mac_iter_s ndi_mac_iter_t;
+
+/**
+ * @brief Start a paged walk of the MAC table. Entries are read from the NDI
+ *        FDB shadow when it is enabled. Otherwise the SAI FDB key list is
+ *        read here and each entry is read from SAI as the walk reaches it,
+ *        entries learned after this call are not seen.
+ *
+ * @param[in] npu_id - npu id
+ *
+ * @param[in] filter - entry filter, NULL for all entries
+ *
+ * @return iterator, NULL if filter is invalid or the SAI key list can not
+ *  be read
+ */
+ndi_mac_iter_t *ndi_mac_iter_create(npu_id_t npu_id, const ndi_mac_iter_filter_t *filter);
+
+/**
+ * @brief Get the next page of MAC entries
+ *
+ * @param[in] iter - iterator
+ *
+ * @param[out] entries - page buffer
+ *
+ * @param[in] max_count - page size
+ *
+ * @param[out] count - number of entries filled, 0 at the end of the table
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_mac_iter_next(ndi_mac_iter_t *iter, ndi_mac_entry_t *entries,
+                              size_t max_count, size_t *count);
+
+/**
+ * @brief Free the iterator
+ */
+void ndi_mac_iter_destroy(ndi_mac_iter_t *iter);
+
+/* Port or LAG of a MAC flush request */
+typedef struct {
+    /* LAG if ndi_lag_id is not 0, otherwise port_info */
+    ndi_obj_id_t ndi_lag_id;
+    ndi_port_t port_info;
+} ndi_mac_flush_port_t;
+
+/*
+ * MAC flush request. Entries on any of the ports and in any of the VLANs
+ * are flushed. Empty port list matches all ports, vlan_min 0 matches all
+ * VLANs.
+ */
+typedef struct {
+    npu_id_t npu_id;
+    const ndi_mac_flush_port_t *port_list;
+    size_t port_count;
+    hal_vlan_id_t vlan_min;
+    hal_vlan_id_t vlan_max;
+    /* flush only static or only dynamic entries if set, otherwise dynamic */
+    bool type_set;
+    bool is_static;
+} ndi_mac_flush_req_t;
+
+typedef struct {
+    t_std_error rc;
+    /* number of bridge port and VLAN combinations flushed */
+    size_t sai_flush_count;
+    /* entry_count is known only with a seeded FDB shadow */
+    bool entry_count_known;
+    /* number of entries flushed, 0 if not known */
+    size_t entry_count;
+} ndi_mac_flush_result_t;
+
+/* Flush completion callback */
+typedef void (*ndi_mac_flush_cmpl_fn)(const ndi_mac_flush_req_t *req,
+                                      const ndi_mac_flush_result_t *result, void *cookie);
+
+/**
+ * @brief Flush MAC entries for a list of ports and a VLAN range. The flush
+ *        runs on the NDI L2 async queue when async mode is started.
+ *        Aged and flushed FDB events for entries matching the request are
+ *        not sent to the MAC event callback, one completion callback is
+ *        called instead. Events are held back per bridge port and VLAN
+ *        pair, from the SAI flush of the pair until SAI ends it or up to
+ *        the drain time. The completion callback is called once the SAI
+ *        flushes are done, without waiting for those events. Without a
+ *        seeded FDB shadow the number of entries flushed is not known.
+ *
+ * @param[in] req - flush request, owned by caller until completion
+ *
+ * @param[in] cmpl_fn - completion callback, can be NULL
+ *
+ * @param[in] cookie - passed to completion callback
+ *
+ * @return STD_ERR_OK if the flush is queued otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_mac_flush_async(const ndi_mac_flush_req_t *req,
+                                ndi_mac_flush_cmpl_fn cmpl_fn, void *cookie);
+
 #ifdef __cplusplus
 }
 #endif
@@ -135,6 +135,13 @@ typedef struct _nas_ndi_map_val_t {
     nas_ndi_map_data_t *data;
 } nas_ndi_map_val_t;
 
+/*
+ * Called for each element of each key during nas_ndi_map_walk.
+ */
+typedef void (*nas_ndi_map_walk_fn) (const nas_ndi_map_key_t  *key,
+                                     const nas_ndi_map_data_t *data,
+                                     void *context);
+
 #ifdef __cplusplus
 extern "C"{
 #endif
@@ -154,6 +161,8 @@ t_std_error nas_ndi_map_get_elements (nas_ndi_map_key_t        *key,
 
 t_std_error nas_ndi_map_get_val_count (nas_ndi_map_key_t *key, size_t *count);
 
+t_std_error nas_ndi_map_walk (nas_ndi_map_walk_fn fn, void *context);
+
 #ifdef __cplusplus
 }
 #endif
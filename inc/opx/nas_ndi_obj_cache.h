@@ -112,6 +112,8 @@ bool nas_ndi_get_virtual_obj(ndi_virtual_obj_t * obj,ndi_virtual_obj_query_type_
 
 bool nas_ndi_add_bridge_port_obj(ndi_brport_obj_t * obj);
 
+bool nas_ndi_add_bridge_port_obj_list(const ndi_brport_obj_t * obj_list, size_t count);
+
 bool nas_ndi_remove_bridge_port_obj(ndi_brport_obj_t * obj);
 
 bool nas_ndi_get_bridge_port_obj(ndi_brport_obj_t * obj,ndi_brport_query_type_t qtype);
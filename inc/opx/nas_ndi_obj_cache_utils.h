@@ -28,10 +28,22 @@ using brport_slave_list = std::list<ndi_brport_slave_t>;
 
 using brport_slave_fn = std::function< void (ndi_brport_slave_t) >;
 
+using brport_walk_fn = std::function< void (const ndi_brport_obj_t &) >;
+
+using virtual_obj_walk_fn = std::function< void (const ndi_virtual_obj_t &) >;
+
 bool nas_ndi_get_bridge_port_obj_list(sai_object_id_t port_id,brport_list & list );
 
 bool nas_ndi_get_bridge_port_slave_list(sai_object_id_t brport_id, brport_slave_list & list);
 
 void nas_ndi_bridge_port_slave_callback(sai_object_id_t brport_id, brport_slave_fn fn);
 
+/*
+ * Call given function for each bridge port/virtual obj in the cache,
+ * used to checkpoint the caches for warm restart
+ */
+void nas_ndi_bridge_port_obj_walk(brport_walk_fn fn);
+
+void nas_ndi_virtual_obj_walk(virtual_obj_walk_fn fn);
+
 #endif /* NAS_NDI_INC_NAS_NDI_OBJ_CACHE_UTILS_H_ */
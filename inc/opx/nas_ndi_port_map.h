@@ -50,6 +50,9 @@ t_std_error ndi_port_map_sai_port_add(npu_id_t npu, sai_object_id_t sai_port,
 
 t_std_error ndi_port_map_sai_port_delete(npu_id_t npu, sai_object_id_t sai_port, npu_port_t *npu_port);
 
+/*  Port map generation, changes whenever a port is added to or deleted from the map */
+uint64_t ndi_port_map_generation_get(void);
+
 npu_id_t ndi_saiport_to_npu_id_get(sai_object_id_t sai_port);
 
 t_std_error ndi_sai_port_map_create(void);
@@ -34,6 +34,7 @@
 #include <memory>
 #include <deque>
 #include <utility>
+#include <functional>
 
 typedef struct _ndi_rif_entry_key_t {
     npu_id_t               npu_id;
@@ -105,6 +106,14 @@ typedef std::unordered_map<ndi_rif_entry_db_t, ndi_rif_id_t,
                            ndi_rif_entry_key_hash, ndi_rif_entry_key_equal> ndi_rif_db_t;
 typedef std::pair<ndi_rif_entry_db_t, ndi_rif_id_t> ndi_rif_entry_db_pair_t;
 
+using ndi_rif_walk_fn = std::function<void (ndi_rif_id_t, const ndi_rif_entry_db_t&)>;
+
+/* Walk/restore the RIF cache, used to checkpoint the cache for warm restart */
+void ndi_rif_utl_walk(ndi_rif_walk_fn fn);
+t_std_error ndi_rif_utl_restore_rif(ndi_rif_id_t rif_id, const ndi_rif_entry_db_t& rif_db_entry);
+/* Drop a restored RIF regardless of its reference count */
+t_std_error ndi_rif_utl_discard_rif(ndi_rif_id_t rif_id);
+
 
 extern "C" {
 #endif
@@ -28,9 +28,12 @@
 #include "saitypes.h"
 #include "saitunnel.h"
 #include "nas_ndi_int.h"
+#include "nas_ndi_utils.h"
 #include "ds_common_types.h"
 #include "std_error_codes.h"
+#include "std_mutex_lock.h"
 
+#include <functional>
 #include <map>
 #include <string>
 #include <stdlib.h>
@@ -43,4 +46,53 @@ bool insert_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip,
 bool remove_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip);
 bool has_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip);
 
+/** Call given function for each tunnel object, caller must hold ndi_tun_mutex_lock() */
+void walk_tunnel_obj(std::function<void (TunnelObj *)> fn);
+
+std_mutex_type_t *ndi_tun_mutex_lock();
+
+extern "C" {
+
+/** Remote VXLAN endpoint to attach to a bridge with a VNI */
+typedef struct {
+    hal_ip_addr_t remote_ip;
+    hal_ip_addr_t local_ip;
+    uint32_t vni;
+    ndi_obj_id_t bridge_oid;
+    ndi_obj_id_t tun_brport_oid;    /* Output, tunnel bridge port created for the endpoint */
+} ndi_tunnel_endpoint_t;
+
+/**
+ * Add a list of remote endpoints, same as calling nas_ndi_add_remote_endpoint
+ * for each of them with the given VRF and underlay RIF, but the tunnel lock is
+ * taken once for the batch and the tunnel of each remote and local IP pair is
+ * looked up or created once.
+ *
+ * @param rc_list optional, per endpoint status
+ * @return STD_ERR_OK if all the endpoints are added, else first failure
+ */
+t_std_error nas_ndi_add_remote_endpoints(npu_id_t npu_id, ndi_obj_id_t vrf_oid, ndi_obj_id_t ulay_rif_oid,
+                                         ndi_tunnel_endpoint_t *ep_list, size_t count, t_std_error *rc_list);
+
+/**
+ * Get the SAI tunnel OID of each remote and local IP pair, for reading tunnel
+ * stats with ndi_tunnel_stats_bulk_get. OID of a pair with no tunnel is set
+ * to SAI_NULL_OBJECT_ID.
+ */
+t_std_error ndi_tunnel_oid_list_get(const hal_ip_addr_t *remote_ip_list, const hal_ip_addr_t *local_ip_list,
+                                    size_t count, ndi_obj_id_t *tun_oid_list);
+
+/**
+ * Read the same counters from a list of tunnels, handle is created for
+ * NDI_STAT_OBJ_TUNNEL. stats_val has one row of ndi_stat_handle_len(handle)
+ * counters per tunnel, zeroed for a tunnel that failed. rc_list may be NULL.
+ * Tunnel bridge ports are read with ndi_bridge_port_stats_bulk_get and a
+ * NDI_STAT_OBJ_TUNNEL_BRIDGE_PORT handle.
+ */
+t_std_error ndi_tunnel_stats_bulk_get(npu_id_t npu_id, const ndi_obj_id_t *tun_oid_list,
+                                      size_t tun_count, const ndi_stat_handle_t *handle,
+                                      uint64_t *stats_val, t_std_error *rc_list);
+
+}
+
 #endif /* _NAS_NDI_TUNNEL_MAP_H */
@@ -31,8 +31,10 @@
 #include "stdint.h"
 
 #include <iostream>
-#include <map>
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 #include <stdlib.h>
 
 
@@ -42,8 +44,21 @@ typedef struct {
 } vni_s_oid_map_t;
 
 
-/** VNI ID to SAI Object ID Map */
-typedef std::map<sai_object_id_t, vni_s_oid_map_t>           _vni_sai_obj_map_t;
+/**
+ * VNI ID to SAI Object ID Map, kept as a vector sorted by bridge OID. Entries
+ * are 24 bytes each without per node allocation, lookup is a binary search.
+ */
+typedef std::vector<std::pair<sai_object_id_t, vni_s_oid_map_t>>   _vni_sai_obj_map_t;
+
+/** Per bridge maps kept in a tunnel object */
+typedef enum {
+    ndi_tunnel_obj_map_type_ENCAP = 1,
+    ndi_tunnel_obj_map_type_DECAP,
+    ndi_tunnel_obj_map_type_BRIDGE_PORT,
+} ndi_tunnel_obj_map_type_t;
+
+using tunnel_obj_map_walk_fn = std::function<void (ndi_tunnel_obj_map_type_t, sai_object_id_t,
+                                                   const vni_s_oid_map_t &)>;
 
 class TunnelObj {
 
@@ -126,7 +141,14 @@ class TunnelObj {
         /** Method to get a bridge port map size */
         int get_tunnel_bridge_ports_size();
 
+        /** Method to call given function for each entry of the encap, decap and bridge port maps */
+        void walk_map_entries(tunnel_obj_map_walk_fn fn);
+
         void print();
+
+        /** TunnelObj records are allocated from a pool, see nas_ndi_tunnel_obj.cpp */
+        static void *operator new(size_t size);
+        static void operator delete(void *ptr, size_t size);
 };
 
 #endif /* _NAS_NDI_TUNNEL_OBJ_H */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_txn.h
+ *
+ * NDI transaction. Records a list of create/set/remove steps for a composite
+ * object and commits them in order. Consecutive creates of the same object
+ * type are submitted in one SAI bulk call when a bulk handler is registered.
+ * If any step fails, the steps already done are undone in reverse order.
+ */
+
+#ifndef __NAS_NDI_TXN_H
+#define __NAS_NDI_TXN_H
+
+#include "std_error_codes.h"
+#include "nas_ndi_common.h"
+#include "saitypes.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ndi_txn_s ndi_txn_t;
+
+/* Index of a step in the transaction */
+typedef size_t ndi_txn_step_id_t;
+
+#define NDI_TXN_STEP_INVALID ((ndi_txn_step_id_t)-1)
+
+/* Generic step handlers */
+typedef t_std_error (*ndi_txn_do_fn)(void *ctx);
+typedef void (*ndi_txn_undo_fn)(void *ctx);
+
+/* SAI object handlers, same signature as the per object SAI API functions */
+typedef sai_status_t (*ndi_txn_sai_create_fn)(sai_object_id_t *object_id,
+                                              sai_object_id_t switch_id,
+                                              uint32_t attr_count,
+                                              const sai_attribute_t *attr_list);
+typedef sai_status_t (*ndi_txn_sai_remove_fn)(sai_object_id_t object_id);
+typedef sai_status_t (*ndi_txn_sai_set_fn)(sai_object_id_t object_id,
+                                           const sai_attribute_t *attr);
+
+/**
+ * @brief Allocate an empty transaction
+ *
+ * @return transaction, NULL on allocation failure
+ */
+ndi_txn_t *ndi_txn_create(void);
+
+/**
+ * @brief Free the transaction. Objects created by a committed transaction
+ *        are not removed.
+ */
+void ndi_txn_destroy(ndi_txn_t *txn);
+
+/**
+ * @brief Register SAI bulk handlers used for consecutive create steps using
+ *        create_fn. A bulk handler that returns NOT_IMPLEMENTED or
+ *        NOT_SUPPORTED falls back to create_fn.
+ *
+ * @param[in] txn - transaction
+ *
+ * @param[in] create_fn - per object create handler
+ *
+ * @param[in] bulk_create_fn - bulk create handler, may be NULL
+ *
+ * @param[in] bulk_remove_fn - bulk remove handler used on rollback, may be NULL
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_txn_set_bulk_fn(ndi_txn_t *txn, ndi_txn_sai_create_fn create_fn,
+                                sai_bulk_object_create_fn bulk_create_fn,
+                                sai_bulk_object_remove_fn bulk_remove_fn);
+
+/**
+ * @brief Add a generic step
+ *
+ * @param[in] do_fn - handler run on commit
+ *
+ * @param[in] undo_fn - handler run on rollback if do_fn succeeded, may be NULL
+ *
+ * @param[in] ctx - passed to the handlers, owned by caller until destroy
+ *
+ * @return step id, NDI_TXN_STEP_INVALID on failure
+ */
+ndi_txn_step_id_t ndi_txn_add_step(ndi_txn_t *txn, ndi_txn_do_fn do_fn,
+                                   ndi_txn_undo_fn undo_fn, void *ctx);
+
+/**
+ * @brief Add a SAI object create step. The attribute list is copied, data
+ *        referenced by list attributes must stay valid until commit.
+ *
+ * @param[in] create_fn - SAI create handler
+ *
+ * @param[in] remove_fn - SAI remove handler used on rollback
+ *
+ * @param[in] attr_count - number of attributes
+ *
+ * @param[in] attr_list - attributes
+ *
+ * @param[out] object_id - set to the created object id on commit, may be NULL
+ *
+ * @return step id, NDI_TXN_STEP_INVALID on failure
+ */
+ndi_txn_step_id_t ndi_txn_add_sai_create(ndi_txn_t *txn,
+                                         ndi_txn_sai_create_fn create_fn,
+                                         ndi_txn_sai_remove_fn remove_fn,
+                                         uint32_t attr_count,
+                                         const sai_attribute_t *attr_list,
+                                         sai_object_id_t *object_id);
+
+/**
+ * @brief Set an oid attribute of a create step to the object id created by
+ *        an earlier step when the transaction is committed
+ *
+ * @param[in] step - create step
+ *
+ * @param[in] attr_ix - index of the attribute in the step attribute list
+ *
+ * @param[in] src_step - earlier create step
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_txn_bind_oid(ndi_txn_t *txn, ndi_txn_step_id_t step,
+                             uint32_t attr_ix, ndi_txn_step_id_t src_step);
+
+/**
+ * @brief Add a SAI attribute set step
+ *
+ * @param[in] set_fn - SAI set handler
+ *
+ * @param[in] object_id - object to update
+ *
+ * @param[in] attr - new attribute value
+ *
+ * @param[in] old_attr - attribute value restored on rollback, may be NULL
+ *
+ * @return step id, NDI_TXN_STEP_INVALID on failure
+ */
+ndi_txn_step_id_t ndi_txn_add_sai_set(ndi_txn_t *txn, ndi_txn_sai_set_fn set_fn,
+                                      sai_object_id_t object_id,
+                                      const sai_attribute_t *attr,
+                                      const sai_attribute_t *old_attr);
+
+/**
+ * @brief Add a SAI object remove step. A removed object can not be restored
+ *        with the same id, so remove steps should be added after all steps
+ *        that can fail.
+ *
+ * @param[in] remove_fn - SAI remove handler
+ *
+ * @param[in] object_id - object to remove
+ *
+ * @return step id, NDI_TXN_STEP_INVALID on failure
+ */
+ndi_txn_step_id_t ndi_txn_add_sai_remove(ndi_txn_t *txn, ndi_txn_sai_remove_fn remove_fn,
+                                         sai_object_id_t object_id);
+
+/**
+ * @brief Get object id created by a committed create step
+ *
+ * @return object id, SAI_NULL_OBJECT_ID if not created
+ */
+sai_object_id_t ndi_txn_get_oid(const ndi_txn_t *txn, ndi_txn_step_id_t step);
+
+/**
+ * @brief Run all the steps in order. On failure the steps already done are
+ *        undone in reverse order. A transaction can be committed only once.
+ *
+ * @return STD_ERR_OK if all steps succeeded, otherwise error of the failed step
+ */
+t_std_error ndi_txn_commit(ndi_txn_t *txn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
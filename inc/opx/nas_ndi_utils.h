@@ -107,8 +107,54 @@ static inline t_std_error ndi_utl_mk_qos_std_err(sai_status_t st)
 }
 
 bool ndi_to_sai_stats_mode(ndi_stats_mode_t ndi_id, sai_stats_mode_t *sai_id);
+
+/* Object type of a stat handle */
+typedef enum {
+    NDI_STAT_OBJ_VLAN = 0,
+    NDI_STAT_OBJ_BRIDGE_1D,
+    NDI_STAT_OBJ_BRIDGE_PORT,
+    NDI_STAT_OBJ_TUNNEL,
+    /* Bridge port counters of a VXLAN tunnel, stat ids as for NDI_STAT_OBJ_TUNNEL */
+    NDI_STAT_OBJ_TUNNEL_BRIDGE_PORT,
+} ndi_stat_obj_type_t;
+
+/* Stat id list translated to SAI counter ids once, for repeated multi object reads */
+typedef struct ndi_stat_handle_s ndi_stat_handle_t;
+
+/**
+ * @brief Create a stat handle for a list of NDI stat ids
+ *
+ * @param[in] obj_type - object type the stats are read from
+ *
+ * @param[in] ndi_stat_ids - NDI stat id list
+ *
+ * @param[in] len - number of stat ids
+ *
+ * @return stat handle, NULL if a stat id is not supported for the object type
+ */
+ndi_stat_handle_t *ndi_stat_handle_create(ndi_stat_obj_type_t obj_type,
+                                          const ndi_stat_id_t *ndi_stat_ids, size_t len);
+
+void ndi_stat_handle_destroy(ndi_stat_handle_t *handle);
+
+/**
+ * @brief Number of counters per object read with the handle
+ */
+size_t ndi_stat_handle_len(const ndi_stat_handle_t *handle);
+
 #ifdef __cplusplus
 }
+
+#include <vector>
+
+struct ndi_stat_handle_s {
+    ndi_stat_obj_type_t obj_type;
+    size_t len;
+    std::vector<sai_vlan_stat_t> vlan_ids;
+    std::vector<sai_bridge_stat_t> bridge_ids;
+    std::vector<sai_bridge_port_stat_t> brport_ids;
+    std::vector<sai_tunnel_stat_t> tunnel_ids;
+};
 #endif
 
 #endif  /*  _NAS_NDI_UTILS_H_ */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_vlan_mbr_cache.h
+ *
+ * VLAN membership cache. Each VLAN keeps a bitmap of member ports and the
+ * member object of each port, each port keeps a bitmap of its VLANs, so that
+ * membership lookups are O(1) and all the VLANs of a port or all the ports
+ * of a VLAN are found in one pass. Ports are SAI port or LAG object ids.
+ */
+
+#ifndef __NAS_NDI_VLAN_MBR_CACHE_H
+#define __NAS_NDI_VLAN_MBR_CACHE_H
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+#include "nas_ndi_common.h"
+#include "saitypes.h"
+#include "saivlan.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    hal_vlan_id_t vlan_id;
+    sai_object_id_t port_id;
+    sai_object_id_t member_id;
+    sai_vlan_tagging_mode_t tagging_mode;
+} ndi_vlan_mbr_info_t;
+
+/**
+ * @brief Get VLAN member of a port
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] vlan_id - VLAN ID
+ *
+ * @param[in] port_id - SAI port or LAG id
+ *
+ * @param[out] member_id - SAI VLAN member id, may be NULL
+ *
+ * @param[out] tagging_mode - tagging mode of the member, may be NULL
+ *
+ * @return STD_ERR_OK if the port is a member otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_vlan_mbr_cache_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        sai_object_id_t port_id, sai_object_id_t *member_id,
+        sai_vlan_tagging_mode_t *tagging_mode);
+
+/**
+ * @brief Add members or update the member id and tagging mode of existing
+ *        members, with one cache lock
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_vlan_mbr_cache_set(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr_list,
+        size_t count);
+
+/**
+ * @brief Remove members with one cache lock. vlan_id and port_id are used,
+ *        members not in the cache are ignored.
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_vlan_mbr_cache_del(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr_list,
+        size_t count);
+
+/**
+ * @brief Get the members of a port in VLAN ID order
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] port_id - SAI port or LAG id
+ *
+ * @param[out] mbr_list - member list, may be NULL if max_count is 0
+ *
+ * @param[in] max_count - size of member list
+ *
+ * @return number of VLANs of the port, can be larger than max_count
+ */
+size_t ndi_vlan_mbr_cache_port_get(npu_id_t npu_id, sai_object_id_t port_id,
+        ndi_vlan_mbr_info_t *mbr_list, size_t max_count);
+
+/**
+ * @brief Get the members of a VLAN
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] vlan_id - VLAN ID
+ *
+ * @param[out] mbr_list - member list, may be NULL if max_count is 0
+ *
+ * @param[in] max_count - size of member list
+ *
+ * @return number of ports in the VLAN, can be larger than max_count
+ */
+size_t ndi_vlan_mbr_cache_vlan_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        ndi_vlan_mbr_info_t *mbr_list, size_t max_count);
+
+typedef void (*ndi_vlan_mbr_cache_walk_fn)(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr,
+        void *context);
+
+/**
+ * @brief Walk all the members of all the NPUs, in VLAN ID order per NPU.
+ *        Called with the cache read lock held, fn must not update the cache.
+ *        Used to checkpoint the cache for warm restart.
+ *
+ * @param[in] fn - called once for each member
+ *
+ * @param[in] context - passed to fn
+ */
+void ndi_vlan_mbr_cache_walk(ndi_vlan_mbr_cache_walk_fn fn, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
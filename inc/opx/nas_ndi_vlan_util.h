@@ -25,6 +25,7 @@
 #include "ds_common_types.h"
 #include "nas_ndi_common.h"
 #include "saitypes.h"
+#include "nas_ndi_utils.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -73,10 +74,101 @@ sai_object_id_t ndi_get_sai_vlan_obj_id(npu_id_t npu_id,
 t_std_error ndi_get_sai_vlan_id(npu_id_t npu_id, sai_object_id_t vlan_obj_id,
         hal_vlan_id_t *vlan_id);
 
+/**
+ * @brief Restore VLAN Id to SAI VLAN UOID mapping from warm restart checkpoint
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] vlan_id - VLAN ID
+ *
+ * @param[in] vlan_obj_id - SAI VLAN UOID
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_vlan_restore_sai_vlan_obj_id(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        sai_object_id_t vlan_obj_id);
+
+/**
+ * @brief Drop a VLAN object mapping added by ndi_vlan_restore_sai_vlan_obj_id,
+ *        used to roll back a checkpoint restore that failed.
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] vlan_id - VLAN ID
+ *
+ * @param[in] vlan_obj_id - SAI VLAN UOID
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_vlan_discard_sai_vlan_obj_id(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        sai_object_id_t vlan_obj_id);
+
 t_std_error ndi_vlan_delete_default_member_brports(npu_id_t npu_id, sai_object_id_t brport, bool del_all);
 
 bool ndi_vlan_get_default_obj_id(npu_id_t npu_id);
 
+/**
+ * @brief Add a port to all the created VLANs in a VLAN range. VLANs in the
+ *        range that are not created are skipped.
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] p_ndi_port - port to add
+ *
+ * @param[in] vlan_min - first VLAN ID of the range
+ *
+ * @param[in] vlan_max - last VLAN ID of the range
+ *
+ * @param[in] tagged - true to add as tagged member
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_add_port_to_vlan_range(npu_id_t npu_id, ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max, bool tagged);
+
+/**
+ * @brief Delete a port from all the VLANs in a VLAN range
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] p_ndi_port - port to delete
+ *
+ * @param[in] vlan_min - first VLAN ID of the range
+ *
+ * @param[in] vlan_max - last VLAN ID of the range
+ *
+ * @return STD_ERR_OK if operation is successful otherwise a different
+ *  error code is returned.
+ */
+t_std_error ndi_del_port_from_vlan_range(npu_id_t npu_id, ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max);
+
+/**
+ * @brief Read the same counters from a list of VLANs
+ *
+ * @param[in] npu_id - NPU ID
+ *
+ * @param[in] vlan_list - VLAN ID list
+ *
+ * @param[in] vlan_count - number of VLANs
+ *
+ * @param[in] handle - stat handle created for NDI_STAT_OBJ_VLAN
+ *
+ * @param[out] stats_val - vlan_count x ndi_stat_handle_len(handle) counters,
+ *                         one row per VLAN, zeroed for a VLAN that failed
+ *
+ * @param[out] rc_list - per VLAN result, may be NULL
+ *
+ * @return STD_ERR_OK if all the VLANs are read otherwise the error of the
+ *  first VLAN that failed
+ */
+t_std_error ndi_vlan_stats_bulk_get(npu_id_t npu_id, const hal_vlan_id_t *vlan_list,
+                                    size_t vlan_count, const ndi_stat_handle_t *handle,
+                                    uint64_t *stats_val, t_std_error *rc_list);
+
 #ifdef __cplusplus
 }
 #endif
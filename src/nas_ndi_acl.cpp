@@ -20,6 +20,7 @@
 
 
 #include "std_assert.h"
+#include "std_mutex_lock.h"
 #include "dell-base-acl.h"
 #include "nas_ndi_int.h"
 #include "nas_ndi_event_logs.h"
@@ -27,20 +28,220 @@
 #include "nas_base_utils.h"
 #include "nas_ndi_switch.h"
 #include "nas_ndi_acl.h"
+#include "nas_ndi_acl_bulk.h"
 #include "nas_ndi_trap.h"
 #include "nas_ndi_acl_utl.h"
 #include "nas_ndi_udf_utl.h"
+#include "nas_ndi_async.h"
+#include "nas_ndi_acl_resource.h"
+#include <chrono>
 #include <vector>
 #include <unordered_map>
 #include <string.h>
 #include <list>
 #include <inttypes.h>
+#include <algorithm>
 
 static inline t_std_error _sai_to_ndi_err (sai_status_t st)
 {
     return ndi_utl_mk_std_err (e_std_err_ACL, st);
 }
 
+// Last counter values returned by delta mode reads, per NPU
+typedef struct {
+    uint64_t byte_count;
+    uint64_t pkt_count;
+} ndi_acl_counter_last_t;
+
+// Count modes enabled on each counter, per NPU, so that delta mode reads
+// only ask SAI for the counts the counter keeps
+typedef struct {
+    bool byte_count;
+    bool pkt_count;
+} ndi_acl_counter_mode_t;
+
+static std_mutex_lock_create_static_init_fast(_acl_counter_last_lock);
+static auto _acl_counter_last =
+    new std::unordered_map<npu_id_t, std::unordered_map<ndi_obj_id_t, ndi_acl_counter_last_t>>;
+static auto _acl_counter_mode =
+    new std::unordered_map<npu_id_t, std::unordered_map<ndi_obj_id_t, ndi_acl_counter_mode_t>>;
+
+// Programmed filters and actions of each entry, per NPU, kept to diff entry
+// updates against. The value is the filled SAI attribute with the contents
+// of its lists copied in, so that equal values compare equal.
+typedef struct {
+    bool        is_action;
+    bool        has_list;
+    std::string value;
+} ndi_acl_entry_attr_shadow_t;
+
+typedef struct {
+    ndi_obj_id_t                                              table_id;
+    ndi_acl_priority_t                                        priority;
+    std::unordered_map<sai_attr_id_t, ndi_acl_entry_attr_shadow_t> attrs;
+} ndi_acl_entry_shadow_t;
+
+static std_mutex_lock_create_static_init_fast(_acl_entry_shadow_lock);
+static auto _acl_entry_shadow =
+    new std::unordered_map<npu_id_t, std::unordered_map<ndi_obj_id_t, ndi_acl_entry_shadow_t>>;
+
+// Table Id, priority and admin state come before the filters and actions
+static const size_t _ACL_ENTRY_FIXED_ATTR_CNT = 3;
+
+template <typename T>
+static void _ndi_acl_shadow_append_list (std::string& value, T& list)
+{
+    value.append (reinterpret_cast<const char*> (list.list), list.count * sizeof (*list.list));
+    list.list = nullptr;
+}
+
+static ndi_acl_entry_attr_shadow_t _ndi_acl_filter_shadow (const sai_attribute_t& sai_attr,
+                                                          ndi_acl_filter_values_type_t values_type)
+{
+    ndi_acl_entry_attr_shadow_t shadow {false, true, {}};
+    sai_acl_field_data_t        field;
+
+    memcpy (&field, &sai_attr.value.aclfield, sizeof (field));
+    switch (values_type) {
+        case NDI_ACL_FILTER_PORTLIST:
+        case NDI_ACL_FILTER_OBJ_ID_LIST:
+            _ndi_acl_shadow_append_list (shadow.value, field.data.objlist);
+            break;
+        case NDI_ACL_FILTER_U8LIST:
+            _ndi_acl_shadow_append_list (shadow.value, field.data.u8list);
+            _ndi_acl_shadow_append_list (shadow.value, field.mask.u8list);
+            break;
+        default:
+            shadow.has_list = false;
+            break;
+    }
+    shadow.value.append (reinterpret_cast<const char*> (&field), sizeof (field));
+    return shadow;
+}
+
+static ndi_acl_entry_attr_shadow_t _ndi_acl_action_shadow (const sai_attribute_t& sai_attr,
+                                                          ndi_acl_action_values_type_t values_type)
+{
+    ndi_acl_entry_attr_shadow_t shadow {true, true, {}};
+    sai_acl_action_data_t       action;
+
+    memcpy (&action, &sai_attr.value.aclaction, sizeof (action));
+    switch (values_type) {
+        case NDI_ACL_ACTION_PORTLIST:
+        case NDI_ACL_ACTION_OBJ_ID_LIST:
+            _ndi_acl_shadow_append_list (shadow.value, action.parameter.objlist);
+            break;
+        default:
+            shadow.has_list = false;
+            break;
+    }
+    shadow.value.append (reinterpret_cast<const char*> (&action), sizeof (action));
+    return shadow;
+}
+
+/* Build the shadow of an entry from its filled SAI attribute list */
+static void _ndi_acl_entry_shadow_build (const ndi_acl_entry_t* ndi_entry_p,
+                                         const std::vector<sai_attribute_t>& sai_entry_attr_list,
+                                         ndi_acl_entry_shadow_t& shadow)
+{
+    size_t ix = _ACL_ENTRY_FIXED_ATTR_CNT;
+
+    shadow.table_id = ndi_entry_p->table_id;
+    shadow.priority = ndi_entry_p->priority;
+    shadow.attrs.clear ();
+    for (uint_t count = 0; count < ndi_entry_p->filter_count; count++, ix++) {
+        shadow.attrs[sai_entry_attr_list[ix].id] =
+            _ndi_acl_filter_shadow (sai_entry_attr_list[ix],
+                                    ndi_entry_p->filter_list[count].values_type);
+    }
+    for (uint_t count = 0; count < ndi_entry_p->action_count; count++, ix++) {
+        shadow.attrs[sai_entry_attr_list[ix].id] =
+            _ndi_acl_action_shadow (sai_entry_attr_list[ix],
+                                    ndi_entry_p->action_list[count].values_type);
+    }
+}
+
+/* Apply fn to the shadow of an entry, if the entry is known */
+template <typename F>
+static void _ndi_acl_entry_shadow_update (npu_id_t npu_id, ndi_obj_id_t ndi_entry_id, F fn)
+{
+    std_mutex_simple_lock_guard g(&_acl_entry_shadow_lock);
+
+    auto npu_it = _acl_entry_shadow->find (npu_id);
+    if (npu_it == _acl_entry_shadow->end ()) return;
+    auto it = npu_it->second.find (ndi_entry_id);
+    if (it == npu_it->second.end ()) return;
+    fn (it->second);
+}
+
+/* Drop the shadow of an entry, returns the table of the entry or 0 */
+static ndi_obj_id_t _ndi_acl_entry_shadow_del (npu_id_t npu_id, ndi_obj_id_t ndi_entry_id)
+{
+    ndi_obj_id_t ndi_tbl_id = 0;
+    std_mutex_simple_lock_guard g(&_acl_entry_shadow_lock);
+
+    auto npu_it = _acl_entry_shadow->find (npu_id);
+    if (npu_it != _acl_entry_shadow->end ()) {
+        auto it = npu_it->second.find (ndi_entry_id);
+        if (it != npu_it->second.end ()) {
+            ndi_tbl_id = it->second.table_id;
+            npu_it->second.erase (it);
+        }
+    }
+    return ndi_tbl_id;
+}
+
+/* Entry delete, keep the resource model in step */
+static void _ndi_acl_entry_deleted (npu_id_t npu_id, ndi_obj_id_t ndi_entry_id)
+{
+    ndi_obj_id_t ndi_tbl_id = _ndi_acl_entry_shadow_del (npu_id, ndi_entry_id);
+    if (ndi_tbl_id != 0) {
+        ndi_acl_resource_entry_del (npu_id, ndi_tbl_id, 1);
+    }
+}
+
+/* SAI ran out of ACL entries, the resource model has drifted */
+static void _ndi_acl_resource_check_full (npu_id_t npu_id, sai_status_t sai_ret)
+{
+    if ((sai_ret == SAI_STATUS_INSUFFICIENT_RESOURCES) || (sai_ret == SAI_STATUS_TABLE_FULL)) {
+        ndi_acl_resource_invalidate (npu_id);
+    }
+}
+
+/* Entries of a table, as recorded in the entry shadow */
+static std::vector<ndi_obj_id_t> _ndi_acl_table_entries_get (npu_id_t npu_id,
+                                                            ndi_obj_id_t ndi_tbl_id)
+{
+    std::vector<ndi_obj_id_t> entry_id_list;
+    std_mutex_simple_lock_guard g(&_acl_entry_shadow_lock);
+
+    auto npu_it = _acl_entry_shadow->find (npu_id);
+    if (npu_it != _acl_entry_shadow->end ()) {
+        for (auto& entry: npu_it->second) {
+            if (entry.second.table_id == ndi_tbl_id) {
+                entry_id_list.push_back (entry.first);
+            }
+        }
+    }
+    return entry_id_list;
+}
+
+static uint64_t _ndi_acl_usec_since (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now () - start).count ();
+}
+
+// Teardown of the old table of a swap, run from the ACL async queue
+typedef struct {
+    npu_id_t                    npu_id;
+    ndi_obj_id_t                old_tbl_id;
+    std::vector<ndi_obj_id_t>   old_entry_id_list;
+    ndi_acl_table_swap_stats_t  stats;
+    ndi_acl_table_swap_cmpl_fn  cmpl_fn;
+    void                       *cookie;
+} ndi_acl_table_swap_ctx_t;
+
 extern "C" {
 
 t_std_error ndi_acl_table_create (npu_id_t npu_id, const ndi_acl_table_t* ndi_tbl_p,
@@ -165,6 +366,7 @@ t_std_error ndi_acl_table_create (npu_id_t npu_id, const ndi_acl_table_t* ndi_tb
     *ndi_tbl_id_p = ndi_acl_utl_sai2ndi_table_id (sai_tbl_id);
     NDI_ACL_LOG_INFO ("Successfully created ACL Table - Return NDI ID %" PRIx64,
                       *ndi_tbl_id_p);
+    ndi_acl_resource_table_add (npu_id, *ndi_tbl_id_p, ndi_tbl_p->stage, ndi_tbl_p->size);
     return rc;
 }
 
@@ -188,6 +390,7 @@ t_std_error ndi_acl_table_delete (npu_id_t npu_id, ndi_obj_id_t ndi_tbl_id)
 
     NDI_ACL_LOG_INFO ("Successfully deleted ACL Table NDI ID %" PRIx64,
                       ndi_tbl_id);
+    ndi_acl_resource_table_del (npu_id, ndi_tbl_id);
     return rc;
 }
 
@@ -219,24 +422,20 @@ t_std_error ndi_acl_table_set_priority (npu_id_t npu_id,
     return rc;
 }
 
-t_std_error ndi_acl_entry_create (npu_id_t npu_id,
-                                  const ndi_acl_entry_t* ndi_entry_p,
-                                  ndi_obj_id_t* ndi_entry_id_p)
+/* Fill the SAI attribute list of an entry, list buffers come from the arena */
+static t_std_error _ndi_acl_entry_fill_attrs (const ndi_acl_entry_t* ndi_entry_p,
+                                              std::vector<sai_attribute_t>& sai_entry_attr_list,
+                                              ndi_acl_utl_arena_t& arena,
+                                              bool admin_state = true)
 {
     t_std_error                   rc = STD_ERR_OK;
-
-    sai_status_t                  sai_ret = SAI_STATUS_FAILURE;
-    sai_object_id_t               sai_entry_id = 0;
-
     sai_attribute_t               sai_entry_attr = {0}, nil_attr = {0};
-    std::vector<sai_attribute_t>  sai_entry_attr_list;
-    nas_ndi_db_t                  *ndi_db_ptr = ndi_db_ptr_get(npu_id);
-    nas::mem_alloc_helper_t       malloc_tracker;
 
-    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+    sai_entry_attr_list.clear ();
 
     /* Reserve some space to avoid repeated memmoves */
-    sai_entry_attr_list.reserve (3 + ndi_entry_p->filter_count + ndi_entry_p->action_count);
+    sai_entry_attr_list.reserve (_ACL_ENTRY_FIXED_ATTR_CNT + ndi_entry_p->filter_count
+                                 + ndi_entry_p->action_count);
 
     // Table Id to which Entry belongs
     sai_entry_attr.id = SAI_ACL_ENTRY_ATTR_TABLE_ID;
@@ -252,7 +451,7 @@ t_std_error ndi_acl_entry_create (npu_id_t npu_id,
     // Entry Admin State
     sai_entry_attr = nil_attr;
     sai_entry_attr.id = SAI_ACL_ENTRY_ATTR_ADMIN_STATE;
-    sai_entry_attr.value.u8 = 1; // Enabled
+    sai_entry_attr.value.booldata = admin_state;
     sai_entry_attr_list.push_back (sai_entry_attr);
 
     // Filter fields and their values
@@ -261,7 +460,7 @@ t_std_error ndi_acl_entry_create (npu_id_t npu_id,
         ndi_acl_entry_filter_t *filter_p = &(ndi_entry_p->filter_list[count]);
 
         if ((rc = ndi_acl_utl_fill_sai_filter (&sai_entry_attr, filter_p,
-                                                malloc_tracker)) != STD_ERR_OK) {
+                                                arena)) != STD_ERR_OK) {
             return rc;
         }
         sai_entry_attr.value.aclfield.enable = true;
@@ -274,13 +473,36 @@ t_std_error ndi_acl_entry_create (npu_id_t npu_id,
         ndi_acl_entry_action_t *action_p = &(ndi_entry_p->action_list[count]);
 
         if ((rc = ndi_acl_utl_fill_sai_action (&sai_entry_attr, action_p,
-                                                malloc_tracker)) != STD_ERR_OK) {
+                                                arena)) != STD_ERR_OK) {
             return rc;
         }
         sai_entry_attr.value.aclaction.enable = true;
         sai_entry_attr_list.push_back (sai_entry_attr);
     }
 
+    return rc;
+}
+
+t_std_error ndi_acl_entry_create (npu_id_t npu_id,
+                                  const ndi_acl_entry_t* ndi_entry_p,
+                                  ndi_obj_id_t* ndi_entry_id_p)
+{
+    t_std_error                   rc = STD_ERR_OK;
+
+    sai_status_t                  sai_ret = SAI_STATUS_FAILURE;
+    sai_object_id_t               sai_entry_id = 0;
+
+    std::vector<sai_attribute_t>  sai_entry_attr_list;
+    nas_ndi_db_t                  *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    ndi_acl_utl_arena_t           arena;
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    if ((rc = _ndi_acl_entry_fill_attrs (ndi_entry_p, sai_entry_attr_list, arena))
+        != STD_ERR_OK) {
+        return rc;
+    }
+
     NDI_ACL_LOG_DETAIL ("Creating ACL Entry with %lu attributes",
                         sai_entry_attr_list.size());
 
@@ -290,6 +512,7 @@ t_std_error ndi_acl_entry_create (npu_id_t npu_id,
                                                                    sai_entry_attr_list.data()))
         != SAI_STATUS_SUCCESS) {
         NDI_ACL_LOG_ERROR ("Create ACL Entry failed in SAI %d", sai_ret);
+        _ndi_acl_resource_check_full (npu_id, sai_ret);
         return _sai_to_ndi_err (sai_ret);
     }
 
@@ -297,6 +520,214 @@ t_std_error ndi_acl_entry_create (npu_id_t npu_id,
     NDI_ACL_LOG_INFO ("Successfully created ACL Entry - Return NDI ID %" PRIx64,
                       *ndi_entry_id_p);
 
+    ndi_acl_resource_entry_add (npu_id, ndi_entry_p->table_id, 1);
+
+    ndi_acl_entry_shadow_t shadow;
+    _ndi_acl_entry_shadow_build (ndi_entry_p, sai_entry_attr_list, shadow);
+    std_mutex_simple_lock_guard g(&_acl_entry_shadow_lock);
+    (*_acl_entry_shadow)[npu_id][*ndi_entry_id_p] = std::move (shadow);
+
+    return rc;
+}
+
+/*
+ * SAI has no bulk ACL entry create, entries are created one per call. The
+ * attribute list and arena are reused across the batch so that filling an
+ * entry does not allocate once the buffers have grown to the largest entry.
+ */
+static t_std_error _ndi_acl_entries_create_bulk (npu_id_t npu_id,
+                                                 const ndi_acl_entry_t* entry_list,
+                                                 size_t count,
+                                                 ndi_obj_id_t* entry_id_list,
+                                                 t_std_error* rc_list,
+                                                 bool admin_state)
+{
+    t_std_error                   rc = STD_ERR_OK;
+    std::vector<sai_attribute_t>  sai_entry_attr_list;
+    nas_ndi_db_t                  *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    ndi_acl_utl_arena_t           arena;
+    size_t                        created = 0;
+    std::vector<std::pair<ndi_obj_id_t, ndi_acl_entry_shadow_t>> shadow_list;
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    shadow_list.reserve (count);
+
+    auto create_fn = ndi_acl_utl_api_get(ndi_db_ptr)->create_acl_entry;
+    auto switch_id = ndi_switch_id_get();
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        t_std_error     entry_rc = STD_ERR_OK;
+        sai_object_id_t sai_entry_id = SAI_NULL_OBJECT_ID;
+        sai_status_t    sai_ret;
+
+        arena.reset ();
+        if ((entry_rc = _ndi_acl_entry_fill_attrs (&entry_list[ix], sai_entry_attr_list, arena,
+                                                   admin_state)) == STD_ERR_OK) {
+            if ((sai_ret = create_fn (&sai_entry_id, switch_id, sai_entry_attr_list.size(),
+                                      sai_entry_attr_list.data())) != SAI_STATUS_SUCCESS) {
+                NDI_ACL_LOG_ERROR ("Create ACL Entry %lu of bulk failed in SAI %d", ix, sai_ret);
+                _ndi_acl_resource_check_full (npu_id, sai_ret);
+                entry_rc = _sai_to_ndi_err (sai_ret);
+            } else {
+                created++;
+                shadow_list.emplace_back ();
+                shadow_list.back().first = ndi_acl_utl_sai2ndi_entry_id (sai_entry_id);
+                _ndi_acl_entry_shadow_build (&entry_list[ix], sai_entry_attr_list,
+                                             shadow_list.back().second);
+            }
+        }
+
+        entry_id_list[ix] = ndi_acl_utl_sai2ndi_entry_id (sai_entry_id);
+        if (rc_list != NULL) rc_list[ix] = entry_rc;
+        if ((entry_rc != STD_ERR_OK) && (rc == STD_ERR_OK)) rc = entry_rc;
+    }
+
+    NDI_ACL_LOG_INFO ("Bulk created %lu of %lu ACL Entries", created, count);
+
+    // Entries of a batch usually all go to one table
+    size_t tbl_count = 0;
+    for (size_t ix = 0; ix < shadow_list.size (); ++ix) {
+        tbl_count++;
+        auto ndi_tbl_id = shadow_list[ix].second.table_id;
+        if ((ix + 1 == shadow_list.size ()) || (shadow_list[ix + 1].second.table_id != ndi_tbl_id)) {
+            ndi_acl_resource_entry_add (npu_id, ndi_tbl_id, tbl_count);
+            tbl_count = 0;
+        }
+    }
+
+    std_mutex_simple_lock_guard g(&_acl_entry_shadow_lock);
+    auto& npu_shadow = (*_acl_entry_shadow)[npu_id];
+    for (auto& shadow: shadow_list) {
+        npu_shadow[shadow.first] = std::move (shadow.second);
+    }
+    return rc;
+}
+
+t_std_error ndi_acl_entries_create_bulk (npu_id_t npu_id,
+                                         const ndi_acl_entry_t* entry_list,
+                                         size_t count,
+                                         ndi_obj_id_t* entry_id_list,
+                                         t_std_error* rc_list)
+{
+    return _ndi_acl_entries_create_bulk (npu_id, entry_list, count, entry_id_list, rc_list,
+                                         true);
+}
+
+/* Set admin state of entries, stops at the first failure */
+static t_std_error _ndi_acl_entries_admin_state_set (npu_id_t npu_id,
+                                                     const ndi_obj_id_t* entry_id_list,
+                                                     size_t count, bool admin_state)
+{
+    sai_status_t      sai_ret;
+    sai_attribute_t   sai_entry_attr = {0};
+    nas_ndi_db_t     *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    auto set_fn = ndi_acl_utl_api_get(ndi_db_ptr)->set_acl_entry_attribute;
+    sai_entry_attr.id = SAI_ACL_ENTRY_ATTR_ADMIN_STATE;
+    sai_entry_attr.value.booldata = admin_state;
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        if ((sai_ret = set_fn (ndi_acl_utl_ndi2sai_entry_id (entry_id_list[ix]),
+                               &sai_entry_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Set admin state of ACL Entry NDI ID %" PRIx64 " failed in SAI %d",
+                               entry_id_list[ix], sai_ret);
+            return _sai_to_ndi_err (sai_ret);
+        }
+    }
+    return STD_ERR_OK;
+}
+
+/* Entries of a table, as reported by SAI */
+static t_std_error _ndi_acl_table_sai_entries_get (npu_id_t npu_id, ndi_obj_id_t ndi_tbl_id,
+                                                   std::vector<ndi_obj_id_t>& entry_id_list)
+{
+    sai_status_t                  sai_ret;
+    sai_attribute_t               sai_tbl_attr = {0};
+    std::vector<sai_object_id_t>  sai_entry_list (64);
+    nas_ndi_db_t                  *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    auto get_fn = ndi_acl_utl_api_get(ndi_db_ptr)->get_acl_table_attribute;
+    sai_object_id_t sai_tbl_id = ndi_acl_utl_ndi2sai_table_id (ndi_tbl_id);
+
+    sai_tbl_attr.id = SAI_ACL_TABLE_ATTR_ENTRY_LIST;
+    sai_tbl_attr.value.objlist.count = sai_entry_list.size ();
+    sai_tbl_attr.value.objlist.list = sai_entry_list.data ();
+    sai_ret = get_fn (sai_tbl_id, 1, &sai_tbl_attr);
+    if (sai_ret == SAI_STATUS_BUFFER_OVERFLOW) {
+        sai_entry_list.resize (sai_tbl_attr.value.objlist.count);
+        sai_tbl_attr.value.objlist.list = sai_entry_list.data ();
+        sai_ret = get_fn (sai_tbl_id, 1, &sai_tbl_attr);
+    }
+    if (sai_ret != SAI_STATUS_SUCCESS) {
+        NDI_ACL_LOG_ERROR ("Get entry list of ACL Table NDI ID %" PRIx64 " failed in SAI %d",
+                           ndi_tbl_id, sai_ret);
+        return _sai_to_ndi_err (sai_ret);
+    }
+
+    entry_id_list.clear ();
+    for (uint32_t ix = 0; ix < sai_tbl_attr.value.objlist.count; ++ix) {
+        entry_id_list.push_back (ndi_acl_utl_sai2ndi_entry_id (sai_entry_list[ix]));
+    }
+    return STD_ERR_OK;
+}
+
+/* Priority of a table, as programmed in SAI */
+static t_std_error _ndi_acl_table_priority_get (npu_id_t npu_id, ndi_obj_id_t ndi_tbl_id,
+                                                ndi_acl_priority_t& tbl_priority)
+{
+    sai_status_t        sai_ret;
+    sai_attribute_t     sai_tbl_attr = {0};
+    nas_ndi_db_t       *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    sai_object_id_t sai_tbl_id = ndi_acl_utl_ndi2sai_table_id (ndi_tbl_id);
+
+    sai_tbl_attr.id = SAI_ACL_TABLE_ATTR_PRIORITY;
+    if ((sai_ret = ndi_acl_utl_api_get(ndi_db_ptr)->get_acl_table_attribute (sai_tbl_id, 1,
+                                                                          &sai_tbl_attr))
+        != SAI_STATUS_SUCCESS) {
+        NDI_ACL_LOG_ERROR ("Get priority of ACL Table NDI ID %" PRIx64 " failed in SAI %d",
+                           ndi_tbl_id, sai_ret);
+        return _sai_to_ndi_err (sai_ret);
+    }
+    tbl_priority = sai_tbl_attr.value.u32;
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_acl_entries_delete_bulk (npu_id_t npu_id,
+                                         const ndi_obj_id_t* entry_id_list,
+                                         size_t count,
+                                         t_std_error* rc_list)
+{
+    t_std_error       rc = STD_ERR_OK;
+    nas_ndi_db_t     *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    auto remove_fn = ndi_acl_utl_api_get(ndi_db_ptr)->remove_acl_entry;
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        t_std_error  entry_rc = STD_ERR_OK;
+        sai_status_t sai_ret;
+
+        if ((sai_ret = remove_fn (ndi_acl_utl_ndi2sai_entry_id (entry_id_list[ix])))
+            != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Delete ACL Entry NDI ID %" PRIx64 " failed in SAI %d",
+                               entry_id_list[ix], sai_ret);
+            entry_rc = _sai_to_ndi_err (sai_ret);
+            if (rc == STD_ERR_OK) rc = entry_rc;
+        } else {
+            _ndi_acl_entry_deleted (npu_id, entry_id_list[ix]);
+        }
+        if (rc_list != NULL) rc_list[ix] = entry_rc;
+    }
+
     return rc;
 }
 
@@ -320,6 +751,7 @@ t_std_error ndi_acl_entry_delete (npu_id_t npu_id, ndi_obj_id_t ndi_entry_id)
 
     NDI_ACL_LOG_INFO ("Successfully deleted ACL Entry NDI ID %" PRIx64,
                       ndi_entry_id);
+    _ndi_acl_entry_deleted (npu_id, ndi_entry_id);
     return rc;
 }
 
@@ -348,6 +780,10 @@ t_std_error ndi_acl_entry_set_priority (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully set priority for ACL Entry NDI ID %" PRIx64,
                       ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [entry_prio] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.priority = entry_prio;
+                                  });
     return rc;
 }
 
@@ -359,14 +795,14 @@ t_std_error ndi_acl_entry_set_filter (npu_id_t npu_id,
     sai_status_t          sai_ret = SAI_STATUS_FAILURE;
     sai_attribute_t       sai_entry_attr = {0};
     nas_ndi_db_t         *ndi_db_ptr = ndi_db_ptr_get(npu_id);
-    nas::mem_alloc_helper_t malloc_tracker;
+    ndi_acl_utl_arena_t arena;
 
     if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
 
     sai_object_id_t sai_entry_id = ndi_acl_utl_ndi2sai_entry_id (ndi_entry_id);
 
     if ((rc = ndi_acl_utl_fill_sai_filter (&sai_entry_attr, filter_p,
-                                            malloc_tracker)) != STD_ERR_OK) {
+                                            arena)) != STD_ERR_OK) {
         return rc;
     }
 
@@ -381,6 +817,12 @@ t_std_error ndi_acl_entry_set_filter (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully set filter type %d for ACL Table NDI ID %" PRIx64,
                       filter_p->filter_type, ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.attrs[sai_entry_attr.id] =
+                                          _ndi_acl_filter_shadow (sai_entry_attr,
+                                                                  filter_p->values_type);
+                                  });
     return rc;
 }
 
@@ -415,6 +857,10 @@ t_std_error ndi_acl_entry_disable_filter (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully disabled filter type %d for ACL Table NDI ID %" PRIx64,
                       filter_type, ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.attrs.erase (sai_entry_attr.id);
+                                  });
     return rc;
 }
 
@@ -426,14 +872,14 @@ t_std_error ndi_acl_entry_set_action (npu_id_t npu_id,
     sai_status_t          sai_ret = SAI_STATUS_FAILURE;
     sai_attribute_t       sai_entry_attr = {0};
     nas_ndi_db_t         *ndi_db_ptr = ndi_db_ptr_get(npu_id);
-    nas::mem_alloc_helper_t malloc_tracker;
+    ndi_acl_utl_arena_t arena;
 
     if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
 
     sai_object_id_t sai_entry_id = ndi_acl_utl_ndi2sai_entry_id (ndi_entry_id);
 
     if ((rc = ndi_acl_utl_fill_sai_action (&sai_entry_attr, action_p,
-                                            malloc_tracker)) != STD_ERR_OK) {
+                                            arena)) != STD_ERR_OK) {
         return rc;
     }
 
@@ -448,6 +894,12 @@ t_std_error ndi_acl_entry_set_action (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully set action type %d for ACL Entry NDI ID %" PRIx64,
                       action_p->action_type, ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.attrs[sai_entry_attr.id] =
+                                          _ndi_acl_action_shadow (sai_entry_attr,
+                                                                  action_p->values_type);
+                                  });
     return rc;
 }
 
@@ -482,6 +934,10 @@ t_std_error ndi_acl_entry_disable_action (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully disabled action type %d for ACL Table NDI ID %" PRIx64,
                       action_type, ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.attrs.erase (sai_entry_attr.id);
+                                  });
     return rc;
 }
 
@@ -517,9 +973,407 @@ t_std_error ndi_acl_entry_disable_counter_action (npu_id_t npu_id,
 
     NDI_ACL_LOG_INFO ("Successfully disabled Counter NDI ID %" PRIx64" for ACL Entry NDI ID %" PRIx64,
                       ndi_counter_id, ndi_entry_id);
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& shadow) {
+                                      shadow.attrs.erase (sai_entry_attr.id);
+                                  });
+    return rc;
+}
+
+/* Slices are read again from SAI when the model is older than this */
+static const uint32_t NDI_ACL_RESOURCE_SYNC_MS = 30000;
+
+t_std_error ndi_acl_resource_sync (npu_id_t npu_id)
+{
+    t_std_error                             rc = STD_ERR_OK;
+    nas_ndi_switch_param_t                  param;
+    std::vector<ndi_obj_id_t>               slice_id_list;
+
+    memset (&param, 0, sizeof (param));
+    // First read gets the number of slices
+    if ((rc = ndi_switch_get_slice_list (npu_id, &param)) != STD_ERR_OK) {
+        return rc;
+    }
+    slice_id_list.resize (param.obj_list.len);
+    param.obj_list.vals = slice_id_list.data ();
+    if ((rc = ndi_switch_get_slice_list (npu_id, &param)) != STD_ERR_OK) {
+        return rc;
+    }
+    slice_id_list.resize (std::min<size_t> (param.obj_list.len, slice_id_list.size ()));
+
+    std::vector<ndi_acl_resource_slice_t>   slice_list (slice_id_list.size ());
+    std::vector<std::vector<ndi_obj_id_t>>  tbl_lists (slice_id_list.size ());
+
+    for (size_t ix = 0; ix < slice_id_list.size (); ++ix) {
+        ndi_acl_slice_attr_t slice_attr;
+        memset (&slice_attr, 0, sizeof (slice_attr));
+
+        // Slice attributes are only filled in if the table list has room
+        do {
+            tbl_lists[ix].resize (std::max<size_t> (slice_attr.acl_table_count, 1));
+            slice_attr.acl_table_count = tbl_lists[ix].size ();
+            slice_attr.acl_table_list = tbl_lists[ix].data ();
+            if ((rc = ndi_acl_get_slice_attribute (npu_id, slice_id_list[ix], &slice_attr))
+                != STD_ERR_OK) {
+                return rc;
+            }
+        } while (slice_attr.acl_table_count > tbl_lists[ix].size ());
+        tbl_lists[ix].resize (slice_attr.acl_table_count);
+
+        slice_list[ix].slice_id = slice_id_list[ix];
+        slice_list[ix].stage = slice_attr.stage;
+        slice_list[ix].pipeline_index = slice_attr.pipeline_index;
+        slice_list[ix].used_count = slice_attr.used_count;
+        slice_list[ix].avail_count = slice_attr.avail_count;
+        slice_list[ix].table_list = tbl_lists[ix].data ();
+        slice_list[ix].table_count = tbl_lists[ix].size ();
+    }
+
+    ndi_acl_resource_slices_set (npu_id, slice_list.data (), slice_list.size ());
+    NDI_ACL_LOG_INFO ("ACL resource model synced with %lu slices", slice_list.size ());
+    return rc;
+}
+
+static void _ndi_acl_resource_sync_if_old (npu_id_t npu_id)
+{
+    if (ndi_acl_resource_sync_needed (npu_id, NDI_ACL_RESOURCE_SYNC_MS) &&
+        (ndi_acl_resource_sync (npu_id) != STD_ERR_OK)) {
+        NDI_ACL_LOG_ERROR ("ACL resource sync failed, using cached slice usage");
+    }
+}
+
+t_std_error ndi_acl_entries_admit (npu_id_t npu_id,
+                                   ndi_obj_id_t ndi_tbl_id,
+                                   size_t entry_count,
+                                   size_t* fit_count_p)
+{
+    _ndi_acl_resource_sync_if_old (npu_id);
+    // Stage is taken from the tracked table
+    return ndi_acl_resource_admit (npu_id, BASE_ACL_STAGE_INGRESS, ndi_tbl_id,
+                                   entry_count, fit_count_p);
+}
+
+t_std_error ndi_acl_table_admit (npu_id_t npu_id,
+                                 const ndi_acl_table_t* ndi_tbl_p,
+                                 size_t entry_count,
+                                 size_t* fit_count_p)
+{
+    size_t fit_count = 0;
+
+    _ndi_acl_resource_sync_if_old (npu_id);
+    ndi_acl_resource_admit (npu_id, ndi_tbl_p->stage, 0, entry_count, &fit_count);
+    if (ndi_tbl_p->size != 0) {
+        fit_count = std::min<size_t> (fit_count, ndi_tbl_p->size);
+    }
+    if (fit_count_p != NULL) *fit_count_p = fit_count;
+
+    return (entry_count <= fit_count) ? STD_ERR_OK : STD_ERR(ACL, NORESOURCE, 0);
+}
+
+/*
+ * SAI ACL entries only take one attribute per set call, so the update
+ * sets each filter or action that differs from the shadow of the entry.
+ * New and changed filters and actions are set first and the ones no longer
+ * wanted are disabled last, so that while the update runs the entry never
+ * matches traffic that neither the old nor the new entry would match.
+ */
+t_std_error ndi_acl_entry_update (npu_id_t npu_id,
+                                  ndi_obj_id_t ndi_entry_id,
+                                  const ndi_acl_entry_t* ndi_entry_p)
+{
+    t_std_error                   rc = STD_ERR_OK;
+    sai_status_t                  sai_ret = SAI_STATUS_FAILURE;
+    std::vector<sai_attribute_t>  sai_entry_attr_list;
+    nas_ndi_db_t                  *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    ndi_acl_utl_arena_t           arena;
+    ndi_acl_entry_shadow_t        shadow, desired;
+    bool                          found = false;
+    size_t                        set_count = 0;
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& cur) {
+                                      shadow = cur;
+                                      found = true;
+                                  });
+    if (!found) {
+        NDI_ACL_LOG_ERROR ("ACL Entry NDI ID %" PRIx64 " not known for update",
+                           ndi_entry_id);
+        return STD_ERR(ACL, PARAM, 0);
+    }
+
+    if ((rc = _ndi_acl_entry_fill_attrs (ndi_entry_p, sai_entry_attr_list, arena))
+        != STD_ERR_OK) {
+        return rc;
+    }
+    _ndi_acl_entry_shadow_build (ndi_entry_p, sai_entry_attr_list, desired);
+
+    auto set_fn = ndi_acl_utl_api_get(ndi_db_ptr)->set_acl_entry_attribute;
+    sai_object_id_t sai_entry_id = ndi_acl_utl_ndi2sai_entry_id (ndi_entry_id);
+
+    // Set the filters and actions that are new or changed
+    for (size_t ix = _ACL_ENTRY_FIXED_ATTR_CNT;
+         (rc == STD_ERR_OK) && (ix < sai_entry_attr_list.size ()); ix++) {
+        auto& sai_entry_attr = sai_entry_attr_list[ix];
+        auto& want = desired.attrs[sai_entry_attr.id];
+        auto cur = shadow.attrs.find (sai_entry_attr.id);
+
+        if ((cur != shadow.attrs.end ()) && (cur->second.value == want.value)) {
+            continue;
+        }
+        if ((sai_ret = set_fn (sai_entry_id, &sai_entry_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Set attr %d of ACL Entry NDI ID %" PRIx64 " failed in SAI %d",
+                               sai_entry_attr.id, ndi_entry_id, sai_ret);
+            rc = _sai_to_ndi_err (sai_ret);
+            break;
+        }
+        shadow.attrs[sai_entry_attr.id] = want;
+        set_count++;
+    }
+
+    // Disable the filters and actions that are not in the new entry
+    for (auto it = shadow.attrs.begin ();
+         (rc == STD_ERR_OK) && (it != shadow.attrs.end ());) {
+        if (desired.attrs.find (it->first) != desired.attrs.end ()) {
+            ++it;
+            continue;
+        }
+        sai_attribute_t sai_entry_attr = {0};
+        sai_entry_attr.id = it->first;
+        if (it->second.is_action) {
+            if (!it->second.has_list) {
+                memcpy (&sai_entry_attr.value.aclaction, it->second.value.data (),
+                        sizeof (sai_entry_attr.value.aclaction));
+            }
+            sai_entry_attr.value.aclaction.enable = false;
+        } else {
+            if (!it->second.has_list) {
+                memcpy (&sai_entry_attr.value.aclfield, it->second.value.data (),
+                        sizeof (sai_entry_attr.value.aclfield));
+            }
+            sai_entry_attr.value.aclfield.enable = false;
+        }
+        if ((sai_ret = set_fn (sai_entry_id, &sai_entry_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Disable attr %d of ACL Entry NDI ID %" PRIx64 " failed in SAI %d",
+                               it->first, ndi_entry_id, sai_ret);
+            rc = _sai_to_ndi_err (sai_ret);
+            break;
+        }
+        it = shadow.attrs.erase (it);
+        set_count++;
+    }
+
+    if ((rc == STD_ERR_OK) && (desired.priority != shadow.priority)) {
+        sai_attribute_t sai_entry_attr = {0};
+        sai_entry_attr.id = SAI_ACL_ENTRY_ATTR_PRIORITY;
+        sai_entry_attr.value.u32 = desired.priority;
+        if ((sai_ret = set_fn (sai_entry_id, &sai_entry_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Set priority of ACL Entry NDI ID %" PRIx64 " failed in SAI %d",
+                               ndi_entry_id, sai_ret);
+            rc = _sai_to_ndi_err (sai_ret);
+        } else {
+            shadow.priority = desired.priority;
+            set_count++;
+        }
+    }
+
+    // Shadow keeps what was programmed, also when a set failed half way
+    _ndi_acl_entry_shadow_update (npu_id, ndi_entry_id,
+                                  [&] (ndi_acl_entry_shadow_t& cur) {
+                                      cur = std::move (shadow);
+                                  });
+
+    NDI_ACL_LOG_INFO ("Updated ACL Entry NDI ID %" PRIx64 " with %lu SAI sets",
+                      ndi_entry_id, set_count);
     return rc;
 }
 
+static t_std_error _ndi_acl_table_swap_teardown (void *req_data, ndi_obj_id_t *obj_id)
+{
+    auto ctx = static_cast<ndi_acl_table_swap_ctx_t*> (req_data);
+    auto start = std::chrono::steady_clock::now ();
+
+    t_std_error rc = ndi_acl_entries_delete_bulk (ctx->npu_id, ctx->old_entry_id_list.data (),
+                                                  ctx->old_entry_id_list.size (), NULL);
+
+    // Entries the shadow does not know of, e.g. created before a warm restart
+    std::vector<ndi_obj_id_t> sai_entry_id_list;
+    if (_ndi_acl_table_sai_entries_get (ctx->npu_id, ctx->old_tbl_id, sai_entry_id_list)
+        == STD_ERR_OK && !sai_entry_id_list.empty ()) {
+        NDI_ACL_LOG_INFO ("ACL Table swap teardown of NDI ID %" PRIx64 ": %lu entries not in "
+                          "shadow", ctx->old_tbl_id, sai_entry_id_list.size ());
+        rc = ndi_acl_entries_delete_bulk (ctx->npu_id, sai_entry_id_list.data (),
+                                          sai_entry_id_list.size (), NULL);
+        ctx->stats.old_entry_count += sai_entry_id_list.size ();
+    }
+    if (rc == STD_ERR_OK) {
+        rc = ndi_acl_table_delete (ctx->npu_id, ctx->old_tbl_id);
+    }
+
+    ctx->stats.teardown_usec = _ndi_acl_usec_since (start);
+    NDI_ACL_LOG_INFO ("ACL Table swap teardown of NDI ID %" PRIx64 ": %lu entries in %lu usec",
+                      ctx->old_tbl_id, ctx->stats.old_entry_count, ctx->stats.teardown_usec);
+    *obj_id = ctx->old_tbl_id;
+    return rc;
+}
+
+static void _ndi_acl_table_swap_cmpl (t_std_error rc, ndi_obj_id_t obj_id, void *cookie)
+{
+    auto ctx = static_cast<ndi_acl_table_swap_ctx_t*> (cookie);
+
+    if (rc != STD_ERR_OK) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap teardown of NDI ID %" PRIx64 " failed", obj_id);
+    }
+    if (ctx->cmpl_fn != NULL) {
+        ctx->cmpl_fn (rc, &ctx->stats, ctx->cookie);
+    }
+    delete ctx;
+}
+
+static void _ndi_acl_table_swap_ctx_init (ndi_acl_table_swap_ctx_t& ctx, npu_id_t npu_id,
+                                          ndi_obj_id_t old_tbl_id,
+                                          const ndi_acl_table_swap_stats_t& stats,
+                                          ndi_acl_table_swap_cmpl_fn cmpl_fn, void* cookie)
+{
+    ctx.npu_id = npu_id;
+    ctx.old_tbl_id = old_tbl_id;
+    ctx.old_entry_id_list = _ndi_acl_table_entries_get (npu_id, old_tbl_id);
+    ctx.stats = stats;
+    ctx.stats.old_entry_count = ctx.old_entry_id_list.size ();
+    ctx.cmpl_fn = cmpl_fn;
+    ctx.cookie = cookie;
+}
+
+/* Teardown when the ACL async queue can not take it */
+static void _ndi_acl_table_swap_teardown_inline (ndi_acl_table_swap_ctx_t& ctx)
+{
+    ndi_obj_id_t obj_id = 0;
+    t_std_error rc = _ndi_acl_table_swap_teardown (&ctx, &obj_id);
+    if (rc != STD_ERR_OK) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap teardown of NDI ID %" PRIx64 " failed", obj_id);
+    }
+    if (ctx.cmpl_fn != NULL) {
+        ctx.cmpl_fn (rc, &ctx.stats, ctx.cookie);
+    }
+}
+
+/*
+ * Tables are not bound to ports in this SAI and there are no ACL table
+ * groups, every table of a stage is looked up and the table priority decides
+ * between conflicting actions. SAI can not switch a stage from one table to
+ * another in one call, so the swap is make-before-break as far as it goes:
+ * the new table is built below the old one with its entries admin-disabled,
+ * the entries are enabled in one pass of SAI sets with no other work in
+ * between, and the new table then takes over with a single priority set.
+ * While the enable pass runs, new entries apply only where they do not
+ * conflict with the old table.
+ */
+t_std_error ndi_acl_table_swap (npu_id_t npu_id,
+                                ndi_obj_id_t old_tbl_id,
+                                const ndi_acl_table_t* new_tbl_p,
+                                ndi_acl_priority_t swap_priority,
+                                const ndi_acl_entry_t* entry_list,
+                                size_t entry_count,
+                                ndi_obj_id_t* new_tbl_id_p,
+                                ndi_obj_id_t* entry_id_list,
+                                ndi_acl_table_swap_cmpl_fn cmpl_fn,
+                                void* cookie)
+{
+    t_std_error                   rc = STD_ERR_OK;
+    ndi_acl_table_swap_stats_t    stats;
+    ndi_obj_id_t                  new_tbl_id = 0;
+
+    memset (&stats, 0, sizeof (stats));
+
+    // Higher value ranks higher: build below the old table, go live above it
+    ndi_acl_priority_t old_priority = 0;
+    if ((rc = _ndi_acl_table_priority_get (npu_id, old_tbl_id, old_priority)) != STD_ERR_OK) {
+        return rc;
+    }
+    if ((new_tbl_p->priority >= old_priority) || (swap_priority <= old_priority)) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap of NDI ID %" PRIx64 " at priority %u: build priority "
+                           "%u must rank below and swap priority %u above it", old_tbl_id,
+                           (uint32_t) old_priority, (uint32_t) new_tbl_p->priority,
+                           (uint32_t) swap_priority);
+        return STD_ERR(ACL, PARAM, 0);
+    }
+
+    // Old table is only freed after the swap, the new one must fit next to it
+    if ((rc = ndi_acl_table_admit (npu_id, new_tbl_p, entry_count, NULL)) != STD_ERR_OK) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap of NDI ID %" PRIx64 ": %lu entries do not fit",
+                           old_tbl_id, entry_count);
+        return rc;
+    }
+
+    // Build
+    auto start = std::chrono::steady_clock::now ();
+    if ((rc = ndi_acl_table_create (npu_id, new_tbl_p, &new_tbl_id)) != STD_ERR_OK) {
+        return rc;
+    }
+
+    std::vector<ndi_acl_entry_t> new_entry_list (entry_list, entry_list + entry_count);
+    for (auto& entry: new_entry_list) {
+        entry.table_id = new_tbl_id;
+    }
+    rc = _ndi_acl_entries_create_bulk (npu_id, new_entry_list.data (), entry_count,
+                                       entry_id_list, NULL, false);
+    stats.build_usec = _ndi_acl_usec_since (start);
+    stats.entry_count = entry_count;
+
+    // Swap
+    if (rc == STD_ERR_OK) {
+        start = std::chrono::steady_clock::now ();
+        rc = _ndi_acl_entries_admin_state_set (npu_id, entry_id_list, entry_count, true);
+        if (rc == STD_ERR_OK) {
+            rc = ndi_acl_table_set_priority (npu_id, new_tbl_id, swap_priority);
+        }
+        stats.swap_usec = _ndi_acl_usec_since (start);
+    }
+
+    if (rc != STD_ERR_OK) {
+        // Old table is still the active policy, drop what was built
+        NDI_ACL_LOG_ERROR ("ACL Table swap of NDI ID %" PRIx64 " failed, removing new table",
+                           old_tbl_id);
+        std::vector<ndi_obj_id_t> created_id_list;
+        for (size_t ix = 0; ix < entry_count; ++ix) {
+            if (entry_id_list[ix] != 0) created_id_list.push_back (entry_id_list[ix]);
+        }
+        ndi_acl_entries_delete_bulk (npu_id, created_id_list.data (), created_id_list.size (),
+                                     NULL);
+        ndi_acl_table_delete (npu_id, new_tbl_id);
+        return rc;
+    }
+    *new_tbl_id_p = new_tbl_id;
+
+    NDI_ACL_LOG_INFO ("ACL Table swap to NDI ID %" PRIx64 ": built %lu entries in %lu usec, "
+                      "swapped in %lu usec", new_tbl_id, entry_count,
+                      stats.build_usec, stats.swap_usec);
+
+    // Teardown. The new table is live from here on, so the swap succeeded
+    // whatever happens to the old table; its errors go to cmpl_fn only
+    auto ctx = new (std::nothrow) ndi_acl_table_swap_ctx_t;
+    if (ctx == NULL) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap teardown of NDI ID %" PRIx64 ": no memory, "
+                           "running inline", old_tbl_id);
+        ndi_acl_table_swap_ctx_t inline_ctx;
+        _ndi_acl_table_swap_ctx_init (inline_ctx, npu_id, old_tbl_id, stats, cmpl_fn, cookie);
+        _ndi_acl_table_swap_teardown_inline (inline_ctx);
+        return STD_ERR_OK;
+    }
+    _ndi_acl_table_swap_ctx_init (*ctx, npu_id, old_tbl_id, stats, cmpl_fn, cookie);
+
+    // Without ndi_async_init the ACL queue runs the teardown in this thread
+    if (ndi_async_submit (NDI_ASYNC_OBJ_CLASS_ACL, old_tbl_id, _ndi_acl_table_swap_teardown,
+                          ctx, _ndi_acl_table_swap_cmpl, ctx, true) != STD_ERR_OK) {
+        NDI_ACL_LOG_ERROR ("ACL Table swap teardown of NDI ID %" PRIx64 ": not queued, "
+                           "running inline", old_tbl_id);
+        _ndi_acl_table_swap_teardown_inline (*ctx);
+        delete ctx;
+    }
+    return STD_ERR_OK;
+}
+
 t_std_error ndi_acl_counter_create (npu_id_t npu_id,
                                     const ndi_acl_counter_t* ndi_counter_p,
                                     ndi_obj_id_t* ndi_counter_id_p)
@@ -563,6 +1417,12 @@ t_std_error ndi_acl_counter_create (npu_id_t npu_id,
 
     *ndi_counter_id_p = ndi_acl_utl_sai2ndi_counter_id (sai_counter_id);
 
+    {
+        std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+        (*_acl_counter_mode)[npu_id][*ndi_counter_id_p] = {(bool)ndi_counter_p->enable_byte_count,
+                                                           (bool)ndi_counter_p->enable_pkt_count};
+    }
+
     NDI_ACL_LOG_INFO ("Successfully created counter - Return NDI ID %" PRIx64,
                       *ndi_counter_id_p);
 
@@ -586,6 +1446,18 @@ t_std_error ndi_acl_counter_delete (npu_id_t npu_id,
         return _sai_to_ndi_err (sai_ret);
     }
 
+    {
+        std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+        auto it = _acl_counter_last->find (npu_id);
+        if (it != _acl_counter_last->end()) {
+            it->second.erase (ndi_counter_id);
+        }
+        auto mode_it = _acl_counter_mode->find (npu_id);
+        if (mode_it != _acl_counter_mode->end()) {
+            mode_it->second.erase (ndi_counter_id);
+        }
+    }
+
     NDI_ACL_LOG_INFO ("Successfully deleted counter - Return NDI ID %" PRIx64,
                       ndi_counter_id);
 
@@ -601,7 +1473,14 @@ t_std_error ndi_acl_counter_enable_pkt_count (npu_id_t npu_id,
     sai_counter_attr.id = SAI_ACL_COUNTER_ATTR_ENABLE_PACKET_COUNT;
     sai_counter_attr.value.u8 = enable;
 
-    return ndi_acl_utl_set_counter_attr (npu_id, ndi_counter_id, &sai_counter_attr);
+    t_std_error rc = ndi_acl_utl_set_counter_attr (npu_id, ndi_counter_id, &sai_counter_attr);
+    if (rc == STD_ERR_OK) {
+        std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+        auto& mode_map = (*_acl_counter_mode)[npu_id];
+        auto it = mode_map.find (ndi_counter_id);
+        if (it != mode_map.end()) it->second.pkt_count = enable;
+    }
+    return rc;
 }
 
 t_std_error ndi_acl_counter_enable_byte_count (npu_id_t npu_id,
@@ -613,7 +1492,14 @@ t_std_error ndi_acl_counter_enable_byte_count (npu_id_t npu_id,
     sai_counter_attr.id = SAI_ACL_COUNTER_ATTR_ENABLE_BYTE_COUNT;
     sai_counter_attr.value.u8 = enable;
 
-    return ndi_acl_utl_set_counter_attr (npu_id, ndi_counter_id, &sai_counter_attr);
+    t_std_error rc = ndi_acl_utl_set_counter_attr (npu_id, ndi_counter_id, &sai_counter_attr);
+    if (rc == STD_ERR_OK) {
+        std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+        auto& mode_map = (*_acl_counter_mode)[npu_id];
+        auto it = mode_map.find (ndi_counter_id);
+        if (it != mode_map.end()) it->second.byte_count = enable;
+    }
+    return rc;
 }
 
 t_std_error ndi_acl_counter_set_pkt_count (npu_id_t npu_id,
@@ -697,6 +1583,175 @@ t_std_error ndi_acl_counter_get_byte_count (npu_id_t npu_id,
     return ndi_acl_counter_get_count(npu_id, ndi_counter_id, byte_count_p, nullptr);
 }
 
+/*
+ * SAI has no multi object get for ACL counters, counters are read one per
+ * call with the attribute list built once for the batch.
+ */
+t_std_error ndi_acl_counters_get_bulk (npu_id_t npu_id,
+                                       const ndi_obj_id_t* counter_id_list,
+                                       size_t count,
+                                       uint64_t* byte_count_list,
+                                       uint64_t* pkt_count_list,
+                                       t_std_error* rc_list)
+{
+    t_std_error       rc = STD_ERR_OK;
+    nas_ndi_db_t     *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) return STD_ERR(ACL, FAIL, 0);
+    if (byte_count_list == nullptr && pkt_count_list == nullptr) {
+        NDI_ACL_LOG_ERROR("Invalid input arguments");
+        return STD_ERR(ACL, PARAM, 0);
+    }
+
+    uint_t attr_cnt = 0;
+    sai_attribute_t   sai_counter_attr[2] = {0};
+    if (byte_count_list != nullptr) {
+        sai_counter_attr[attr_cnt++].id = SAI_ACL_COUNTER_ATTR_BYTES;
+    }
+    if (pkt_count_list != nullptr) {
+        sai_counter_attr[attr_cnt++].id = SAI_ACL_COUNTER_ATTR_PACKETS;
+    }
+
+    auto get_fn = ndi_acl_utl_api_get(ndi_db_ptr)->get_acl_counter_attribute;
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        t_std_error  counter_rc = STD_ERR_OK;
+        sai_status_t sai_ret;
+        uint64_t     values[2] = {0, 0};
+
+        if ((sai_ret = get_fn (ndi_acl_utl_ndi2sai_counter_id (counter_id_list[ix]),
+                               attr_cnt, sai_counter_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_ACL_LOG_ERROR ("Failed to get counter NDI ID %" PRIx64 " value %d",
+                               counter_id_list[ix], sai_ret);
+            counter_rc = STD_ERR(ACL, FAIL, sai_ret);
+            if (rc == STD_ERR_OK) rc = counter_rc;
+        } else {
+            for (uint_t attr_idx = 0; attr_idx < attr_cnt; attr_idx++) {
+                values[attr_idx] = sai_counter_attr[attr_idx].value.u64;
+            }
+        }
+
+        uint_t attr_idx = 0;
+        if (byte_count_list != nullptr) byte_count_list[ix] = values[attr_idx++];
+        if (pkt_count_list != nullptr) pkt_count_list[ix] = values[attr_idx];
+        if (rc_list != NULL) rc_list[ix] = counter_rc;
+    }
+
+    return rc;
+}
+
+// Count modes of a counter not created through this NDI instance are read
+// from SAI once
+static t_std_error _ndi_acl_counter_mode_get (npu_id_t npu_id,
+                                              ndi_obj_id_t ndi_counter_id,
+                                              ndi_acl_counter_mode_t* mode_p)
+{
+    {
+        std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+        auto& mode_map = (*_acl_counter_mode)[npu_id];
+        auto it = mode_map.find (ndi_counter_id);
+        if (it != mode_map.end()) {
+            *mode_p = it->second;
+            return STD_ERR_OK;
+        }
+    }
+
+    sai_attribute_t sai_counter_attr[2] = {0};
+    sai_counter_attr[0].id = SAI_ACL_COUNTER_ATTR_ENABLE_BYTE_COUNT;
+    sai_counter_attr[1].id = SAI_ACL_COUNTER_ATTR_ENABLE_PACKET_COUNT;
+    t_std_error rc = ndi_acl_utl_get_counter_attr (npu_id, ndi_counter_id, sai_counter_attr, 2);
+    if (rc != STD_ERR_OK) {
+        NDI_ACL_LOG_ERROR ("Failed to get count modes of counter NDI ID %" PRIx64,
+                           ndi_counter_id);
+        return rc;
+    }
+    *mode_p = {sai_counter_attr[0].value.booldata, sai_counter_attr[1].value.booldata};
+
+    std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+    (*_acl_counter_mode)[npu_id][ndi_counter_id] = *mode_p;
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_acl_counters_get_changed (npu_id_t npu_id,
+                                          const ndi_obj_id_t* counter_id_list,
+                                          size_t count,
+                                          ndi_acl_counter_value_t* changed_list,
+                                          size_t* changed_count_p)
+{
+    if (ndi_db_ptr_get(npu_id) == NULL) return STD_ERR(ACL, FAIL, 0);
+    if (changed_list == nullptr || changed_count_p == nullptr) {
+        NDI_ACL_LOG_ERROR("Invalid input arguments");
+        return STD_ERR(ACL, PARAM, 0);
+    }
+    *changed_count_p = 0;
+
+    std::vector<uint64_t> byte_count_list (count, 0), pkt_count_list (count, 0);
+    std::vector<t_std_error> rc_list (count, STD_ERR_OK);
+    t_std_error rc = STD_ERR_OK;
+
+    /*
+     * Counters are read in groups with the same enabled modes: byte and
+     * packet, byte only, packet only. Counts that are not enabled are not
+     * asked from SAI and read as 0.
+     */
+    std::vector<size_t> group_idx[3];
+    for (size_t ix = 0; ix < count; ++ix) {
+        ndi_acl_counter_mode_t mode;
+        if ((rc_list[ix] = _ndi_acl_counter_mode_get (npu_id, counter_id_list[ix], &mode))
+            != STD_ERR_OK) {
+            if (rc == STD_ERR_OK) rc = rc_list[ix];
+            continue;
+        }
+        if (mode.byte_count && mode.pkt_count) group_idx[0].push_back (ix);
+        else if (mode.byte_count) group_idx[1].push_back (ix);
+        else if (mode.pkt_count) group_idx[2].push_back (ix);
+    }
+
+    for (size_t grp = 0; grp < 3; ++grp) {
+        auto& idx_list = group_idx[grp];
+        if (idx_list.empty()) continue;
+
+        size_t grp_count = idx_list.size();
+        std::vector<ndi_obj_id_t> grp_id_list (grp_count);
+        std::vector<uint64_t> grp_byte_list (grp_count), grp_pkt_list (grp_count);
+        std::vector<t_std_error> grp_rc_list (grp_count);
+        for (size_t gx = 0; gx < grp_count; ++gx) {
+            grp_id_list[gx] = counter_id_list[idx_list[gx]];
+        }
+        t_std_error grp_rc = ndi_acl_counters_get_bulk (npu_id, grp_id_list.data(), grp_count,
+                                                        (grp != 2) ? grp_byte_list.data() : nullptr,
+                                                        (grp != 1) ? grp_pkt_list.data() : nullptr,
+                                                        grp_rc_list.data());
+        if (rc == STD_ERR_OK) rc = grp_rc;
+        for (size_t gx = 0; gx < grp_count; ++gx) {
+            size_t ix = idx_list[gx];
+            if (grp != 2) byte_count_list[ix] = grp_byte_list[gx];
+            if (grp != 1) pkt_count_list[ix] = grp_pkt_list[gx];
+            rc_list[ix] = grp_rc_list[gx];
+        }
+    }
+
+    std_mutex_simple_lock_guard g(&_acl_counter_last_lock);
+    auto& last_map = (*_acl_counter_last)[npu_id];
+    size_t changed = 0;
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        if (rc_list[ix] != STD_ERR_OK) continue;
+
+        auto it = last_map.find (counter_id_list[ix]);
+        if (it != last_map.end() && it->second.byte_count == byte_count_list[ix] &&
+            it->second.pkt_count == pkt_count_list[ix]) {
+            continue;
+        }
+        last_map[counter_id_list[ix]] = {byte_count_list[ix], pkt_count_list[ix]};
+        changed_list[changed++] = {counter_id_list[ix], byte_count_list[ix],
+                                   pkt_count_list[ix]};
+    }
+
+    *changed_count_p = changed;
+    return rc;
+}
+
 t_std_error ndi_acl_range_create(npu_id_t npu_id, const ndi_acl_range_t *acl_range_p,
                                  ndi_obj_id_t *ndi_range_id_p)
 {
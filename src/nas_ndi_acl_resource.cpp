@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_acl_resource.cpp
+ */
+
+#include "nas_ndi_acl_resource.h"
+#include "std_rw_lock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+typedef struct {
+    ndi_obj_id_t slice_id;
+    BASE_ACL_STAGE_t stage;
+    uint32_t pipeline_index;
+    uint32_t used_count;
+    uint32_t avail_count;
+    std::vector<ndi_obj_id_t> tables;
+} ndi_acl_resource_slice_rec_t;
+
+typedef struct {
+    BASE_ACL_STAGE_t stage;
+    size_t size;
+    size_t entry_count;
+} ndi_acl_resource_table_rec_t;
+
+class ndi_acl_resource_db {
+public:
+    void slices_set(const ndi_acl_resource_slice_t *slice_list, size_t count);
+    void table_add(ndi_obj_id_t table_id, BASE_ACL_STAGE_t stage, size_t size);
+    void table_del(ndi_obj_id_t table_id);
+    void entry_add(ndi_obj_id_t table_id, size_t count);
+    void entry_del(ndi_obj_id_t table_id, size_t count);
+    size_t fit_get(BASE_ACL_STAGE_t stage, ndi_obj_id_t table_id) const;
+
+    bool synced = false;
+    std::chrono::steady_clock::time_point sync_time;
+
+private:
+    static bool slice_has_table(const ndi_acl_resource_slice_rec_t &slice, ndi_obj_id_t table_id)
+    {
+        return std::find(slice.tables.begin(), slice.tables.end(), table_id) != slice.tables.end();
+    }
+    std::vector<uint32_t> pipelines_get(BASE_ACL_STAGE_t stage) const;
+
+    std::vector<ndi_acl_resource_slice_rec_t> _slices;
+    std::unordered_map<ndi_obj_id_t, ndi_acl_resource_table_rec_t> _tables;
+};
+
+void ndi_acl_resource_db::slices_set(const ndi_acl_resource_slice_t *slice_list, size_t count)
+{
+    _slices.resize(count);
+    for (size_t ix = 0; ix < count; ++ix) {
+        _slices[ix].slice_id = slice_list[ix].slice_id;
+        _slices[ix].stage = slice_list[ix].stage;
+        _slices[ix].pipeline_index = slice_list[ix].pipeline_index;
+        _slices[ix].used_count = slice_list[ix].used_count;
+        _slices[ix].avail_count = slice_list[ix].avail_count;
+        _slices[ix].tables.assign(slice_list[ix].table_list,
+                                  slice_list[ix].table_list + slice_list[ix].table_count);
+    }
+    synced = true;
+    sync_time = std::chrono::steady_clock::now();
+}
+
+void ndi_acl_resource_db::table_add(ndi_obj_id_t table_id, BASE_ACL_STAGE_t stage, size_t size)
+{
+    _tables[table_id] = {stage, size, 0};
+}
+
+void ndi_acl_resource_db::table_del(ndi_obj_id_t table_id)
+{
+    _tables.erase(table_id);
+    for (auto &slice : _slices) {
+        slice.tables.erase(std::remove(slice.tables.begin(), slice.tables.end(), table_id),
+                           slice.tables.end());
+    }
+}
+
+std::vector<uint32_t> ndi_acl_resource_db::pipelines_get(BASE_ACL_STAGE_t stage) const
+{
+    std::vector<uint32_t> pipes;
+    for (auto &slice : _slices) {
+        if ((slice.stage == stage) &&
+            (std::find(pipes.begin(), pipes.end(), slice.pipeline_index) == pipes.end())) {
+            pipes.push_back(slice.pipeline_index);
+        }
+    }
+    return pipes;
+}
+
+void ndi_acl_resource_db::entry_add(ndi_obj_id_t table_id, size_t count)
+{
+    auto it = _tables.find(table_id);
+    if (it == _tables.end()) {
+        return;
+    }
+    it->second.entry_count += count;
+
+    for (auto pipe : pipelines_get(it->second.stage)) {
+        size_t left = count;
+        /* Slices of the table first, then free slices of the stage */
+        for (int pass = 0; (pass < 2) && (left > 0); ++pass) {
+            for (auto &slice : _slices) {
+                if ((slice.stage != it->second.stage) || (slice.pipeline_index != pipe) ||
+                    (slice.avail_count == 0)) {
+                    continue;
+                }
+                if (pass == 0 ? !slice_has_table(slice, table_id) : !slice.tables.empty()) {
+                    continue;
+                }
+                if (pass == 1) {
+                    slice.tables.push_back(table_id);
+                }
+                size_t take = std::min<size_t>(left, slice.avail_count);
+                slice.avail_count -= take;
+                slice.used_count += take;
+                left -= take;
+                if (left == 0) {
+                    break;
+                }
+            }
+        }
+        if (left > 0) {
+            /* More entries than the model has room for, it is out of date */
+            synced = false;
+        }
+    }
+}
+
+void ndi_acl_resource_db::entry_del(ndi_obj_id_t table_id, size_t count)
+{
+    auto it = _tables.find(table_id);
+    if (it == _tables.end()) {
+        return;
+    }
+    it->second.entry_count -= std::min(count, it->second.entry_count);
+
+    for (auto pipe : pipelines_get(it->second.stage)) {
+        size_t left = count;
+        for (auto &slice : _slices) {
+            if ((left == 0) || (slice.stage != it->second.stage) ||
+                (slice.pipeline_index != pipe) || !slice_has_table(slice, table_id)) {
+                continue;
+            }
+            size_t give = std::min<size_t>(left, slice.used_count);
+            slice.used_count -= give;
+            slice.avail_count += give;
+            left -= give;
+        }
+    }
+}
+
+size_t ndi_acl_resource_db::fit_get(BASE_ACL_STAGE_t stage, ndi_obj_id_t table_id) const
+{
+    size_t fit = SIZE_MAX;
+    auto it = _tables.find(table_id);
+    if ((it == _tables.end()) && (table_id != 0)) {
+        /* Table not created through NDI, nothing known about it */
+        return fit;
+    }
+    if (it != _tables.end()) {
+        stage = it->second.stage;
+        if (it->second.size != 0) {
+            fit = (it->second.size > it->second.entry_count) ?
+                  (it->second.size - it->second.entry_count) : 0;
+        }
+    }
+
+    /* Entries go in every pipeline, the fullest pipeline decides */
+    for (auto pipe : pipelines_get(stage)) {
+        size_t room = 0;
+        for (auto &slice : _slices) {
+            if ((slice.stage == stage) && (slice.pipeline_index == pipe) &&
+                (slice.tables.empty() || slice_has_table(slice, table_id))) {
+                room += slice.avail_count;
+            }
+        }
+        fit = std::min(fit, room);
+    }
+    return fit;
+}
+
+class ndi_acl_resource {
+public:
+    ndi_acl_resource() {
+        std_rw_lock_create_default(&rw_lock);
+    }
+
+    ndi_acl_resource_db *db_get(npu_id_t npu_id, bool create) {
+        auto it = _dbs.find(npu_id);
+        if (it != _dbs.end()) {
+            return it->second.get();
+        }
+        if (!create) {
+            return NULL;
+        }
+        auto db = new ndi_acl_resource_db;
+        _dbs[npu_id].reset(db);
+        return db;
+    }
+
+    std_rw_lock_t rw_lock;
+
+private:
+    std::unordered_map<npu_id_t, std::unique_ptr<ndi_acl_resource_db>> _dbs;
+};
+
+static auto _acl_resource = new ndi_acl_resource;
+
+extern "C" {
+
+void ndi_acl_resource_slices_set(npu_id_t npu_id, const ndi_acl_resource_slice_t *slice_list,
+                                 size_t count)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    _acl_resource->db_get(npu_id, true)->slices_set(slice_list, count);
+}
+
+void ndi_acl_resource_invalidate(npu_id_t npu_id)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+    if (db != NULL) {
+        db->synced = false;
+    }
+}
+
+bool ndi_acl_resource_sync_needed(npu_id_t npu_id, uint32_t max_age_ms)
+{
+    std_rw_lock_read_guard lg(&_acl_resource->rw_lock);
+    ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+    if ((db == NULL) || !db->synced) {
+        return true;
+    }
+    return (std::chrono::steady_clock::now() - db->sync_time) >
+           std::chrono::milliseconds(max_age_ms);
+}
+
+void ndi_acl_resource_table_add(npu_id_t npu_id, ndi_obj_id_t table_id,
+                                BASE_ACL_STAGE_t stage, size_t size)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    _acl_resource->db_get(npu_id, true)->table_add(table_id, stage, size);
+}
+
+void ndi_acl_resource_table_del(npu_id_t npu_id, ndi_obj_id_t table_id)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+    if (db != NULL) {
+        db->table_del(table_id);
+    }
+}
+
+void ndi_acl_resource_entry_add(npu_id_t npu_id, ndi_obj_id_t table_id, size_t count)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+    if (db != NULL) {
+        db->entry_add(table_id, count);
+    }
+}
+
+void ndi_acl_resource_entry_del(npu_id_t npu_id, ndi_obj_id_t table_id, size_t count)
+{
+    std_rw_lock_write_guard lg(&_acl_resource->rw_lock);
+    ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+    if (db != NULL) {
+        db->entry_del(table_id, count);
+    }
+}
+
+t_std_error ndi_acl_resource_admit(npu_id_t npu_id, BASE_ACL_STAGE_t stage,
+                                   ndi_obj_id_t table_id, size_t entry_count,
+                                   size_t *fit_count)
+{
+    size_t fit = SIZE_MAX;
+    {
+        std_rw_lock_read_guard lg(&_acl_resource->rw_lock);
+        ndi_acl_resource_db *db = _acl_resource->db_get(npu_id, false);
+        if (db != NULL) {
+            fit = db->fit_get(stage, table_id);
+        }
+    }
+    if (fit_count != NULL) {
+        *fit_count = fit;
+    }
+    return (entry_count <= fit) ? STD_ERR_OK : STD_ERR(ACL, NORESOURCE, 0);
+}
+
+}
@@ -321,13 +321,138 @@ t_std_error ndi_acl_utl_ndi2sai_tbl_filter_type (BASE_ACL_MATCH_TYPE_t ndi_filte
     return STD_ERR_OK;
 }
 
+void* ndi_acl_utl_arena_t::alloc_bytes (size_t size, size_t align)
+{
+    while (true) {
+        if (_cur_block < _blocks.size()) {
+            size_t offset = (_cur_used + align - 1) & ~(align - 1);
+            if (offset + size <= _block_sizes[_cur_block]) {
+                uint8_t* p = _blocks[_cur_block].get() + offset;
+                memset (p, 0, size);
+                _cur_used = offset + size;
+                return p;
+            }
+            if (_cur_block + 1 < _blocks.size()) {
+                _cur_block++;
+                _cur_used = 0;
+                continue;
+            }
+        }
+        // No room left in the existing blocks
+        size_t block_size = (size + align > BLOCK_SIZE) ? (size + align) : BLOCK_SIZE;
+        _blocks.emplace_back (new uint8_t [block_size]);
+        _block_sizes.push_back (block_size);
+        _cur_block = _blocks.size() - 1;
+        _cur_used = 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Interned SAI port lists, keyed by the NDI port list. The cache holds one
+// reference, lists only referenced by the cache are dropped when it is full.
+//////////////////////////////////////////////////////////////////////////////////////
+struct _portlist_key_hash {
+    size_t operator() (const std::vector<uint64_t>& key) const {
+        size_t h = key.size ();
+        for (auto k: key) {
+            h ^= std::hash<uint64_t> {} (k) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+typedef std::unordered_map<std::vector<uint64_t>,
+                           std::shared_ptr<const ndi_acl_utl_portlist_t>,
+                           _portlist_key_hash> _portlist_cache_t;
+
+static auto _portlist_cache = new _portlist_cache_t;
+static const size_t _PORTLIST_CACHE_MAX = 1024;
+
+static void _portlist_cache_evict_unused ()
+{
+    for (auto it = _portlist_cache->begin (); it != _portlist_cache->end ();) {
+        if (it->second.use_count () == 1) {
+            it = _portlist_cache->erase (it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+ndi_acl_utl_portlist_ref_t ndi_acl_utl_portlist_get (const ndi_port_t* port_list,
+                                                     size_t port_count)
+{
+    std::vector<uint64_t> key (port_count);
+    for (size_t count = 0; count < port_count; count++) {
+        key[count] = (static_cast<uint64_t> (static_cast<uint32_t> (port_list[count].npu_id)) << 32)
+                     | static_cast<uint32_t> (port_list[count].npu_port);
+    }
+    // Read before translating, a change during translation makes the list stale
+    auto gen = ndi_port_map_generation_get ();
+
+    // Locking instances where global variables are used
+    std_mutex_simple_lock_guard g(&table_lock);
+
+    auto it = _portlist_cache->find (key);
+    if (it != _portlist_cache->end () && it->second->port_map_gen == gen) {
+        return it->second;
+    }
+
+    std::shared_ptr<ndi_acl_utl_portlist_t> portlist {new ndi_acl_utl_portlist_t};
+    portlist->port_map_gen = gen;
+    portlist->sai_port_list.resize (port_count);
+
+    for (size_t count = 0; count < port_count; count++) {
+        auto npu_id = port_list[count].npu_id;
+        auto npu_port = port_list[count].npu_port;
+
+        if (ndi_sai_port_id_get (npu_id, npu_port,
+                                 &portlist->sai_port_list[count]) != STD_ERR_OK) {
+            throw std::out_of_range (std::string {"SAI port conversion failed for NPU "}
+                                     + std::to_string (npu_id)
+                                     + std::string {" Port "}
+                                     + std::to_string (npu_port));
+        }
+        NDI_ACL_LOG_DETAIL ("Portlist: Fill SAI port %lu for NPU %d Port %d",
+                            portlist->sai_port_list[count], npu_id, npu_port);
+    }
+
+    if (it != _portlist_cache->end ()) {
+        it->second = portlist;
+    } else {
+        if (_portlist_cache->size () >= _PORTLIST_CACHE_MAX) {
+            _portlist_cache_evict_unused ();
+        }
+        _portlist_cache->emplace (std::move (key), portlist);
+    }
+    return portlist;
+}
+
+bool ndi_acl_utl_portlist_is_current (const ndi_acl_utl_portlist_ref_t& ref)
+{
+    return ref->port_map_gen == ndi_port_map_generation_get ();
+}
+
+// A port map change while the list was translated leaves it stale, the fill
+// functions translate it once more so that SAI gets the new port ids
+static ndi_acl_utl_portlist_ref_t _portlist_get_current (const ndi_port_t* port_list,
+                                                         size_t port_count)
+{
+    auto portlist = ndi_acl_utl_portlist_get (port_list, port_count);
+    if (!ndi_acl_utl_portlist_is_current (portlist)) {
+        NDI_ACL_LOG_DETAIL ("Portlist: port map changed during translation, translate again");
+        portlist = ndi_acl_utl_portlist_get (port_list, port_count);
+    }
+    return portlist;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////
 // Map NAS-NDI Filter values to SAI values and populate the SAI attribute
 /////////////////////////////////////////////////////////////////////////////////////
 
 static void _fill_sai_filter_ipv6_attr (sai_attribute_t *sai_attr_p,
                                         const ndi_acl_entry_filter_t* f,
-                                        nas::mem_alloc_helper_t& mem_helper)
+                                        ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclfield.data.ip6;
     auto& mask = sai_attr_p->value.aclfield.mask.ip6;
@@ -337,7 +462,7 @@ static void _fill_sai_filter_ipv6_attr (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_ipv4_attr (sai_attribute_t *sai_attr_p,
                                         const ndi_acl_entry_filter_t* f,
-                                        nas::mem_alloc_helper_t& mem_helper)
+                                        ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclfield.data.ip4;
     auto& mask = sai_attr_p->value.aclfield.mask.ip4;
@@ -347,7 +472,7 @@ static void _fill_sai_filter_ipv4_attr (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_mac_attr (sai_attribute_t *sai_attr_p,
                                         const ndi_acl_entry_filter_t* f,
-                                        nas::mem_alloc_helper_t& mem_helper)
+                                        ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclfield.data.mac;
     auto& mask = sai_attr_p->value.aclfield.mask.mac;
@@ -358,56 +483,30 @@ static void _fill_sai_filter_mac_attr (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_portlist_attr (sai_attribute_t *sai_attr_p,
                                             const ndi_acl_entry_filter_t* f,
-                                            nas::mem_alloc_helper_t& mem_helper)
+                                            ndi_acl_utl_arena_t& mem_helper)
 {
-    sai_object_id_t  sai_portid;
-    size_t           portcount = f->data.values.ndi_portlist.port_count;
-
-    sai_object_id_t* sai_portlist = mem_helper.alloc <sai_object_id_t> (portcount);
-
-    for (uint_t count=0; count<portcount; count++) {
-        auto npu_id = f->data.values.ndi_portlist.port_list[count].npu_id;
-        auto npu_port = f->data.values.ndi_portlist.port_list[count].npu_port;
-
-        if (ndi_sai_port_id_get (npu_id, npu_port, &sai_portid) != STD_ERR_OK) {
-            throw std::out_of_range (std::string {"SAI port conversion failed for NPU "}
-                                     + std::to_string (npu_id)
-                                     + std::string {" Port "}
-                                     + std::to_string (npu_port));
-        }
-        sai_portlist[count] = sai_portid;
-        NDI_ACL_LOG_DETAIL ("Filter-Portlist: Fill SAI port %lu for NPU %d Port %d",
-                            sai_portid, npu_id, npu_port);
-    }
+    auto portlist = _portlist_get_current (f->data.values.ndi_portlist.port_list,
+                                           f->data.values.ndi_portlist.port_count);
 
-    sai_attr_p->value.aclfield.data.objlist.count = portcount;
-    sai_attr_p->value.aclfield.data.objlist.list = sai_portlist;
+    sai_attr_p->value.aclfield.data.objlist.count = portlist->sai_port_list.size ();
+    sai_attr_p->value.aclfield.data.objlist.list =
+        const_cast<sai_object_id_t*> (portlist->sai_port_list.data ());
+    // Keep the list alive until the attribute is sent to SAI
+    mem_helper.hold (portlist);
 }
 
 static void _fill_sai_filter_port_attr (sai_attribute_t *sai_attr_p,
                                         const ndi_acl_entry_filter_t* f,
-                                        nas::mem_alloc_helper_t& mem_helper)
+                                        ndi_acl_utl_arena_t& mem_helper)
 {
-    sai_object_id_t  sai_portid;
-
-    auto npu_id = f->data.values.ndi_port.npu_id;
-    auto npu_port = f->data.values.ndi_port.npu_port;
-
-    if (ndi_sai_port_id_get (npu_id, npu_port, &sai_portid) != STD_ERR_OK) {
-        throw std::out_of_range (std::string {"SAI port conversion failed for NPU "}
-        + std::to_string (npu_id)
-        + std::string {" Port "}
-        + std::to_string (npu_port));
-    }
-    NDI_ACL_LOG_DETAIL ("Filter-Port: Fill SAI port %lu for NPU %d Port %d",
-                        sai_portid, npu_id, npu_port);
+    auto port = _portlist_get_current (&f->data.values.ndi_port, 1);
 
-    sai_attr_p->value.aclfield.data.oid = sai_portid;
+    sai_attr_p->value.aclfield.data.oid = port->sai_port_list[0];
 }
 
 static void _fill_sai_filter_u32 (sai_attribute_t *sai_attr_p,
                                   const ndi_acl_entry_filter_t* f,
-                                  nas::mem_alloc_helper_t& mem_helper)
+                                  ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclfield.data.u32 = f->data.values.u32;
     sai_attr_p->value.aclfield.mask.u32 = f->mask.values.u32;
@@ -415,7 +514,7 @@ static void _fill_sai_filter_u32 (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_u16 (sai_attribute_t *sai_attr_p,
                                   const ndi_acl_entry_filter_t* f,
-                                  nas::mem_alloc_helper_t& mem_helper)
+                                  ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclfield.data.u16 = f->data.values.u16;
     sai_attr_p->value.aclfield.mask.u16 = f->mask.values.u16;
@@ -423,7 +522,7 @@ static void _fill_sai_filter_u16 (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_u8 (sai_attribute_t *sai_attr_p,
                                  const ndi_acl_entry_filter_t* f,
-                                 nas::mem_alloc_helper_t& mem_helper)
+                                 ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclfield.data.u8 = f->data.values.u8;
     sai_attr_p->value.aclfield.mask.u8 = f->mask.values.u8;
@@ -431,7 +530,7 @@ static void _fill_sai_filter_u8 (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_u8list (sai_attribute_t *sai_attr_p,
                                      const ndi_acl_entry_filter_t* f,
-                                     nas::mem_alloc_helper_t& mem_helper)
+                                     ndi_acl_utl_arena_t& mem_helper)
 {
     size_t bytecount = f->data.values.ndi_u8list.byte_count;
     uint8_t* datalist = mem_helper.alloc <uint8_t> (bytecount);
@@ -449,7 +548,7 @@ static void _fill_sai_filter_u8list (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_ip_type (sai_attribute_t *sai_attr_p,
                                       const ndi_acl_entry_filter_t* f,
-                                      nas::mem_alloc_helper_t& mem_helper)
+                                      ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
@@ -482,7 +581,7 @@ static void _fill_sai_filter_ip_type (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_ip_frag (sai_attribute_t *sai_attr_p,
                                       const ndi_acl_entry_filter_t* f,
-                                      nas::mem_alloc_helper_t& mem_helper)
+                                      ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
@@ -510,7 +609,7 @@ static void _fill_sai_filter_ip_frag (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_filter_oid (sai_attribute_t* sai_attr_p,
                                   const ndi_acl_entry_filter_t* ndi_filter_p,
-                                  nas::mem_alloc_helper_t& mem_helper)
+                                  ndi_acl_utl_arena_t& mem_helper)
 {
     auto sai_oid = static_cast<sai_object_id_t> (ndi_filter_p->data.values.ndi_obj_ref);
     sai_attr_p->value.aclfield.data.oid = sai_oid;
@@ -518,7 +617,7 @@ static void _fill_sai_filter_oid (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_filter_oid_list (sai_attribute_t* sai_attr_p,
                                        const ndi_acl_entry_filter_t* ndi_filter_p,
-                                       nas::mem_alloc_helper_t& mem_helper)
+                                       ndi_acl_utl_arena_t& mem_helper)
 {
     auto oid_count = ndi_filter_p->data.values.ndi_obj_ref_list.count;
     auto oid_list = mem_helper.alloc<sai_object_id_t> (oid_count);
@@ -534,14 +633,14 @@ static void _fill_sai_filter_oid_list (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_filter_bool (sai_attribute_t* sai_attr_p,
                                    const ndi_acl_entry_filter_t* ndi_filter_p,
-                                   nas::mem_alloc_helper_t& mem_helper)
+                                   ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclfield.data.booldata = ndi_filter_p->data.values.u32;
 }
 
 static void _fill_sai_filter_bridge_type (sai_attribute_t *sai_attr_p,
                                           const ndi_acl_entry_filter_t* f,
-                                          nas::mem_alloc_helper_t& mem_helper)
+                                          ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
@@ -566,14 +665,14 @@ static void _fill_sai_filter_bridge_type (sai_attribute_t *sai_attr_p,
 
 t_std_error ndi_acl_utl_fill_sai_filter (sai_attribute_t *sai_attr_p,
                                          const ndi_acl_entry_filter_t *ndi_filter_p,
-                                         nas::mem_alloc_helper_t& mem_helper)
+                                         ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
 
     typedef void (*fill_sai_filter_fn) (sai_attribute_t* s,
                                         const ndi_acl_entry_filter_t* f,
-                                        nas::mem_alloc_helper_t& mem_helper);
+                                        ndi_acl_utl_arena_t& mem_helper);
 
     static const
         std::unordered_map<ndi_acl_filter_values_type_t, fill_sai_filter_fn, std::hash<int>>
@@ -629,7 +728,7 @@ t_std_error ndi_acl_utl_fill_sai_filter (sai_attribute_t *sai_attr_p,
 
 static void _fill_sai_action_oid (sai_attribute_t* sai_attr_p,
                                   const ndi_acl_entry_action_t* ndi_action_p,
-                                  nas::mem_alloc_helper_t& mem_helper)
+                                  ndi_acl_utl_arena_t& mem_helper)
 {
     auto sai_oid = static_cast<sai_object_id_t> (ndi_action_p->values.ndi_obj_ref);
     sai_attr_p->value.aclaction.parameter.oid = sai_oid;
@@ -637,7 +736,7 @@ static void _fill_sai_action_oid (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_oid_list (sai_attribute_t* sai_attr_p,
                                        const ndi_acl_entry_action_t* ndi_action_p,
-                                       nas::mem_alloc_helper_t& mem_helper)
+                                       ndi_acl_utl_arena_t& mem_helper)
 {
     auto oid_count = ndi_action_p->values.ndi_obj_ref_list.count;
     auto oid_list = mem_helper.alloc<sai_object_id_t> (oid_count);
@@ -653,35 +752,35 @@ static void _fill_sai_action_oid_list (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_set_u64 (sai_attribute_t* sai_attr_p,
                                      const ndi_acl_entry_action_t* ndi_action_p,
-                                     nas::mem_alloc_helper_t& mem_helper)
+                                     ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclaction.parameter.oid = ndi_action_p->values.u64;
 }
 
 static void _fill_sai_action_set_u32 (sai_attribute_t* sai_attr_p,
                                       const ndi_acl_entry_action_t* ndi_action_p,
-                                      nas::mem_alloc_helper_t& mem_helper)
+                                      ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclaction.parameter.u32 = ndi_action_p->values.u32;
 }
 
 static void _fill_sai_action_set_u16 (sai_attribute_t* sai_attr_p,
                                       const ndi_acl_entry_action_t* ndi_action_p,
-                                      nas::mem_alloc_helper_t& mem_helper)
+                                      ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclaction.parameter.u16 = ndi_action_p->values.u16;
 }
 
 static void _fill_sai_action_set_u8 (sai_attribute_t* sai_attr_p,
                                      const ndi_acl_entry_action_t* ndi_action_p,
-                                     nas::mem_alloc_helper_t& mem_helper)
+                                     ndi_acl_utl_arena_t& mem_helper)
 {
     sai_attr_p->value.aclaction.parameter.u8 = ndi_action_p->values.u8;
 }
 
 static void _fill_sai_action_set_mac (sai_attribute_t* sai_attr_p,
                                           const ndi_acl_entry_action_t* ndi_action_p,
-                                          nas::mem_alloc_helper_t& mem_helper)
+                                          ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclaction.parameter.mac;
     memcpy((uint8_t *)&data, (uint8_t *)&ndi_action_p->values.mac, sizeof(data));
@@ -689,7 +788,7 @@ static void _fill_sai_action_set_mac (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_set_ipv6 (sai_attribute_t* sai_attr_p,
                                        const ndi_acl_entry_action_t* ndi_action_p,
-                                       nas::mem_alloc_helper_t& mem_helper)
+                                       ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclaction.parameter.ip6;
     memcpy((uint8_t *)&data, (uint8_t *)&ndi_action_p->values.ipv6, sizeof(data));
@@ -697,7 +796,7 @@ static void _fill_sai_action_set_ipv6 (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_set_ipv4 (sai_attribute_t* sai_attr_p,
                                        const ndi_acl_entry_action_t* ndi_action_p,
-                                       nas::mem_alloc_helper_t& mem_helper)
+                                       ndi_acl_utl_arena_t& mem_helper)
 {
     auto& data = sai_attr_p->value.aclaction.parameter.ip4;
     memcpy((uint8_t *)&data, (uint8_t *)&ndi_action_p->values.ipv4, sizeof(data));
@@ -705,55 +804,30 @@ static void _fill_sai_action_set_ipv4 (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_set_npu_port (sai_attribute_t* sai_attr_p,
                                            const ndi_acl_entry_action_t* ndi_action_p,
-                                           nas::mem_alloc_helper_t& mem_helper)
+                                           ndi_acl_utl_arena_t& mem_helper)
 {
-    sai_object_id_t  sai_portid;
-    auto npu_id = ndi_action_p->values.ndi_port.npu_id;
-    auto npu_port = ndi_action_p->values.ndi_port.npu_port;
+    auto port = _portlist_get_current (&ndi_action_p->values.ndi_port, 1);
 
-    if (ndi_sai_port_id_get (npu_id, npu_port, &sai_portid) != STD_ERR_OK) {
-
-        throw std::out_of_range {std::string {"SAI port conversion failed for NPU "} +
-                                 std::to_string (npu_id) + std::string {" Port "} +
-                                 std::to_string (npu_port)};
-    }
-    NDI_ACL_LOG_DETAIL ("Action-Port: Fill SAI port %lu for NPU %d Port %d",
-                        sai_portid, npu_id, npu_port);
-
-    sai_attr_p->value.aclaction.parameter.oid = sai_portid;
+    sai_attr_p->value.aclaction.parameter.oid = port->sai_port_list[0];
 }
 
 static void _fill_sai_action_set_npu_portlist (sai_attribute_t* sai_attr_p,
                                                const ndi_acl_entry_action_t* ndi_action_p,
-                                               nas::mem_alloc_helper_t& mem_helper)
+                                               ndi_acl_utl_arena_t& mem_helper)
 {
-    sai_object_id_t  sai_portid;
-    size_t           portcount = ndi_action_p->values.ndi_portlist.port_count;
-
-    sai_object_id_t* sai_portlist = mem_helper.alloc <sai_object_id_t> (portcount);
-
-    for (uint_t count=0; count<portcount; count++) {
-        auto npu_id = ndi_action_p->values.ndi_portlist.port_list[count].npu_id;
-        auto npu_port = ndi_action_p->values.ndi_portlist.port_list[count].npu_port;
-
-        if (ndi_sai_port_id_get (npu_id, npu_port, &sai_portid) != STD_ERR_OK) {
-            throw std::out_of_range (std::string {"SAI port conversion failed for NPU "}
-                                     + std::to_string (npu_id)
-                                     + std::string {" Port "}
-                                     + std::to_string (npu_port));
-        }
-        sai_portlist[count] = sai_portid;
-        NDI_ACL_LOG_DETAIL ("Action-Portlist: Fill SAI port %lu for NPU %d Port %d",
-                            sai_portid, npu_id, npu_port);
-    }
+    auto portlist = _portlist_get_current (ndi_action_p->values.ndi_portlist.port_list,
+                                           ndi_action_p->values.ndi_portlist.port_count);
 
-    sai_attr_p->value.aclaction.parameter.objlist.count = portcount;
-    sai_attr_p->value.aclaction.parameter.objlist.list = sai_portlist;
+    sai_attr_p->value.aclaction.parameter.objlist.count = portlist->sai_port_list.size ();
+    sai_attr_p->value.aclaction.parameter.objlist.list =
+        const_cast<sai_object_id_t*> (portlist->sai_port_list.data ());
+    // Keep the list alive until the attribute is sent to SAI
+    mem_helper.hold (portlist);
 }
 
 static void _fill_sai_action_pkt_color (sai_attribute_t* sai_attr_p,
                                         const ndi_acl_entry_action_t* ndi_action_p,
-                                        nas::mem_alloc_helper_t& mem_helper)
+                                        ndi_acl_utl_arena_t& mem_helper)
 {
     static const
         std::unordered_map<BASE_ACL_PACKET_COLOR_t, sai_packet_color_t, std::hash<int>>
@@ -774,7 +848,7 @@ static void _fill_sai_action_pkt_color (sai_attribute_t* sai_attr_p,
 
 static void _fill_sai_action_pkt_action (sai_attribute_t* sai_attr_p,
                                          const ndi_acl_entry_action_t* ndi_action_p,
-                                         nas::mem_alloc_helper_t& mem_helper)
+                                         ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
@@ -804,14 +878,14 @@ static void _fill_sai_action_pkt_action (sai_attribute_t* sai_attr_p,
 
 t_std_error ndi_acl_utl_fill_sai_action (sai_attribute_t* sai_attr_p,
                                          const ndi_acl_entry_action_t* ndi_action_p,
-                                         nas::mem_alloc_helper_t& mem_helper)
+                                         ndi_acl_utl_arena_t& mem_helper)
 {
     // Locking instances where global variables are used
     std_mutex_simple_lock_guard g(&table_lock);
 
     typedef void (*fill_sai_action_fn) (sai_attribute_t* s,
                                         const ndi_acl_entry_action_t* a,
-                                        nas::mem_alloc_helper_t& m);
+                                        ndi_acl_utl_arena_t& m);
 
     static const
         std::unordered_map<ndi_acl_action_values_type_t, fill_sai_action_fn, std::hash<int>>
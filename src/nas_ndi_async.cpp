@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_async.cpp
+ */
+
+#include "nas_ndi_async.h"
+#include "nas_ndi_event_logs.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define NDI_ASYNC_DEFAULT_QUEUE_DEPTH  4096
+#define NDI_ASYNC_DEFAULT_BATCH_SIZE   64
+
+typedef struct {
+    ndi_async_req_fn req_fn;
+    void *req_data;
+    ndi_async_cmpl_fn cmpl_fn;
+    void *cookie;
+} ndi_async_req_t;
+
+/*
+ * Bulk handlers, registered once at init by the NDI modules. Looked up by
+ * the workers for every batch so protected by its own lock.
+ */
+static std::mutex _batch_fn_mutex;
+static auto &_batch_fn_map = *(new std::unordered_map<ndi_async_req_fn, ndi_async_batch_fn>);
+
+static ndi_async_batch_fn ndi_async_batch_fn_get(ndi_async_req_fn req_fn)
+{
+    std::lock_guard<std::mutex> lock(_batch_fn_mutex);
+    auto it = _batch_fn_map.find(req_fn);
+    return (it == _batch_fn_map.end()) ? nullptr : it->second;
+}
+
+class ndi_async_queue;
+
+/*
+ * Queue drained by the calling thread, NULL outside the workers. Request
+ * handlers and completion callbacks run on a worker, waiting there for a
+ * queue to drain could wait on the worker itself.
+ */
+static thread_local ndi_async_queue *_worker_queue = nullptr;
+
+/* Submission queue drained by a single worker thread */
+class ndi_async_queue
+{
+public:
+    ndi_async_queue(size_t depth, size_t batch_size) :
+        _depth(depth), _batch_size(batch_size) {}
+
+    void start()
+    {
+        _worker = std::thread(&ndi_async_queue::run, this);
+    }
+
+    bool push(const ndi_async_req_t& req, bool wait);
+    void flush();
+    void stop();
+
+    size_t pending()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _queue.size() + _in_progress;
+    }
+
+private:
+    void run();
+    void process(std::vector<ndi_async_req_t>& batch);
+
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::condition_variable _idle;
+    std::deque<ndi_async_req_t> _queue;
+    size_t _depth;
+    size_t _batch_size;
+    size_t _in_progress = 0;
+    bool _stop = false;
+    std::thread _worker;
+};
+
+bool ndi_async_queue::push(const ndi_async_req_t& req, bool wait)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_queue.size() >= _depth) {
+        if (!wait) {
+            return false;
+        }
+        /* Workers may be waited on by the worker of this queue, so they queue
+         * past the depth instead of waiting for room */
+        if (_worker_queue == nullptr) {
+            _not_full.wait(lock, [this] { return (_queue.size() < _depth) || _stop; });
+        }
+    }
+    if (_stop) {
+        return false;
+    }
+    _queue.push_back(req);
+    _not_empty.notify_one();
+    return true;
+}
+
+void ndi_async_queue::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _queue.empty() && (_in_progress == 0); });
+}
+
+void ndi_async_queue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _not_empty.notify_all();
+        _not_full.notify_all();
+    }
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void ndi_async_queue::process(std::vector<ndi_async_req_t>& batch)
+{
+    std::vector<void *> req_data_list;
+    std::vector<t_std_error> rc_list;
+    std::vector<ndi_obj_id_t> obj_id_list;
+    size_t start = 0;
+
+    while (start < batch.size()) {
+        ndi_async_req_fn req_fn = batch[start].req_fn;
+        ndi_async_batch_fn batch_fn = ndi_async_batch_fn_get(req_fn);
+        size_t end = start + 1;
+
+        if (batch_fn != nullptr) {
+            /* Combine consecutive requests with the same handler */
+            while ((end < batch.size()) && (batch[end].req_fn == req_fn)) {
+                ++end;
+            }
+        }
+
+        size_t count = end - start;
+        rc_list.assign(count, STD_ERR_OK);
+        obj_id_list.assign(count, 0);
+        if (batch_fn != nullptr) {
+            req_data_list.clear();
+            for (size_t ix = start; ix < end; ++ix) {
+                req_data_list.push_back(batch[ix].req_data);
+            }
+            batch_fn(count, req_data_list.data(), rc_list.data(), obj_id_list.data());
+        } else {
+            rc_list[0] = req_fn(batch[start].req_data, &obj_id_list[0]);
+        }
+
+        for (size_t ix = start; ix < end; ++ix) {
+            if (batch[ix].cmpl_fn != nullptr) {
+                batch[ix].cmpl_fn(rc_list[ix - start], obj_id_list[ix - start], batch[ix].cookie);
+            }
+        }
+        start = end;
+    }
+}
+
+void ndi_async_queue::run()
+{
+    std::vector<ndi_async_req_t> batch;
+    batch.reserve(_batch_size);
+    _worker_queue = this;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_empty.wait(lock, [this] { return !_queue.empty() || _stop; });
+            if (_queue.empty() && _stop) {
+                break;
+            }
+            batch.clear();
+            while (!_queue.empty() && (batch.size() < _batch_size)) {
+                batch.push_back(_queue.front());
+                _queue.pop_front();
+            }
+            _in_progress = batch.size();
+            _not_full.notify_all();
+        }
+
+        process(batch);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _in_progress = 0;
+        if (_queue.empty()) {
+            _idle.notify_all();
+        }
+    }
+}
+
+/* Queues of an object class, object key selects the queue */
+class ndi_async_class
+{
+public:
+    ndi_async_class(const ndi_async_cfg_t& cfg)
+    {
+        for (size_t ix = 0; ix < cfg.workers_per_class; ++ix) {
+            _queues.emplace_back(new ndi_async_queue(cfg.queue_depth, cfg.batch_size));
+        }
+        for (auto& queue: _queues) {
+            queue->start();
+        }
+    }
+
+    ~ndi_async_class()
+    {
+        for (auto& queue: _queues) {
+            queue->stop();
+        }
+    }
+
+    ndi_async_queue& get_queue(uint64_t obj_key)
+    {
+        return *_queues[std::hash<uint64_t>()(obj_key) % _queues.size()];
+    }
+
+    void flush()
+    {
+        for (auto& queue: _queues) {
+            queue->flush();
+        }
+    }
+
+    size_t pending()
+    {
+        size_t count = 0;
+        for (auto& queue: _queues) {
+            count += queue->pending();
+        }
+        return count;
+    }
+
+private:
+    std::vector<std::unique_ptr<ndi_async_queue>> _queues;
+};
+
+static std::mutex _async_mutex;
+static std::unique_ptr<ndi_async_class> *_async_class_tbl = nullptr;
+
+static ndi_async_class *ndi_async_class_get(ndi_async_obj_class_t obj_class)
+{
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    if ((_async_class_tbl == nullptr) || (obj_class < 0) || (obj_class >= NDI_ASYNC_OBJ_CLASS_MAX)) {
+        return nullptr;
+    }
+    return _async_class_tbl[obj_class].get();
+}
+
+extern "C" {
+
+t_std_error ndi_async_init(const ndi_async_cfg_t *cfg)
+{
+    ndi_async_cfg_t async_cfg = {NDI_ASYNC_DEFAULT_QUEUE_DEPTH, NDI_ASYNC_DEFAULT_BATCH_SIZE, 1};
+    if (cfg != NULL) {
+        async_cfg = *cfg;
+    }
+    if ((async_cfg.queue_depth == 0) || (async_cfg.batch_size == 0) ||
+        (async_cfg.workers_per_class == 0)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    if (_async_class_tbl != nullptr) {
+        NDI_INIT_LOG_ERROR("NDI async mode already started");
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    try {
+        _async_class_tbl = new std::unique_ptr<ndi_async_class>[NDI_ASYNC_OBJ_CLASS_MAX];
+        for (int ix = 0; ix < NDI_ASYNC_OBJ_CLASS_MAX; ++ix) {
+            _async_class_tbl[ix].reset(new ndi_async_class(async_cfg));
+        }
+    } catch (...) {
+        NDI_INIT_LOG_ERROR("Failed to start NDI async workers");
+        delete [] _async_class_tbl;
+        _async_class_tbl = nullptr;
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+    NDI_INIT_LOG_TRACE("NDI async mode started, queue depth %lu batch size %lu workers %lu",
+                       async_cfg.queue_depth, async_cfg.batch_size, async_cfg.workers_per_class);
+    return STD_ERR_OK;
+}
+
+void ndi_async_deinit(void)
+{
+    std::unique_ptr<ndi_async_class> *class_tbl = nullptr;
+    if (_worker_queue != nullptr) {
+        NDI_INIT_LOG_ERROR("NDI async mode can not be stopped from a worker thread");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_async_mutex);
+        class_tbl = _async_class_tbl;
+        _async_class_tbl = nullptr;
+    }
+    /* Workers drain the queued requests before exiting */
+    delete [] class_tbl;
+}
+
+bool ndi_async_is_enabled(void)
+{
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    return _async_class_tbl != nullptr;
+}
+
+t_std_error ndi_async_register_batch_fn(ndi_async_req_fn req_fn, ndi_async_batch_fn batch_fn)
+{
+    if (req_fn == NULL) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    std::lock_guard<std::mutex> lock(_batch_fn_mutex);
+    if (batch_fn == NULL) {
+        _batch_fn_map.erase(req_fn);
+    } else {
+        _batch_fn_map[req_fn] = batch_fn;
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_async_submit(ndi_async_obj_class_t obj_class, uint64_t obj_key,
+                             ndi_async_req_fn req_fn, void *req_data,
+                             ndi_async_cmpl_fn cmpl_fn, void *cookie, bool wait)
+{
+    if ((req_fn == NULL) || (obj_class < 0) || (obj_class >= NDI_ASYNC_OBJ_CLASS_MAX)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    ndi_async_class *async_class = ndi_async_class_get(obj_class);
+    if (async_class == nullptr) {
+        /* Async mode not started, complete the request in caller context */
+        ndi_obj_id_t obj_id = 0;
+        t_std_error rc = req_fn(req_data, &obj_id);
+        if (cmpl_fn != NULL) {
+            cmpl_fn(rc, obj_id, cookie);
+        }
+        return STD_ERR_OK;
+    }
+
+    ndi_async_req_t req = {req_fn, req_data, cmpl_fn, cookie};
+    if (!async_class->get_queue(obj_key).push(req, wait)) {
+        return STD_ERR(NPU, NORESOURCE, 0);
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_async_flush(ndi_async_obj_class_t obj_class)
+{
+    if ((obj_class < 0) || (obj_class >= NDI_ASYNC_OBJ_CLASS_MAX)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    ndi_async_class *async_class = ndi_async_class_get(obj_class);
+    if (async_class == nullptr) {
+        return STD_ERR_OK;
+    }
+    if (_worker_queue != nullptr) {
+        NDI_INIT_LOG_ERROR("NDI async flush of class %d called from a worker thread", obj_class);
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    async_class->flush();
+    return STD_ERR_OK;
+}
+
+size_t ndi_async_pending_count(ndi_async_obj_class_t obj_class)
+{
+    ndi_async_class *async_class = ndi_async_class_get(obj_class);
+    return (async_class == nullptr) ? 0 : async_class->pending();
+}
+
+}
+
+static void ndi_async_future_cmpl(t_std_error rc, ndi_obj_id_t obj_id, void *cookie)
+{
+    auto promise = static_cast<std::promise<ndi_async_result_t> *>(cookie);
+    promise->set_value(ndi_async_result_t{rc, obj_id});
+    delete promise;
+}
+
+std::future<ndi_async_result_t> ndi_async_submit_future(ndi_async_obj_class_t obj_class,
+                                                        uint64_t obj_key,
+                                                        ndi_async_req_fn req_fn,
+                                                        void *req_data)
+{
+    auto promise = new std::promise<ndi_async_result_t>;
+    auto future = promise->get_future();
+    t_std_error rc = ndi_async_submit(obj_class, obj_key, req_fn, req_data,
+                                      ndi_async_future_cmpl, promise, true);
+    if (rc != STD_ERR_OK) {
+        promise->set_value(ndi_async_result_t{rc, 0});
+        delete promise;
+    }
+    return future;
+}
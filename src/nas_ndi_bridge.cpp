@@ -177,9 +177,21 @@ t_std_error ndi_init_brport_for_1Q(void)
     }
 
     sai_object_id_t bridge_port_id;
-    /* get physical port id from bridge port id & store in mapping */
+    std::vector<ndi_brport_obj_t> bp_map_list;
+    bp_map_list.reserve(bridge_attr.value.objlist.count);
+
+    /* get physical port id from bridge port id of all the 1Q bridge ports */
     for (uint32_t i = 0; i < bridge_attr.value.objlist.count; ++i) {
         bridge_port_id = bridge_attr.value.objlist.list[i];
+
+        /* Bridge port already restored from the warm restart checkpoint */
+        bp_map.brport_obj_id = bridge_port_id;
+        if (nas_ndi_get_bridge_port_obj(&bp_map, ndi_brport_query_type_FROM_BRPORT)) {
+            NDI_PORT_LOG_TRACE("INIT : bridge port id %" PRIx64 " restored from checkpoint",
+                bridge_port_id);
+            continue;
+        }
+
         bridge_port_attr.id = SAI_BRIDGE_PORT_ATTR_PORT_ID;
         if((sai_ret = ndi_sai_bridge_api(ndi_db_ptr)->get_bridge_port_attribute(bridge_port_id,
               1, &bridge_port_attr)) != SAI_STATUS_SUCCESS) {
@@ -187,19 +199,24 @@ t_std_error ndi_init_brport_for_1Q(void)
             return STD_ERR(NPU, CFG, sai_ret);
         }
 
+        memset(&bp_map, 0, sizeof(ndi_brport_obj_t));
         bp_map.brport_type = ndi_brport_type_PORT;
         bp_map.port_type = ndi_port_type_PORT;
         bp_map.brport_obj_id = bridge_port_id;
         bp_map.port_obj_id = bridge_port_attr.value.oid;
-        /* Add to cache */
-        if (!nas_ndi_add_bridge_port_obj(&bp_map)) {
-            NDI_PORT_LOG_ERROR("INIT map add port failed: bridge port id %" PRIx64 " " "port id %" PRIx64 " ",
-                                           bridge_port_id, bridge_port_attr.value.oid);
-
-            return STD_ERR(NPU, CFG, sai_ret);
-        }
+        bp_map_list.push_back(bp_map);
         NDI_PORT_LOG_TRACE("INIT : bridge port id %" PRIx64 " " "port id %" PRIx64 " ",
             bridge_port_id, bridge_port_attr.value.oid);
+    }
+
+    /* Add all the bridge ports to cache in one go */
+    if (!nas_ndi_add_bridge_port_obj_list(bp_map_list.data(), bp_map_list.size())) {
+        NDI_PORT_LOG_ERROR("INIT map add of %lu 1Q bridge ports failed", bp_map_list.size());
+        return STD_ERR(NPU, CFG, 0);
+    }
+
+    for (auto &bp: bp_map_list) {
+        bridge_port_id = bp.brport_obj_id;
 
         /* Set bridgeport to ADMIN UP */
         bridge_port_attr.id = SAI_BRIDGE_PORT_ATTR_ADMIN_STATE;
@@ -413,6 +430,83 @@ t_std_error ndi_bridge_1d_stats_get(npu_id_t npu_id, bridge_id_t br_oid,
     return STD_ERR_OK;
 }
 
+/*
+ * SAI has no bulk stats call for bridges and bridge ports, objects are read
+ * one per call with the SAI counter ids translated once in the handle.
+ * Counters of an object that failed are zeroed.
+ */
+template <typename ID, typename F>
+static t_std_error ndi_bridge_stats_bulk_helper(const ID *obj_list, size_t obj_count,
+                                                size_t len, uint64_t *stats_val,
+                                                t_std_error *rc_list, F get_fn)
+{
+    t_std_error rc = STD_ERR_OK;
+
+    for (size_t ix = 0; ix < obj_count; ++ix) {
+        t_std_error obj_rc = STD_ERR_OK;
+        uint64_t *obj_stats = &stats_val[ix * len];
+        sai_status_t sai_ret;
+
+        if ((sai_ret = get_fn(obj_list[ix], obj_stats)) != SAI_STATUS_SUCCESS) {
+            NDI_PORT_LOG_ERROR("Bridge stats Get failed for object %" PRIx64 ", ret %d",
+                               obj_list[ix], sai_ret);
+            obj_rc = STD_ERR(NPU, FAIL, sai_ret);
+            memset(obj_stats, 0, len * sizeof(uint64_t));
+            if (rc == STD_ERR_OK) {
+                rc = obj_rc;
+            }
+        }
+        if (rc_list != NULL) {
+            rc_list[ix] = obj_rc;
+        }
+    }
+    return rc;
+}
+
+t_std_error ndi_bridge_1d_stats_bulk_get(npu_id_t npu_id, const bridge_id_t *br_list,
+                                         size_t br_count, const ndi_stat_handle_t *handle,
+                                         uint64_t *stats_val, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) {
+        NDI_VLAN_LOG_ERROR("Invalid NPU Id %d passed",npu_id);
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((handle == NULL) || (handle->obj_type != NDI_STAT_OBJ_BRIDGE_1D)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    return ndi_bridge_stats_bulk_helper(br_list, br_count, handle->len, stats_val, rc_list,
+            [ndi_db_ptr, handle](bridge_id_t br_oid, uint64_t *obj_stats) {
+                return ndi_sai_bridge_api(ndi_db_ptr)->get_bridge_stats(br_oid,
+                        handle->len, handle->bridge_ids.data(), obj_stats);
+            });
+}
+
+t_std_error ndi_bridge_port_stats_bulk_get(npu_id_t npu_id, const ndi_obj_id_t *brport_list,
+                                           size_t brport_count, const ndi_stat_handle_t *handle,
+                                           uint64_t *stats_val, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) {
+        NDI_VLAN_LOG_ERROR("Invalid NPU Id %d passed",npu_id);
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((handle == NULL) || ((handle->obj_type != NDI_STAT_OBJ_BRIDGE_PORT) &&
+                             (handle->obj_type != NDI_STAT_OBJ_TUNNEL_BRIDGE_PORT))) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    return ndi_bridge_stats_bulk_helper(brport_list, brport_count, handle->len, stats_val,
+            rc_list,
+            [ndi_db_ptr, handle](ndi_obj_id_t brport_oid, uint64_t *obj_stats) {
+                return ndi_sai_bridge_api(ndi_db_ptr)->get_bridge_port_stats(brport_oid,
+                        handle->len, handle->brport_ids.data(), obj_stats);
+            });
+}
+
 t_std_error ndi_bridge_1d_stats_clear(npu_id_t npu_id, bridge_id_t br_oid,
                                       ndi_stat_id_t *ndi_stat_ids, size_t len)
 {
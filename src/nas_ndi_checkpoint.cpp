@@ -0,0 +1,793 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_checkpoint.cpp
+ *
+ * Checkpoint of NDI object caches for warm restart
+ */
+
+#include "nas_ndi_checkpoint.h"
+#include "nas_ndi_event_logs.h"
+#include "nas_ndi_sw_profile.h"
+#include "nas_ndi_obj_cache.h"
+#include "nas_ndi_obj_cache_utils.h"
+#include "nas_ndi_vlan_util.h"
+#include "nas_ndi_map.h"
+#include "nas_ndi_router_interface_utl.h"
+#include "nas_ndi_ipmc_utl.h"
+#include "nas_ndi_tunnel_map.h"
+#include "nas_ndi_tunnel_obj.h"
+#include "nas_ndi_vlan_mbr_cache.h"
+#include "std_mutex_lock.h"
+#include "sai.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SAI_KEY_BOOT_TYPE
+#define SAI_KEY_BOOT_TYPE "SAI_BOOT_TYPE"
+#endif
+
+#define NDI_CHECKPOINT_ALIGN(x) (((x) + 7) & ~((uint64_t)7))
+
+typedef struct {
+    nas_ndi_map_key_t key;
+    nas_ndi_map_data_t data;
+} ndi_checkpoint_map_rec_t;
+
+typedef struct {
+    ndi_rif_id_t rif_id;
+    ndi_rif_entry_db_t rif_entry;
+} ndi_checkpoint_rif_rec_t;
+
+typedef struct {
+    npu_id_t npu_id;
+    ndi_obj_id_t repl_grp_id;
+    ndi_obj_id_t rpf_grp_id;
+    ndi_obj_id_t ipmc_grp_id;
+} ndi_checkpoint_repl_grp_rec_t;
+
+typedef struct {
+    npu_id_t npu_id;
+    ndi_obj_id_t repl_grp_id;
+    uint32_t mbr_type;
+    ndi_obj_id_t mbr_id;
+    ndi_rif_id_t rif_id;
+    /* index and count in the REPL_GRP_MBR_PORT section */
+    uint32_t port_start;
+    uint32_t port_count;
+} ndi_checkpoint_repl_grp_mbr_rec_t;
+
+typedef struct {
+    npu_id_t npu_id;
+    ndi_ipmc_entry_t ipmc_entry;
+} ndi_checkpoint_ipmc_entry_rec_t;
+
+typedef struct {
+    hal_ip_addr_t remote_src_ip;
+    hal_ip_addr_t local_src_ip;
+    sai_object_id_t tun_oid;
+    sai_object_id_t encap_map_oid;
+    sai_object_id_t decap_map_oid;
+    sai_object_id_t term_oid;
+} ndi_checkpoint_tunnel_rec_t;
+
+typedef struct {
+    hal_ip_addr_t remote_src_ip;
+    hal_ip_addr_t local_src_ip;
+    uint32_t map_type;
+    uint32_t vni;
+    sai_object_id_t br_oid;
+    sai_object_id_t oid;
+} ndi_checkpoint_tunnel_map_rec_t;
+
+typedef struct {
+    npu_id_t npu_id;
+    hal_vlan_id_t vlan_id;
+    sai_object_id_t port_id;
+    sai_object_id_t member_id;
+    uint32_t tagging_mode;
+} ndi_checkpoint_vlan_mbr_rec_t;
+
+static const char *ndi_checkpoint_file_name(const char *file_name)
+{
+    if (file_name != NULL) {
+        return file_name;
+    }
+    const char *env_file_name = getenv("OPX_NDI_CHECKPOINT_FILE");
+    if (env_file_name != NULL) {
+        return env_file_name;
+    }
+    return NDI_CHECKPOINT_DEFAULT_FILE;
+}
+
+class ndi_checkpoint_writer
+{
+public:
+    template<typename T>
+    void add_section(ndi_checkpoint_section_type_t type, const std::vector<T>& recs)
+    {
+        ndi_checkpoint_section_t section;
+        memset(&section, 0, sizeof(section));
+        section.type = type;
+        section.rec_size = sizeof(T);
+        section.rec_count = recs.size();
+        _sections.push_back(section);
+        _data.emplace_back((const char *)recs.data(), recs.size() * sizeof(T));
+    }
+
+    bool write(const char *file_name);
+
+    /* FNV-1a hash of the collected sections, used to skip unchanged periodic saves */
+    uint64_t digest() const;
+
+private:
+    std::vector<ndi_checkpoint_section_t> _sections;
+    std::vector<std::string> _data;
+};
+
+static bool ndi_checkpoint_write_buf(int fd, const void *buf, size_t len)
+{
+    const char *ptr = (const char *)buf;
+    while (len > 0) {
+        ssize_t ret = ::write(fd, ptr, len);
+        if (ret < 0) {
+            return false;
+        }
+        ptr += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+bool ndi_checkpoint_writer::write(const char *file_name)
+{
+    ndi_checkpoint_hdr_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = NDI_CHECKPOINT_MAGIC;
+    hdr.version = NDI_CHECKPOINT_VERSION;
+    hdr.section_count = _sections.size();
+
+    uint64_t offset = NDI_CHECKPOINT_ALIGN(sizeof(hdr) +
+                                           _sections.size() * sizeof(ndi_checkpoint_section_t));
+    for (size_t idx = 0; idx < _sections.size(); idx++) {
+        _sections[idx].offset = offset;
+        offset = NDI_CHECKPOINT_ALIGN(offset + _data[idx].size());
+    }
+    hdr.total_len = offset;
+
+    std::string tmp_file_name = std::string(file_name) + ".tmp";
+    int fd = open(tmp_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        NDI_INIT_LOG_ERROR("Failed to open checkpoint file %s", tmp_file_name.c_str());
+        return false;
+    }
+
+    static const char pad[8] = {0};
+    bool ret = ndi_checkpoint_write_buf(fd, &hdr, sizeof(hdr)) &&
+               ndi_checkpoint_write_buf(fd, _sections.data(),
+                                        _sections.size() * sizeof(ndi_checkpoint_section_t));
+    uint64_t cur_len = sizeof(hdr) + _sections.size() * sizeof(ndi_checkpoint_section_t);
+    for (size_t idx = 0; ret && idx < _sections.size(); idx++) {
+        ret = ndi_checkpoint_write_buf(fd, pad, _sections[idx].offset - cur_len) &&
+              ndi_checkpoint_write_buf(fd, _data[idx].data(), _data[idx].size());
+        cur_len = _sections[idx].offset + _data[idx].size();
+    }
+    if (ret) {
+        ret = ndi_checkpoint_write_buf(fd, pad, hdr.total_len - cur_len) && (fsync(fd) == 0);
+    }
+    close(fd);
+
+    if (!ret || rename(tmp_file_name.c_str(), file_name) != 0) {
+        NDI_INIT_LOG_ERROR("Failed to write checkpoint file %s", file_name);
+        unlink(tmp_file_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t ndi_checkpoint_writer::digest() const
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto add = [&hash](const char *buf, size_t len) {
+        for (size_t idx = 0; idx < len; idx++) {
+            hash = (hash ^ (uint8_t)buf[idx]) * 0x100000001b3ULL;
+        }
+    };
+    for (size_t idx = 0; idx < _sections.size(); idx++) {
+        add((const char *)&_sections[idx].type, sizeof(_sections[idx].type));
+        add((const char *)&_sections[idx].rec_count, sizeof(_sections[idx].rec_count));
+        add(_data[idx].data(), _data[idx].size());
+    }
+    return hash;
+}
+
+class ndi_checkpoint_reader
+{
+public:
+    ~ndi_checkpoint_reader()
+    {
+        if (_base != MAP_FAILED) {
+            munmap(_base, _len);
+        }
+    }
+
+    bool open(const char *file_name);
+
+    /* Return pointer to the records of section in the mapped file */
+    template<typename T>
+    const T *get_section(ndi_checkpoint_section_type_t type, size_t& rec_count) const
+    {
+        rec_count = 0;
+        auto hdr = (const ndi_checkpoint_hdr_t *)_base;
+        auto sections = (const ndi_checkpoint_section_t *)(hdr + 1);
+        for (uint32_t idx = 0; idx < hdr->section_count; idx++) {
+            if (sections[idx].type != type) {
+                continue;
+            }
+            if (sections[idx].rec_size != sizeof(T)) {
+                NDI_INIT_LOG_ERROR("Checkpoint section %d record size mismatch %u", type,
+                                   sections[idx].rec_size);
+                return nullptr;
+            }
+            rec_count = sections[idx].rec_count;
+            return (const T *)((const char *)_base + sections[idx].offset);
+        }
+        return nullptr;
+    }
+
+private:
+    void *_base = MAP_FAILED;
+    size_t _len = 0;
+};
+
+bool ndi_checkpoint_reader::open(const char *file_name)
+{
+    int fd = ::open(file_name, O_RDONLY);
+    if (fd < 0) {
+        NDI_INIT_LOG_TRACE("No checkpoint file %s", file_name);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ndi_checkpoint_hdr_t)) {
+        close(fd);
+        NDI_INIT_LOG_ERROR("Invalid checkpoint file %s", file_name);
+        return false;
+    }
+    _len = st.st_size;
+    _base = mmap(NULL, _len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (_base == MAP_FAILED) {
+        NDI_INIT_LOG_ERROR("Failed to map checkpoint file %s", file_name);
+        return false;
+    }
+
+    auto hdr = (const ndi_checkpoint_hdr_t *)_base;
+    if (hdr->magic != NDI_CHECKPOINT_MAGIC || hdr->version != NDI_CHECKPOINT_VERSION ||
+        hdr->total_len != _len ||
+        sizeof(*hdr) + (uint64_t)hdr->section_count * sizeof(ndi_checkpoint_section_t) > _len) {
+        NDI_INIT_LOG_ERROR("Checkpoint file %s header mismatch, version %u", file_name,
+                           hdr->version);
+        return false;
+    }
+    auto sections = (const ndi_checkpoint_section_t *)(hdr + 1);
+    for (uint32_t idx = 0; idx < hdr->section_count; idx++) {
+        if (sections[idx].offset > _len || sections[idx].rec_size == 0 ||
+            sections[idx].rec_count > (_len - sections[idx].offset) / sections[idx].rec_size) {
+            NDI_INIT_LOG_ERROR("Checkpoint file %s section %u is truncated", file_name,
+                               sections[idx].type);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void ndi_checkpoint_map_walk_cb(const nas_ndi_map_key_t *key,
+                                       const nas_ndi_map_data_t *data, void *context)
+{
+    auto recs = (std::vector<ndi_checkpoint_map_rec_t> *)context;
+    ndi_checkpoint_map_rec_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.key = *key;
+    rec.data = *data;
+    recs->push_back(rec);
+}
+
+static void ndi_checkpoint_vlan_mbr_walk_cb(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr,
+                                            void *context)
+{
+    auto recs = (std::vector<ndi_checkpoint_vlan_mbr_rec_t> *)context;
+    ndi_checkpoint_vlan_mbr_rec_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.npu_id = npu_id;
+    rec.vlan_id = mbr->vlan_id;
+    rec.port_id = mbr->port_id;
+    rec.member_id = mbr->member_id;
+    rec.tagging_mode = mbr->tagging_mode;
+    recs->push_back(rec);
+}
+
+static void ndi_checkpoint_add_grp_mbr(std::vector<ndi_checkpoint_repl_grp_mbr_rec_t>& mbr_recs,
+                                       std::vector<ndi_sw_port_t>& port_recs,
+                                       npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                       ndi_mc_grp_mbr_type_t mbr_type,
+                                       const ndi_cache_repl_grp_t::mbr_list_t& mbr_list)
+{
+    for (auto& mbr: mbr_list) {
+        ndi_checkpoint_repl_grp_mbr_rec_t rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.npu_id = npu_id;
+        rec.repl_grp_id = repl_grp_id;
+        rec.mbr_type = mbr_type;
+        rec.mbr_id = mbr.second.mbr_id;
+        rec.rif_id = mbr.second.rif_id;
+        rec.port_start = port_recs.size();
+        rec.port_count = mbr.second.port_list.size();
+        port_recs.insert(port_recs.end(), mbr.second.port_list.begin(), mbr.second.port_list.end());
+        mbr_recs.push_back(rec);
+    }
+}
+
+static t_std_error ndi_checkpoint_collect(ndi_checkpoint_writer& writer)
+{
+    try {
+        std::vector<ndi_virtual_obj_t> virt_obj_recs;
+        nas_ndi_virtual_obj_walk([&virt_obj_recs](const ndi_virtual_obj_t& obj) {
+            virt_obj_recs.push_back(obj);
+        });
+        writer.add_section(NDI_CHECKPOINT_SECTION_VIRT_OBJ, virt_obj_recs);
+
+        std::vector<ndi_brport_obj_t> brport_recs;
+        nas_ndi_bridge_port_obj_walk([&brport_recs](const ndi_brport_obj_t& obj) {
+            brport_recs.push_back(obj);
+        });
+        writer.add_section(NDI_CHECKPOINT_SECTION_BRPORT, brport_recs);
+
+        std::vector<ndi_checkpoint_map_rec_t> map_recs;
+        if (nas_ndi_map_walk(ndi_checkpoint_map_walk_cb, &map_recs) != STD_ERR_OK) {
+            return STD_ERR(NPU, FAIL, 0);
+        }
+        writer.add_section(NDI_CHECKPOINT_SECTION_NDI_MAP, map_recs);
+
+        std::vector<ndi_checkpoint_rif_rec_t> rif_recs;
+        ndi_rif_utl_walk([&rif_recs](ndi_rif_id_t rif_id, const ndi_rif_entry_db_t& rif_entry) {
+            ndi_checkpoint_rif_rec_t rec;
+            memset(&rec, 0, sizeof(rec));
+            rec.rif_id = rif_id;
+            memcpy(&rec.rif_entry, &rif_entry, sizeof(ndi_rif_entry_db_t));
+            rif_recs.push_back(rec);
+        });
+        writer.add_section(NDI_CHECKPOINT_SECTION_RIF, rif_recs);
+
+        std::vector<ndi_checkpoint_repl_grp_rec_t> grp_recs;
+        std::vector<ndi_checkpoint_repl_grp_mbr_rec_t> mbr_recs;
+        std::vector<ndi_sw_port_t> port_recs;
+        ndi_ipmc_cache_walk_repl_grp([&](npu_id_t npu_id, const ndi_cache_repl_grp_t& grp) {
+            ndi_checkpoint_repl_grp_rec_t rec;
+            memset(&rec, 0, sizeof(rec));
+            rec.npu_id = npu_id;
+            rec.repl_grp_id = grp.repl_grp_id;
+            rec.rpf_grp_id = grp.rpf_grp_id;
+            rec.ipmc_grp_id = grp.ipmc_grp_id;
+            grp_recs.push_back(rec);
+            ndi_checkpoint_add_grp_mbr(mbr_recs, port_recs, npu_id, grp.repl_grp_id,
+                                       NDI_RPF_GRP_MBR, grp.rpf_mbr_list);
+            ndi_checkpoint_add_grp_mbr(mbr_recs, port_recs, npu_id, grp.repl_grp_id,
+                                       NDI_IPMC_GRP_MBR, grp.ipmc_mbr_list);
+        });
+        writer.add_section(NDI_CHECKPOINT_SECTION_REPL_GRP, grp_recs);
+        writer.add_section(NDI_CHECKPOINT_SECTION_REPL_GRP_MBR, mbr_recs);
+        writer.add_section(NDI_CHECKPOINT_SECTION_REPL_GRP_MBR_PORT, port_recs);
+
+        std::vector<ndi_checkpoint_ipmc_entry_rec_t> ipmc_recs;
+        ndi_ipmc_cache_walk_entry([&ipmc_recs](npu_id_t npu_id, const ndi_ipmc_entry_t& entry) {
+            ndi_checkpoint_ipmc_entry_rec_t rec;
+            memset(&rec, 0, sizeof(rec));
+            rec.npu_id = npu_id;
+            rec.ipmc_entry = entry;
+            ipmc_recs.push_back(rec);
+        });
+        writer.add_section(NDI_CHECKPOINT_SECTION_IPMC_ENTRY, ipmc_recs);
+
+        std::vector<ndi_checkpoint_tunnel_rec_t> tun_recs;
+        std::vector<ndi_checkpoint_tunnel_map_rec_t> tun_map_recs;
+        {
+            std_mutex_simple_lock_guard lock_t(ndi_tun_mutex_lock());
+            walk_tunnel_obj([&](TunnelObj *tun_obj) {
+                ndi_checkpoint_tunnel_rec_t rec;
+                memset(&rec, 0, sizeof(rec));
+                tun_obj->get_remote_src_ip(&rec.remote_src_ip);
+                tun_obj->get_local_src_ip(&rec.local_src_ip);
+                rec.tun_oid = tun_obj->get_tun_oid();
+                rec.encap_map_oid = tun_obj->get_encap_map_oid();
+                rec.decap_map_oid = tun_obj->get_decap_map_oid();
+                rec.term_oid = tun_obj->get_term_oid();
+                tun_recs.push_back(rec);
+
+                tun_obj->walk_map_entries([&](ndi_tunnel_obj_map_type_t map_type,
+                                              sai_object_id_t br_oid,
+                                              const vni_s_oid_map_t& map_val) {
+                    ndi_checkpoint_tunnel_map_rec_t map_rec;
+                    memset(&map_rec, 0, sizeof(map_rec));
+                    map_rec.remote_src_ip = rec.remote_src_ip;
+                    map_rec.local_src_ip = rec.local_src_ip;
+                    map_rec.map_type = map_type;
+                    map_rec.vni = map_val.vni;
+                    map_rec.br_oid = br_oid;
+                    map_rec.oid = map_val.oid;
+                    tun_map_recs.push_back(map_rec);
+                });
+            });
+        }
+        writer.add_section(NDI_CHECKPOINT_SECTION_TUNNEL, tun_recs);
+        writer.add_section(NDI_CHECKPOINT_SECTION_TUNNEL_MAP, tun_map_recs);
+
+        std::vector<ndi_checkpoint_vlan_mbr_rec_t> vlan_mbr_recs;
+        ndi_vlan_mbr_cache_walk(ndi_checkpoint_vlan_mbr_walk_cb, &vlan_mbr_recs);
+        writer.add_section(NDI_CHECKPOINT_SECTION_VLAN_MBR, vlan_mbr_recs);
+    } catch (...) {
+        NDI_INIT_LOG_ERROR("Failed to collect NDI caches for checkpoint");
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+    return STD_ERR_OK;
+}
+
+/* Serializes the writers of the checkpoint file, they share the temporary file */
+static std::mutex _ckpt_save_lock;
+static std::string _ckpt_saved_file;
+static uint64_t _ckpt_saved_digest = 0;
+
+static t_std_error ndi_checkpoint_save(const char *file_name, bool if_changed)
+{
+    ndi_checkpoint_writer writer;
+    file_name = ndi_checkpoint_file_name(file_name);
+
+    std::lock_guard<std::mutex> lock(_ckpt_save_lock);
+    t_std_error rc = ndi_checkpoint_collect(writer);
+    if (rc != STD_ERR_OK) {
+        return rc;
+    }
+    uint64_t digest = writer.digest();
+    if (if_changed && (_ckpt_saved_file == file_name) && (digest == _ckpt_saved_digest)) {
+        return STD_ERR_OK;
+    }
+    if (!writer.write(file_name)) {
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    _ckpt_saved_file = file_name;
+    _ckpt_saved_digest = digest;
+    NDI_INIT_LOG_TRACE("NDI caches saved to checkpoint file %s", file_name);
+    return STD_ERR_OK;
+}
+
+/* Periodic saver, bounds how stale the checkpoint is when NAS goes down
+ * without an orderly shutdown. The thread is stopped and joined either by
+ * nas_ndi_checkpoint_shutdown or at process exit */
+class ndi_checkpoint_saver
+{
+public:
+    ~ndi_checkpoint_saver() { stop(); }
+
+    bool start(uint32_t interval_sec)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_thread.joinable()) {
+            return true;
+        }
+        _stop = false;
+        try {
+            _thread = std::thread(&ndi_checkpoint_saver::run, this, interval_sec);
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _stop = true;
+        }
+        _cv.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    void run(uint32_t interval_sec)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        while (!_cv.wait_for(lock, std::chrono::seconds(interval_sec),
+                             [this] { return _stop; })) {
+            lock.unlock();
+            if (ndi_checkpoint_save(NULL, true) != STD_ERR_OK) {
+                NDI_INIT_LOG_ERROR("Periodic NDI checkpoint save failed");
+            }
+            lock.lock();
+        }
+    }
+
+    std::mutex _lock;
+    std::condition_variable _cv;
+    std::thread _thread;
+    bool _stop = false;
+};
+
+static ndi_checkpoint_saver _ckpt_saver;
+
+extern "C" {
+
+bool nas_ndi_checkpoint_is_warm_boot(void)
+{
+    const char *boot_type = ndi_profile_get_value(0, SAI_KEY_BOOT_TYPE);
+    return (boot_type != NULL) && (atoi(boot_type) == 1);
+}
+
+t_std_error nas_ndi_checkpoint_save(const char *file_name)
+{
+    return ndi_checkpoint_save(file_name, false);
+}
+
+t_std_error nas_ndi_checkpoint_start(uint32_t interval_sec)
+{
+    if (interval_sec == 0) {
+        /* Only worth the periodic cache walk when a warm restart can use
+         * the file, or when asked for explicitly */
+        const char *env_interval = getenv("OPX_NDI_CHECKPOINT_INTERVAL");
+        if (env_interval != NULL) {
+            interval_sec = strtoul(env_interval, NULL, 10);
+        } else if (nas_ndi_checkpoint_is_warm_boot()) {
+            interval_sec = NDI_CHECKPOINT_DEFAULT_INTERVAL;
+        }
+        if (interval_sec == 0) {
+            NDI_INIT_LOG_TRACE("Periodic NDI checkpoint save is disabled");
+            return STD_ERR_OK;
+        }
+    }
+
+    if (!_ckpt_saver.start(interval_sec)) {
+        NDI_INIT_LOG_ERROR("Failed to start periodic NDI checkpoint save");
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error nas_ndi_checkpoint_shutdown(void)
+{
+    _ckpt_saver.stop();
+    return ndi_checkpoint_save(NULL, false);
+}
+
+t_std_error nas_ndi_checkpoint_restore(const char *file_name)
+{
+    ndi_checkpoint_reader reader;
+    t_std_error rc = STD_ERR_OK;
+    size_t count = 0;
+    size_t idx;
+
+    file_name = ndi_checkpoint_file_name(file_name);
+    if (!reader.open(file_name)) {
+        return STD_ERR(NPU, FAIL, 0);
+    }
+
+    /* Every restored cache entry is recorded so that a failed restore leaves
+     * the caches empty for cold discovery instead of half populated */
+    std::vector<std::function<void ()>> undo_list;
+    try {
+        auto virt_obj_recs = reader.get_section<ndi_virtual_obj_t>(NDI_CHECKPOINT_SECTION_VIRT_OBJ, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            ndi_virtual_obj_t obj = virt_obj_recs[idx];
+            if (ndi_vlan_restore_sai_vlan_obj_id(0, obj.vid, obj.oid) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([obj] { ndi_vlan_discard_sai_vlan_obj_id(0, obj.vid, obj.oid); });
+        }
+
+        auto brport_recs = reader.get_section<ndi_brport_obj_t>(NDI_CHECKPOINT_SECTION_BRPORT, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            ndi_brport_obj_t brport = brport_recs[idx];
+            if (!nas_ndi_add_bridge_port_obj(&brport)) {
+                NDI_INIT_LOG_ERROR("Failed to restore bridge port 0x%" PRIx64, brport.brport_obj_id);
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([brport] () mutable { nas_ndi_remove_bridge_port_obj(&brport); });
+        }
+
+        auto map_recs = reader.get_section<ndi_checkpoint_map_rec_t>(NDI_CHECKPOINT_SECTION_NDI_MAP, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            nas_ndi_map_key_t key = map_recs[idx].key;
+            nas_ndi_map_data_t data = map_recs[idx].data;
+            nas_ndi_map_val_t val;
+            val.count = 1;
+            val.data = &data;
+            if (nas_ndi_map_insert(&key, &val) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([key] () mutable { nas_ndi_map_delete(&key); });
+        }
+
+        auto rif_recs = reader.get_section<ndi_checkpoint_rif_rec_t>(NDI_CHECKPOINT_SECTION_RIF, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            ndi_rif_id_t rif_id = rif_recs[idx].rif_id;
+            if (ndi_rif_utl_restore_rif(rif_id, rif_recs[idx].rif_entry) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([rif_id] { ndi_rif_utl_discard_rif(rif_id); });
+        }
+
+        /* Group members are dropped with their group */
+        auto grp_recs = reader.get_section<ndi_checkpoint_repl_grp_rec_t>(NDI_CHECKPOINT_SECTION_REPL_GRP, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            npu_id_t npu_id = grp_recs[idx].npu_id;
+            ndi_obj_id_t repl_grp_id = grp_recs[idx].repl_grp_id;
+            if (ndi_ipmc_cache_restore_repl_grp(npu_id, repl_grp_id, grp_recs[idx].rpf_grp_id,
+                                                grp_recs[idx].ipmc_grp_id) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([npu_id, repl_grp_id] {
+                ndi_ipmc_cache_discard_repl_grp(npu_id, repl_grp_id);
+            });
+        }
+
+        size_t port_count = 0;
+        auto port_recs = reader.get_section<ndi_sw_port_t>(NDI_CHECKPOINT_SECTION_REPL_GRP_MBR_PORT,
+                                                           port_count);
+        auto mbr_recs = reader.get_section<ndi_checkpoint_repl_grp_mbr_rec_t>(
+                                                NDI_CHECKPOINT_SECTION_REPL_GRP_MBR, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            auto& rec = mbr_recs[idx];
+            if ((uint64_t)rec.port_start + rec.port_count > port_count) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            std::vector<ndi_sw_port_t> ports(port_recs + rec.port_start,
+                                             port_recs + rec.port_start + rec.port_count);
+            ndi_mc_grp_mbr_t grp_mbr;
+            memset(&grp_mbr, 0, sizeof(grp_mbr));
+            grp_mbr.rif_id = rec.rif_id;
+            grp_mbr.port_list.port_count = ports.size();
+            grp_mbr.port_list.list = ports.data();
+            if (ndi_ipmc_cache_restore_grp_mbr(rec.npu_id, rec.repl_grp_id,
+                                               (ndi_mc_grp_mbr_type_t)rec.mbr_type, rec.mbr_id,
+                                               grp_mbr) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+            }
+        }
+
+        auto ipmc_recs = reader.get_section<ndi_checkpoint_ipmc_entry_rec_t>(
+                                                NDI_CHECKPOINT_SECTION_IPMC_ENTRY, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            npu_id_t npu_id = ipmc_recs[idx].npu_id;
+            ndi_ipmc_entry_t entry = ipmc_recs[idx].ipmc_entry;
+            if (ndi_ipmc_cache_add_entry(npu_id, entry) != STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            undo_list.push_back([npu_id, entry] { ndi_ipmc_cache_del_entry(npu_id, entry); });
+        }
+
+        /* Records are saved grouped by NPU, each run of one NPU is set with one cache lock */
+        auto vlan_mbr_recs = reader.get_section<ndi_checkpoint_vlan_mbr_rec_t>(
+                                                NDI_CHECKPOINT_SECTION_VLAN_MBR, count);
+        std::vector<ndi_vlan_mbr_info_t> vlan_mbrs;
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            auto& rec = vlan_mbr_recs[idx];
+            vlan_mbrs.push_back({rec.vlan_id, rec.port_id, rec.member_id,
+                                 (sai_vlan_tagging_mode_t)rec.tagging_mode});
+            if ((idx + 1 == count) || (vlan_mbr_recs[idx + 1].npu_id != rec.npu_id)) {
+                npu_id_t npu_id = rec.npu_id;
+                if (ndi_vlan_mbr_cache_set(npu_id, vlan_mbrs.data(), vlan_mbrs.size()) != STD_ERR_OK) {
+                    NDI_INIT_LOG_ERROR("Failed to restore VLAN members of NPU %d", npu_id);
+                    rc = STD_ERR(NPU, FAIL, 0);
+                }
+                undo_list.push_back([npu_id, vlan_mbrs] {
+                    ndi_vlan_mbr_cache_del(npu_id, vlan_mbrs.data(), vlan_mbrs.size());
+                });
+                vlan_mbrs.clear();
+            }
+        }
+
+        /* Map entries are dropped with their tunnel */
+        std_mutex_simple_lock_guard lock_t(ndi_tun_mutex_lock());
+        auto tun_recs = reader.get_section<ndi_checkpoint_tunnel_rec_t>(NDI_CHECKPOINT_SECTION_TUNNEL, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            auto& rec = tun_recs[idx];
+            TunnelObj *obj = new TunnelObj(rec.tun_oid, rec.encap_map_oid, rec.decap_map_oid,
+                                           rec.term_oid, rec.local_src_ip, rec.remote_src_ip);
+            if (!insert_tunnel_obj(&rec.remote_src_ip, &rec.local_src_ip, obj)) {
+                NDI_INIT_LOG_ERROR("Failed to restore tunnel 0x%" PRIx64, rec.tun_oid);
+                delete obj;
+                rc = STD_ERR(NPU, FAIL, 0);
+                break;
+            }
+            hal_ip_addr_t remote_src_ip = rec.remote_src_ip;
+            hal_ip_addr_t local_src_ip = rec.local_src_ip;
+            undo_list.push_back([remote_src_ip, local_src_ip] {
+                std_mutex_simple_lock_guard lock_t(ndi_tun_mutex_lock());
+                remove_tunnel_obj(&remote_src_ip, &local_src_ip);
+            });
+        }
+
+        auto tun_map_recs = reader.get_section<ndi_checkpoint_tunnel_map_rec_t>(
+                                                NDI_CHECKPOINT_SECTION_TUNNEL_MAP, count);
+        for (idx = 0; (rc == STD_ERR_OK) && (idx < count); idx++) {
+            auto& rec = tun_map_recs[idx];
+            TunnelObj *obj = get_tunnel_obj(&rec.remote_src_ip, &rec.local_src_ip);
+            bool ret = false;
+            if (obj != nullptr) {
+                switch (rec.map_type) {
+                case ndi_tunnel_obj_map_type_ENCAP:
+                    ret = obj->insert_encap_map_entry(rec.br_oid, rec.vni, rec.oid);
+                    break;
+                case ndi_tunnel_obj_map_type_DECAP:
+                    ret = obj->insert_decap_map_entry(rec.br_oid, rec.vni, rec.oid);
+                    break;
+                case ndi_tunnel_obj_map_type_BRIDGE_PORT:
+                    ret = obj->insert_tunnel_bridge_port(rec.br_oid, rec.vni, rec.oid);
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (!ret) {
+                rc = STD_ERR(NPU, FAIL, 0);
+            }
+        }
+    } catch (...) {
+        NDI_INIT_LOG_ERROR("Failed to allocate memory to restore NDI caches");
+        rc = STD_ERR(NPU, NOMEM, 0);
+    }
+
+    if (rc != STD_ERR_OK) {
+        for (auto it = undo_list.rbegin(); it != undo_list.rend(); ++it) {
+            (*it)();
+        }
+        NDI_INIT_LOG_ERROR("Failed to restore NDI caches from checkpoint file %s, caches cleared",
+                           file_name);
+    } else {
+        NDI_INIT_LOG_TRACE("NDI caches restored from checkpoint file %s", file_name);
+    }
+
+    /* Checkpoint is consumed, a later warm boot must not reload it unless it
+     * is saved again */
+    if (unlink(file_name) != 0) {
+        NDI_INIT_LOG_ERROR("Failed to remove checkpoint file %s", file_name);
+    }
+    return rc;
+}
+
+}
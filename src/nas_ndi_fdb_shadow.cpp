@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_fdb_shadow.cpp
+ */
+
+#include "nas_ndi_fdb_shadow.h"
+#include "nas_ndi_event_logs.h"
+#include "std_rw_lock.h"
+
+#include <atomic>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Records are kept in a vector and referenced by index. The (bv_id, mac) index
+ * is an open addressing table of record indexes with backward shift delete.
+ * Each record is linked in a circular list of its bridge port and of its
+ * bv_id, list heads keep the number of records in the list.
+ */
+static const uint32_t NDI_FDB_SHADOW_NIL = (uint32_t)-1;
+
+typedef struct {
+    ndi_fdb_shadow_entry_t entry;
+    uint32_t port_prev;
+    uint32_t port_next;
+    uint32_t bv_prev;
+    uint32_t bv_next;
+    bool in_use;
+} ndi_fdb_shadow_rec_t;
+
+typedef struct {
+    uint32_t head;
+    size_t count;
+} ndi_fdb_shadow_list_t;
+
+typedef std::unordered_map<sai_object_id_t, ndi_fdb_shadow_list_t> ndi_fdb_shadow_lists_t;
+
+class ndi_fdb_shadow {
+public:
+    ndi_fdb_shadow() {
+        std_rw_lock_create_default(&_rw_lock);
+        _slots.assign(1024, NDI_FDB_SHADOW_NIL);
+    }
+
+    t_std_error add(const ndi_fdb_shadow_entry_t *entry);
+    bool del(sai_object_id_t bv_id, const hal_mac_addr_t mac);
+    bool update(sai_object_id_t bv_id, const hal_mac_addr_t mac, const sai_object_id_t *brport_id,
+                const sai_packet_action_t *action);
+    bool get(ndi_fdb_shadow_entry_t *entry);
+    size_t flush(const ndi_fdb_shadow_filter_t *filter);
+    size_t count(const ndi_fdb_shadow_filter_t *filter);
+    size_t walk(const ndi_fdb_shadow_filter_t *filter, ndi_fdb_shadow_walk_fn fn, void *ctx);
+    size_t get_next(const ndi_fdb_shadow_filter_t *filter, size_t *cursor,
+                    ndi_fdb_shadow_entry_t *entries, size_t max_count);
+    void clear();
+
+private:
+    static size_t hash(sai_object_id_t bv_id, const uint8_t *mac) {
+        uint64_t key = bv_id;
+        for (size_t ix = 0; ix < HAL_MAC_ADDR_LEN; ++ix) {
+            key = (key * 0x100000001b3ULL) ^ mac[ix];
+        }
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return (size_t)key;
+    }
+
+    bool match_key(uint32_t idx, sai_object_id_t bv_id, const uint8_t *mac) const {
+        const ndi_fdb_shadow_entry_t &e = _recs[idx].entry;
+        return (e.bv_id == bv_id) && (memcmp(e.mac, mac, HAL_MAC_ADDR_LEN) == 0);
+    }
+
+    static bool match_filter(const ndi_fdb_shadow_entry_t &e, const ndi_fdb_shadow_filter_t *filter) {
+        if (filter == NULL) return true;
+        if ((filter->brport_id != SAI_NULL_OBJECT_ID) && (e.brport_id != filter->brport_id)) return false;
+        if ((filter->bv_id != SAI_NULL_OBJECT_ID) && (e.bv_id != filter->bv_id)) return false;
+        if (filter->type == NDI_FDB_SHADOW_TYPE_STATIC) return e.is_static;
+        if (filter->type == NDI_FDB_SHADOW_TYPE_DYNAMIC) return !e.is_static;
+        return true;
+    }
+
+    size_t find_slot(sai_object_id_t bv_id, const uint8_t *mac) const;
+    void grow();
+    void erase_slot(size_t slot);
+    void list_add(ndi_fdb_shadow_lists_t &lists, sai_object_id_t key, uint32_t idx, bool port_list);
+    void list_del(ndi_fdb_shadow_lists_t &lists, sai_object_id_t key, uint32_t idx, bool port_list);
+    uint32_t &next(uint32_t idx, bool port_list) {
+        return port_list ? _recs[idx].port_next : _recs[idx].bv_next;
+    }
+    uint32_t &prev(uint32_t idx, bool port_list) {
+        return port_list ? _recs[idx].port_prev : _recs[idx].bv_prev;
+    }
+    const ndi_fdb_shadow_list_t *select_list(const ndi_fdb_shadow_filter_t *filter, bool &port_list) const;
+
+    std_rw_lock_t _rw_lock;
+    std::vector<ndi_fdb_shadow_rec_t> _recs;
+    std::vector<uint32_t> _free;
+    std::vector<uint32_t> _slots;
+    size_t _used = 0;
+    ndi_fdb_shadow_lists_t _port_lists;
+    ndi_fdb_shadow_lists_t _bv_lists;
+};
+
+size_t ndi_fdb_shadow::find_slot(sai_object_id_t bv_id, const uint8_t *mac) const
+{
+    size_t mask = _slots.size() - 1;
+    size_t slot = hash(bv_id, mac) & mask;
+    while (_slots[slot] != NDI_FDB_SHADOW_NIL) {
+        if (match_key(_slots[slot], bv_id, mac)) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void ndi_fdb_shadow::grow()
+{
+    std::vector<uint32_t> old_slots(_slots.size() * 2, NDI_FDB_SHADOW_NIL);
+    old_slots.swap(_slots);
+    for (auto idx : old_slots) {
+        if (idx != NDI_FDB_SHADOW_NIL) {
+            const ndi_fdb_shadow_entry_t &e = _recs[idx].entry;
+            _slots[find_slot(e.bv_id, e.mac)] = idx;
+        }
+    }
+}
+
+void ndi_fdb_shadow::erase_slot(size_t slot)
+{
+    size_t mask = _slots.size() - 1;
+    size_t hole = slot;
+    size_t ix = (slot + 1) & mask;
+    while (_slots[ix] != NDI_FDB_SHADOW_NIL) {
+        const ndi_fdb_shadow_entry_t &e = _recs[_slots[ix]].entry;
+        size_t home = hash(e.bv_id, e.mac) & mask;
+        /* move back if the hole is between home slot and current slot */
+        if (((ix - home) & mask) >= ((ix - hole) & mask)) {
+            _slots[hole] = _slots[ix];
+            hole = ix;
+        }
+        ix = (ix + 1) & mask;
+    }
+    _slots[hole] = NDI_FDB_SHADOW_NIL;
+}
+
+void ndi_fdb_shadow::list_add(ndi_fdb_shadow_lists_t &lists, sai_object_id_t key,
+                              uint32_t idx, bool port_list)
+{
+    auto it = lists.find(key);
+    if (it == lists.end()) {
+        next(idx, port_list) = idx;
+        prev(idx, port_list) = idx;
+        lists[key] = {idx, 1};
+        return;
+    }
+    uint32_t head = it->second.head;
+    uint32_t tail = prev(head, port_list);
+    next(idx, port_list) = head;
+    prev(idx, port_list) = tail;
+    next(tail, port_list) = idx;
+    prev(head, port_list) = idx;
+    it->second.count++;
+}
+
+void ndi_fdb_shadow::list_del(ndi_fdb_shadow_lists_t &lists, sai_object_id_t key,
+                              uint32_t idx, bool port_list)
+{
+    auto it = lists.find(key);
+    if (it == lists.end()) {
+        return;
+    }
+    if (--it->second.count == 0) {
+        lists.erase(it);
+        return;
+    }
+    uint32_t nxt = next(idx, port_list);
+    uint32_t prv = prev(idx, port_list);
+    next(prv, port_list) = nxt;
+    prev(nxt, port_list) = prv;
+    if (it->second.head == idx) {
+        it->second.head = nxt;
+    }
+}
+
+t_std_error ndi_fdb_shadow::add(const ndi_fdb_shadow_entry_t *entry)
+{
+    std_rw_lock_write_guard lg(&_rw_lock);
+
+    size_t slot = find_slot(entry->bv_id, entry->mac);
+    uint32_t idx = _slots[slot];
+    if (idx != NDI_FDB_SHADOW_NIL) {
+        ndi_fdb_shadow_entry_t &e = _recs[idx].entry;
+        if (e.brport_id != entry->brport_id) {
+            list_del(_port_lists, e.brport_id, idx, true);
+            list_add(_port_lists, entry->brport_id, idx, true);
+        }
+        e = *entry;
+        return STD_ERR_OK;
+    }
+
+    if ((_used + 1) * 4 > _slots.size() * 3) {
+        grow();
+        slot = find_slot(entry->bv_id, entry->mac);
+    }
+
+    if (!_free.empty()) {
+        idx = _free.back();
+        _free.pop_back();
+    } else {
+        if (_recs.size() >= NDI_FDB_SHADOW_NIL) {
+            return STD_ERR(MAC, NOMEM, 0);
+        }
+        idx = (uint32_t)_recs.size();
+        _recs.push_back(ndi_fdb_shadow_rec_t());
+    }
+    _recs[idx].entry = *entry;
+    _recs[idx].in_use = true;
+    _slots[slot] = idx;
+    _used++;
+    list_add(_port_lists, entry->brport_id, idx, true);
+    list_add(_bv_lists, entry->bv_id, idx, false);
+    return STD_ERR_OK;
+}
+
+bool ndi_fdb_shadow::del(sai_object_id_t bv_id, const hal_mac_addr_t mac)
+{
+    std_rw_lock_write_guard lg(&_rw_lock);
+
+    size_t slot = find_slot(bv_id, mac);
+    uint32_t idx = _slots[slot];
+    if (idx == NDI_FDB_SHADOW_NIL) {
+        return false;
+    }
+    list_del(_port_lists, _recs[idx].entry.brport_id, idx, true);
+    list_del(_bv_lists, bv_id, idx, false);
+    erase_slot(slot);
+    _recs[idx].in_use = false;
+    _free.push_back(idx);
+    _used--;
+    return true;
+}
+
+bool ndi_fdb_shadow::update(sai_object_id_t bv_id, const hal_mac_addr_t mac,
+                           const sai_object_id_t *brport_id, const sai_packet_action_t *action)
+{
+    std_rw_lock_write_guard lg(&_rw_lock);
+
+    uint32_t idx = _slots[find_slot(bv_id, mac)];
+    if (idx == NDI_FDB_SHADOW_NIL) {
+        return false;
+    }
+    ndi_fdb_shadow_entry_t &e = _recs[idx].entry;
+    if ((brport_id != NULL) && (e.brport_id != *brport_id)) {
+        list_del(_port_lists, e.brport_id, idx, true);
+        list_add(_port_lists, *brport_id, idx, true);
+        e.brport_id = *brport_id;
+    }
+    if (action != NULL) {
+        e.action = *action;
+    }
+    return true;
+}
+
+bool ndi_fdb_shadow::get(ndi_fdb_shadow_entry_t *entry)
+{
+    std_rw_lock_read_guard lg(&_rw_lock);
+
+    uint32_t idx = _slots[find_slot(entry->bv_id, entry->mac)];
+    if (idx == NDI_FDB_SHADOW_NIL) {
+        return false;
+    }
+    *entry = _recs[idx].entry;
+    return true;
+}
+
+/* Pick the shortest list that holds all the entries matching the filter */
+const ndi_fdb_shadow_list_t *ndi_fdb_shadow::select_list(const ndi_fdb_shadow_filter_t *filter,
+                                                         bool &port_list) const
+{
+    static const ndi_fdb_shadow_list_t empty = {NDI_FDB_SHADOW_NIL, 0};
+    const ndi_fdb_shadow_list_t *port = NULL, *bv = NULL;
+
+    if (filter->brport_id != SAI_NULL_OBJECT_ID) {
+        auto it = _port_lists.find(filter->brport_id);
+        port = (it == _port_lists.end()) ? &empty : &it->second;
+    }
+    if (filter->bv_id != SAI_NULL_OBJECT_ID) {
+        auto it = _bv_lists.find(filter->bv_id);
+        bv = (it == _bv_lists.end()) ? &empty : &it->second;
+    }
+    port_list = (port != NULL) && ((bv == NULL) || (port->count <= bv->count));
+    return port_list ? port : bv;
+}
+
+size_t ndi_fdb_shadow::count(const ndi_fdb_shadow_filter_t *filter)
+{
+    std_rw_lock_read_guard lg(&_rw_lock);
+
+    bool port_list;
+    const ndi_fdb_shadow_list_t *list = (filter != NULL) ? select_list(filter, port_list) : NULL;
+    bool any_type = (filter == NULL) || (filter->type == NDI_FDB_SHADOW_TYPE_ALL);
+
+    if (list == NULL) {
+        if (any_type) {
+            return _used;
+        }
+        size_t cnt = 0;
+        for (auto idx : _slots) {
+            if ((idx != NDI_FDB_SHADOW_NIL) && match_filter(_recs[idx].entry, filter)) cnt++;
+        }
+        return cnt;
+    }
+    bool single_key = (filter->brport_id == SAI_NULL_OBJECT_ID) ||
+                      (filter->bv_id == SAI_NULL_OBJECT_ID);
+    if (any_type && single_key) {
+        return list->count;
+    }
+    size_t cnt = 0;
+    uint32_t idx = list->head;
+    for (size_t ix = 0; ix < list->count; ++ix) {
+        if (match_filter(_recs[idx].entry, filter)) cnt++;
+        idx = port_list ? _recs[idx].port_next : _recs[idx].bv_next;
+    }
+    return cnt;
+}
+
+size_t ndi_fdb_shadow::walk(const ndi_fdb_shadow_filter_t *filter,
+                            ndi_fdb_shadow_walk_fn fn, void *ctx)
+{
+    std_rw_lock_read_guard lg(&_rw_lock);
+
+    bool port_list;
+    const ndi_fdb_shadow_list_t *list = (filter != NULL) ? select_list(filter, port_list) : NULL;
+    size_t cnt = 0;
+
+    if (list == NULL) {
+        for (auto idx : _slots) {
+            if ((idx == NDI_FDB_SHADOW_NIL) || !match_filter(_recs[idx].entry, filter)) continue;
+            cnt++;
+            if (!fn(&_recs[idx].entry, ctx)) break;
+        }
+        return cnt;
+    }
+    uint32_t idx = list->head;
+    for (size_t ix = 0; ix < list->count; ++ix) {
+        const ndi_fdb_shadow_rec_t &rec = _recs[idx];
+        idx = port_list ? rec.port_next : rec.bv_next;
+        if (!match_filter(rec.entry, filter)) continue;
+        cnt++;
+        if (!fn(&rec.entry, ctx)) break;
+    }
+    return cnt;
+}
+
+size_t ndi_fdb_shadow::get_next(const ndi_fdb_shadow_filter_t *filter, size_t *cursor,
+                                ndi_fdb_shadow_entry_t *entries, size_t max_count)
+{
+    std_rw_lock_read_guard lg(&_rw_lock);
+
+    size_t cnt = 0;
+    size_t idx = *cursor;
+    for (; (idx < _recs.size()) && (cnt < max_count); ++idx) {
+        if (_recs[idx].in_use && match_filter(_recs[idx].entry, filter)) {
+            entries[cnt++] = _recs[idx].entry;
+        }
+    }
+    *cursor = idx;
+    return cnt;
+}
+
+size_t ndi_fdb_shadow::flush(const ndi_fdb_shadow_filter_t *filter)
+{
+    std_rw_lock_write_guard lg(&_rw_lock);
+
+    bool port_list;
+    const ndi_fdb_shadow_list_t *list = (filter != NULL) ? select_list(filter, port_list) : NULL;
+    std::vector<uint32_t> victims;
+
+    if (list == NULL) {
+        for (auto idx : _slots) {
+            if ((idx != NDI_FDB_SHADOW_NIL) && match_filter(_recs[idx].entry, filter)) {
+                victims.push_back(idx);
+            }
+        }
+    } else {
+        uint32_t idx = list->head;
+        for (size_t ix = 0; ix < list->count; ++ix) {
+            if (match_filter(_recs[idx].entry, filter)) {
+                victims.push_back(idx);
+            }
+            idx = port_list ? _recs[idx].port_next : _recs[idx].bv_next;
+        }
+    }
+
+    for (auto idx : victims) {
+        const ndi_fdb_shadow_entry_t &e = _recs[idx].entry;
+        list_del(_port_lists, e.brport_id, idx, true);
+        list_del(_bv_lists, e.bv_id, idx, false);
+        erase_slot(find_slot(e.bv_id, e.mac));
+        _recs[idx].in_use = false;
+        _free.push_back(idx);
+        _used--;
+    }
+    return victims.size();
+}
+
+void ndi_fdb_shadow::clear()
+{
+    std_rw_lock_write_guard lg(&_rw_lock);
+
+    std::vector<ndi_fdb_shadow_rec_t>().swap(_recs);
+    std::vector<uint32_t>().swap(_free);
+    _slots.assign(1024, NDI_FDB_SHADOW_NIL);
+    _used = 0;
+    _port_lists.clear();
+    _bv_lists.clear();
+}
+
+static auto _fdb_shadow = new ndi_fdb_shadow;
+static std::atomic<bool> _fdb_shadow_enabled(false);
+static std::atomic<bool> _fdb_shadow_seeded(false);
+static std::atomic<ndi_fdb_shadow_seed_fn> _fdb_shadow_seed_fn(nullptr);
+
+extern "C" {
+
+void ndi_fdb_shadow_seed_fn_set(ndi_fdb_shadow_seed_fn fn)
+{
+    _fdb_shadow_seed_fn = fn;
+}
+
+void ndi_fdb_shadow_enable(bool enable)
+{
+    _fdb_shadow_seeded = false;
+    _fdb_shadow_enabled = enable;
+    if (!enable) {
+        _fdb_shadow->clear();
+        return;
+    }
+
+    /* Updates are tracked from here on, entries learned while seeding are not lost */
+    ndi_fdb_shadow_seed_fn seed_fn = _fdb_shadow_seed_fn;
+    if ((seed_fn == NULL) || !seed_fn()) {
+        return;
+    }
+    _fdb_shadow_seeded = _fdb_shadow_enabled.load();
+}
+
+bool ndi_fdb_shadow_is_enabled(void)
+{
+    return _fdb_shadow_enabled;
+}
+
+bool ndi_fdb_shadow_is_seeded(void)
+{
+    return _fdb_shadow_enabled && _fdb_shadow_seeded;
+}
+
+t_std_error ndi_fdb_shadow_add(const ndi_fdb_shadow_entry_t *entry)
+{
+    if (!_fdb_shadow_enabled) {
+        return STD_ERR_OK;
+    }
+    if (entry == NULL) {
+        return STD_ERR(MAC, PARAM, 0);
+    }
+    return _fdb_shadow->add(entry);
+}
+
+bool ndi_fdb_shadow_del(sai_object_id_t bv_id, const hal_mac_addr_t mac)
+{
+    return _fdb_shadow_enabled && _fdb_shadow->del(bv_id, mac);
+}
+
+bool ndi_fdb_shadow_update(sai_object_id_t bv_id, const hal_mac_addr_t mac,
+                           const sai_object_id_t *brport_id, const sai_packet_action_t *action)
+{
+    return _fdb_shadow_enabled && _fdb_shadow->update(bv_id, mac, brport_id, action);
+}
+
+bool ndi_fdb_shadow_get(ndi_fdb_shadow_entry_t *entry)
+{
+    return _fdb_shadow_enabled && (entry != NULL) && _fdb_shadow->get(entry);
+}
+
+size_t ndi_fdb_shadow_flush(const ndi_fdb_shadow_filter_t *filter)
+{
+    return _fdb_shadow_enabled ? _fdb_shadow->flush(filter) : 0;
+}
+
+size_t ndi_fdb_shadow_count(const ndi_fdb_shadow_filter_t *filter)
+{
+    return _fdb_shadow_enabled ? _fdb_shadow->count(filter) : 0;
+}
+
+size_t ndi_fdb_shadow_get_next(const ndi_fdb_shadow_filter_t *filter, size_t *cursor,
+                               ndi_fdb_shadow_entry_t *entries, size_t max_count)
+{
+    if (!_fdb_shadow_enabled || (cursor == NULL) || (entries == NULL)) {
+        return 0;
+    }
+    return _fdb_shadow->get_next(filter, cursor, entries, max_count);
+}
+
+size_t ndi_fdb_shadow_walk(const ndi_fdb_shadow_filter_t *filter,
+                           ndi_fdb_shadow_walk_fn fn, void *ctx)
+{
+    if (!_fdb_shadow_enabled || (fn == NULL)) {
+        return 0;
+    }
+    return _fdb_shadow->walk(filter, fn, ctx);
+}
+
+}
@@ -27,6 +27,7 @@
 #include "nas_ndi_common.h"
 #include "nas_ndi_mac.h"
 #include "nas_ndi_mac_utl.h"
+#include "nas_ndi_fdb_shadow.h"
 #include "nas_ndi_int.h"
 #include "nas_ndi_utils.h"
 #include "nas_ndi_fc_init.h"
@@ -39,6 +40,7 @@
 #include "nas_switch.h"
 #include "nas_ndi_obj_cache.h"
 #include "nas_ndi_bridge_port.h"
+#include "nas_ndi_checkpoint.h"
 
 #include "std_thread_tools.h"
 #include "std_socket_tools.h"
@@ -47,6 +49,7 @@
 #include <string.h>
 #include<unistd.h>
 #include <inttypes.h>
+#include <time.h>
 
 typedef enum {
     ndi_internal_event_T_SWITCH_OPER,
@@ -381,6 +384,12 @@ static void * _ndi_event_push(void * param) {
 static void ndi_switch_shutdown_request_cb(sai_object_id_t switch_id)
 {
     NDI_INIT_LOG_TRACE("Calling switch shutdown request from SAI\n");
+
+    /* Stop the periodic save and write the final checkpoint so that the
+     * NDI caches can be reloaded on warm restart */
+    if (nas_ndi_checkpoint_shutdown() != STD_ERR_OK) {
+        NDI_INIT_LOG_ERROR("Failed to save NDI checkpoint on switch shutdown\n");
+    }
 }
 
 
@@ -451,6 +460,18 @@ t_std_error ndi_initialize_switch(nas_ndi_db_t *ndi_db_ptr)
     return STD_ERR_OK;
 }
 
+/* Monotonic time in usec, used to log time taken by each init phase */
+static uint64_t ndi_init_time_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+#define NDI_INIT_PHASE_LOG(phase, start_usec) \
+    NDI_INIT_LOG_INFO("nas ndi init phase %s took %" PRIu64 " usec", (phase), \
+                      ndi_init_time_usec() - (start_usec))
+
 t_std_error nas_ndi_init(void)
 {
     t_std_error ret_code = STD_ERR_OK;
@@ -459,11 +480,14 @@ t_std_error nas_ndi_init(void)
     npu_id_t npu_idx = 0;
     nas_ndi_db_t *ndi_db_ptr = NULL;
     uint32_t switch_id = 0;
+    uint64_t init_start_usec = ndi_init_time_usec();
+    uint64_t phase_start_usec = init_start_usec;
 
     /*  first read NPU count and NPU type from config file.*/
     NDI_INIT_LOG_TRACE("nas ndi initialization\n");
 
     nas_ndi_populate_cfg_key_value_pair (switch_id);
+    NDI_INIT_PHASE_LOG("cfg key value", phase_start_usec);
 
     /*  @todo TODO number of npus should be read from the config file */
     no_of_npu = 1;
@@ -493,6 +517,7 @@ t_std_error nas_ndi_init(void)
 
     for (npu_idx = 0; npu_idx < no_of_npu; npu_idx++) {
 
+        phase_start_usec = ndi_init_time_usec();
         ndi_db_ptr = ndi_db_ptr_get(npu_idx);
         ndi_db_ptr->npu_profile_id = (sai_switch_profile_id_t )npu_idx;
 
@@ -521,6 +546,9 @@ t_std_error nas_ndi_init(void)
             break;
         }
         NDI_INIT_LOG_TRACE("sai api method table init passed\n");
+        NDI_INIT_PHASE_LOG("sai api init", phase_start_usec);
+
+        phase_start_usec = ndi_init_time_usec();
 
         /* Key-value pair is used by sai after and during sai_initialize_switch()  */
         /* call sai_initialize_switch() with profile id, switch_hardware_id, microcode, callback table */
@@ -528,6 +556,9 @@ t_std_error nas_ndi_init(void)
             NDI_INIT_LOG_ERROR("sai switch initialization failure\n");
             break;
         }
+        NDI_INIT_PHASE_LOG("sai switch init", phase_start_usec);
+
+        phase_start_usec = ndi_init_time_usec();
 
         // Initialize FC specfic APIs
         if ((ret_code = ndi_sai_fc_apis_init()) != STD_ERR_OK) {
@@ -539,6 +570,7 @@ t_std_error nas_ndi_init(void)
             NDI_INIT_LOG_ERROR("sai FC switch initialization failure\n");
             break;
         }
+        NDI_INIT_PHASE_LOG("sai FC init", phase_start_usec);
         NDI_INIT_LOG_TRACE("sai instance and npu # %d init passed\n", npu_idx);
     }
 
@@ -561,14 +593,42 @@ t_std_error nas_ndi_init(void)
             return ret_code;
         }
 
+        phase_start_usec = ndi_init_time_usec();
         if ((ret_code = ndi_sai_port_map_create()) != STD_ERR_OK) {
              NDI_INIT_LOG_TRACE("Unable to create sai_port_map %d \n", ret_code);
              return ret_code;
         }
+        NDI_INIT_PHASE_LOG("port map", phase_start_usec);
+
+        /* On warm boot reload NDI caches instead of rediscovering them */
+        if (nas_ndi_checkpoint_is_warm_boot()) {
+            phase_start_usec = ndi_init_time_usec();
+            if (nas_ndi_checkpoint_restore(NULL) != STD_ERR_OK) {
+                NDI_INIT_LOG_ERROR("Unable to restore NDI caches from checkpoint, "
+                                   "using cold discovery\n");
+            }
+            NDI_INIT_PHASE_LOG("checkpoint restore", phase_start_usec);
+        }
+
+        phase_start_usec = ndi_init_time_usec();
         if ((ret_code = ndi_init_brport_for_1Q()) != STD_ERR_OK) {
              NDI_INIT_LOG_TRACE("Unable to init bridgeport for 1Q %d \n", ret_code);
              return ret_code;
         }
+        NDI_INIT_PHASE_LOG("1Q bridge ports", phase_start_usec);
+
+        /* FDB shadow reads the SAI FDB table when it gets enabled */
+        ndi_fdb_shadow_seed_fn_set(ndi_mac_fdb_shadow_seed);
+
+        if ((ret_code = ndi_mac_async_init()) != STD_ERR_OK) {
+            NDI_INIT_LOG_ERROR("Unable to register MAC async handlers %d\n", ret_code);
+            return ret_code;
+        }
+
+        if (nas_ndi_checkpoint_start(0) != STD_ERR_OK) {
+            NDI_INIT_LOG_ERROR("Unable to start periodic NDI checkpoint save\n");
+        }
     }
+    NDI_INIT_PHASE_LOG("total", init_start_usec);
     return ret_code;
 }
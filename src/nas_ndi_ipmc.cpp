@@ -23,12 +23,17 @@
 #include "nas_ndi_ipmc_utl.h"
 #include "nas_ndi_event_logs.h"
 #include "nas_ndi_bridge_port.h"
+#include "std_rw_lock.h"
 
 #include <functional>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
 #include <inttypes.h>
+#include <pthread.h>
 
 ndi_cache_grp_mbr_t::operator std::string() const
 {
@@ -112,82 +117,155 @@ cached_ipmc_entry_map<T>::operator std::string() const
     return ss.str();
 }
 
+static inline size_t _ipmc_cache_shard_index(size_t h_val)
+{
+    /* Mix the hash, object IDs only differ in low bits */
+    uint64_t val = h_val;
+    val ^= val >> 33;
+    val *= 0xff51afd7ed558ccdULL;
+    val ^= val >> 33;
+    return static_cast<size_t>(val % repl_group_cache::SHARD_COUNT);
+}
+
+/*
+ * Lookups are far more frequent than updates, prefer writers so that continuous
+ * lookups do not starve join/prune. Read lock must not be taken recursively.
+ */
+static void _ipmc_cache_rw_lock_init(std_rw_lock_t *rw_lock)
+{
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init(rw_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+repl_group_cache::grp_shard_t::grp_shard_t()
+{
+    _ipmc_cache_rw_lock_init(&rw_lock);
+}
+
+repl_group_cache::entry_shard_t::entry_shard_t()
+{
+    _ipmc_cache_rw_lock_init(&rw_lock);
+}
+
+repl_group_cache::grp_shard_t& repl_group_cache::get_grp_shard(npu_id_t npu_id,
+                                                               ndi_obj_id_t repl_grp_id) const
+{
+    auto h_val = std::hash<std::pair<npu_id_t, ndi_obj_id_t>>()(std::make_pair(npu_id, repl_grp_id));
+    return _grp_shard[_ipmc_cache_shard_index(h_val)];
+}
+
+repl_group_cache::entry_shard_t& repl_group_cache::get_entry_shard(npu_id_t npu_id,
+                                                                   const ndi_ipmc_entry_t& ipmc_entry)
+{
+    size_t h_val;
+    if (ipmc_entry.dst_ip.af_index == HAL_INET4_FAMILY) {
+        using key_type = cached_ipmc_entry_map<dn_ipv4_addr_t>::key_type;
+        h_val = std::hash<key_type>()(std::make_pair(npu_id, cached_ipmc_af_entry<dn_ipv4_addr_t>{ipmc_entry}));
+    } else {
+        using key_type = cached_ipmc_entry_map<dn_ipv6_addr_t>::key_type;
+        h_val = std::hash<key_type>()(std::make_pair(npu_id, cached_ipmc_af_entry<dn_ipv6_addr_t>{ipmc_entry}));
+    }
+    return _entry_shard[_ipmc_cache_shard_index(h_val)];
+}
+
+repl_group_cache::grp_ptr_t repl_group_cache::find_repl_group(npu_id_t npu_id,
+                                                              ndi_obj_id_t repl_grp_id) const
+{
+    auto& shard = get_grp_shard(npu_id, repl_grp_id);
+    std_rw_lock_read_guard lock(&shard.rw_lock);
+    auto itor = shard.repl_grp_list.find(std::make_pair(npu_id, repl_grp_id));
+    if (itor == shard.repl_grp_list.end()) {
+        return nullptr;
+    }
+    return itor->second;
+}
+
+static ndi_cache_repl_grp_t::mbr_list_t* _ipmc_cache_mbr_list(ndi_cache_repl_grp_t& repl_grp,
+                                                             ndi_mc_grp_mbr_type_t mbr_type)
+{
+    switch(mbr_type) {
+    case NDI_RPF_GRP_MBR:
+        return &repl_grp.rpf_mbr_list;
+    case NDI_IPMC_GRP_MBR:
+        return &repl_grp.ipmc_mbr_list;
+    default:
+        NDI_MCAST_LOG_ERROR("Invalid group member type");
+        return nullptr;
+    }
+}
+
 bool repl_group_cache::add_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
                                       ndi_obj_id_t rpf_grp_id, ndi_obj_id_t ipmc_grp_id)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    if (_repl_grp_list.find(std::make_pair(npu_id, repl_grp_id)) != _repl_grp_list.end()) {
+    auto& shard = get_grp_shard(npu_id, repl_grp_id);
+    std_rw_lock_write_guard lock(&shard.rw_lock);
+    if (shard.repl_grp_list.find(std::make_pair(npu_id, repl_grp_id)) != shard.repl_grp_list.end()) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld already exists in cache", repl_grp_id);
         return false;
     }
-    _repl_grp_list.insert({std::make_pair(npu_id, repl_grp_id),
-                           std::make_shared<ndi_cache_repl_grp_t>(repl_grp_id, rpf_grp_id, ipmc_grp_id)});
+    shard.repl_grp_list.insert({std::make_pair(npu_id, repl_grp_id),
+                               std::make_shared<ndi_cache_repl_grp_t>(repl_grp_id, rpf_grp_id, ipmc_grp_id)});
     return true;
 }
 
 bool repl_group_cache::add_rpf_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_obj_id_t mbr_id,
                                             const ndi_mc_grp_mbr_t& grp_mbr)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    if (!_repl_grp_list[grp_key]->rpf_mbr_list.empty()) {
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    if (!repl_grp->rpf_mbr_list.empty()) {
         NDI_MCAST_LOG_ERROR("Could not add multiple RPF group to replication group");
         return false;
     }
 
-    _repl_grp_list[grp_key]->rpf_mbr_list.emplace(grp_mbr.rif_id, ndi_cache_grp_mbr_t{mbr_id, grp_mbr.rif_id, grp_mbr.port_list});
+    repl_grp->rpf_mbr_list.emplace(grp_mbr.rif_id, ndi_cache_grp_mbr_t{mbr_id, grp_mbr.rif_id, grp_mbr.port_list});
     return true;
 }
 
 bool repl_group_cache::add_ipmc_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_obj_id_t mbr_id,
                                              const ndi_mc_grp_mbr_t& grp_mbr)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    if (_repl_grp_list[grp_key]->ipmc_mbr_list.find(grp_mbr.rif_id) != _repl_grp_list[grp_key]->ipmc_mbr_list.end()) {
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    if (repl_grp->ipmc_mbr_list.find(grp_mbr.rif_id) != repl_grp->ipmc_mbr_list.end()) {
         NDI_MCAST_LOG_ERROR("IPMC group with RIF ID %ld alreay exists in replication group %ld", grp_mbr.rif_id, repl_grp_id);
         return false;
     }
-    _repl_grp_list[grp_key]->ipmc_mbr_list.emplace(grp_mbr.rif_id, ndi_cache_grp_mbr_t{mbr_id, grp_mbr.rif_id, grp_mbr.port_list});
+    repl_grp->ipmc_mbr_list.emplace(grp_mbr.rif_id, ndi_cache_grp_mbr_t{mbr_id, grp_mbr.rif_id, grp_mbr.port_list});
     return true;
 }
 
 bool repl_group_cache::update_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id, ndi_mc_grp_mbr_type_t mbr_type,
                                            ndi_rif_id_t rif_id, const ndi_sw_port_list_t& port_list)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    auto repl_grp = _repl_grp_list[grp_key];
-    ndi_cache_repl_grp_t::mbr_list_t* p_mbr_list;
-    switch(mbr_type) {
-    case NDI_RPF_GRP_MBR:
-        p_mbr_list = &repl_grp->rpf_mbr_list;
-        break;
-    case NDI_IPMC_GRP_MBR:
-        p_mbr_list = &repl_grp->ipmc_mbr_list;
-        break;
-    default:
-        NDI_MCAST_LOG_ERROR("Invalid group member type");
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
         return false;
     }
 
-    if (p_mbr_list->find(rif_id) == p_mbr_list->end()) {
+    auto itor = p_mbr_list->find(rif_id);
+    if (itor == p_mbr_list->end()) {
         NDI_MCAST_LOG_ERROR("RIF ID %ld not found in group member list", rif_id);
         return false;
     }
-    p_mbr_list->at(rif_id).update_port_list(port_list);
+    itor->second.update_port_list(port_list);
 
     return true;
 }
@@ -195,72 +273,84 @@ bool repl_group_cache::update_group_member(npu_id_t npu_id, ndi_obj_id_t repl_gr
 bool repl_group_cache::del_group_member(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
                                 ndi_mc_grp_mbr_type_t mbr_type, ndi_rif_id_t rif_id)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    auto repl_grp = _repl_grp_list[grp_key];
-    ndi_cache_repl_grp_t::mbr_list_t* p_mbr_list;
-    switch(mbr_type) {
-    case NDI_RPF_GRP_MBR:
-        p_mbr_list = &repl_grp->rpf_mbr_list;
-        break;
-    case NDI_IPMC_GRP_MBR:
-        p_mbr_list = &repl_grp->ipmc_mbr_list;
-        break;
-    default:
-        NDI_MCAST_LOG_ERROR("Invalid group member type");
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
         return false;
     }
 
-    if (p_mbr_list->find(rif_id) == p_mbr_list->end()) {
+    if (p_mbr_list->erase(rif_id) == 0) {
         NDI_MCAST_LOG_ERROR("RIF ID %ld not found in group member list", rif_id);
         return false;
     }
-    p_mbr_list->erase(rif_id);
 
     return true;
 }
 
 bool repl_group_cache::del_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
-        NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
-        return false;
+    grp_ptr_t repl_grp;
+    {
+        auto& shard = get_grp_shard(npu_id, repl_grp_id);
+        std_rw_lock_write_guard lock(&shard.rw_lock);
+        auto itor = shard.repl_grp_list.find(std::make_pair(npu_id, repl_grp_id));
+        if (itor == shard.repl_grp_list.end()) {
+            NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
+            return false;
+        }
+        repl_grp = itor->second;
+        shard.repl_grp_list.erase(itor);
     }
-    _repl_grp_list.erase(grp_key);
+    /* Entry add that already found the group would fail */
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    repl_grp->deleted = true;
 
     return true;
 }
 
+/* Group could be updated or deleted once the locks are released, a copy taken
+ * under the group lock is returned */
+ndi_cache_repl_grp_t repl_group_cache::get_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_grp_id) const
+{
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
+        throw std::out_of_range{"Replication group " + std::to_string(repl_grp_id) + " not found"};
+    }
+
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    return *repl_grp;
+}
+
 bool repl_group_cache::is_repl_group_used(npu_id_t npu_id, ndi_obj_id_t repl_grp_id)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
 
-    auto repl_grp = _repl_grp_list[grp_key];
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
     return !(repl_grp->ipmc_ipv4_entry_list.empty() && repl_grp->ipmc_ipv6_entry_list.empty());
 }
 
 bool repl_group_cache::get_sub_group_id(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
                                         ndi_obj_id_t& rpf_grp_id, ndi_obj_id_t& ipmc_grp_id) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto& shard = get_grp_shard(npu_id, repl_grp_id);
+    std_rw_lock_read_guard lock(&shard.rw_lock);
+    auto itor = shard.repl_grp_list.find(std::make_pair(npu_id, repl_grp_id));
+    if (itor == shard.repl_grp_list.end()) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    rpf_grp_id = _repl_grp_list.at(grp_key)->rpf_grp_id;
-    ipmc_grp_id = _repl_grp_list.at(grp_key)->ipmc_grp_id;
+    /* Sub group IDs are not changed after group is added */
+    rpf_grp_id = itor->second->rpf_grp_id;
+    ipmc_grp_id = itor->second->ipmc_grp_id;
 
     return true;
 }
@@ -268,30 +358,21 @@ bool repl_group_cache::get_sub_group_id(npu_id_t npu_id, ndi_obj_id_t repl_grp_i
 std::vector<ndi_obj_id_t> repl_group_cache::get_group_member_list(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
                                                                   ndi_mc_grp_mbr_type_t mbr_type) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return std::vector<ndi_obj_id_t>{};
     }
 
-    auto& repl_grp = _repl_grp_list.at(grp_key);
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
     std::vector<ndi_obj_id_t> mbr_id_list{};
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
+        return mbr_id_list;
+    }
     auto conv_func = [](const std::pair<ndi_rif_id_t, ndi_cache_grp_mbr_t>& mbr)->ndi_obj_id_t{
         return mbr.second.mbr_id;};
-    switch(mbr_type) {
-    case NDI_RPF_GRP_MBR:
-        std::transform(repl_grp->rpf_mbr_list.begin(), repl_grp->rpf_mbr_list.end(),
-                       std::back_inserter(mbr_id_list), conv_func);
-        break;
-    case NDI_IPMC_GRP_MBR:
-        std::transform(repl_grp->ipmc_mbr_list.begin(), repl_grp->ipmc_mbr_list.end(),
-                       std::back_inserter(mbr_id_list), conv_func);
-        break;
-    default:
-        NDI_MCAST_LOG_ERROR("Invalid group member type");
-        break;
-    }
+    std::transform(p_mbr_list->begin(), p_mbr_list->end(), std::back_inserter(mbr_id_list), conv_func);
 
     return mbr_id_list;
 }
@@ -300,50 +381,92 @@ bool repl_group_cache::get_group_rif_member(npu_id_t npu_id, ndi_obj_id_t repl_g
                                             ndi_mc_grp_mbr_type_t mbr_type, ndi_rif_id_t rif_id,
                                             ndi_obj_id_t& mbr_id)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, repl_grp_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
         return false;
     }
-    auto repl_grp = _repl_grp_list[grp_key];
-    ndi_cache_repl_grp_t::mbr_list_t* p_mbr_list;
-    switch(mbr_type) {
-    case NDI_RPF_GRP_MBR:
-        p_mbr_list = &repl_grp->rpf_mbr_list;
-        break;
-    case NDI_IPMC_GRP_MBR:
-        p_mbr_list = &repl_grp->ipmc_mbr_list;
-        break;
-    default:
-        NDI_MCAST_LOG_ERROR("Invalid group member type");
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
         return false;
     }
 
-    if (p_mbr_list->find(rif_id) == p_mbr_list->end()) {
+    auto itor = p_mbr_list->find(rif_id);
+    if (itor == p_mbr_list->end()) {
         NDI_MCAST_LOG_ERROR("RIF ID %ld not found in group member list", rif_id);
         return false;
     }
-    mbr_id = p_mbr_list->at(rif_id).mbr_id;
+    mbr_id = itor->second.mbr_id;
 
     return true;
 }
 
-bool repl_group_cache::add_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry)
+bool repl_group_cache::get_group_member_info(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                             ndi_mc_grp_mbr_type_t mbr_type,
+                                             ndi_cache_repl_grp_t::mbr_list_t& mbr_list) const
+{
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
+        NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
+        return false;
+    }
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
+        return false;
+    }
+    mbr_list = *p_mbr_list;
+
+    return true;
+}
+
+bool repl_group_cache::update_group_member_list(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                                ndi_mc_grp_mbr_type_t mbr_type,
+                                                const std::vector<ndi_rif_id_t>& del_rif_list,
+                                                const std::vector<ndi_cache_grp_mbr_t>& set_mbr_list)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto grp_key = std::make_pair(npu_id, ipmc_entry.repl_group_id);
-    if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+    auto repl_grp = find_repl_group(npu_id, repl_grp_id);
+    if (!repl_grp) {
+        NDI_MCAST_LOG_ERROR("Replication group of ID %ld not found in cache", repl_grp_id);
+        return false;
+    }
+    std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+    auto p_mbr_list = _ipmc_cache_mbr_list(*repl_grp, mbr_type);
+    if (p_mbr_list == nullptr) {
+        return false;
+    }
+    for (auto rif_id: del_rif_list) {
+        p_mbr_list->erase(rif_id);
+    }
+    for (auto& grp_mbr: set_mbr_list) {
+        (*p_mbr_list)[grp_mbr.rif_id] = grp_mbr;
+    }
+
+    return true;
+}
+
+bool repl_group_cache::add_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id,
+                                             const ndi_ipmc_entry_t& ipmc_entry, const grp_ptr_t& repl_grp)
+{
+    if (!repl_grp) {
         NDI_MCAST_LOG_ERROR("Replication group %ld in entry does not exist",
                             ipmc_entry.repl_group_id);
         return false;
     }
-    auto& repl_grp = _repl_grp_list[grp_key];
-    auto& grp_entry_list = repl_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
-    if (!grp_entry_list.add_entry(npu_id, ipmc_entry)) {
-        return false;
+    {
+        std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
+        if (repl_grp->deleted) {
+            NDI_MCAST_LOG_ERROR("Replication group %ld in entry is being deleted",
+                                ipmc_entry.repl_group_id);
+            return false;
+        }
+        auto& grp_entry_list = repl_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+        if (!grp_entry_list.add_entry(npu_id, ipmc_entry)) {
+            return false;
+        }
     }
-    auto& entry_list = get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+    auto& entry_list = shard.get_cached_entry_list(ipmc_entry.dst_ip.af_index);
     if (!entry_list.add_entry(npu_id, ipmc_entry, repl_grp)) {
         return false;
     }
@@ -351,12 +474,13 @@ bool repl_group_cache::add_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& i
     return true;
 }
 
-bool repl_group_cache::del_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry)
+bool repl_group_cache::del_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id,
+                                             const ndi_ipmc_entry_t& ipmc_entry)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto& entry_list = get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+    auto& entry_list = shard.get_cached_entry_list(ipmc_entry.dst_ip.af_index);
     try {
         auto& repl_grp = entry_list.get_repl_grp_obj(npu_id, ipmc_entry);
+        std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
         auto& grp_entry_list = repl_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
         if (!grp_entry_list.delete_entry(npu_id, ipmc_entry)) {
             return false;
@@ -372,23 +496,21 @@ bool repl_group_cache::del_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& i
     return true;
 }
 
-bool repl_group_cache::update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
-                                         ndi_ipmc_update_type_t upd_type)
+bool repl_group_cache::update_ipmc_entry_locked(entry_shard_t& shard, npu_id_t npu_id,
+                                                const ndi_ipmc_entry_t& ipmc_entry,
+                                                ndi_ipmc_update_type_t upd_type, const grp_ptr_t& new_grp)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
     switch(upd_type) {
     case NAS_NDI_IPMC_UPD_REPL_GRP:
     {
-
-        auto grp_key = std::make_pair(npu_id, ipmc_entry.repl_group_id);
-        if (_repl_grp_list.find(grp_key) == _repl_grp_list.end()) {
+        if (!new_grp) {
             NDI_MCAST_LOG_ERROR("Group to be replaced not exists");
             return false;
         }
-        auto new_grp = _repl_grp_list[grp_key];
-        auto& entry_list = get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+        auto& entry_list = shard.get_cached_entry_list(ipmc_entry.dst_ip.af_index);
         try {
             auto& orig_grp = entry_list.get_repl_grp_obj(npu_id, ipmc_entry);
+            std::lock_guard<std::mutex> grp_lock(orig_grp->grp_lock.mutex());
             auto& grp_entry_list = orig_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
             if (!grp_entry_list.delete_entry(npu_id, ipmc_entry)) {
                 return false;
@@ -396,9 +518,12 @@ bool repl_group_cache::update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t
         } catch (std::out_of_range& ex) {
             return false;
         }
-        auto& grp_entry_list = new_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
-        if (!grp_entry_list.add_entry(npu_id, ipmc_entry)) {
-            return false;
+        {
+            std::lock_guard<std::mutex> grp_lock(new_grp->grp_lock.mutex());
+            auto& grp_entry_list = new_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+            if (new_grp->deleted || !grp_entry_list.add_entry(npu_id, ipmc_entry)) {
+                return false;
+            }
         }
 
         if (!entry_list.update_entry_repl_grp(npu_id, ipmc_entry, new_grp)) {
@@ -408,9 +533,10 @@ bool repl_group_cache::update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t
     }
     case NAS_NDI_IPMC_UPD_COPY_TO_CPU:
     {
-        auto& entry_list = get_cached_entry_list(ipmc_entry.dst_ip.af_index);
+        auto& entry_list = shard.get_cached_entry_list(ipmc_entry.dst_ip.af_index);
         try {
             auto& repl_grp = entry_list.get_repl_grp_obj(npu_id, ipmc_entry);
+            std::lock_guard<std::mutex> grp_lock(repl_grp->grp_lock.mutex());
             auto& grp_entry_list = repl_grp->get_cached_entry_list(ipmc_entry.dst_ip.af_index);
             if (!grp_entry_list.update_entry_copy_to_cpu(npu_id, ipmc_entry)) {
                 return false;
@@ -431,10 +557,116 @@ bool repl_group_cache::update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t
     return true;
 }
 
+bool repl_group_cache::add_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry)
+{
+    auto& shard = get_entry_shard(npu_id, ipmc_entry);
+    std_rw_lock_write_guard lock(&shard.rw_lock);
+    return add_ipmc_entry_locked(shard, npu_id, ipmc_entry,
+                                 find_repl_group(npu_id, ipmc_entry.repl_group_id));
+}
+
+bool repl_group_cache::del_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry)
+{
+    auto& shard = get_entry_shard(npu_id, ipmc_entry);
+    std_rw_lock_write_guard lock(&shard.rw_lock);
+    return del_ipmc_entry_locked(shard, npu_id, ipmc_entry);
+}
+
+bool repl_group_cache::update_ipmc_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry,
+                                         ndi_ipmc_update_type_t upd_type)
+{
+    auto& shard = get_entry_shard(npu_id, ipmc_entry);
+    std_rw_lock_write_guard lock(&shard.rw_lock);
+    grp_ptr_t new_grp{};
+    if (upd_type == NAS_NDI_IPMC_UPD_REPL_GRP) {
+        new_grp = find_repl_group(npu_id, ipmc_entry.repl_group_id);
+    }
+    return update_ipmc_entry_locked(shard, npu_id, ipmc_entry, upd_type, new_grp);
+}
+
+/*
+ * Call fn for each entry with its shard write locked, each shard is locked
+ * once. Entries of a shard are handled in list order.
+ */
+template<typename F>
+size_t repl_group_cache::walk_entry_shard(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list,
+                                          F fn)
+{
+    std::vector<std::pair<size_t, size_t>> shard_order{};
+    shard_order.reserve(entry_list.size());
+    for (size_t idx = 0; idx < entry_list.size(); idx ++) {
+        auto shard_idx = &get_entry_shard(npu_id, entry_list[idx]) - _entry_shard;
+        shard_order.emplace_back(static_cast<size_t>(shard_idx), idx);
+    }
+    std::sort(shard_order.begin(), shard_order.end());
+
+    size_t done_cnt = 0;
+    for (size_t start = 0; start < shard_order.size();) {
+        auto shard_idx = shard_order[start].first;
+        auto& shard = _entry_shard[shard_idx];
+        std_rw_lock_write_guard lock(&shard.rw_lock);
+        for (; start < shard_order.size() && shard_order[start].first == shard_idx; start ++) {
+            if (fn(shard, entry_list[shard_order[start].second])) {
+                done_cnt ++;
+            }
+        }
+    }
+    return done_cnt;
+}
+
+/* Replication groups of a batch, looked up once per group */
+std::unordered_map<ndi_obj_id_t, repl_group_cache::grp_ptr_t>
+repl_group_cache::find_repl_group_list(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list) const
+{
+    std::unordered_map<ndi_obj_id_t, grp_ptr_t> grp_map{};
+    for (auto& entry: entry_list) {
+        if (grp_map.find(entry.repl_group_id) == grp_map.end()) {
+            grp_map[entry.repl_group_id] = find_repl_group(npu_id, entry.repl_group_id);
+        }
+    }
+    return grp_map;
+}
+
+size_t repl_group_cache::add_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list)
+{
+    auto grp_map = find_repl_group_list(npu_id, entry_list);
+    return walk_entry_shard(npu_id, entry_list,
+            [&](entry_shard_t& shard, const ndi_ipmc_entry_t& ipmc_entry) {
+                return add_ipmc_entry_locked(shard, npu_id, ipmc_entry, grp_map[ipmc_entry.repl_group_id]);
+            });
+}
+
+size_t repl_group_cache::del_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list)
+{
+    return walk_entry_shard(npu_id, entry_list,
+            [&](entry_shard_t& shard, const ndi_ipmc_entry_t& ipmc_entry) {
+                return del_ipmc_entry_locked(shard, npu_id, ipmc_entry);
+            });
+}
+
+size_t repl_group_cache::update_ipmc_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list,
+                                             ndi_ipmc_update_type_t upd_type)
+{
+    std::unordered_map<ndi_obj_id_t, grp_ptr_t> grp_map{};
+    if (upd_type == NAS_NDI_IPMC_UPD_REPL_GRP) {
+        grp_map = find_repl_group_list(npu_id, entry_list);
+    }
+    return walk_entry_shard(npu_id, entry_list,
+            [&](entry_shard_t& shard, const ndi_ipmc_entry_t& ipmc_entry) {
+                grp_ptr_t new_grp{};
+                auto itor = grp_map.find(ipmc_entry.repl_group_id);
+                if (itor != grp_map.end()) {
+                    new_grp = itor->second;
+                }
+                return update_ipmc_entry_locked(shard, npu_id, ipmc_entry, upd_type, new_grp);
+            });
+}
+
 bool repl_group_cache::get_ipmc_entry(npu_id_t npu_id, ndi_ipmc_entry_t& ipmc_entry)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    return get_cached_entry_list(ipmc_entry.dst_ip.af_index).get_entry(npu_id, ipmc_entry);
+    auto& shard = get_entry_shard(npu_id, ipmc_entry);
+    std_rw_lock_read_guard lock(&shard.rw_lock);
+    return shard.get_cached_entry_list(ipmc_entry.dst_ip.af_index).get_entry(npu_id, ipmc_entry);
 }
 
 void repl_group_cache::dump_ipmc_group() const
@@ -442,29 +674,59 @@ void repl_group_cache::dump_ipmc_group() const
     std::cout << "==========================" << std::endl;
     std::cout << "  Replication Groups" << std::endl;
     std::cout << "==========================" << std::endl;
-    for (auto& group: _repl_grp_list) {
-        std::cout << "NPU-" << group.first.first << " "
+    walk_repl_group([](npu_id_t npu_id, const ndi_cache_repl_grp_t& group) {
+        std::cout << "NPU-" << npu_id << " "
                   << "ID-" << std::hex << std::showbase
-                  << group.first.second << " "
+                  << group.repl_grp_id << " "
                   << std::dec << std::noshowbase
-                  << std::string(*group.second) << std::endl;
-    }
+                  << std::string(group) << std::endl;
+    });
 }
 
 void repl_group_cache::dump_ipmc_entry(int af_index) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
     if (af_index == 0 || af_index == AF_INET) {
         std::cout << "==========================" << std::endl;
         std::cout << "  IPv4 multicast entries" << std::endl;
         std::cout << "==========================" << std::endl;
-        std::cout << std::string(_ipmc_ipv4_entry_list) << std::endl;
+        for (auto& shard: _entry_shard) {
+            std_rw_lock_read_guard lock(&shard.rw_lock);
+            std::cout << std::string(shard.ipmc_ipv4_entry_list);
+        }
+        std::cout << std::endl;
     }
     if (af_index == 0 || af_index == AF_INET6) {
         std::cout << "==========================" << std::endl;
         std::cout << "  IPv6 multicast entries" << std::endl;
         std::cout << "==========================" << std::endl;
-        std::cout << std::string(_ipmc_ipv6_entry_list) << std::endl;
+        for (auto& shard: _entry_shard) {
+            std_rw_lock_read_guard lock(&shard.rw_lock);
+            std::cout << std::string(shard.ipmc_ipv6_entry_list);
+        }
+        std::cout << std::endl;
+    }
+}
+
+void repl_group_cache::walk_repl_group(const grp_walk_fn& fn) const
+{
+    for (auto& shard: _grp_shard) {
+        std_rw_lock_read_guard lock(&shard.rw_lock);
+        for (auto& group: shard.repl_grp_list) {
+            std::lock_guard<std::mutex> grp_lock(group.second->grp_lock.mutex());
+            fn(group.first.first, *group.second);
+        }
+    }
+}
+
+void repl_group_cache::walk_ipmc_entry(const entry_walk_fn& fn) const
+{
+    for (auto& shard: _entry_shard) {
+        std_rw_lock_read_guard lock(&shard.rw_lock);
+        shard.ipmc_ipv4_entry_list.walk(fn);
+    }
+    for (auto& shard: _entry_shard) {
+        std_rw_lock_read_guard lock(&shard.rw_lock);
+        shard.ipmc_ipv6_entry_list.walk(fn);
     }
 }
 
@@ -1031,6 +1293,109 @@ t_std_error ndi_update_repl_group(npu_id_t npu_id, ndi_obj_id_t repl_group_id,
     return STD_ERR_OK;
 }
 
+t_std_error ndi_set_repl_group_members(npu_id_t npu_id, ndi_obj_id_t repl_group_id,
+                                       ndi_mc_grp_mbr_type_t mbr_type,
+                                       size_t grp_mbr_cnt, ndi_mc_grp_mbr_t *grp_mbr_list)
+{
+    NDI_MCAST_LOG_INFO("Set replication group members");
+    NDI_MCAST_LOG_INFO("Group ID: 0x%" PRIx64, repl_group_id);
+    NDI_MCAST_LOG_INFO("Member Type: %s", mbr_type == NDI_RPF_GRP_MBR ? "RPF" : "IPMC");
+
+    if (grp_mbr_cnt > 0 && grp_mbr_list == nullptr) {
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+    if (mbr_type != NDI_RPF_GRP_MBR && mbr_type != NDI_IPMC_GRP_MBR) {
+        NDI_MCAST_LOG_ERROR("Invalid member type");
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+    if (mbr_type == NDI_RPF_GRP_MBR && grp_mbr_cnt > 1) {
+        NDI_MCAST_LOG_ERROR("Could not add multiple RPF group to replication group");
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+
+    ndi_obj_id_t rpf_grp_id, ipmc_grp_id;
+    ndi_cache_repl_grp_t::mbr_list_t cur_mbr_list{};
+    if (!ipmc_cache.get_sub_group_id(npu_id, repl_group_id, rpf_grp_id, ipmc_grp_id) ||
+        !ipmc_cache.get_group_member_info(npu_id, repl_group_id, mbr_type, cur_mbr_list)) {
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+    auto group_id = (mbr_type == NDI_RPF_GRP_MBR ? rpf_grp_id : ipmc_grp_id);
+
+    /* Membership delta against the cache */
+    std::vector<ndi_mc_grp_mbr_t*> add_list{}, upd_list{};
+    std::vector<ndi_obj_id_t> del_list{};
+    std::unordered_set<ndi_rif_id_t> rif_set{};
+    for (size_t idx = 0; idx < grp_mbr_cnt; idx ++) {
+        auto& grp_mbr = grp_mbr_list[idx];
+        NDI_MCAST_LOG_INFO("  %s", dump_grp_mbr_info(grp_mbr).c_str());
+        if (!rif_set.insert(grp_mbr.rif_id).second) {
+            NDI_MCAST_LOG_ERROR("Duplicate group member with RIF ID %ld", grp_mbr.rif_id);
+            return STD_ERR(MCAST, PARAM, 0);
+        }
+        auto itor = cur_mbr_list.find(grp_mbr.rif_id);
+        if (itor == cur_mbr_list.end()) {
+            add_list.push_back(&grp_mbr);
+        } else if (ndi_cache_grp_mbr_t{0, grp_mbr.rif_id, grp_mbr.port_list}.port_list !=
+                   itor->second.port_list) {
+            upd_list.push_back(&grp_mbr);
+        }
+    }
+    std::vector<ndi_rif_id_t> del_rif_list{};
+    for (auto& cur_mbr: cur_mbr_list) {
+        if (rif_set.find(cur_mbr.first) == rif_set.end()) {
+            del_list.push_back(cur_mbr.second.mbr_id);
+            del_rif_list.push_back(cur_mbr.first);
+        }
+    }
+    NDI_MCAST_LOG_INFO("Members to add %lu, delete %lu, update %lu, unchanged %lu",
+                       add_list.size(), del_list.size(), upd_list.size(),
+                       grp_mbr_cnt - add_list.size() - upd_list.size());
+
+    /* Members are removed first, so that RPF member could be replaced */
+    t_std_error rc = STD_ERR_OK;
+    std::vector<ndi_rif_id_t> done_del_list{};
+    std::vector<ndi_cache_grp_mbr_t> done_set_list{};
+    for (size_t idx = 0; idx < del_list.size(); idx ++) {
+        auto mbr_rc = ndi_delete_group_member(npu_id, mbr_type, del_list[idx]);
+        if (mbr_rc != STD_ERR_OK) {
+            NDI_MCAST_LOG_ERROR("Failed to delete group member, ID=0x%" PRIx64, del_list[idx]);
+            rc = (rc == STD_ERR_OK ? mbr_rc : rc);
+            continue;
+        }
+        done_del_list.push_back(del_rif_list[idx]);
+    }
+    for (auto grp_mbr: upd_list) {
+        auto mbr_id = cur_mbr_list.at(grp_mbr->rif_id).mbr_id;
+        auto mbr_rc = ndi_update_group_member(npu_id, mbr_type, mbr_id, grp_mbr->rif_id,
+                                              &grp_mbr->port_list);
+        if (mbr_rc != STD_ERR_OK) {
+            NDI_MCAST_LOG_ERROR("Failed to update group member, ID=0x%" PRIx64, mbr_id);
+            rc = (rc == STD_ERR_OK ? mbr_rc : rc);
+            continue;
+        }
+        done_set_list.emplace_back(mbr_id, grp_mbr->rif_id, grp_mbr->port_list);
+    }
+    for (auto grp_mbr: add_list) {
+        ndi_obj_id_t mbr_id;
+        auto mbr_rc = ndi_add_group_member(npu_id, group_id, grp_mbr->rif_id, &grp_mbr->port_list,
+                                           mbr_type, &mbr_id);
+        if (mbr_rc != STD_ERR_OK) {
+            NDI_MCAST_LOG_ERROR("Failed to add group member with RIF ID %ld", grp_mbr->rif_id);
+            rc = (rc == STD_ERR_OK ? mbr_rc : rc);
+            continue;
+        }
+        done_set_list.emplace_back(mbr_id, grp_mbr->rif_id, grp_mbr->port_list);
+    }
+
+    if (!ipmc_cache.update_group_member_list(npu_id, repl_group_id, mbr_type, done_del_list,
+                                             done_set_list)) {
+        NDI_MCAST_LOG_ERROR("Failed to update group members in cache");
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return rc;
+}
+
 t_std_error ndi_ipmc_cache_add_entry(npu_id_t npu_id, const ndi_ipmc_entry_t& ipmc_entry)
 {
     if (!ipmc_cache.add_ipmc_entry(npu_id, ipmc_entry)) {
@@ -1072,7 +1437,44 @@ t_std_error ndi_ipmc_cache_get_entry(npu_id_t npu_id, ndi_ipmc_entry_t& ipmc_ent
     return STD_ERR_OK;
 }
 
-const ndi_cache_repl_grp_t& ndi_ipmc_cache_get_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id)
+t_std_error ndi_ipmc_cache_add_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list)
+{
+    auto done_cnt = ipmc_cache.add_ipmc_entries(npu_id, entry_list);
+    if (done_cnt != entry_list.size()) {
+        NDI_MCAST_LOG_ERROR("Failed to add %lu of %lu IPMC entries to cache",
+                            entry_list.size() - done_cnt, entry_list.size());
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_ipmc_cache_del_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list)
+{
+    auto done_cnt = ipmc_cache.del_ipmc_entries(npu_id, entry_list);
+    if (done_cnt != entry_list.size()) {
+        NDI_MCAST_LOG_ERROR("Failed to delete %lu of %lu IPMC entries from cache",
+                            entry_list.size() - done_cnt, entry_list.size());
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_ipmc_cache_update_entries(npu_id_t npu_id, const std::vector<ndi_ipmc_entry_t>& entry_list,
+                                          ndi_ipmc_update_type_t upd_type)
+{
+    auto done_cnt = ipmc_cache.update_ipmc_entries(npu_id, entry_list, upd_type);
+    if (done_cnt != entry_list.size()) {
+        NDI_MCAST_LOG_ERROR("Failed to update %lu of %lu IPMC entries in cache",
+                            entry_list.size() - done_cnt, entry_list.size());
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
+
+ndi_cache_repl_grp_t ndi_ipmc_cache_get_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id)
 {
     return ipmc_cache.get_repl_group(npu_id, repl_grp_id);
 }
@@ -1086,3 +1488,58 @@ void ndi_ipmc_cache_dump_entry(int af_index)
 {
     ipmc_cache.dump_ipmc_entry(af_index);
 }
+
+void ndi_ipmc_cache_walk_repl_grp(const repl_group_cache::grp_walk_fn& fn)
+{
+    ipmc_cache.walk_repl_group(fn);
+}
+
+void ndi_ipmc_cache_walk_entry(const repl_group_cache::entry_walk_fn& fn)
+{
+    ipmc_cache.walk_ipmc_entry(fn);
+}
+
+t_std_error ndi_ipmc_cache_restore_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                            ndi_obj_id_t rpf_grp_id, ndi_obj_id_t ipmc_grp_id)
+{
+    if (!ipmc_cache.add_repl_group(npu_id, repl_grp_id, rpf_grp_id, ipmc_grp_id)) {
+        NDI_MCAST_LOG_ERROR("Failed to restore replication group 0x%" PRIx64 " to cache",
+                            repl_grp_id);
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_ipmc_cache_discard_repl_grp(npu_id_t npu_id, ndi_obj_id_t repl_grp_id)
+{
+    if (!ipmc_cache.del_repl_group(npu_id, repl_grp_id)) {
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_ipmc_cache_restore_grp_mbr(npu_id_t npu_id, ndi_obj_id_t repl_grp_id,
+                                           ndi_mc_grp_mbr_type_t mbr_type, ndi_obj_id_t mbr_id,
+                                           const ndi_mc_grp_mbr_t& grp_mbr)
+{
+    bool ret = false;
+    switch(mbr_type) {
+    case NDI_RPF_GRP_MBR:
+        ret = ipmc_cache.add_rpf_group_member(npu_id, repl_grp_id, mbr_id, grp_mbr);
+        break;
+    case NDI_IPMC_GRP_MBR:
+        ret = ipmc_cache.add_ipmc_group_member(npu_id, repl_grp_id, mbr_id, grp_mbr);
+        break;
+    default:
+        break;
+    }
+    if (!ret) {
+        NDI_MCAST_LOG_ERROR("Failed to restore group member 0x%" PRIx64 " of replication group 0x%" PRIx64,
+                            mbr_id, repl_grp_id);
+        return STD_ERR(MCAST, FAIL, 0);
+    }
+
+    return STD_ERR_OK;
+}
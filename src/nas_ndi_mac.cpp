@@ -25,6 +25,8 @@
 #include "nas_ndi_utils.h"
 #include "nas_ndi_mac_utl.h"
 #include "nas_ndi_obj_cache.h"
+#include "nas_ndi_fdb_shadow.h"
+#include "nas_ndi_async.h"
 #include "sai.h"
 #include "saistatus.h"
 #include "saitypes.h"
@@ -32,7 +34,18 @@
 #include "nas_ndi_mac_utl.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_set>
 #include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #include <functional>
 #include <string.h>
 #include <inttypes.h>
@@ -153,6 +166,188 @@ static bool _get_brport_from_entry(ndi_mac_entry_t * entry, sai_object_id_t & br
 }
 
 
+/* Fill FDB shadow entry from SAI FDB entry attributes */
+static void _ndi_mac_shadow_entry_fill(const sai_fdb_entry_t & sai_mac_entry, uint32_t attr_count,
+                                       const sai_attribute_t *sai_attr,
+                                       ndi_fdb_shadow_entry_t & shadow){
+    memset(&shadow, 0, sizeof(shadow));
+    shadow.bv_id = sai_mac_entry.bv_id;
+    memcpy(shadow.mac, sai_mac_entry.mac_address, HAL_MAC_ADDR_LEN);
+    shadow.action = SAI_PACKET_ACTION_FORWARD;
+
+    for (uint32_t ix = 0; ix < attr_count; ++ix) {
+        switch (sai_attr[ix].id) {
+            case SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID:
+                shadow.brport_id = sai_attr[ix].value.oid;
+                break;
+            case SAI_FDB_ENTRY_ATTR_TYPE:
+                shadow.is_static = (sai_attr[ix].value.s32 == SAI_FDB_ENTRY_TYPE_STATIC);
+                break;
+            case SAI_FDB_ENTRY_ATTR_PACKET_ACTION:
+                shadow.action = (sai_packet_action_t)sai_attr[ix].value.s32;
+                break;
+            case SAI_FDB_ENTRY_ATTR_ENDPOINT_IP:
+                shadow.endpoint_ip = sai_attr[ix].value.ipaddr;
+                shadow.is_remote = true;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Add or update FDB shadow entry from SAI FDB entry attributes */
+static void _ndi_mac_shadow_add(const sai_fdb_entry_t & sai_mac_entry, uint32_t attr_count,
+                                const sai_attribute_t *sai_attr){
+    if (!ndi_fdb_shadow_is_enabled()) {
+        return;
+    }
+    ndi_fdb_shadow_entry_t shadow;
+    _ndi_mac_shadow_entry_fill(sai_mac_entry, attr_count, sai_attr, shadow);
+    ndi_fdb_shadow_add(&shadow);
+}
+
+/* Convert SAI FDB flush attributes to FDB shadow filter */
+static void _ndi_mac_shadow_flush_filter(size_t attr_count, const sai_attribute_t *sai_attr,
+                                         ndi_fdb_shadow_filter_t & filter){
+    filter.brport_id = SAI_NULL_OBJECT_ID;
+    filter.bv_id = SAI_NULL_OBJECT_ID;
+    /* SAI flushes only dynamic entries when entry type is not given */
+    filter.type = NDI_FDB_SHADOW_TYPE_DYNAMIC;
+
+    for (size_t ix = 0; ix < attr_count; ++ix) {
+        switch (sai_attr[ix].id) {
+            case SAI_FDB_FLUSH_ATTR_BRIDGE_PORT_ID:
+                filter.brport_id = sai_attr[ix].value.oid;
+                break;
+            case SAI_FDB_FLUSH_ATTR_BV_ID:
+                filter.bv_id = sai_attr[ix].value.oid;
+                break;
+            case SAI_FDB_FLUSH_ATTR_ENTRY_TYPE:
+                if (sai_attr[ix].value.s32 == SAI_FDB_FLUSH_ENTRY_TYPE_STATIC) {
+                    filter.type = NDI_FDB_SHADOW_TYPE_STATIC;
+                } else if (sai_attr[ix].value.s32 == SAI_FDB_FLUSH_ENTRY_TYPE_DYNAMIC) {
+                    filter.type = NDI_FDB_SHADOW_TYPE_DYNAMIC;
+                } else {
+                    filter.type = NDI_FDB_SHADOW_TYPE_ALL;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * Flush FDB entries matching the flush attributes. When the FDB shadow is
+ * seeded and has no matching entry the SAI flush is skipped.
+ */
+static sai_status_t _ndi_mac_flush_entries(nas_ndi_db_t *ndi_db_ptr, size_t attr_count,
+                                           const sai_attribute_t *sai_attr){
+    ndi_fdb_shadow_filter_t filter;
+    _ndi_mac_shadow_flush_filter(attr_count, sai_attr, filter);
+
+    if (ndi_fdb_shadow_is_seeded() && (ndi_fdb_shadow_count(&filter) == 0)) {
+        NDI_MAC_LOG(DEBUG,"No FDB entries to flush for bridge port 0x%" PRIx64 " bv_id 0x%" PRIx64,
+                    filter.brport_id, filter.bv_id);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    sai_status_t sai_ret = ndi_mac_api_get(ndi_db_ptr)->flush_fdb_entries(ndi_switch_id_get(),
+                                                                          attr_count, sai_attr);
+    if (sai_ret == SAI_STATUS_SUCCESS) {
+        ndi_fdb_shadow_flush(&filter);
+    }
+    return sai_ret;
+}
+
+/* Keys of all FDB entries in SAI */
+static bool _ndi_mac_sai_keys_get(std::vector<sai_object_key_t> & keys){
+    uint32_t count = 0;
+    sai_status_t sai_ret = sai_get_object_count(ndi_switch_id_get(), SAI_OBJECT_TYPE_FDB_ENTRY,
+                                                &count);
+    if (sai_ret != SAI_STATUS_SUCCESS) {
+        NDI_MAC_LOG(ERR,"Failed to get FDB entry count ret:%d", sai_ret);
+        return false;
+    }
+
+    /* Room for entries learned after the count */
+    keys.resize(count + 1);
+    count = keys.size();
+    sai_ret = sai_get_object_key(ndi_switch_id_get(), SAI_OBJECT_TYPE_FDB_ENTRY, &count,
+                                 keys.data());
+    if (sai_ret == SAI_STATUS_BUFFER_OVERFLOW) {
+        keys.resize(count);
+        sai_ret = sai_get_object_key(ndi_switch_id_get(), SAI_OBJECT_TYPE_FDB_ENTRY, &count,
+                                     keys.data());
+    }
+    if (sai_ret != SAI_STATUS_SUCCESS) {
+        NDI_MAC_LOG(ERR,"Failed to get FDB entry list ret:%d", sai_ret);
+        return false;
+    }
+    keys.resize(count);
+    return true;
+}
+
+/* Read FDB entry from SAI, false if it is gone */
+static bool _ndi_mac_sai_entry_read(nas_ndi_db_t *ndi_db_ptr, const sai_fdb_entry_t & fdb_entry,
+                                    ndi_fdb_shadow_entry_t & shadow){
+    auto get_fn = ndi_mac_api_get(ndi_db_ptr)->get_fdb_entry_attribute;
+    sai_attribute_t sai_attr[4];
+    memset(sai_attr, 0, sizeof(sai_attr));
+    sai_attr[0].id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
+    sai_attr[1].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    sai_attr[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    uint32_t attr_count = 3;
+    if (get_fn(&fdb_entry, attr_count, sai_attr) != SAI_STATUS_SUCCESS) {
+        return false;
+    }
+
+    /* Endpoint IP is only there for entries on tunnel bridge ports */
+    ndi_brport_obj_t brport_obj;
+    brport_obj.brport_obj_id = sai_attr[0].value.oid;
+    if (nas_ndi_get_bridge_port_obj(&brport_obj, ndi_brport_query_type_FROM_BRPORT) &&
+        (brport_obj.brport_type == ndi_brport_type_TUNNEL)) {
+        sai_attr[attr_count].id = SAI_FDB_ENTRY_ATTR_ENDPOINT_IP;
+        if (get_fn(&fdb_entry, 1, &sai_attr[attr_count]) == SAI_STATUS_SUCCESS) {
+            attr_count++;
+        }
+    }
+    _ndi_mac_shadow_entry_fill(fdb_entry, attr_count, sai_attr, shadow);
+    return true;
+}
+
+/*
+ * Seed the FDB shadow with the entries in SAI. Entries that age out between
+ * reading the key list and their attributes are skipped.
+ */
+bool ndi_mac_fdb_shadow_seed(void)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(ndi_npu_id_get());
+    if (ndi_db_ptr == NULL) {
+        return false;
+    }
+
+    /* Entries learned after the key list is read are tracked by the shadow already */
+    std::vector<sai_object_key_t> keys;
+    if (!_ndi_mac_sai_keys_get(keys)) {
+        return false;
+    }
+
+    size_t seeded = 0;
+    for (auto & key : keys) {
+        ndi_fdb_shadow_entry_t shadow;
+        if (!_ndi_mac_sai_entry_read(ndi_db_ptr, key.key.fdb_entry, shadow)) {
+            continue;
+        }
+        ndi_fdb_shadow_add(&shadow);
+        seeded++;
+    }
+
+    NDI_MAC_LOG(INFO,"FDB shadow seeded with %lu of %lu SAI entries", seeded, keys.size());
+    return true;
+}
+
 t_std_error ndi_update_mac_entry(ndi_mac_entry_t *entry, ndi_mac_attr_flags attr_changed)
 {
     sai_status_t sai_ret = SAI_STATUS_FAILURE;
@@ -213,6 +408,15 @@ t_std_error ndi_update_mac_entry(ndi_mac_entry_t *entry, ndi_mac_attr_flags attr
         return sai_to_ndi_err_translate(sai_ret);
     }
 
+    /* Keep shadow lookups, counts and flush filters in line with SAI */
+    if (sai_attr.id == SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID) {
+        ndi_fdb_shadow_update(sai_mac_entry.bv_id, sai_mac_entry.mac_address,
+                              &sai_attr.value.oid, NULL);
+    } else {
+        sai_packet_action_t action = (sai_packet_action_t)sai_attr.value.s32;
+        ndi_fdb_shadow_update(sai_mac_entry.bv_id, sai_mac_entry.mac_address, NULL, &action);
+    }
+
     return STD_ERR_OK;
 }
 
@@ -265,35 +469,95 @@ static bool _get_port_vlan_from_bridge_port(sai_object_id_t & brport ,ndi_mac_en
 }
 
 
-t_std_error ndi_create_mac_entry(ndi_mac_entry_t *entry)
-{
-    uint32_t attr_idx = 0;
-    sai_status_t sai_ret = SAI_STATUS_FAILURE;
-    sai_fdb_entry_t sai_mac_entry;
-    sai_attribute_t sai_attr[NDI_MAC_ENTRY_ATTR_MAX -1];
-    sai_object_id_t sai_brport;
+/*
+ * VLAN and bridge port lookups done while programming a list of MAC entries,
+ * so that each VLAN and port is resolved once per list
+ */
+typedef std::tuple<bool, ndi_obj_id_t, npu_id_t, npu_port_t, hal_vlan_id_t> ndi_mac_brport_key_t;
 
-    if (entry == NULL) {
-        NDI_MAC_LOG(ERR,"Entry passed to create MAC entry is null");
-        return STD_ERR(MAC,FAIL,0);
-    }
+typedef struct {
+    std::unordered_map<hal_vlan_id_t, sai_object_id_t> vlan_oid;
+    std::map<ndi_mac_brport_key_t, sai_object_id_t> brport;
+} ndi_mac_resolve_cache_t;
 
-    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(entry->npu_id);
+typedef std::array<sai_attribute_t, NDI_MAC_ENTRY_ATTR_MAX - 1> ndi_mac_sai_attr_list_t;
 
-    if (ndi_db_ptr == NULL) {
-        NDI_MAC_LOG(ERR, "Not able to find NDI API Table for npu_id: %d", entry->npu_id);
-        return STD_ERR(MAC,FAIL,0);
+static bool _ndi_mac_get_vlan_oid_cached(hal_vlan_id_t vid, sai_object_id_t & oid,
+                                         ndi_mac_resolve_cache_t *cache){
+    if (cache == NULL) {
+        return ndi_mac_get_vlan_oid(vid, oid);
     }
+    auto it = cache->vlan_oid.find(vid);
+    if (it != cache->vlan_oid.end()) {
+        oid = it->second;
+        return true;
+    }
+    if (!ndi_mac_get_vlan_oid(vid, oid)) {
+        return false;
+    }
+    cache->vlan_oid[vid] = oid;
+    return true;
+}
 
-    sai_attr[attr_idx].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
-    sai_attr[attr_idx++].value.s32 = ndi_mac_sai_packet_action_get(entry->action);
+static bool _get_brport_from_entry_cached(ndi_mac_entry_t * entry, sai_object_id_t & brport,
+                                          ndi_mac_resolve_cache_t *cache){
+    if ((cache == NULL) || (entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE)) {
+        return _get_brport_from_entry(entry, brport);
+    }
+    bool is_pv = (entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_LOCAL);
+    ndi_mac_brport_key_t key(is_pv, entry->ndi_lag_id,
+                             (entry->ndi_lag_id != 0) ? 0 : entry->port_info.npu_id,
+                             (entry->ndi_lag_id != 0) ? 0 : entry->port_info.npu_port,
+                             is_pv ? entry->vlan_id : 0);
+    auto it = cache->brport.find(key);
+    if (it != cache->brport.end()) {
+        brport = it->second;
+        return true;
+    }
+    if (!_get_brport_from_entry(entry, brport)) {
+        return false;
+    }
+    cache->brport[key] = brport;
+    return true;
+}
 
+/* Fill SAI FDB entry key from the MAC entry */
+static t_std_error _ndi_mac_fill_sai_key(ndi_mac_entry_t *entry, sai_fdb_entry_t & sai_mac_entry,
+                                         ndi_mac_resolve_cache_t *cache){
     memcpy(&(sai_mac_entry.mac_address), entry->mac_addr, HAL_MAC_ADDR_LEN);
     sai_mac_entry.switch_id = ndi_switch_id_get();
 
+    if(entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_LOCAL ||
+        entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE){
+        sai_mac_entry.bv_id = entry->bridge_id;
+    }else{
+        /*
+         * if mac_entry_type is not passed then assume it is 1Q for backward compatibility
+         */
+        sai_object_id_t vlan_oid = 0;
+        if(!_ndi_mac_get_vlan_oid_cached(entry->vlan_id,vlan_oid,cache)){
+            NDI_MAC_LOG(ERR,"Failed to get vlan object id for vlan id %d",entry->vlan_id);
+            return STD_ERR(MAC,FAIL,0);
+        }
+        sai_mac_entry.bv_id = vlan_oid;
+    }
+    return STD_ERR_OK;
+}
+
+/* Fill SAI FDB entry key and create attributes from the MAC entry */
+static t_std_error _ndi_mac_fill_sai_entry(ndi_mac_entry_t *entry, sai_fdb_entry_t & sai_mac_entry,
+                                           sai_attribute_t *sai_attr, uint32_t & attr_idx,
+                                           ndi_mac_resolve_cache_t *cache){
+    sai_object_id_t sai_brport;
+    t_std_error rc;
+
+    attr_idx = 0;
+    sai_attr[attr_idx].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    sai_attr[attr_idx++].value.s32 = ndi_mac_sai_packet_action_get(entry->action);
+
     if (entry->action != BASE_MAC_PACKET_ACTION_TRAP) {
 
-        if(!_get_brport_from_entry(entry,sai_brport)){
+        if(!_get_brport_from_entry_cached(entry,sai_brport,cache)){
             NDI_MAC_LOG(ERR,"Failed to get bridge port for entry type %d",entry->mac_entry_type);
             return STD_ERR(MAC,PARAM,0);
         }
@@ -301,11 +565,7 @@ t_std_error ndi_create_mac_entry(ndi_mac_entry_t *entry)
         sai_attr[attr_idx++].value.oid = sai_brport;
     }
 
-
-    if(entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_LOCAL){
-        sai_mac_entry.bv_id = entry->bridge_id;
-    }else if(entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE){
-        sai_mac_entry.bv_id = entry->bridge_id;
+    if(entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE){
         sai_attr[attr_idx].id= SAI_FDB_ENTRY_ATTR_ENDPOINT_IP;
         if(entry->endpoint_ip.af_index == HAL_INET4_FAMILY){
             sai_attr[attr_idx].value.ipaddr.addr.ip4 = entry->endpoint_ip.u.ipv4.s_addr;
@@ -318,31 +578,315 @@ t_std_error ndi_create_mac_entry(ndi_mac_entry_t *entry)
             NDI_MAC_LOG(ERR,"Invalid address family for remote IP %d",entry->endpoint_ip.af_index);
             return STD_ERR(MAC,FAIL,0);
         }
-    }else{
-        /*
-         * if mac_entry_type is not passed then assume it is 1Q for backward compatibility
-         */
-        sai_object_id_t vlan_oid = 0;
-        if(!ndi_mac_get_vlan_oid(entry->vlan_id,vlan_oid)){
-            NDI_MAC_LOG(ERR,"Failed to get vlan object id for vlan id %d",entry->vlan_id);
-            return STD_ERR(MAC,FAIL,0);
-        }
-        sai_mac_entry.bv_id = vlan_oid;
     }
 
+    if ((rc = _ndi_mac_fill_sai_key(entry, sai_mac_entry, cache)) != STD_ERR_OK) {
+        return rc;
+    }
 
     sai_attr[attr_idx].id = SAI_FDB_ENTRY_ATTR_TYPE;
     sai_attr[attr_idx++].value.s32 = (entry->is_static) ? SAI_FDB_ENTRY_TYPE_STATIC : SAI_FDB_ENTRY_TYPE_DYNAMIC;
 
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_create_mac_entry(ndi_mac_entry_t *entry)
+{
+    uint32_t attr_idx = 0;
+    sai_status_t sai_ret = SAI_STATUS_FAILURE;
+    sai_fdb_entry_t sai_mac_entry;
+    sai_attribute_t sai_attr[NDI_MAC_ENTRY_ATTR_MAX -1];
+    t_std_error rc;
+
+    if (entry == NULL) {
+        NDI_MAC_LOG(ERR,"Entry passed to create MAC entry is null");
+        return STD_ERR(MAC,FAIL,0);
+    }
+
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(entry->npu_id);
+
+    if (ndi_db_ptr == NULL) {
+        NDI_MAC_LOG(ERR, "Not able to find NDI API Table for npu_id: %d", entry->npu_id);
+        return STD_ERR(MAC,FAIL,0);
+    }
+
+    if ((rc = _ndi_mac_fill_sai_entry(entry, sai_mac_entry, sai_attr, attr_idx, NULL)) != STD_ERR_OK) {
+        return rc;
+    }
+
     if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->
             create_fdb_entry(&sai_mac_entry, attr_idx, sai_attr)) != SAI_STATUS_SUCCESS) {
         NDI_MAC_LOG(ERR,"Failed to configure mac entry ret:%d",sai_ret);
         return sai_to_ndi_err_translate(sai_ret);
     }
+    _ndi_mac_shadow_add(sai_mac_entry, attr_idx, sai_attr);
 
     return STD_ERR_OK;
 }
 
+/* Copy per entry status to the caller list and return the first error */
+static t_std_error _ndi_mac_list_rc(const std::vector<t_std_error> & rc_vec, t_std_error *rc_list)
+{
+    t_std_error rc = STD_ERR_OK;
+    for (size_t ix = 0; ix < rc_vec.size(); ++ix) {
+        if (rc_list != NULL) {
+            rc_list[ix] = rc_vec[ix];
+        }
+        if ((rc == STD_ERR_OK) && (rc_vec[ix] != STD_ERR_OK)) {
+            rc = rc_vec[ix];
+        }
+    }
+    return rc;
+}
+
+/* Check that all the entries are on the same NPU and get its NDI table */
+static nas_ndi_db_t *_ndi_mac_list_db_get(ndi_mac_entry_t *entries, size_t count)
+{
+    if ((entries == NULL) || (count == 0)) {
+        NDI_MAC_LOG(ERR,"Empty MAC entry list");
+        return NULL;
+    }
+    for (size_t ix = 1; ix < count; ++ix) {
+        if (entries[ix].npu_id != entries[0].npu_id) {
+            NDI_MAC_LOG(ERR,"MAC entry list spans npu %d and %d",
+                        entries[0].npu_id, entries[ix].npu_id);
+            return NULL;
+        }
+    }
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(entries[0].npu_id);
+    if (ndi_db_ptr == NULL) {
+        NDI_MAC_LOG(ERR, "Not able to find NDI API Table for npu_id: %d", entries[0].npu_id);
+    }
+    return ndi_db_ptr;
+}
+
+static inline bool _ndi_mac_bulk_supported(sai_status_t sai_ret)
+{
+    return ((sai_ret != SAI_STATUS_NOT_IMPLEMENTED) && (sai_ret != SAI_STATUS_NOT_SUPPORTED));
+}
+
+t_std_error ndi_create_mac_entries(ndi_mac_entry_t *entries, size_t count, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = _ndi_mac_list_db_get(entries, count);
+    if (ndi_db_ptr == NULL) {
+        return (count == 0) ? STD_ERR_OK : STD_ERR(MAC,PARAM,0);
+    }
+
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+    std::vector<size_t> ix_list;
+    std::vector<sai_fdb_entry_t> sai_entries;
+    std::vector<ndi_mac_sai_attr_list_t> attr_lists;
+    std::vector<uint32_t> attr_counts;
+    ndi_mac_resolve_cache_t cache;
+
+    ix_list.reserve(count);
+    sai_entries.reserve(count);
+    attr_lists.reserve(count);
+    attr_counts.reserve(count);
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        sai_fdb_entry_t sai_mac_entry;
+        ndi_mac_sai_attr_list_t sai_attr;
+        uint32_t attr_idx = 0;
+        if ((rc_vec[ix] = _ndi_mac_fill_sai_entry(&entries[ix], sai_mac_entry, sai_attr.data(),
+                                                  attr_idx, &cache)) != STD_ERR_OK) {
+            continue;
+        }
+        ix_list.push_back(ix);
+        sai_entries.push_back(sai_mac_entry);
+        attr_lists.push_back(sai_attr);
+        attr_counts.push_back(attr_idx);
+    }
+
+    if (sai_entries.empty()) {
+        return _ndi_mac_list_rc(rc_vec, rc_list);
+    }
+
+    std::vector<const sai_attribute_t *> attr_ptrs;
+    attr_ptrs.reserve(attr_lists.size());
+    for (auto & attr_list : attr_lists) {
+        attr_ptrs.push_back(attr_list.data());
+    }
+
+    sai_fdb_api_t *fdb_api = ndi_mac_api_get(ndi_db_ptr);
+    std::vector<sai_status_t> status_list(sai_entries.size(), SAI_STATUS_FAILURE);
+    sai_status_t sai_ret = SAI_STATUS_NOT_IMPLEMENTED;
+
+    if (fdb_api->create_fdb_entries != NULL) {
+        sai_ret = fdb_api->create_fdb_entries(sai_entries.size(), sai_entries.data(),
+                                              attr_counts.data(), attr_ptrs.data(),
+                                              SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+                                              status_list.data());
+    }
+    if (!_ndi_mac_bulk_supported(sai_ret)) {
+        for (size_t ix = 0; ix < sai_entries.size(); ++ix) {
+            status_list[ix] = fdb_api->create_fdb_entry(&sai_entries[ix], attr_counts[ix],
+                                                        attr_ptrs[ix]);
+        }
+    }
+
+    for (size_t ix = 0; ix < sai_entries.size(); ++ix) {
+        if (status_list[ix] != SAI_STATUS_SUCCESS) {
+            NDI_MAC_LOG(ERR,"Failed to configure mac entry %lu of %lu ret:%d",
+                        ix_list[ix], count, status_list[ix]);
+            rc_vec[ix_list[ix]] = sai_to_ndi_err_translate(status_list[ix]);
+            continue;
+        }
+        _ndi_mac_shadow_add(sai_entries[ix], attr_counts[ix], attr_ptrs[ix]);
+    }
+
+    return _ndi_mac_list_rc(rc_vec, rc_list);
+}
+
+t_std_error ndi_delete_mac_entries(ndi_mac_entry_t *entries, size_t count, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = _ndi_mac_list_db_get(entries, count);
+    if (ndi_db_ptr == NULL) {
+        return (count == 0) ? STD_ERR_OK : STD_ERR(MAC,PARAM,0);
+    }
+
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+    std::vector<size_t> ix_list;
+    std::vector<sai_fdb_entry_t> sai_entries;
+    ndi_mac_resolve_cache_t cache;
+
+    ix_list.reserve(count);
+    sai_entries.reserve(count);
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        sai_fdb_entry_t sai_mac_entry;
+        if ((rc_vec[ix] = _ndi_mac_fill_sai_key(&entries[ix], sai_mac_entry, &cache)) != STD_ERR_OK) {
+            continue;
+        }
+        ix_list.push_back(ix);
+        sai_entries.push_back(sai_mac_entry);
+    }
+
+    if (sai_entries.empty()) {
+        return _ndi_mac_list_rc(rc_vec, rc_list);
+    }
+
+    sai_fdb_api_t *fdb_api = ndi_mac_api_get(ndi_db_ptr);
+    std::vector<sai_status_t> status_list(sai_entries.size(), SAI_STATUS_FAILURE);
+    sai_status_t sai_ret = SAI_STATUS_NOT_IMPLEMENTED;
+
+    if (fdb_api->remove_fdb_entries != NULL) {
+        sai_ret = fdb_api->remove_fdb_entries(sai_entries.size(), sai_entries.data(),
+                                              SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+                                              status_list.data());
+    }
+    if (!_ndi_mac_bulk_supported(sai_ret)) {
+        for (size_t ix = 0; ix < sai_entries.size(); ++ix) {
+            status_list[ix] = fdb_api->remove_fdb_entry(&sai_entries[ix]);
+        }
+    }
+
+    for (size_t ix = 0; ix < sai_entries.size(); ++ix) {
+        if (status_list[ix] != SAI_STATUS_SUCCESS) {
+            NDI_MAC_LOG(ERR,"Failed to remove mac entry for vlan:%d ret=%d",
+                        entries[ix_list[ix]].vlan_id, status_list[ix]);
+            rc_vec[ix_list[ix]] = sai_to_ndi_err_translate(status_list[ix]);
+            continue;
+        }
+        ndi_fdb_shadow_del(sai_entries[ix].bv_id, sai_entries[ix].mac_address);
+    }
+
+    return _ndi_mac_list_rc(rc_vec, rc_list);
+}
+
+/* Requests for the same MAC entry go to the same queue so they stay in order */
+static uint64_t _ndi_mac_async_key(const ndi_mac_entry_t *entry)
+{
+    uint64_t key = 0;
+    for (size_t ix = 0; ix < HAL_MAC_ADDR_LEN; ++ix) {
+        key = (key << 8) | entry->mac_addr[ix];
+    }
+    uint64_t bv = (entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1Q) ? entry->vlan_id :
+                                                                     entry->bridge_id;
+    return key ^ std::hash<uint64_t>()(bv);
+}
+
+static t_std_error _ndi_mac_create_req(void *req_data, ndi_obj_id_t *obj_id)
+{
+    return ndi_create_mac_entries(static_cast<ndi_mac_entry_t *>(req_data), 1, NULL);
+}
+
+static t_std_error _ndi_mac_delete_req(void *req_data, ndi_obj_id_t *obj_id)
+{
+    return ndi_delete_mac_entries(static_cast<ndi_mac_entry_t *>(req_data), 1, NULL);
+}
+
+/* Queued requests are programmed with one list call per run of one NPU */
+static void _ndi_mac_req_batch(size_t count, void **req_data_list, t_std_error *rc_list,
+                               t_std_error (*list_fn)(ndi_mac_entry_t *, size_t, t_std_error *))
+{
+    std::vector<ndi_mac_entry_t> entries;
+    size_t start = 0;
+
+    try {
+        entries.reserve(count);
+    } catch (...) {
+        for (size_t ix = 0; ix < count; ++ix) {
+            rc_list[ix] = list_fn(static_cast<ndi_mac_entry_t *>(req_data_list[ix]), 1, NULL);
+        }
+        return;
+    }
+    for (size_t ix = 0; ix < count; ++ix) {
+        entries.push_back(*static_cast<ndi_mac_entry_t *>(req_data_list[ix]));
+    }
+    for (size_t ix = 1; ix <= count; ++ix) {
+        if ((ix == count) || (entries[ix].npu_id != entries[start].npu_id)) {
+            /* rc_list is not filled when the whole list is rejected */
+            t_std_error rc = list_fn(&entries[start], ix - start, &rc_list[start]);
+            if (rc != STD_ERR_OK) {
+                std::replace(&rc_list[start], &rc_list[ix], (t_std_error)STD_ERR_OK, rc);
+            }
+            start = ix;
+        }
+    }
+}
+
+static void _ndi_mac_create_batch(size_t count, void **req_data_list, t_std_error *rc_list,
+                                  ndi_obj_id_t *obj_id_list)
+{
+    _ndi_mac_req_batch(count, req_data_list, rc_list, ndi_create_mac_entries);
+}
+
+static void _ndi_mac_delete_batch(size_t count, void **req_data_list, t_std_error *rc_list,
+                                  ndi_obj_id_t *obj_id_list)
+{
+    _ndi_mac_req_batch(count, req_data_list, rc_list, ndi_delete_mac_entries);
+}
+
+t_std_error ndi_mac_async_init(void)
+{
+    t_std_error rc = ndi_async_register_batch_fn(_ndi_mac_create_req, _ndi_mac_create_batch);
+    if (rc == STD_ERR_OK) {
+        rc = ndi_async_register_batch_fn(_ndi_mac_delete_req, _ndi_mac_delete_batch);
+    }
+    return rc;
+}
+
+t_std_error ndi_create_mac_entry_async(ndi_mac_entry_t *entry, ndi_async_cmpl_fn cmpl_fn,
+                                       void *cookie)
+{
+    if (entry == NULL) {
+        return STD_ERR(MAC,PARAM,0);
+    }
+    return ndi_async_submit(NDI_ASYNC_OBJ_CLASS_L2, _ndi_mac_async_key(entry),
+                            _ndi_mac_create_req, entry, cmpl_fn, cookie, true);
+}
+
+t_std_error ndi_delete_mac_entry_async(ndi_mac_entry_t *entry, ndi_async_cmpl_fn cmpl_fn,
+                                       void *cookie)
+{
+    if (entry == NULL) {
+        return STD_ERR(MAC,PARAM,0);
+    }
+    return ndi_async_submit(NDI_ASYNC_OBJ_CLASS_L2, _ndi_mac_async_key(entry),
+                            _ndi_mac_delete_req, entry, cmpl_fn, cookie, true);
+}
+
 bool ndi_mac_handle_port_delete(ndi_mac_entry_t *entry, sai_attribute_t * sai_attrs,size_t & ix){
      sai_object_id_t brport;
 
@@ -426,24 +970,16 @@ t_std_error ndi_delete_mac_entry(ndi_mac_entry_t *entry, ndi_mac_delete_type_t d
 
     if(delete_type == NDI_MAC_DEL_SINGLE_ENTRY){
         sai_fdb_entry_t sai_mac_entry;
-        memcpy(&(sai_mac_entry.mac_address), entry->mac_addr, HAL_MAC_ADDR_LEN);
-
-        if(entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_LOCAL ||
-            entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE){
-            sai_mac_entry.bv_id = entry->bridge_id;
-        }else{
-            sai_object_id_t vlan_oid;
-            if(!ndi_mac_get_vlan_oid(entry->vlan_id,vlan_oid)){
-                return STD_ERR(MAC,FAIL,0);
-            }
-            sai_mac_entry.bv_id = vlan_oid;
+        t_std_error rc;
+        if ((rc = _ndi_mac_fill_sai_key(entry, sai_mac_entry, NULL)) != STD_ERR_OK) {
+            return rc;
         }
-        sai_mac_entry.switch_id = ndi_switch_id_get();
         if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->remove_fdb_entry(&sai_mac_entry))
                                                                 != SAI_STATUS_SUCCESS) {
             NDI_MAC_LOG(ERR,"Failed to remove mac entry for vlan:%d ret=%d",entry->vlan_id, sai_ret);
             return sai_to_ndi_err_translate(sai_ret);
         }
+        ndi_fdb_shadow_del(sai_mac_entry.bv_id, sai_mac_entry.mac_address);
         return STD_ERR_OK;
     }
 
@@ -479,8 +1015,8 @@ t_std_error ndi_delete_mac_entry(ndi_mac_entry_t *entry, ndi_mac_delete_type_t d
         }
     }
 
-    if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->flush_fdb_entries(ndi_switch_id_get(),
-                   attr_idx, (const sai_attribute_t *)fdb_flush_attr)) != SAI_STATUS_SUCCESS){
+    if ((sai_ret = _ndi_mac_flush_entries(ndi_db_ptr, attr_idx,
+                   (const sai_attribute_t *)fdb_flush_attr)) != SAI_STATUS_SUCCESS){
         NDI_MAC_LOG(ERR, "Failed to remove mac entries of type %d ret:%d",delete_type, sai_ret);
         return sai_to_ndi_err_translate(sai_ret);
     }
@@ -554,6 +1090,18 @@ t_std_error ndi_get_mac_entry_attr(ndi_mac_entry_t *mac_entry)
         sai_mac_entry.bv_id = mac_entry->bridge_id;
     }
 
+    ndi_fdb_shadow_entry_t shadow;
+    shadow.bv_id = sai_mac_entry.bv_id;
+    memcpy(shadow.mac, mac_entry->mac_addr, HAL_MAC_ADDR_LEN);
+    if (ndi_fdb_shadow_get(&shadow)) {
+        if(!_fill_mac_entry_from_brport(mac_entry,shadow.brport_id)){
+            return STD_ERR(MAC,FAIL,0);
+        }
+        mac_entry->is_static = shadow.is_static;
+        mac_entry->action = ndi_mac_packet_action_get(shadow.action);
+        return STD_ERR_OK;
+    }
+
     if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->get_fdb_entry_attribute
                     (&sai_mac_entry,sai_attr_ix,sai_attrs))!= SAI_STATUS_SUCCESS) {
         EV_LOGGING(NDI, DEBUG, "NDI-MAC","Failed to fetch mac entry from NDI");
@@ -598,8 +1146,8 @@ t_std_error ndi_flush_bridge_port_entry(sai_object_id_t brport_oid) {
     memset(&fdb_flush_attr, 0, sizeof(fdb_flush_attr));
     fdb_flush_attr.id = SAI_FDB_FLUSH_ATTR_BRIDGE_PORT_ID;
     fdb_flush_attr.value.oid = brport_oid;
-    if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->flush_fdb_entries(ndi_switch_id_get(),
-        fdb_flush_attr_count, (const sai_attribute_t *)&fdb_flush_attr)) != SAI_STATUS_SUCCESS) {
+    if ((sai_ret = _ndi_mac_flush_entries(ndi_db_ptr, fdb_flush_attr_count,
+        (const sai_attribute_t *)&fdb_flush_attr)) != SAI_STATUS_SUCCESS) {
         NDI_MAC_LOG(ERR,"NDI-MAC", "Failed to remove mac entries for bridge port 0x%llx", brport_oid);
         return sai_to_ndi_err_translate(sai_ret);
     }
@@ -634,8 +1182,8 @@ bool ndi_mac_flush_vlan(hal_vlan_id_t vlan_id){
     fdb_flush_attr[attr_idx++].value.oid = vlan_oid;
 
 
-    if ((sai_ret = ndi_mac_api_get(ndi_db_ptr)->flush_fdb_entries(ndi_switch_id_get(),
-                    attr_idx, (const sai_attribute_t *)fdb_flush_attr)) != SAI_STATUS_SUCCESS){
+    if ((sai_ret = _ndi_mac_flush_entries(ndi_db_ptr, attr_idx,
+                    (const sai_attribute_t *)fdb_flush_attr)) != SAI_STATUS_SUCCESS){
         NDI_MAC_LOG(ERR, "Failed to remove mac entries for vlan %d",vlan_id);
         return false;
     }
@@ -645,6 +1193,538 @@ bool ndi_mac_flush_vlan(hal_vlan_id_t vlan_id){
 }
 
 
+/*
+ * Flushes started by ndi_mac_flush_async. The request is flushed as one SAI
+ * flush per (bridge port, bv_id) pair and each pair is tracked on its own.
+ * Aged and flushed events of a pair are counted instead of being sent to NAS
+ * once the SAI flush of the pair is started and until the pair has ended.
+ * A pair ends when SAI fails its flush, when SAI reports the end of the
+ * flush with a flushed event with no MAC, or, with a seeded FDB shadow, once
+ * all the shadow entries of the pair are seen. The flush completes once the
+ * SAI flushes are done and stays tracked until all its pairs have ended or
+ * until the drain time expires.
+ */
+static const auto NDI_MAC_FLUSH_DRAIN_TIME = std::chrono::seconds(5);
+
+typedef struct {
+    size_t expected;
+    size_t seen;
+    bool sai_called;
+    bool ended;
+} ndi_mac_flush_pair_t;
+
+/* Bridge ports or bv_ids of a flush, SAI_NULL_OBJECT_ID alone matches all */
+typedef struct {
+    std::vector<sai_object_id_t> ids;
+    std::unordered_map<sai_object_id_t, size_t> index;
+} ndi_mac_flush_axis_t;
+
+typedef struct {
+    ndi_mac_flush_axis_t brports;
+    ndi_mac_flush_axis_t bv_ids;
+    ndi_fdb_shadow_type_t type;
+    /* expected of each pair is known from the FDB shadow */
+    bool counted;
+    /* brport major */
+    std::vector<ndi_mac_flush_pair_t> pairs;
+    size_t pairs_open;
+    bool sai_done;
+    bool closed;
+    std::chrono::steady_clock::time_point deadline;
+} ndi_mac_flush_track_t;
+
+typedef std::shared_ptr<ndi_mac_flush_track_t> ndi_mac_flush_track_ptr;
+
+static std::mutex _flush_track_lock;
+static auto _flush_tracks = new std::list<ndi_mac_flush_track_ptr>;
+
+typedef struct {
+    const ndi_mac_flush_req_t *req;
+    ndi_mac_flush_cmpl_fn cmpl_fn;
+    void *cookie;
+    ndi_mac_flush_result_t result;
+} ndi_mac_flush_ctx_t;
+
+static void _ndi_mac_flush_axis_add(ndi_mac_flush_axis_t & axis, sai_object_id_t id){
+    if (axis.index.emplace(id, axis.ids.size()).second) {
+        axis.ids.push_back(id);
+    }
+}
+
+/* Index range [lo, hi) of the axis matching an event object id */
+static bool _ndi_mac_flush_axis_match(const ndi_mac_flush_axis_t & axis, sai_object_id_t id,
+                                      size_t & lo, size_t & hi){
+    if (axis.index.empty() || (id == SAI_NULL_OBJECT_ID)) {
+        lo = 0;
+        hi = axis.ids.size();
+        return true;
+    }
+    auto it = axis.index.find(id);
+    if (it == axis.index.end()) {
+        return false;
+    }
+    lo = it->second;
+    hi = lo + 1;
+    return true;
+}
+
+/* Called with _flush_track_lock held */
+static void _ndi_mac_flush_pair_end(ndi_mac_flush_track_t & track, ndi_mac_flush_pair_t & pair){
+    if (pair.ended) {
+        return;
+    }
+    pair.ended = true;
+    track.pairs_open--;
+    if (track.sai_done && (track.pairs_open == 0)) {
+        track.closed = true;
+    }
+}
+
+/* Count FDB event against the tracked flushes, returns true if it matched */
+static bool _ndi_mac_flush_track_event(const sai_fdb_event_notification_data_t & data,
+                                       sai_object_id_t brport_id, bool is_static){
+    if ((data.event_type != SAI_FDB_EVENT_AGED) && (data.event_type != SAI_FDB_EVENT_FLUSHED)) {
+        return false;
+    }
+
+    static const hal_mac_addr_t zero_mac = {0};
+    bool wildcard = (data.event_type == SAI_FDB_EVENT_FLUSHED) &&
+                    (memcmp(data.fdb_entry.mac_address, zero_mac, HAL_MAC_ADDR_LEN) == 0);
+    auto now = std::chrono::steady_clock::now();
+    bool matched = false;
+
+    std::lock_guard<std::mutex> lg(_flush_track_lock);
+    for (auto it = _flush_tracks->begin(); it != _flush_tracks->end(); ) {
+        auto cur = it++;
+        auto & track = *cur;
+        if (track->closed || (track->sai_done && (now > track->deadline))) {
+            _flush_tracks->erase(cur);
+            continue;
+        }
+        if (matched) {
+            continue;
+        }
+        if (!wildcard && (track->type != NDI_FDB_SHADOW_TYPE_ALL) &&
+            (is_static != (track->type == NDI_FDB_SHADOW_TYPE_STATIC))) {
+            continue;
+        }
+        size_t brport_lo, brport_hi, bv_lo, bv_hi;
+        if (!_ndi_mac_flush_axis_match(track->brports, brport_id, brport_lo, brport_hi) ||
+            !_ndi_mac_flush_axis_match(track->bv_ids, data.fdb_entry.bv_id, bv_lo, bv_hi)) {
+            continue;
+        }
+
+        /* A flushed event with no MAC ends only the pairs it matches */
+        for (size_t bix = brport_lo; (bix < brport_hi) && !(matched && !wildcard); ++bix) {
+            for (size_t vix = bv_lo; vix < bv_hi; ++vix) {
+                auto & pair = track->pairs[bix * track->bv_ids.ids.size() + vix];
+                if (!pair.sai_called || pair.ended) {
+                    continue;
+                }
+                matched = true;
+                if (wildcard) {
+                    _ndi_mac_flush_pair_end(*track, pair);
+                    continue;
+                }
+                pair.seen++;
+                if (track->counted && (pair.seen >= pair.expected)) {
+                    _ndi_mac_flush_pair_end(*track, pair);
+                }
+                break;
+            }
+        }
+        if (track->closed) {
+            _flush_tracks->erase(cur);
+        }
+    }
+    return matched;
+}
+
+/* Build tracked flush from the request, resolving bridge ports and VLANs */
+static t_std_error _ndi_mac_flush_track_init(const ndi_mac_flush_req_t *req,
+                                             ndi_mac_flush_track_t & track){
+    for (size_t ix = 0; ix < req->port_count; ++ix) {
+        ndi_mac_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.ndi_lag_id = req->port_list[ix].ndi_lag_id;
+        entry.port_info = req->port_list[ix].port_info;
+        sai_object_id_t brport;
+        if (!ndi_mac_get_brport(&entry, brport)) {
+            return STD_ERR(MAC,PARAM,0);
+        }
+        _ndi_mac_flush_axis_add(track.brports, brport);
+    }
+
+    if (req->vlan_min != 0) {
+        if (req->vlan_max < req->vlan_min) {
+            NDI_MAC_LOG(ERR,"Invalid VLAN range %d-%d",req->vlan_min,req->vlan_max);
+            return STD_ERR(MAC,PARAM,0);
+        }
+        for (uint32_t vid = req->vlan_min; vid <= req->vlan_max; ++vid) {
+            /* VLANs not created have no entries to flush */
+            ndi_virtual_obj_t obj;
+            obj.vid = (hal_vlan_id_t)vid;
+            if (nas_ndi_get_virtual_obj(&obj,ndi_virtual_obj_query_type_FROM_VLAN)) {
+                _ndi_mac_flush_axis_add(track.bv_ids, obj.oid);
+            }
+        }
+        if (track.bv_ids.ids.empty()) {
+            NDI_MAC_LOG(DEBUG,"No VLAN in range %d-%d",req->vlan_min,req->vlan_max);
+        }
+    }
+
+    track.type = NDI_FDB_SHADOW_TYPE_DYNAMIC;
+    if (req->type_set) {
+        track.type = req->is_static ? NDI_FDB_SHADOW_TYPE_STATIC : NDI_FDB_SHADOW_TYPE_DYNAMIC;
+    }
+    track.counted = false;
+    track.pairs_open = 0;
+    track.sai_done = false;
+    track.closed = false;
+    return STD_ERR_OK;
+}
+
+/* Flush the cross product of the request bridge ports and VLANs */
+static t_std_error _ndi_mac_flush_run(void *req_data, ndi_obj_id_t *obj_id)
+{
+    ndi_mac_flush_ctx_t *ctx = static_cast<ndi_mac_flush_ctx_t *>(req_data);
+    const ndi_mac_flush_req_t *req = ctx->req;
+    ndi_mac_flush_result_t & result = ctx->result;
+
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(req->npu_id);
+    if (ndi_db_ptr == NULL) {
+        NDI_MAC_LOG(ERR, "Not able to find MAC NDI function table entry");
+        return (result.rc = STD_ERR(MAC, FAIL, 0));
+    }
+
+    auto track = std::make_shared<ndi_mac_flush_track_t>();
+    if ((result.rc = _ndi_mac_flush_track_init(req, *track)) != STD_ERR_OK) {
+        return result.rc;
+    }
+    if ((req->vlan_min != 0) && track->bv_ids.ids.empty()) {
+        result.entry_count_known = true;
+        return result.rc;
+    }
+    if (track->brports.ids.empty()) track->brports.ids.push_back(SAI_NULL_OBJECT_ID);
+    if (track->bv_ids.ids.empty()) track->bv_ids.ids.push_back(SAI_NULL_OBJECT_ID);
+
+    const auto & brports = track->brports.ids;
+    const auto & bv_ids = track->bv_ids.ids;
+    track->pairs.assign(brports.size() * bv_ids.size(), ndi_mac_flush_pair_t{0, 0, false, false});
+    track->pairs_open = track->pairs.size();
+    track->counted = ndi_fdb_shadow_is_seeded();
+    size_t expected = 0;
+    if (track->counted) {
+        for (size_t bix = 0; bix < brports.size(); ++bix) {
+            for (size_t vix = 0; vix < bv_ids.size(); ++vix) {
+                ndi_fdb_shadow_filter_t filter = {brports[bix], bv_ids[vix], track->type};
+                track->pairs[bix * bv_ids.size() + vix].expected = ndi_fdb_shadow_count(&filter);
+                expected += track->pairs[bix * bv_ids.size() + vix].expected;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(_flush_track_lock);
+        _flush_tracks->push_back(track);
+    }
+
+    for (size_t bix = 0; bix < brports.size(); ++bix) {
+        for (size_t vix = 0; vix < bv_ids.size(); ++vix) {
+            sai_object_id_t brport = brports[bix];
+            sai_object_id_t bv_id = bv_ids[vix];
+            auto & pair = track->pairs[bix * bv_ids.size() + vix];
+            size_t attr_idx = 0;
+            sai_attribute_t fdb_flush_attr[3];
+            memset(fdb_flush_attr, 0, sizeof(fdb_flush_attr));
+
+            if (req->type_set) {
+                fdb_flush_attr[attr_idx].id = SAI_FDB_FLUSH_ATTR_ENTRY_TYPE;
+                fdb_flush_attr[attr_idx++].value.s32 = req->is_static ?
+                        SAI_FDB_FLUSH_ENTRY_TYPE_STATIC : SAI_FDB_FLUSH_ENTRY_TYPE_DYNAMIC;
+            }
+            if (brport != SAI_NULL_OBJECT_ID) {
+                fdb_flush_attr[attr_idx].id = SAI_FDB_FLUSH_ATTR_BRIDGE_PORT_ID;
+                fdb_flush_attr[attr_idx++].value.oid = brport;
+            }
+            if (bv_id != SAI_NULL_OBJECT_ID) {
+                fdb_flush_attr[attr_idx].id = SAI_FDB_FLUSH_ATTR_BV_ID;
+                fdb_flush_attr[attr_idx++].value.oid = bv_id;
+            }
+
+            /* Events of the pair can come in while SAI flushes */
+            {
+                std::lock_guard<std::mutex> lg(_flush_track_lock);
+                pair.sai_called = true;
+            }
+            sai_status_t sai_ret = _ndi_mac_flush_entries(ndi_db_ptr, attr_idx, fdb_flush_attr);
+            result.sai_flush_count++;
+            if (sai_ret != SAI_STATUS_SUCCESS) {
+                NDI_MAC_LOG(ERR,"Failed to flush mac entries for bridge port 0x%" PRIx64
+                            " bv_id 0x%" PRIx64 " ret:%d", brport, bv_id, sai_ret);
+                if (result.rc == STD_ERR_OK) {
+                    result.rc = sai_to_ndi_err_translate(sai_ret);
+                }
+            }
+            std::lock_guard<std::mutex> lg(_flush_track_lock);
+            if ((sai_ret != SAI_STATUS_SUCCESS) ||
+                (track->counted && (pair.seen >= pair.expected))) {
+                _ndi_mac_flush_pair_end(*track, pair);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lg(_flush_track_lock);
+    track->sai_done = true;
+    track->deadline = std::chrono::steady_clock::now() + NDI_MAC_FLUSH_DRAIN_TIME;
+    if (track->pairs_open == 0) {
+        track->closed = true;
+    }
+
+    /* Remaining events are held back as they come in. Without a seeded
+     * shadow only those events could tell how many entries went, the
+     * count is left unknown instead of holding up the caller for them */
+    result.entry_count_known = track->counted;
+    result.entry_count = track->counted ? expected : 0;
+    if (track->closed) {
+        _flush_tracks->remove(track);
+    }
+    return result.rc;
+}
+
+static void _ndi_mac_flush_cmpl(t_std_error rc, ndi_obj_id_t obj_id, void *cookie)
+{
+    ndi_mac_flush_ctx_t *ctx = static_cast<ndi_mac_flush_ctx_t *>(cookie);
+    ctx->result.rc = rc;
+    if (ctx->cmpl_fn != NULL) {
+        ctx->cmpl_fn(ctx->req, &ctx->result, ctx->cookie);
+    }
+    delete ctx;
+}
+
+t_std_error ndi_mac_flush_async(const ndi_mac_flush_req_t *req,
+                                ndi_mac_flush_cmpl_fn cmpl_fn, void *cookie)
+{
+    if ((req == NULL) || ((req->port_count != 0) && (req->port_list == NULL))) {
+        NDI_MAC_LOG(ERR,"Invalid MAC flush request");
+        return STD_ERR(MAC,PARAM,0);
+    }
+
+    ndi_mac_flush_ctx_t *ctx = new (std::nothrow) ndi_mac_flush_ctx_t;
+    if (ctx == NULL) {
+        return STD_ERR(MAC,NOMEM,0);
+    }
+    ctx->req = req;
+    ctx->cmpl_fn = cmpl_fn;
+    ctx->cookie = cookie;
+    memset(&ctx->result, 0, sizeof(ctx->result));
+
+    /* all flushes use one key so they run in request order */
+    t_std_error rc = ndi_async_submit(NDI_ASYNC_OBJ_CLASS_L2, 0, _ndi_mac_flush_run, ctx,
+                                      _ndi_mac_flush_cmpl, ctx, true);
+    if (rc != STD_ERR_OK) {
+        delete ctx;
+    }
+    return rc;
+}
+
+/* Number of shadow entries read under the shadow lock in one go */
+static const size_t NDI_MAC_ITER_CHUNK = 256;
+
+struct ndi_mac_iter_s {
+    npu_id_t npu_id;
+    ndi_fdb_shadow_filter_t shadow_filter;
+    bool match_port;
+    ndi_obj_id_t ndi_lag_id;
+    ndi_port_t port_info;
+    size_t cursor;
+    bool done;
+    /* FDB shadow disabled, walk the SAI key list taken at create time */
+    bool from_sai;
+    std::vector<sai_object_key_t> sai_keys;
+    ndi_fdb_shadow_entry_t chunk[NDI_MAC_ITER_CHUNK];
+};
+
+/* Fill MAC entry from FDB shadow entry */
+static bool _ndi_mac_entry_from_shadow(const ndi_fdb_shadow_entry_t & shadow, npu_id_t npu_id,
+                                       ndi_mac_entry_t *mac_entry){
+    memset(mac_entry, 0, sizeof(*mac_entry));
+    mac_entry->npu_id = npu_id;
+    memcpy(mac_entry->mac_addr, shadow.mac, HAL_MAC_ADDR_LEN);
+    mac_entry->is_static = shadow.is_static;
+    mac_entry->action = ndi_mac_packet_action_get(shadow.action);
+
+    ndi_virtual_obj_t obj;
+    obj.oid = shadow.bv_id;
+    if(nas_ndi_get_virtual_obj(&obj,ndi_virtual_obj_query_type_FROM_OBJ)){
+        mac_entry->vlan_id = obj.vid;
+        mac_entry->mac_entry_type = NDI_MAC_ENTRY_TYPE_1Q;
+    }else if(shadow.is_remote){
+        mac_entry->bridge_id = shadow.bv_id;
+        mac_entry->mac_entry_type = NDI_MAC_ENTRY_TYPE_1D_REMOTE;
+        if(shadow.endpoint_ip.addr_family == SAI_IP_ADDR_FAMILY_IPV4){
+            mac_entry->endpoint_ip.u.v4_addr = shadow.endpoint_ip.addr.ip4;
+            mac_entry->endpoint_ip.af_index = HAL_INET4_FAMILY;
+        }else{
+            memcpy(mac_entry->endpoint_ip.u.v6_addr, shadow.endpoint_ip.addr.ip6,
+                   sizeof(mac_entry->endpoint_ip.u.v6_addr));
+            mac_entry->endpoint_ip.af_index = HAL_INET6_FAMILY;
+        }
+    }else{
+        mac_entry->bridge_id = shadow.bv_id;
+        mac_entry->mac_entry_type = NDI_MAC_ENTRY_TYPE_1D_LOCAL;
+    }
+
+    return _fill_mac_entry_from_brport(mac_entry, shadow.brport_id);
+}
+
+/* Next entries of the SAI key list matching the filter, one SAI get each */
+static size_t _ndi_mac_iter_sai_get_next(ndi_mac_iter_t *iter, size_t max_count){
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(iter->npu_id);
+    if (ndi_db_ptr == NULL) {
+        return 0;
+    }
+
+    size_t got = 0;
+    while ((got < max_count) && (iter->cursor < iter->sai_keys.size())) {
+        const sai_fdb_entry_t & fdb_entry = iter->sai_keys[iter->cursor++].key.fdb_entry;
+        if ((iter->shadow_filter.bv_id != SAI_NULL_OBJECT_ID) &&
+            (fdb_entry.bv_id != iter->shadow_filter.bv_id)) {
+            continue;
+        }
+        /* Entries aged out since the key list was read are skipped */
+        if (_ndi_mac_sai_entry_read(ndi_db_ptr, fdb_entry, iter->chunk[got])) {
+            got++;
+        }
+    }
+    return got;
+}
+
+ndi_mac_iter_t *ndi_mac_iter_create(npu_id_t npu_id, const ndi_mac_iter_filter_t *filter)
+{
+    ndi_fdb_shadow_filter_t shadow_filter;
+    shadow_filter.brport_id = SAI_NULL_OBJECT_ID;
+    shadow_filter.bv_id = SAI_NULL_OBJECT_ID;
+    shadow_filter.type = NDI_FDB_SHADOW_TYPE_ALL;
+
+    if (filter != NULL) {
+        if (filter->match_vlan && filter->match_bridge) {
+            NDI_MAC_LOG(ERR,"MAC table walk can not filter on both VLAN and bridge");
+            return NULL;
+        }
+        if (filter->match_vlan && !ndi_mac_get_vlan_oid(filter->vlan_id, shadow_filter.bv_id)) {
+            return NULL;
+        }
+        if (filter->match_bridge) {
+            shadow_filter.bv_id = filter->bridge_id;
+        }
+    }
+
+    ndi_mac_iter_t *iter = new (std::nothrow) ndi_mac_iter_t;
+    if (iter == NULL) {
+        return NULL;
+    }
+    iter->npu_id = npu_id;
+    iter->shadow_filter = shadow_filter;
+    iter->match_port = (filter != NULL) && filter->match_port;
+    iter->ndi_lag_id = iter->match_port ? filter->ndi_lag_id : 0;
+    if (iter->match_port) {
+        iter->port_info = filter->port_info;
+    }
+    iter->cursor = 0;
+    iter->done = false;
+    iter->from_sai = !ndi_fdb_shadow_is_enabled();
+    if (iter->from_sai && !_ndi_mac_sai_keys_get(iter->sai_keys)) {
+        delete iter;
+        return NULL;
+    }
+    return iter;
+}
+
+t_std_error ndi_mac_iter_next(ndi_mac_iter_t *iter, ndi_mac_entry_t *entries,
+                              size_t max_count, size_t *count)
+{
+    if ((iter == NULL) || (entries == NULL) || (count == NULL)) {
+        return STD_ERR(MAC,PARAM,0);
+    }
+
+    size_t filled = 0;
+    while ((filled < max_count) && !iter->done) {
+        size_t want = std::min(max_count - filled, NDI_MAC_ITER_CHUNK);
+        size_t got = iter->from_sai ? _ndi_mac_iter_sai_get_next(iter, want) :
+                     ndi_fdb_shadow_get_next(&iter->shadow_filter, &iter->cursor,
+                                             iter->chunk, want);
+        if (got == 0) {
+            iter->done = true;
+            break;
+        }
+        for (size_t ix = 0; ix < got; ++ix) {
+            ndi_mac_entry_t *mac_entry = &entries[filled];
+            if (!_ndi_mac_entry_from_shadow(iter->chunk[ix], iter->npu_id, mac_entry)) {
+                continue;
+            }
+            if (iter->match_port) {
+                if (mac_entry->mac_entry_type == NDI_MAC_ENTRY_TYPE_1D_REMOTE) {
+                    continue;
+                }
+                if (iter->ndi_lag_id != 0) {
+                    if (mac_entry->ndi_lag_id != iter->ndi_lag_id) continue;
+                } else if ((mac_entry->ndi_lag_id != 0) ||
+                           (mac_entry->port_info.npu_id != iter->port_info.npu_id) ||
+                           (mac_entry->port_info.npu_port != iter->port_info.npu_port)) {
+                    continue;
+                }
+            }
+            filled++;
+        }
+    }
+
+    *count = filled;
+    return STD_ERR_OK;
+}
+
+void ndi_mac_iter_destroy(ndi_mac_iter_t *iter)
+{
+    delete iter;
+}
+
+/* Update FDB shadow from FDB event */
+static void _ndi_mac_shadow_event(const sai_fdb_event_notification_data_t & data){
+    if (!ndi_fdb_shadow_is_enabled()) {
+        return;
+    }
+    switch (data.event_type) {
+        case SAI_FDB_EVENT_LEARNED:
+        case SAI_FDB_EVENT_MOVE:
+            _ndi_mac_shadow_add(data.fdb_entry, data.attr_count, data.attr);
+            break;
+
+        case SAI_FDB_EVENT_AGED:
+            ndi_fdb_shadow_del(data.fdb_entry.bv_id, data.fdb_entry.mac_address);
+            break;
+
+        case SAI_FDB_EVENT_FLUSHED: {
+            ndi_fdb_shadow_filter_t filter;
+            filter.brport_id = SAI_NULL_OBJECT_ID;
+            filter.bv_id = data.fdb_entry.bv_id;
+            filter.type = NDI_FDB_SHADOW_TYPE_DYNAMIC;
+            for (uint32_t ix = 0; ix < data.attr_count; ++ix) {
+                if (data.attr[ix].id == SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID) {
+                    filter.brport_id = data.attr[ix].value.oid;
+                } else if (data.attr[ix].id == SAI_FDB_ENTRY_ATTR_TYPE) {
+                    filter.type = (data.attr[ix].value.s32 == SAI_FDB_ENTRY_TYPE_STATIC) ?
+                                  NDI_FDB_SHADOW_TYPE_STATIC : NDI_FDB_SHADOW_TYPE_DYNAMIC;
+                }
+            }
+            ndi_fdb_shadow_flush(&filter);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
 void ndi_fdb_event_cb (uint32_t count,sai_fdb_event_notification_data_t *data)
 {
     ndi_mac_entry_t ndi_mac_entry_temp;
@@ -679,6 +1759,8 @@ void ndi_fdb_event_cb (uint32_t count,sai_fdb_event_notification_data_t *data)
             /*Ignore the entry. Continue with next entry*/
             continue;
         }
+        _ndi_mac_shadow_event(data[entry_idx]);
+
         /* Setting the default values */
         ndi_mac_entry_temp.is_static = false;
         ndi_mac_entry_temp.action =  BASE_MAC_PACKET_ACTION_FORWARD;
@@ -723,6 +1805,11 @@ void ndi_fdb_event_cb (uint32_t count,sai_fdb_event_notification_data_t *data)
             }
         }
 
+        if (_ndi_mac_flush_track_event(data[entry_idx], brport_id, ndi_mac_entry_temp.is_static)) {
+            /* reported in flush completion */
+            continue;
+        }
+
         ndi_mac_event_type_temp = ndi_mac_event_type_get(data[entry_idx].event_type);
         ndi_virtual_obj_t obj;
         obj.oid = data[entry_idx].fdb_entry.bv_id;
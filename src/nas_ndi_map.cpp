@@ -290,4 +290,25 @@ t_std_error nas_ndi_map_get_val_count (nas_ndi_map_key_t *key, size_t *count)
     std_mutex_unlock (&nas_ndi_map_mutex);
     return rc;
 }
+
+t_std_error nas_ndi_map_walk (nas_ndi_map_walk_fn fn, void *context)
+{
+    t_std_error rc = STD_ERR_OK;
+
+    std_mutex_lock (&nas_ndi_map_mutex);
+
+    try {
+        for (auto& map_it: *g_nas_ndi_map) {
+            for (auto& data: map_it.second) {
+                fn (&map_it.first, &data, context);
+            }
+        }
+    }
+    catch (...) {
+        rc = STD_ERR(NPU, FAIL, 0);
+    }
+
+    std_mutex_unlock (&nas_ndi_map_mutex);
+    return rc;
+}
 }
@@ -33,6 +33,9 @@
 
 #include <inttypes.h>
 #include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 
 static inline sai_l2mc_api_t *ndi_mcast_api_get(nas_ndi_db_t *ndi_db_ptr)
 {
@@ -214,6 +217,69 @@ static std::string ndi_ipmc_entry_to_string(const ndi_ipmc_entry_t& ipmc_entry)
     return ss.str();
 }
 
+#define NDI_IPMC_ENTRY_ATTR_MAX 3
+
+/* Attributes of a new entry, returns number of attributes */
+static size_t ndi_ipmc_entry_create_attr(const ndi_ipmc_entry_t& ipmc_entry, ndi_obj_id_t rpf_grp_id,
+                                         ndi_obj_id_t ipmc_grp_id, sai_attribute_t *sai_attr)
+{
+    size_t attr_cnt = 0;
+    sai_attr[attr_cnt].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
+    sai_attr[attr_cnt].value.s32 =
+        (ipmc_entry.copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
+    attr_cnt++;
+    sai_attr[attr_cnt].id = SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID;
+    sai_attr[attr_cnt].value.oid = static_cast<sai_object_id_t>(rpf_grp_id);
+    attr_cnt++;
+    if (ipmc_grp_id > 0) {
+        sai_attr[attr_cnt].id = SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID;
+        sai_attr[attr_cnt].value.oid = static_cast<sai_object_id_t>(ipmc_grp_id);
+        attr_cnt++;
+    }
+    return attr_cnt;
+}
+
+/* Attributes to be set for an update, returns 0 for invalid update type */
+static size_t ndi_ipmc_entry_update_attr(const ndi_ipmc_entry_t& ipmc_entry, ndi_ipmc_update_type_t upd_type,
+                                         ndi_obj_id_t rpf_grp_id, ndi_obj_id_t ipmc_grp_id,
+                                         sai_attribute_t *sai_attr)
+{
+    size_t attr_cnt = 0;
+    switch(upd_type) {
+    case NAS_NDI_IPMC_UPD_REPL_GRP:
+        sai_attr[0].id = SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID;
+        sai_attr[0].value.oid = static_cast<sai_object_id_t>(rpf_grp_id);
+        attr_cnt++;
+
+        //for now SAI doesn't manage internally COPY_TO_CPU for a route.
+        //On certain platforms, when CopyToCpu is enabled, the CPU port is added to
+        //l2 ports of the repl. group entry. Hence it always results in an update
+        //to repl. group id.
+        //Hence irrespective of whether CopyToCpu changed or not, anytime there is an
+        //update to repl. group id, CopyToCpu attribute is also updated to SAI.
+        sai_attr[1].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
+        sai_attr[1].value.s32 =
+            (ipmc_entry.copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
+        attr_cnt++;
+        // IPMC can be 0 in case route with no OIF's, do not send ipmc attr
+        if (ipmc_grp_id > 0) {
+            sai_attr[2].id = SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID;
+            sai_attr[2].value.oid = static_cast<sai_object_id_t>(ipmc_grp_id);
+            attr_cnt++;
+        }
+        break;
+    case NAS_NDI_IPMC_UPD_COPY_TO_CPU:
+        sai_attr[0].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
+        sai_attr[0].value.s32 =
+            (ipmc_entry.copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
+        attr_cnt = 1;
+        break;
+    default:
+        break;
+    }
+    return attr_cnt;
+}
+
 t_std_error ndi_ipmc_entry_create(npu_id_t npu_id, const ndi_ipmc_entry_t *ipmc_entry_p)
 {
     NDI_MCAST_LOG_INFO("Create IPMC entry: %s", ndi_ipmc_entry_to_string(*ipmc_entry_p).c_str());
@@ -239,19 +305,8 @@ t_std_error ndi_ipmc_entry_create(npu_id_t npu_id, const ndi_ipmc_entry_t *ipmc_
         return STD_ERR(MCAST, PARAM, 0);
     }
 
-    sai_attribute_t sai_attr[3];
-    size_t attr_cnt = 1;
-    sai_attr[0].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
-    sai_attr[0].value.s32 =
-        (ipmc_entry_p->copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
-    sai_attr[1].id = SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID;
-    sai_attr[1].value.oid = static_cast<sai_object_id_t>(rpf_grp_id);
-    attr_cnt++;
-    if (ipmc_grp_id > 0) {
-        sai_attr[2].id = SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID;
-        sai_attr[2].value.oid = static_cast<sai_object_id_t>(ipmc_grp_id);
-        attr_cnt++;
-    }
+    sai_attribute_t sai_attr[NDI_IPMC_ENTRY_ATTR_MAX];
+    size_t attr_cnt = ndi_ipmc_entry_create_attr(*ipmc_entry_p, rpf_grp_id, ipmc_grp_id, sai_attr);
 
     sai_status_t sai_ret = ndi_ipmc_api_get(ndi_db_ptr)->create_ipmc_entry((sai_ipmc_entry_t *)&sai_entry,
                                 attr_cnt, sai_attr);
@@ -314,42 +369,15 @@ t_std_error ndi_ipmc_entry_update(npu_id_t npu_id, const ndi_ipmc_entry_t *ipmc_
         return STD_ERR(MCAST, PARAM, 0);
     }
 
-    sai_attribute_t sai_attr[3];
-    size_t attr_cnt = 0;
-    switch(upd_type) {
-    case NAS_NDI_IPMC_UPD_REPL_GRP:
+    if (upd_type == NAS_NDI_IPMC_UPD_REPL_GRP) {
         NDI_MCAST_LOG_INFO("Update replication group to %ld: RPF_GRP_ID=%ld IPMC_GRP_ID=%ld",
                             ipmc_entry_p->repl_group_id, rpf_grp_id, ipmc_grp_id);
-        NDI_MCAST_LOG_INFO("Update copy_to_cpu to %s", ipmc_entry_p->copy_to_cpu ? "TRUE" : "FALSE");
-        sai_attr[0].id = SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID;
-        sai_attr[0].value.oid = static_cast<sai_object_id_t>(rpf_grp_id);
-        attr_cnt++;
+    }
+    NDI_MCAST_LOG_INFO("Update copy_to_cpu to %s", ipmc_entry_p->copy_to_cpu ? "TRUE" : "FALSE");
 
-        //for now SAI doesn't manage internally COPY_TO_CPU for a route.
-        //On certain platforms, when CopyToCpu is enabled, the CPU port is added to
-        //l2 ports of the repl. group entry. Hence it always results in an update
-        //to repl. group id.
-        //Hence irrespective of whether CopyToCpu changed or not, anytime there is an
-        //update to repl. group id, CopyToCpu attribute is also updated to SAI.
-        sai_attr[1].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
-        sai_attr[1].value.s32 =
-            (ipmc_entry_p->copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
-        attr_cnt++;
-        // IPMC can be 0 in case route with no OIF's, do not send ipmc attr
-        if (ipmc_grp_id > 0) {
-            sai_attr[2].id = SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID;
-            sai_attr[2].value.oid = static_cast<sai_object_id_t>(ipmc_grp_id);
-            attr_cnt++;
-        }
-        break;
-    case NAS_NDI_IPMC_UPD_COPY_TO_CPU:
-        NDI_MCAST_LOG_INFO("Update copy_to_cpu to %s", ipmc_entry_p->copy_to_cpu ? "TRUE" : "FALSE");
-        sai_attr[0].id = SAI_IPMC_ENTRY_ATTR_PACKET_ACTION;
-        sai_attr[0].value.s32 =
-            (ipmc_entry_p->copy_to_cpu ? SAI_PACKET_ACTION_LOG : SAI_PACKET_ACTION_FORWARD);
-        attr_cnt = 1;
-        break;
-    default:
+    sai_attribute_t sai_attr[NDI_IPMC_ENTRY_ATTR_MAX];
+    size_t attr_cnt = ndi_ipmc_entry_update_attr(*ipmc_entry_p, upd_type, rpf_grp_id, ipmc_grp_id, sai_attr);
+    if (attr_cnt == 0) {
         NDI_MCAST_LOG_ERROR("Invalid update type");
         return STD_ERR(MCAST, PARAM, 0);
     }
@@ -399,3 +427,215 @@ t_std_error ndi_ipmc_entry_get(npu_id_t npu_id, ndi_ipmc_entry_t *ipmc_entry_p)
 
     return STD_ERR_OK;
 }
+
+/*
+ * Sub group IDs of the replication groups of a batch, resolved once per
+ * replication group
+ */
+class ndi_ipmc_subgrp_resolver
+{
+public:
+    ndi_ipmc_subgrp_resolver(npu_id_t npu_id) : _npu_id(npu_id) {}
+
+    t_std_error get(ndi_obj_id_t repl_grp_id, ndi_obj_id_t& rpf_grp_id, ndi_obj_id_t& ipmc_grp_id)
+    {
+        auto itor = _subgrp_map.find(repl_grp_id);
+        if (itor == _subgrp_map.end()) {
+            subgrp_t subgrp{STD_ERR_OK, 0, 0};
+            subgrp.rc = ndi_ipmc_get_repl_subgrp_id(_npu_id, repl_grp_id, subgrp.rpf_grp_id,
+                                                    subgrp.ipmc_grp_id);
+            if (subgrp.rc != STD_ERR_OK) {
+                NDI_MCAST_LOG_ERROR("Failed get RPF and IPMC group id for repl id %ld", repl_grp_id);
+                subgrp.rc = STD_ERR(MCAST, PARAM, 0);
+            }
+            itor = _subgrp_map.insert({repl_grp_id, subgrp}).first;
+        }
+        rpf_grp_id = itor->second.rpf_grp_id;
+        ipmc_grp_id = itor->second.ipmc_grp_id;
+        return itor->second.rc;
+    }
+
+private:
+    struct subgrp_t
+    {
+        t_std_error rc;
+        ndi_obj_id_t rpf_grp_id;
+        ndi_obj_id_t ipmc_grp_id;
+    };
+
+    npu_id_t _npu_id;
+    std::unordered_map<ndi_obj_id_t, subgrp_t> _subgrp_map;
+};
+
+static t_std_error ndi_ipmc_entry_list_rc(const std::vector<t_std_error>& rc_vec, t_std_error *rc_list)
+{
+    t_std_error rc = STD_ERR_OK;
+    for (size_t idx = 0; idx < rc_vec.size(); idx ++) {
+        if (rc_list != nullptr) {
+            rc_list[idx] = rc_vec[idx];
+        }
+        if (rc == STD_ERR_OK && rc_vec[idx] != STD_ERR_OK) {
+            rc = rc_vec[idx];
+        }
+    }
+    return rc;
+}
+
+/*
+ * Entries are sorted by replication group so that entries sharing a group
+ * are programmed back to back
+ */
+static std::vector<size_t> ndi_ipmc_entry_list_order(const ndi_ipmc_entry_t *entry_list, size_t count)
+{
+    std::vector<size_t> order(count);
+    for (size_t idx = 0; idx < count; idx ++) {
+        order[idx] = idx;
+    }
+    std::stable_sort(order.begin(), order.end(), [entry_list](size_t i1, size_t i2) {
+        return entry_list[i1].repl_group_id < entry_list[i2].repl_group_id;
+    });
+    return order;
+}
+
+t_std_error ndi_ipmc_entries_create(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    t_std_error *rc_list)
+{
+    NDI_MCAST_LOG_INFO("Create %lu IPMC entries", count);
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    if (entry_list == nullptr || ndi_db_ptr == nullptr) {
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+    std::vector<ndi_ipmc_entry_t> done_list{};
+    done_list.reserve(count);
+    ndi_ipmc_subgrp_resolver resolver{npu_id};
+    sai_ipmc_api_t *ipmc_api = ndi_ipmc_api_get(ndi_db_ptr);
+
+    for (auto idx: ndi_ipmc_entry_list_order(entry_list, count)) {
+        auto& ipmc_entry = entry_list[idx];
+        sai_ipmc_entry_extn_t sai_entry;
+        if (!ndi_ipmc_entry_params_copy(&sai_entry, npu_id, &ipmc_entry)) {
+            rc_vec[idx] = STD_ERR(MCAST, FAIL, 0);
+            continue;
+        }
+        ndi_obj_id_t rpf_grp_id, ipmc_grp_id;
+        if ((rc_vec[idx] = resolver.get(ipmc_entry.repl_group_id, rpf_grp_id, ipmc_grp_id)) != STD_ERR_OK) {
+            continue;
+        }
+
+        sai_attribute_t sai_attr[NDI_IPMC_ENTRY_ATTR_MAX];
+        size_t attr_cnt = ndi_ipmc_entry_create_attr(ipmc_entry, rpf_grp_id, ipmc_grp_id, sai_attr);
+        sai_status_t sai_ret = ipmc_api->create_ipmc_entry((sai_ipmc_entry_t *)&sai_entry, attr_cnt, sai_attr);
+        if (sai_ret != SAI_STATUS_SUCCESS) {
+            NDI_MCAST_LOG_ERROR("Failed to create IPMC entry: %s",
+                                ndi_ipmc_entry_to_string(ipmc_entry).c_str());
+            rc_vec[idx] = STD_ERR(MCAST, FAIL, sai_ret);
+            continue;
+        }
+        done_list.push_back(ipmc_entry);
+    }
+
+    ndi_ipmc_cache_add_entries(npu_id, done_list);
+
+    return ndi_ipmc_entry_list_rc(rc_vec, rc_list);
+}
+
+t_std_error ndi_ipmc_entries_delete(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    t_std_error *rc_list)
+{
+    NDI_MCAST_LOG_INFO("Delete %lu IPMC entries", count);
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    if (entry_list == nullptr || ndi_db_ptr == nullptr) {
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+    std::vector<ndi_ipmc_entry_t> done_list{};
+    done_list.reserve(count);
+    sai_ipmc_api_t *ipmc_api = ndi_ipmc_api_get(ndi_db_ptr);
+
+    for (size_t idx = 0; idx < count; idx ++) {
+        auto& ipmc_entry = entry_list[idx];
+        sai_ipmc_entry_extn_t sai_entry;
+        if (!ndi_ipmc_entry_params_copy(&sai_entry, npu_id, &ipmc_entry)) {
+            rc_vec[idx] = STD_ERR(MCAST, FAIL, 0);
+            continue;
+        }
+        sai_status_t sai_ret = ipmc_api->remove_ipmc_entry((sai_ipmc_entry_t *)&sai_entry);
+        if (sai_ret != SAI_STATUS_SUCCESS) {
+            NDI_MCAST_LOG_ERROR("Failed to delete IPMC entry: %s",
+                                ndi_ipmc_entry_to_string(ipmc_entry).c_str());
+            rc_vec[idx] = STD_ERR(MCAST, FAIL, sai_ret);
+            continue;
+        }
+        done_list.push_back(ipmc_entry);
+    }
+
+    ndi_ipmc_cache_del_entries(npu_id, done_list);
+
+    return ndi_ipmc_entry_list_rc(rc_vec, rc_list);
+}
+
+t_std_error ndi_ipmc_entries_update(npu_id_t npu_id, const ndi_ipmc_entry_t *entry_list, size_t count,
+                                    ndi_ipmc_update_type_t upd_type, t_std_error *rc_list)
+{
+    NDI_MCAST_LOG_INFO("Update %lu IPMC entries", count);
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    if (entry_list == nullptr || ndi_db_ptr == nullptr) {
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+    if (upd_type != NAS_NDI_IPMC_UPD_REPL_GRP && upd_type != NAS_NDI_IPMC_UPD_COPY_TO_CPU) {
+        NDI_MCAST_LOG_ERROR("Invalid update type");
+        return STD_ERR(MCAST, PARAM, 0);
+    }
+
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+    std::vector<ndi_ipmc_entry_t> done_list{};
+    done_list.reserve(count);
+    ndi_ipmc_subgrp_resolver resolver{npu_id};
+    sai_ipmc_api_t *ipmc_api = ndi_ipmc_api_get(ndi_db_ptr);
+
+    for (auto idx: ndi_ipmc_entry_list_order(entry_list, count)) {
+        auto& ipmc_entry = entry_list[idx];
+        sai_ipmc_entry_extn_t sai_entry;
+        if (!ndi_ipmc_entry_params_copy(&sai_entry, npu_id, &ipmc_entry)) {
+            rc_vec[idx] = STD_ERR(MCAST, FAIL, 0);
+            continue;
+        }
+        ndi_obj_id_t rpf_grp_id = 0, ipmc_grp_id = 0;
+        if (upd_type == NAS_NDI_IPMC_UPD_REPL_GRP &&
+            (rc_vec[idx] = resolver.get(ipmc_entry.repl_group_id, rpf_grp_id, ipmc_grp_id)) != STD_ERR_OK) {
+            continue;
+        }
+
+        sai_attribute_t sai_attr[NDI_IPMC_ENTRY_ATTR_MAX];
+        size_t attr_cnt = ndi_ipmc_entry_update_attr(ipmc_entry, upd_type, rpf_grp_id, ipmc_grp_id, sai_attr);
+        for (size_t attr_idx = 0; attr_idx < attr_cnt; attr_idx ++) {
+            sai_status_t sai_ret = ipmc_api->set_ipmc_entry_attribute((sai_ipmc_entry_t *)&sai_entry,
+                                                                      &sai_attr[attr_idx]);
+            if (sai_ret != SAI_STATUS_SUCCESS) {
+                NDI_MCAST_LOG_ERROR("Failed to set IPMC entry attribute: %s",
+                                    ndi_ipmc_entry_to_string(ipmc_entry).c_str());
+                rc_vec[idx] = STD_ERR(MCAST, FAIL, sai_ret);
+                break;
+            }
+        }
+        if (rc_vec[idx] == STD_ERR_OK) {
+            done_list.push_back(ipmc_entry);
+        }
+    }
+
+    ndi_ipmc_cache_update_entries(npu_id, done_list, upd_type);
+
+    return ndi_ipmc_entry_list_rc(rc_vec, rc_list);
+}
@@ -20,26 +20,123 @@
 #include "nas_ndi_obj_cache_utils.h"
 #include "std_rw_lock.h"
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <memory>
+#include <new>
+#include <string.h>
+#include <thread>
+#include <vector>
 
 
+/*
+ * Sequence count for caches that are read without a lock. Writers are
+ * serialized by the mutex and keep the count odd while updating. Readers
+ * retry their lookup if the count was odd or changed while they read, so
+ * cached data read by them must be atomics.
+ */
+class ndi_obj_cache_seqlock {
+
+private:
+
+    std::mutex _lock;
+    std::atomic<uint32_t> _seq;
+
+public:
+
+    ndi_obj_cache_seqlock() {
+        _seq.store(0, std::memory_order_relaxed);
+    }
+
+    std::mutex & mutex() { return _lock; }
+
+    class write_guard {
+        std::lock_guard<std::mutex> _lg;
+        std::atomic<uint32_t> & _seq;
+    public:
+        write_guard(ndi_obj_cache_seqlock & sl) : _lg(sl._lock), _seq(sl._seq) {
+            _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~write_guard() {
+            _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    };
+
+    uint32_t read_begin() const {
+        uint32_t seq;
+        while ((seq = _seq.load(std::memory_order_acquire)) & 1) {
+            std::this_thread::yield();
+        }
+        return seq;
+    }
+
+    bool read_retry(uint32_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _seq.load(std::memory_order_relaxed) != seq;
+    }
+};
+
+static inline uint64_t ndi_obj_cache_hash_u64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/* VLAN ids below this are kept in the direct indexed tables */
+#define NDI_VIRTUAL_OBJ_MAX_VID     4096
+/* Twice the max number of VLAN oids in the oid table, keeps probes short */
+#define NDI_VIRTUAL_OBJ_TABLE_SIZE  (2 * NDI_VIRTUAL_OBJ_MAX_VID)
+
 class ndi_virtual_obj_cache {
 
 private:
 
+    /* Serializes writers, readers of the oid table use the sequence count */
+    ndi_obj_cache_seqlock _seqlock;
+
+    /* VLAN id to VLAN oid, SAI_NULL_OBJECT_ID if not set */
+    std::atomic<sai_object_id_t> _vid_to_obj[NDI_VIRTUAL_OBJ_MAX_VID];
+
+    /* VLAN oid to VLAN id, open addressing with linear probing */
+    typedef struct {
+        std::atomic<sai_object_id_t> oid;
+        std::atomic<hal_vlan_id_t> vid;
+    } obj_slot_t;
+    obj_slot_t _obj_to_vid[NDI_VIRTUAL_OBJ_TABLE_SIZE];
+
+    /* Virtual objects with VLAN id out of the direct indexed range */
     std_rw_lock_t rw_lock;
-    using ndi_shared_virtual_obj = std::shared_ptr<ndi_virtual_obj_t>;
+    std::map<hal_vlan_id_t, sai_object_id_t> _ext_vid_to_obj_map;
+    std::map<sai_object_id_t, hal_vlan_id_t> _ext_obj_to_vid_map;
+    std::atomic<size_t> _ext_count;
 
+    size_t obj_slot_home(sai_object_id_t oid) const {
+        return ndi_obj_cache_hash_u64(oid) & (NDI_VIRTUAL_OBJ_TABLE_SIZE - 1);
+    }
 
-    std::map<hal_vlan_id_t, ndi_shared_virtual_obj> _vid_to_obj_map;
-    std::map<sai_object_id_t, ndi_shared_virtual_obj> _obj_to_vid_map;
+    /* Writer only helpers, caller must hold the write guard */
+    bool obj_table_find(sai_object_id_t oid, size_t *pos) const;
+    void obj_table_insert(sai_object_id_t oid, hal_vlan_id_t vid);
+    void obj_table_erase(size_t pos);
+    bool remove_locked(sai_object_id_t oid);
 
 public:
     ndi_virtual_obj_cache() {
 
         std_rw_lock_create_default(&rw_lock);
+        for (auto & oid : _vid_to_obj) {
+            oid.store(SAI_NULL_OBJECT_ID, std::memory_order_relaxed);
+        }
+        for (auto & slot : _obj_to_vid) {
+            slot.oid.store(SAI_NULL_OBJECT_ID, std::memory_order_relaxed);
+            slot.vid.store(0, std::memory_order_relaxed);
+        }
+        _ext_count.store(0, std::memory_order_relaxed);
     }
 
     /*
@@ -58,6 +155,11 @@ public:
      */
     bool get_virtual_obj(ndi_virtual_obj_t * obj, ndi_virtual_obj_query_type_t qtype);
 
+    /*
+     * call given function for each of the virtual obj in the cache
+     */
+    void walk(virtual_obj_walk_fn fn);
+
 };
 
 /*
@@ -104,39 +206,327 @@ public:
 
 };
 
-class ndi_brport_cache {
+/*
+ * Bridge port cache. Bridge port records are kept in a slab of fixed size
+ * chunks which are never freed, and are indexed by open addressing hash
+ * tables of record indexes. Bridge ports of the same port are linked in a
+ * circular chain through the records, in add order.
+ *
+ * Writers are serialized by a mutex and bump a sequence count before and
+ * after every update. Readers take no lock, they retry the lookup if the
+ * sequence count changed while they were reading. Record data, chain links
+ * and hash slots are atomics, so a reader racing with a writer only reads
+ * stale values that are thrown away on retry. Hash tables only grow and the
+ * old tables are kept, so a reader still probing an old table stays safe.
+ */
+#define NDI_BRPORT_REC_NONE         UINT32_MAX
+#define NDI_BRPORT_CHUNK_SHIFT      12
+#define NDI_BRPORT_CHUNK_SIZE       (1u << NDI_BRPORT_CHUNK_SHIFT)
+#define NDI_BRPORT_MAX_CHUNKS       1024
+#define NDI_BRPORT_MAX_RECS         (NDI_BRPORT_CHUNK_SIZE * NDI_BRPORT_MAX_CHUNKS)
+#define NDI_BRPORT_REC_WORDS        ((sizeof(ndi_brport_obj_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+#define NDI_BRPORT_INDEX_MIN_SIZE   64
+
+typedef struct {
+    std::atomic<uint64_t> data[NDI_BRPORT_REC_WORDS];
+    std::atomic<uint32_t> port_next;
+    std::atomic<uint32_t> port_prev;
+} ndi_brport_rec_t;
+
+class ndi_brport_slab {
 
 private:
 
-    std_rw_lock_t rw_lock;
-    using brport_shared_ptr = std::shared_ptr<ndi_brport_obj_t> ;
+    std::atomic<ndi_brport_rec_t *> _chunks[NDI_BRPORT_MAX_CHUNKS];
+    /* Writer only */
+    uint32_t _size = 0;
+    std::vector<uint32_t> _free_list;
+    std::vector<bool> _in_use;
 
-    typedef struct ndi_bridge_pv {
-        sai_object_id_t port_id;
-        hal_vlan_id_t vid;
+public:
 
-        bool operator < (ndi_bridge_pv const & rhs) const{
-            return port_id < rhs.port_id || (port_id == rhs.port_id && vid < rhs.vid);
+    ndi_brport_slab() {
+        for (auto & chunk : _chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
         }
+    }
+
+    ndi_brport_rec_t * rec(uint32_t idx) const {
+        if (idx >= NDI_BRPORT_MAX_RECS) return nullptr;
+        auto chunk = _chunks[idx >> NDI_BRPORT_CHUNK_SHIFT].load(std::memory_order_acquire);
+        return (chunk == nullptr) ? nullptr : &chunk[idx & (NDI_BRPORT_CHUNK_SIZE - 1)];
+    }
+
+    /* Writer only, idx must be a record in use */
+    ndi_brport_rec_t & wrec(uint32_t idx) const {
+        return _chunks[idx >> NDI_BRPORT_CHUNK_SHIFT].load(std::memory_order_relaxed)
+                      [idx & (NDI_BRPORT_CHUNK_SIZE - 1)];
+    }
+
+    bool read(uint32_t idx, ndi_brport_obj_t * obj) const {
+        auto r = rec(idx);
+        if (r == nullptr) return false;
+        uint64_t words[NDI_BRPORT_REC_WORDS];
+        for (size_t ix = 0; ix < NDI_BRPORT_REC_WORDS; ++ix) {
+            words[ix] = r->data[ix].load(std::memory_order_relaxed);
+        }
+        memcpy(obj, words, sizeof(ndi_brport_obj_t));
+        return true;
+    }
+
+    void write(uint32_t idx, const ndi_brport_obj_t * obj) {
+        auto & r = wrec(idx);
+        uint64_t words[NDI_BRPORT_REC_WORDS] = {0};
+        memcpy(words, obj, sizeof(ndi_brport_obj_t));
+        for (size_t ix = 0; ix < NDI_BRPORT_REC_WORDS; ++ix) {
+            r.data[ix].store(words[ix], std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t alloc();
+
+    void free(uint32_t idx) {
+        _in_use[idx] = false;
+        _free_list.push_back(idx);
+    }
+
+    /* Writer only, call given function for each record in use */
+    template <typename Fn> void for_each(Fn fn) const {
+        for (uint32_t idx = 0; idx < _size; ++idx) {
+            if (_in_use[idx]) fn(idx);
+        }
+    }
+};
+
+uint32_t ndi_brport_slab::alloc() {
+    uint32_t idx;
+    if (!_free_list.empty()) {
+        idx = _free_list.back();
+        _free_list.pop_back();
+        _in_use[idx] = true;
+        return idx;
+    }
+    if (_size == NDI_BRPORT_MAX_RECS) return NDI_BRPORT_REC_NONE;
+
+    if ((_size & (NDI_BRPORT_CHUNK_SIZE - 1)) == 0) {
+        auto chunk = new (std::nothrow) ndi_brport_rec_t[NDI_BRPORT_CHUNK_SIZE]();
+        if (chunk == nullptr) return NDI_BRPORT_REC_NONE;
+        _chunks[_size >> NDI_BRPORT_CHUNK_SHIFT].store(chunk, std::memory_order_release);
+    }
+    _in_use.push_back(true);
+    return _size++;
+}
+
+/*
+ * Open addressing hash index with linear probing. Slots hold record index + 1,
+ * 0 is an empty slot. Entries are removed with backward shift so there are no
+ * tombstones and the table never has to be rebuilt at the same size.
+ */
+class ndi_brport_index {
+
+private:
+
+    using hash_fn = uint64_t (*)(const ndi_brport_obj_t &);
+    using match_fn = bool (*)(const ndi_brport_obj_t &, const ndi_brport_obj_t &);
+
+    typedef struct {
+        size_t mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> slots;
+    } table_t;
+
+    hash_fn _hash;
+    match_fn _match;
+    std::atomic<table_t *> _table;
+    /* Current and all the older tables, older ones may still be in use by readers */
+    std::vector<std::unique_ptr<table_t>> _tables;
+    size_t _count = 0;
+
+    bool grow(const ndi_brport_slab & slab);
+
+public:
+
+    ndi_brport_index(hash_fn hash, match_fn match) : _hash(hash), _match(match) {
+        _table.store(nullptr, std::memory_order_relaxed);
+    }
+
+    /*
+     * Find record matching the key and copy it to rec, safe to call without
+     * the writer lock under a read sequence
+     */
+    uint32_t find(const ndi_brport_slab & slab, const ndi_brport_obj_t & key,
+                  ndi_brport_obj_t * rec) const;
+
+    /* Add record, replaces the record with the same key if any */
+    bool insert(const ndi_brport_slab & slab, uint32_t idx, const ndi_brport_obj_t & rec);
+
+    /* Remove the slot holding the record if any */
+    void erase(const ndi_brport_slab & slab, uint32_t idx, const ndi_brport_obj_t & rec);
+};
+
+uint32_t ndi_brport_index::find(const ndi_brport_slab & slab, const ndi_brport_obj_t & key,
+                                ndi_brport_obj_t * rec) const {
+    auto table = _table.load(std::memory_order_acquire);
+    if (table == nullptr) return NDI_BRPORT_REC_NONE;
+
+    size_t pos = _hash(key) & table->mask;
+    for (size_t probe = 0; probe <= table->mask; ++probe) {
+        uint32_t val = table->slots[pos].load(std::memory_order_relaxed);
+        if (val == 0) break;
+        if (slab.read(val - 1, rec) && _match(*rec, key)) {
+            return val - 1;
+        }
+        pos = (pos + 1) & table->mask;
+    }
+    return NDI_BRPORT_REC_NONE;
+}
+
+bool ndi_brport_index::grow(const ndi_brport_slab & slab) {
+    auto old_table = _table.load(std::memory_order_relaxed);
+    size_t size = (old_table == nullptr) ? NDI_BRPORT_INDEX_MIN_SIZE : (old_table->mask + 1) * 2;
+
+    std::unique_ptr<table_t> table(new (std::nothrow) table_t);
+    if (!table) return false;
+    table->mask = size - 1;
+    table->slots.reset(new (std::nothrow) std::atomic<uint32_t>[size]());
+    if (!table->slots) return false;
+
+    if (old_table != nullptr) {
+        ndi_brport_obj_t rec;
+        for (size_t ix = 0; ix <= old_table->mask; ++ix) {
+            uint32_t val = old_table->slots[ix].load(std::memory_order_relaxed);
+            if (val == 0 || !slab.read(val - 1, &rec)) continue;
+            size_t pos = _hash(rec) & table->mask;
+            while (table->slots[pos].load(std::memory_order_relaxed) != 0) {
+                pos = (pos + 1) & table->mask;
+            }
+            table->slots[pos].store(val, std::memory_order_relaxed);
+        }
+    }
+    _table.store(table.get(), std::memory_order_release);
+    _tables.push_back(std::move(table));
+    return true;
+}
+
+bool ndi_brport_index::insert(const ndi_brport_slab & slab, uint32_t idx, const ndi_brport_obj_t & rec) {
+    auto table = _table.load(std::memory_order_relaxed);
+    if (table == nullptr || (_count + 1) * 2 > table->mask + 1) {
+        if (!grow(slab)) return false;
+        table = _table.load(std::memory_order_relaxed);
+    }
+
+    ndi_brport_obj_t cur;
+    size_t pos = _hash(rec) & table->mask;
+    while (true) {
+        uint32_t val = table->slots[pos].load(std::memory_order_relaxed);
+        if (val == 0) {
+            ++_count;
+            break;
+        }
+        if (slab.read(val - 1, &cur) && _match(cur, rec)) {
+            break;
+        }
+        pos = (pos + 1) & table->mask;
+    }
+    table->slots[pos].store(idx + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void ndi_brport_index::erase(const ndi_brport_slab & slab, uint32_t idx, const ndi_brport_obj_t & rec) {
+    auto table = _table.load(std::memory_order_relaxed);
+    if (table == nullptr) return;
+
+    size_t hole = _hash(rec) & table->mask;
+    while (true) {
+        uint32_t val = table->slots[hole].load(std::memory_order_relaxed);
+        if (val == 0) return;
+        if (val == idx + 1) break;
+        hole = (hole + 1) & table->mask;
+    }
+
+    /* Shift back the following entries which probed past the hole */
+    ndi_brport_obj_t cur;
+    size_t pos = hole;
+    while (true) {
+        pos = (pos + 1) & table->mask;
+        uint32_t val = table->slots[pos].load(std::memory_order_relaxed);
+        if (val == 0 || !slab.read(val - 1, &cur)) break;
+        size_t home = _hash(cur) & table->mask;
+        if (((pos - home) & table->mask) >= ((pos - hole) & table->mask)) {
+            table->slots[hole].store(val, std::memory_order_relaxed);
+            hole = pos;
+        }
+    }
+    table->slots[hole].store(0, std::memory_order_relaxed);
+    --_count;
+}
+
+static uint64_t ndi_brport_hash_brport(const ndi_brport_obj_t & obj) {
+    return ndi_obj_cache_hash_u64(obj.brport_obj_id);
+}
+
+static bool ndi_brport_match_brport(const ndi_brport_obj_t & rec, const ndi_brport_obj_t & key) {
+    return rec.brport_obj_id == key.brport_obj_id;
+}
+
+static uint64_t ndi_brport_hash_port(const ndi_brport_obj_t & obj) {
+    return ndi_obj_cache_hash_u64(obj.port_obj_id);
+}
+
+static bool ndi_brport_match_port(const ndi_brport_obj_t & rec, const ndi_brport_obj_t & key) {
+    return rec.port_obj_id == key.port_obj_id;
+}
+
+static uint64_t ndi_brport_hash_pv(const ndi_brport_obj_t & obj) {
+    return ndi_obj_cache_hash_u64(obj.port_obj_id ^ ((uint64_t)obj.vlan_id << 48));
+}
+
+static bool ndi_brport_match_pv(const ndi_brport_obj_t & rec, const ndi_brport_obj_t & key) {
+    return rec.port_obj_id == key.port_obj_id && rec.vlan_id == key.vlan_id;
+}
+
+static uint64_t ndi_brport_hash_rif(const ndi_brport_obj_t & obj) {
+    return ndi_obj_cache_hash_u64(obj.rif_obj_id);
+}
+
+static bool ndi_brport_match_rif(const ndi_brport_obj_t & rec, const ndi_brport_obj_t & key) {
+    return rec.rif_obj_id == key.rif_obj_id;
+}
+
+static inline bool ndi_brport_is_subport(ndi_brport_type_t type) {
+    return type == ndi_brport_type_SUBPORT_TAG || type == ndi_brport_type_SUBPORT_UNTAG;
+}
+
+class ndi_brport_cache {
+
+private:
+
+    /* Serializes writers, readers only use the sequence count */
+    ndi_obj_cache_seqlock _seqlock;
 
-    }ndi_bridge_pv_t;
+    ndi_brport_slab _slab;
+
+    /* All bridge ports, including 1D router bridge ports */
+    ndi_brport_index _brport_idx {ndi_brport_hash_brport, ndi_brport_match_brport};
     /* Only for  .1Q port to bridge port mapping.
      * Where a port is associated with one bridge port
     */
-    std::map<sai_object_id_t, brport_shared_ptr> _port_to_brport_blk;
-    std::map<sai_object_id_t, brport_shared_ptr> _brport_to_port_blk;
-
+    ndi_brport_index _port_idx {ndi_brport_hash_port, ndi_brport_match_port};
     /* valid for SUBPORT type bridgeport */
-    std::map<ndi_bridge_pv_t, brport_shared_ptr> _pv_to_brport_blk;
+    ndi_brport_index _pv_idx {ndi_brport_hash_pv, ndi_brport_match_pv};
+    /* valid for 1D router bridgeport */
+    ndi_brport_index _rif_idx {ndi_brport_hash_rif, ndi_brport_match_rif};
+    /* First bridge port of the per port chain */
+    ndi_brport_index _chain_idx {ndi_brport_hash_port, ndi_brport_match_port};
+
+    /* Add bridge port to all the mappings, caller must hold the write guard */
+    bool add_bridge_port_locked(const ndi_brport_obj_t * obj);
 
-    std::map<sai_object_id_t, brport_list> _port_to_brport_list;
-    std::map<sai_object_id_t, brport_shared_ptr> _rif_to_brport_blk;
+    /* Remove record from all the mappings, caller must hold the write guard */
+    void remove_rec_locked(uint32_t idx, const ndi_brport_obj_t & rec);
 
 public:
 
-    ndi_brport_cache () {
-        std_rw_lock_create_default(&rw_lock);
-    }
+    ndi_brport_cache () {}
 
     /*
      * Store the bridge port struct to maintain all types of mapping needed
@@ -144,6 +534,12 @@ public:
      */
     bool add_bridge_port(ndi_brport_obj_t * obj);
 
+    /*
+     * Store a list of bridge ports under a single lock, used to fill
+     * the cache during init
+     */
+    bool add_bridge_port_list(const ndi_brport_obj_t * obj_list, size_t count);
+
     /*
      * remove the bridge port from all the mappings,brport_obj_id is
      * mandatory
@@ -161,54 +557,48 @@ public:
      */
     bool get_brport_list (sai_object_id_t obj_id, brport_list & list);
 
+    /*
+     * call given function for each of the bridge port in the cache
+     */
+    void walk(brport_walk_fn fn);
+
 };
 
 bool ndi_brport_cache::get_brport_block(ndi_brport_obj_t * obj, ndi_brport_query_type_t qtype) {
 
     if (obj == nullptr) return false;
-    std_rw_lock_read_guard lg(&rw_lock);
 
-    switch(qtype) {
-        case ndi_brport_query_type_FROM_BRPORT:
-            {
-                auto it = _brport_to_port_blk.find(obj->brport_obj_id);
-                if ( it == _brport_to_port_blk.end()) return false;
-                memcpy(obj, &(*(it->second)), sizeof(ndi_brport_obj_t));
+    ndi_brport_obj_t rec;
+    uint32_t idx;
+    uint32_t seq;
+    do {
+        seq = _seqlock.read_begin();
+        switch(qtype) {
+            case ndi_brport_query_type_FROM_BRPORT:
+                idx = _brport_idx.find(_slab, *obj, &rec);
+                /* 1D router bridge ports are only looked up by rif */
+                if (idx != NDI_BRPORT_REC_NONE && rec.brport_type == ndi_brport_type_1D_ROUTER) {
+                    idx = NDI_BRPORT_REC_NONE;
+                }
                 break;
-            }
-
-        case ndi_brport_query_type_FROM_PORT_VLAN:
-            {
-                /* Use for subport type only */
-                ndi_bridge_pv_t pv_obj;
-                pv_obj.port_id = obj->port_obj_id;
-                pv_obj.vid = obj->vlan_id;
-                auto pv_it = _pv_to_brport_blk.find(pv_obj);
-                if ( pv_it == _pv_to_brport_blk.end()) return false;
-                memcpy(obj, &(*(pv_it->second)), sizeof(ndi_brport_obj_t));
+            /* Use for subport type only */
+            case ndi_brport_query_type_FROM_PORT_VLAN:
+                idx = _pv_idx.find(_slab, *obj, &rec);
                 break;
-            }
-        /* This is only for .1q ports */
-        case ndi_brport_query_type_FROM_PORT:
-            {
-                /* use for physical/lag port  */
-                auto blk_it = _port_to_brport_blk.find(obj->port_obj_id);
-                if ( blk_it == _port_to_brport_blk.end())  return false;
-                memcpy(obj, &(*(blk_it->second)), sizeof(ndi_brport_obj_t));
+            /* This is only for .1q ports */
+            case ndi_brport_query_type_FROM_PORT:
+                idx = _port_idx.find(_slab, *obj, &rec);
                 break;
-            }
-        case ndi_brport_query_type_FROM_RIF:
-            {
-                auto blk_it = _rif_to_brport_blk.find(obj->rif_obj_id);
-                if ( blk_it == _rif_to_brport_blk.end())  return false;
-                memcpy(obj, &(*(blk_it->second)), sizeof(ndi_brport_obj_t));
+            case ndi_brport_query_type_FROM_RIF:
+                idx = _rif_idx.find(_slab, *obj, &rec);
                 break;
-            }
-
-        default:
-            return false;
+            default:
+                return false;
+        }
+    } while (_seqlock.read_retry(seq));
 
-    }
+    if (idx == NDI_BRPORT_REC_NONE) return false;
+    memcpy(obj, &rec, sizeof(ndi_brport_obj_t));
     return true;
 }
 
@@ -216,91 +606,184 @@ bool ndi_brport_cache::get_brport_block(ndi_brport_obj_t * obj, ndi_brport_query
 /* may be have only 1D bridge members in this list */
 bool ndi_brport_cache::get_brport_list (sai_object_id_t port_oid, brport_list & list)  {
 
-    std_rw_lock_read_guard lg(&rw_lock);
-    auto it = _port_to_brport_list.find(port_oid);
-    if ( it == _port_to_brport_list.end()) return false;
-    list = it->second;
-    return true;
+    ndi_brport_obj_t key, rec;
+    key.port_obj_id = port_oid;
+    uint32_t head;
+    uint32_t seq;
+    do {
+        seq = _seqlock.read_begin();
+        list.clear();
+        head = _chain_idx.find(_slab, key, &rec);
+        uint32_t idx = head;
+        /* Bounded in case the chain is changed under the reader */
+        for (uint32_t count = 0; idx != NDI_BRPORT_REC_NONE && count < NDI_BRPORT_MAX_RECS; ++count) {
+            auto r = _slab.rec(idx);
+            if (r == nullptr || !_slab.read(idx, &rec)) break;
+            list.push_back(rec.brport_obj_id);
+            idx = r->port_next.load(std::memory_order_relaxed);
+            if (idx == head) break;
+        }
+    } while (_seqlock.read_retry(seq));
 
+    return head != NDI_BRPORT_REC_NONE;
 }
 
-bool ndi_brport_cache::add_bridge_port(ndi_brport_obj_t *obj) {
-    if (obj == nullptr) return false;
-    auto var = std::make_shared<ndi_brport_obj_t>(*obj);
+void ndi_brport_cache::walk(brport_walk_fn fn) {
 
-    std_rw_lock_write_guard lg(&rw_lock);
-    if  (obj->brport_type == ndi_brport_type_1D_ROUTER) {
-        _rif_to_brport_blk[obj->rif_obj_id] = var;
-        return true;
+    std::lock_guard<std::mutex> lg(_seqlock.mutex());
+    ndi_brport_obj_t rec;
+    _slab.for_each([&](uint32_t idx) {
+        if (_slab.read(idx, &rec)) fn(rec);
+    });
+}
+
+void ndi_brport_cache::remove_rec_locked(uint32_t idx, const ndi_brport_obj_t & rec) {
+
+    _brport_idx.erase(_slab, idx, rec);
+
+    if (rec.brport_type == ndi_brport_type_1D_ROUTER) {
+        _rif_idx.erase(_slab, idx, rec);
+        _slab.free(idx);
+        return;
     }
-    /* Added for only .IQ entries */
-    if  (obj->brport_type == ndi_brport_type_PORT) {
-      _port_to_brport_blk[obj->port_obj_id] = var;
+    if (rec.brport_type == ndi_brport_type_PORT) {
+        _port_idx.erase(_slab, idx, rec);
+    }
+    if (ndi_brport_is_subport(rec.brport_type)) {
+        _pv_idx.erase(_slab, idx, rec);
     }
 
-    _brport_to_port_blk[obj->brport_obj_id] = var;
+    /* Unlink from the port chain, move chain head to next if needed */
+    auto & r = _slab.wrec(idx);
+    uint32_t next = r.port_next.load(std::memory_order_relaxed);
+    uint32_t prev = r.port_prev.load(std::memory_order_relaxed);
+    ndi_brport_obj_t head_rec;
+    bool is_head = (_chain_idx.find(_slab, rec, &head_rec) == idx);
+
+    if (next == idx) {
+        _chain_idx.erase(_slab, idx, rec);
+    } else {
+        _slab.wrec(prev).port_next.store(next, std::memory_order_relaxed);
+        _slab.wrec(next).port_prev.store(prev, std::memory_order_relaxed);
+        if (is_head) {
+            ndi_brport_obj_t next_rec;
+            _slab.read(next, &next_rec);
+            _chain_idx.insert(_slab, next, next_rec);
+        }
+    }
+    _slab.free(idx);
+}
+
+bool ndi_brport_cache::add_bridge_port_locked(const ndi_brport_obj_t *obj) {
 
-    if  (obj->brport_type == ndi_brport_type_SUBPORT_UNTAG || obj->brport_type == ndi_brport_type_SUBPORT_TAG) {
-        ndi_bridge_pv_t ndi_bridge_pv_val;
-        ndi_bridge_pv_val.port_id = obj->port_obj_id;
-        ndi_bridge_pv_val.vid = obj->vlan_id;
-        _pv_to_brport_blk[ndi_bridge_pv_val] = var;
+    ndi_brport_obj_t rec;
+    uint32_t idx;
+
+    /* Replace bridge port added before with the same id */
+    if ((idx = _brport_idx.find(_slab, *obj, &rec)) != NDI_BRPORT_REC_NONE) {
+        remove_rec_locked(idx, rec);
+    }
+    if  (obj->brport_type == ndi_brport_type_1D_ROUTER &&
+         (idx = _rif_idx.find(_slab, *obj, &rec)) != NDI_BRPORT_REC_NONE) {
+        remove_rec_locked(idx, rec);
     }
+
+    if ((idx = _slab.alloc()) == NDI_BRPORT_REC_NONE) {
+        NDI_LOG_ERROR("NDI-CACHE", "Bridge port cache full, brport 0x%lx",
+                      obj->brport_obj_id);
+        return false;
+    }
+    _slab.write(idx, obj);
+    rec = *obj;
+
+    if (!_brport_idx.insert(_slab, idx, rec)) goto nomem;
+
+    if  (rec.brport_type == ndi_brport_type_1D_ROUTER) {
+        if (!_rif_idx.insert(_slab, idx, rec)) goto nomem;
+        return true;
+    }
+    /* Added for only .IQ entries */
+    if  (rec.brport_type == ndi_brport_type_PORT) {
+        if (!_port_idx.insert(_slab, idx, rec)) goto nomem;
+    }
+    if  (ndi_brport_is_subport(rec.brport_type)) {
+        if (!_pv_idx.insert(_slab, idx, rec)) goto nomem;
+    }
+
     /* TUNNEL AND SUBPORT will have lists . Tunnel oid is associated to various bridges */
-    _port_to_brport_list[obj->port_obj_id].push_back(obj->brport_obj_id);
+    {
+        auto & r = _slab.wrec(idx);
+        ndi_brport_obj_t head_rec;
+        uint32_t head = _chain_idx.find(_slab, rec, &head_rec);
+        if (head == NDI_BRPORT_REC_NONE) {
+            r.port_next.store(idx, std::memory_order_relaxed);
+            r.port_prev.store(idx, std::memory_order_relaxed);
+            if (!_chain_idx.insert(_slab, idx, rec)) goto nomem;
+        } else {
+            auto & h = _slab.wrec(head);
+            uint32_t tail = h.port_prev.load(std::memory_order_relaxed);
+            r.port_next.store(head, std::memory_order_relaxed);
+            r.port_prev.store(tail, std::memory_order_relaxed);
+            _slab.wrec(tail).port_next.store(idx, std::memory_order_relaxed);
+            h.port_prev.store(idx, std::memory_order_relaxed);
+        }
+    }
     return true;
+
+nomem:
+    NDI_LOG_ERROR("NDI-CACHE", "Bridge port cache index allocation failed, brport 0x%lx",
+                  obj->brport_obj_id);
+    _brport_idx.erase(_slab, idx, rec);
+    _rif_idx.erase(_slab, idx, rec);
+    _port_idx.erase(_slab, idx, rec);
+    _pv_idx.erase(_slab, idx, rec);
+    _slab.free(idx);
+    return false;
 }
-/* needs bridge port id and bridge port type. If type is subport needs  vlan_id also */
-bool ndi_brport_cache::remove_bridge_port(ndi_brport_obj_t * obj) {
 
-    bool found = false;
+bool ndi_brport_cache::add_bridge_port(ndi_brport_obj_t *obj) {
     if (obj == nullptr) return false;
-    std_rw_lock_write_guard lg(&rw_lock);
 
-    if  (obj->brport_type == ndi_brport_type_1D_ROUTER) {
-        auto br_it = _rif_to_brport_blk.find(obj->rif_obj_id);
-        if ( br_it == _rif_to_brport_blk.end()) return false;
-        _rif_to_brport_blk.erase(br_it);
-        return true;
+    ndi_obj_cache_seqlock::write_guard wg(_seqlock);
+    return add_bridge_port_locked(obj);
+}
+
+bool ndi_brport_cache::add_bridge_port_list(const ndi_brport_obj_t *obj_list, size_t count) {
+    if (obj_list == nullptr && count != 0) return false;
+
+    bool rc = true;
+    ndi_obj_cache_seqlock::write_guard wg(_seqlock);
+    for (size_t ix = 0; ix < count; ++ix) {
+        rc = add_bridge_port_locked(&obj_list[ix]) && rc;
     }
+    return rc;
+}
+/* needs bridge port id. For 1D router type bridge port, rif id is used if set */
+bool ndi_brport_cache::remove_bridge_port(ndi_brport_obj_t * obj) {
 
-    auto it = _brport_to_port_blk.find(obj->brport_obj_id);
-    if ( it == _brport_to_port_blk.end()) return false;
-    obj->port_obj_id = it->second->port_obj_id;
-    _brport_to_port_blk.erase(it);
+    if (obj == nullptr) return false;
 
-    for(auto it_po = _port_to_brport_list[obj->port_obj_id].begin();
-               it_po != _port_to_brport_list[obj->port_obj_id].end(); it_po++) {
-        if (*it_po == obj->brport_obj_id) {
-            _port_to_brport_list[obj->port_obj_id].erase(it_po);
-            found = true;
-            break;
+    ndi_brport_obj_t rec;
+    uint32_t idx = NDI_BRPORT_REC_NONE;
+    ndi_obj_cache_seqlock::write_guard wg(_seqlock);
 
-        }
-    }
-    if (!found) {
-        return false;
-    }
-    /* This is the last bridge port associated with a port , then delete PORT  :
-     * check may be explicit call is better
-     */
-    if (_port_to_brport_list[obj->port_obj_id].empty() == true) {
-        _port_to_brport_list.erase(obj->port_obj_id);
+    if  (obj->brport_type == ndi_brport_type_1D_ROUTER) {
+        idx = _rif_idx.find(_slab, *obj, &rec);
     }
-    if (obj->brport_type == ndi_brport_type_SUBPORT_TAG || obj->brport_type == ndi_brport_type_SUBPORT_UNTAG) {
-        ndi_bridge_pv_t ndi_bridge_pv_val;
-        ndi_bridge_pv_val.port_id = obj->port_obj_id;
-        ndi_bridge_pv_val.vid = obj->vlan_id;
-        auto it_pv = _pv_to_brport_blk.find(ndi_bridge_pv_val);
-        if ( it_pv == _pv_to_brport_blk.end()) return false;
-        _pv_to_brport_blk.erase(it_pv);
+    if (idx == NDI_BRPORT_REC_NONE) {
+        idx = _brport_idx.find(_slab, *obj, &rec);
+        if (idx != NDI_BRPORT_REC_NONE &&
+            ((rec.brport_type == ndi_brport_type_1D_ROUTER) !=
+             (obj->brport_type == ndi_brport_type_1D_ROUTER))) {
+            idx = NDI_BRPORT_REC_NONE;
+        }
     }
+    if (idx == NDI_BRPORT_REC_NONE) return false;
 
-    if  (obj->brport_type == ndi_brport_type_PORT) {
-        auto br_it = _port_to_brport_blk.find(obj->port_obj_id);
-        if ( br_it == _port_to_brport_blk.end()) return false;
-        _port_to_brport_blk.erase(br_it);
+    if  (rec.brport_type != ndi_brport_type_1D_ROUTER) {
+        obj->port_obj_id = rec.port_obj_id;
     }
+    remove_rec_locked(idx, rec);
     return true;
 }
 
@@ -313,6 +796,10 @@ bool nas_ndi_add_bridge_port_obj(ndi_brport_obj_t * obj){
     return _ndi_brport_cache->add_bridge_port(obj);
 }
 
+bool nas_ndi_add_bridge_port_obj_list(const ndi_brport_obj_t * obj_list, size_t count){
+    return _ndi_brport_cache->add_bridge_port_list(obj_list, count);
+}
+
 
 
 bool nas_ndi_remove_bridge_port_obj(ndi_brport_obj_t * obj){
@@ -328,6 +815,10 @@ bool nas_ndi_get_bridge_port_obj_list(sai_object_id_t obj_id, brport_list & list
     return _ndi_brport_cache->get_brport_list(obj_id,list);
 }
 
+void nas_ndi_bridge_port_obj_walk(brport_walk_fn fn){
+    _ndi_brport_cache->walk(fn);
+}
+
 
 /*
  * Global instance to maintain all bridge port slave cache
@@ -335,45 +826,159 @@ bool nas_ndi_get_bridge_port_obj_list(sai_object_id_t obj_id, brport_list & list
 static auto _ndi_brport_slave_cache = new ndi_brport_slave_cache;
 
 
-bool ndi_virtual_obj_cache::add_virtual_obj(ndi_virtual_obj_t * obj){
+bool ndi_virtual_obj_cache::obj_table_find(sai_object_id_t oid, size_t *pos) const {
 
-    if (obj == nullptr) return false;
-    auto v_obj = std::make_shared<ndi_virtual_obj_t>(*obj);
+    size_t ix = obj_slot_home(oid);
+    for (size_t probe = 0; probe < NDI_VIRTUAL_OBJ_TABLE_SIZE; ++probe) {
+        sai_object_id_t cur = _obj_to_vid[ix].oid.load(std::memory_order_relaxed);
+        if (cur == SAI_NULL_OBJECT_ID) return false;
+        if (cur == oid) {
+            *pos = ix;
+            return true;
+        }
+        ix = (ix + 1) & (NDI_VIRTUAL_OBJ_TABLE_SIZE - 1);
+    }
+    return false;
+}
+
+void ndi_virtual_obj_cache::obj_table_insert(sai_object_id_t oid, hal_vlan_id_t vid) {
+
+    /* At most one oid per direct indexed VLAN id, so the table never fills up */
+    size_t ix = obj_slot_home(oid);
+    while (_obj_to_vid[ix].oid.load(std::memory_order_relaxed) != SAI_NULL_OBJECT_ID) {
+        ix = (ix + 1) & (NDI_VIRTUAL_OBJ_TABLE_SIZE - 1);
+    }
+    _obj_to_vid[ix].vid.store(vid, std::memory_order_relaxed);
+    _obj_to_vid[ix].oid.store(oid, std::memory_order_relaxed);
+}
+
+void ndi_virtual_obj_cache::obj_table_erase(size_t hole) {
+
+    const size_t mask = NDI_VIRTUAL_OBJ_TABLE_SIZE - 1;
+    size_t pos = hole;
+    /* Shift back the following entries which probed past the hole */
+    while (true) {
+        pos = (pos + 1) & mask;
+        sai_object_id_t oid = _obj_to_vid[pos].oid.load(std::memory_order_relaxed);
+        if (oid == SAI_NULL_OBJECT_ID) break;
+        size_t home = obj_slot_home(oid);
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            _obj_to_vid[hole].vid.store(_obj_to_vid[pos].vid.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+            _obj_to_vid[hole].oid.store(oid, std::memory_order_relaxed);
+            hole = pos;
+        }
+    }
+    _obj_to_vid[hole].oid.store(SAI_NULL_OBJECT_ID, std::memory_order_relaxed);
+}
+
+bool ndi_virtual_obj_cache::remove_locked(sai_object_id_t oid) {
+
+    size_t pos;
+    if (obj_table_find(oid, &pos)) {
+        hal_vlan_id_t vid = _obj_to_vid[pos].vid.load(std::memory_order_relaxed);
+        if (_vid_to_obj[vid].load(std::memory_order_relaxed) == oid) {
+            _vid_to_obj[vid].store(SAI_NULL_OBJECT_ID, std::memory_order_release);
+        }
+        obj_table_erase(pos);
+        return true;
+    }
+
+    if (_ext_count.load(std::memory_order_relaxed) == 0) return false;
     std_rw_lock_write_guard lg(&rw_lock);
-    _vid_to_obj_map[v_obj->vid] = v_obj;
-    _obj_to_vid_map[v_obj->oid] = v_obj;
+    auto it = _ext_obj_to_vid_map.find(oid);
+    if ( it == _ext_obj_to_vid_map.end()) return false;
+    auto vid_it = _ext_vid_to_obj_map.find(it->second);
+    if (vid_it != _ext_vid_to_obj_map.end() && vid_it->second == oid) {
+        _ext_vid_to_obj_map.erase(vid_it);
+    }
+    _ext_obj_to_vid_map.erase(it);
+    _ext_count.store(_ext_obj_to_vid_map.size(), std::memory_order_relaxed);
     return true;
+}
 
+bool ndi_virtual_obj_cache::add_virtual_obj(ndi_virtual_obj_t * obj){
 
-}
+    if (obj == nullptr || obj->oid == SAI_NULL_OBJECT_ID) return false;
+    ndi_obj_cache_seqlock::write_guard wg(_seqlock);
+
+    /* Drop the old mapping of the oid and of the VLAN id */
+    remove_locked(obj->oid);
+
+    if (obj->vid < NDI_VIRTUAL_OBJ_MAX_VID) {
+        sai_object_id_t old_oid = _vid_to_obj[obj->vid].load(std::memory_order_relaxed);
+        if (old_oid != SAI_NULL_OBJECT_ID) {
+            remove_locked(old_oid);
+        }
+        obj_table_insert(obj->oid, obj->vid);
+        _vid_to_obj[obj->vid].store(obj->oid, std::memory_order_release);
+        return true;
+    }
 
-bool ndi_virtual_obj_cache::remove_virtual_obj(ndi_virtual_obj_t *obj){
-    if (obj == nullptr) return false;
     std_rw_lock_write_guard lg(&rw_lock);
-    auto it = _obj_to_vid_map.find(obj->oid);
-    if ( it == _obj_to_vid_map.end()) return false;
-    _vid_to_obj_map.erase(it->second->vid);
-    _obj_to_vid_map.erase(it);
+    auto vid_it = _ext_vid_to_obj_map.find(obj->vid);
+    if (vid_it != _ext_vid_to_obj_map.end()) {
+        _ext_obj_to_vid_map.erase(vid_it->second);
+    }
+    _ext_vid_to_obj_map[obj->vid] = obj->oid;
+    _ext_obj_to_vid_map[obj->oid] = obj->vid;
+    _ext_count.store(_ext_obj_to_vid_map.size(), std::memory_order_relaxed);
     return true;
+}
 
+bool ndi_virtual_obj_cache::remove_virtual_obj(ndi_virtual_obj_t *obj){
+    if (obj == nullptr) return false;
+    ndi_obj_cache_seqlock::write_guard wg(_seqlock);
+    return remove_locked(obj->oid);
 }
 
 bool ndi_virtual_obj_cache::get_virtual_obj(ndi_virtual_obj_t * obj,ndi_virtual_obj_query_type_t qtype){
     if (obj == nullptr) return false;
 
-    std_rw_lock_read_guard lg(&rw_lock);
     if (qtype == ndi_virtual_obj_query_type_FROM_OBJ){
-        auto it = _obj_to_vid_map.find(obj->oid);
-        if(it == _obj_to_vid_map.end()){
-            return false;
+        if (obj->oid == SAI_NULL_OBJECT_ID) return false;
+        bool found;
+        hal_vlan_id_t vid = 0;
+        uint32_t seq;
+        do {
+            seq = _seqlock.read_begin();
+            found = false;
+            size_t ix = obj_slot_home(obj->oid);
+            for (size_t probe = 0; probe < NDI_VIRTUAL_OBJ_TABLE_SIZE; ++probe) {
+                sai_object_id_t cur = _obj_to_vid[ix].oid.load(std::memory_order_relaxed);
+                if (cur == SAI_NULL_OBJECT_ID) break;
+                if (cur == obj->oid) {
+                    vid = _obj_to_vid[ix].vid.load(std::memory_order_relaxed);
+                    found = true;
+                    break;
+                }
+                ix = (ix + 1) & (NDI_VIRTUAL_OBJ_TABLE_SIZE - 1);
+            }
+        } while (_seqlock.read_retry(seq));
+
+        if (!found) {
+            if (_ext_count.load(std::memory_order_relaxed) == 0) return false;
+            std_rw_lock_read_guard lg(&rw_lock);
+            auto it = _ext_obj_to_vid_map.find(obj->oid);
+            if(it == _ext_obj_to_vid_map.end()){
+                return false;
+            }
+            vid = it->second;
         }
-        obj->vid = it->second->vid;
+        obj->vid = vid;
     }else if (qtype == ndi_virtual_obj_query_type_FROM_VLAN ){
-        auto it = _vid_to_obj_map.find(obj->vid);
-        if(it == _vid_to_obj_map.end()){
+        if (obj->vid < NDI_VIRTUAL_OBJ_MAX_VID) {
+            sai_object_id_t oid = _vid_to_obj[obj->vid].load(std::memory_order_acquire);
+            if (oid == SAI_NULL_OBJECT_ID) return false;
+            obj->oid = oid;
+            return true;
+        }
+        std_rw_lock_read_guard lg(&rw_lock);
+        auto it = _ext_vid_to_obj_map.find(obj->vid);
+        if(it == _ext_vid_to_obj_map.end()){
             return false;
         }
-        obj->oid = it->second->oid;
+        obj->oid = it->second;
     }else{
         return false;
     }
@@ -382,6 +987,24 @@ bool ndi_virtual_obj_cache::get_virtual_obj(ndi_virtual_obj_t * obj,ndi_virtual_
 }
 
 
+void ndi_virtual_obj_cache::walk(virtual_obj_walk_fn fn){
+
+    std::lock_guard<std::mutex> lg(_seqlock.mutex());
+    ndi_virtual_obj_t v_obj;
+    for (size_t vid = 0; vid < NDI_VIRTUAL_OBJ_MAX_VID; ++vid) {
+        v_obj.oid = _vid_to_obj[vid].load(std::memory_order_relaxed);
+        if (v_obj.oid == SAI_NULL_OBJECT_ID) continue;
+        v_obj.vid = vid;
+        fn(v_obj);
+    }
+    for (auto & it : _ext_obj_to_vid_map) {
+        v_obj.oid = it.first;
+        v_obj.vid = it.second;
+        fn(v_obj);
+    }
+}
+
+
 bool nas_ndi_add_virtual_obj(ndi_virtual_obj_t * obj){
     return _ndi_virt_obj_cache->add_virtual_obj(obj);
 };
@@ -397,6 +1020,11 @@ bool nas_ndi_get_virtual_obj(ndi_virtual_obj_t * obj,ndi_virtual_obj_query_type_
 }
 
 
+void nas_ndi_virtual_obj_walk(virtual_obj_walk_fn fn){
+    _ndi_virt_obj_cache->walk(fn);
+}
+
+
 bool ndi_brport_slave_cache::add_brport_slave (ndi_brport_slave_obj_t * obj){
     if (obj == nullptr) return false;
     std_rw_lock_write_guard lg(&rw_lock);
@@ -30,6 +30,7 @@
 #include <inttypes.h>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
 
 #define NDI_MAX_NPU          1
 
@@ -84,6 +85,10 @@ std_rw_lock_t ndi_port_map_rwlock;
 
 std_rw_lock_t sai_port_map_rwlock;
 
+/*  Bumped on every port map table update, so that users caching translated
+ *  sai ports can tell when their copy is stale */
+static std::atomic<uint64_t> g_ndi_port_map_gen {0};
+
 extern "C" {
 
 static bool ndi_saiport_map_add_entry(sai_object_id_t sai_port, ndi_saiport_map_t *entry)
@@ -263,6 +268,7 @@ static t_std_error ndi_port_map_tbl_allocate(void) {
     t_std_error ret_code = STD_ERR(NPU, NOMEM, 0);
 
     std_rw_lock_write_guard l(&ndi_port_map_rwlock);
+    g_ndi_port_map_gen++;
 
     try {
        g_ndi_port_map_tbl.resize(npu_max);
@@ -283,31 +289,17 @@ static t_std_error ndi_port_map_tbl_allocate(void) {
     return STD_ERR_OK;
 }
 
-/*  Add sai port in to the port map table */
-t_std_error ndi_port_map_sai_port_add(npu_id_t npu, sai_object_id_t sai_port,
-                                      uint32_t *hw_ports, size_t count,
-                                      npu_port_t *npu_port)
+/*  Add sai port in to the port map table, caller must hold ndi_port_map_rwlock */
+static t_std_error ndi_port_map_sai_port_add_locked(npu_id_t npu, sai_object_id_t sai_port,
+                                                   const uint32_t *hw_ports, size_t count,
+                                                   npu_port_t *npu_port)
 {
-    uint32_t hwport_list[NDI_MAX_HWPORT_PER_PORT] = {0};
-    uint32_t hwport_count = NDI_MAX_HWPORT_PER_PORT;
     uint32_t first_hwport = 0;
     ndi_saiport_map_t sai_entry;
 
-    if (hw_ports == nullptr || count == 0) {
-        t_std_error rc = ndi_sai_port_hwport_list_get(npu, sai_port,
-                                                      hwport_list, &hwport_count);
-        if (rc != STD_ERR_OK) {
-            return rc;
-        }
-        hw_ports = hwport_list;
-        count = hwport_count;
-    }
-
     /*  use first HW port as index in the port map table */
     first_hwport = hw_ports[0];
 
-    std_rw_lock_write_guard l(&ndi_port_map_rwlock);
-
     if (first_hwport > g_ndi_port_map_tbl[npu].size()-1) {
         try {
              g_ndi_port_map_tbl[npu].resize(first_hwport+1);
@@ -343,6 +335,73 @@ t_std_error ndi_port_map_sai_port_add(npu_id_t npu, sai_object_id_t sai_port,
     return(STD_ERR_OK);
 }
 
+/*  Add sai port in to the port map table */
+t_std_error ndi_port_map_sai_port_add(npu_id_t npu, sai_object_id_t sai_port,
+                                      uint32_t *hw_ports, size_t count,
+                                      npu_port_t *npu_port)
+{
+    uint32_t hwport_list[NDI_MAX_HWPORT_PER_PORT] = {0};
+    uint32_t hwport_count = NDI_MAX_HWPORT_PER_PORT;
+
+    if (hw_ports == nullptr || count == 0) {
+        t_std_error rc = ndi_sai_port_hwport_list_get(npu, sai_port,
+                                                      hwport_list, &hwport_count);
+        if (rc != STD_ERR_OK) {
+            return rc;
+        }
+        hw_ports = hwport_list;
+        count = hwport_count;
+    }
+
+    std_rw_lock_write_guard l(&ndi_port_map_rwlock);
+    g_ndi_port_map_gen++;
+    return ndi_port_map_sai_port_add_locked(npu, sai_port, hw_ports, count, npu_port);
+}
+
+/*  Add list of sai ports in to the port map table. HW ports of all the sai ports
+ *  are fetched first and the table is then filled under a single lock */
+static t_std_error ndi_port_map_sai_port_add_list(npu_id_t npu, const sai_object_id_t *sai_port_list,
+                                                  size_t port_count, size_t *added_count)
+{
+    /* HW ports of port index p_idx start at p_idx * NDI_MAX_HWPORT_PER_PORT */
+    std::vector<uint32_t> hwport_tbl;
+    std::vector<uint32_t> hwport_cnt;
+    t_std_error rc = STD_ERR_OK;
+    npu_port_t npu_port = 0;
+    size_t p_idx = 0;
+
+    *added_count = 0;
+    try {
+        hwport_tbl.resize(port_count * NDI_MAX_HWPORT_PER_PORT, 0);
+        hwport_cnt.resize(port_count, NDI_MAX_HWPORT_PER_PORT);
+    } catch (...) {
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+
+    for (p_idx = 0; p_idx < port_count; p_idx++) {
+        if ((rc = ndi_sai_port_hwport_list_get(npu, sai_port_list[p_idx],
+                                               &hwport_tbl[p_idx * NDI_MAX_HWPORT_PER_PORT],
+                                               &hwport_cnt[p_idx])) != STD_ERR_OK) {
+            NDI_PORT_LOG_ERROR("unable to get hwports of sai port index %lu for npu %d ", p_idx, npu);
+            return rc;
+        }
+    }
+
+    std_rw_lock_write_guard l(&ndi_port_map_rwlock);
+    g_ndi_port_map_gen++;
+    for (p_idx = 0; p_idx < port_count; p_idx++) {
+        if ((rc = ndi_port_map_sai_port_add_locked(npu, sai_port_list[p_idx],
+                                                   &hwport_tbl[p_idx * NDI_MAX_HWPORT_PER_PORT],
+                                                   hwport_cnt[p_idx], &npu_port)) != STD_ERR_OK) {
+            NDI_PORT_LOG_ERROR("unable to add sai port index %lu into the port map table for npu %d ",
+                                p_idx, npu);
+            break;
+        }
+        (*added_count)++;
+    }
+    return rc;
+}
+
 t_std_error ndi_sai_cpu_port_add(npu_id_t npu_id)
 {
     sai_status_t sai_ret = SAI_STATUS_FAILURE;
@@ -355,6 +414,7 @@ t_std_error ndi_sai_cpu_port_add(npu_id_t npu_id)
     t_std_error ret_code = STD_ERR_OK;
 
     std_rw_lock_write_guard l(&ndi_port_map_rwlock);
+    g_ndi_port_map_gen++;
 
     /*  Get ndi cpu port */
     if (( ndi_cpu_port_get(npu_id, &ndi_cpu_port)) != STD_ERR_OK) {
@@ -404,6 +464,7 @@ t_std_error ndi_port_map_sai_port_delete(npu_id_t npu, sai_object_id_t sai_port,
     uint32_t first_hwport = 0;
 
     std_rw_lock_write_guard l(&ndi_port_map_rwlock);
+    g_ndi_port_map_gen++;
 
     std_rw_lock_write_guard m(&sai_port_map_rwlock);
 
@@ -447,6 +508,11 @@ t_std_error ndi_port_map_sai_port_delete(npu_id_t npu, sai_object_id_t sai_port,
     return(STD_ERR_OK);
 }
 
+uint64_t ndi_port_map_generation_get(void)
+{
+    return g_ndi_port_map_gen.load();
+}
+
 /*  Extract npu_id from the sai port object*/
 /*  TODO confirm if this conversion is as per SAI spec */
 npu_id_t ndi_saiport_to_npu_id_get(sai_object_id_t sai_port)
@@ -464,8 +530,7 @@ static t_std_error ndi_per_npu_sai_port_map_update(npu_id_t npu_id)
     sai_object_id_t *sai_port_list = NULL;
     t_std_error rc = STD_ERR_OK;
     size_t port_count = 0;
-    uint_t p_idx =0;
-    npu_port_t npu_port = 0;
+    size_t added_count = 0;
 
     /*  Get the list of sai ports */
 
@@ -489,19 +554,10 @@ static t_std_error ndi_per_npu_sai_port_map_update(npu_id_t npu_id)
             break;
         }
 
-        /* run through the list of sai_ports  */
-        for (p_idx = 0; p_idx < port_count; p_idx++) {
-            /*  Now add the sai port and hw port in the port map */
-
-            if ((rc = ndi_port_map_sai_port_add(npu_id, sai_port_list[p_idx],
-                                                nullptr, 0, &npu_port)) != STD_ERR_OK) {
-                NDI_PORT_LOG_ERROR("unable to add sai port index %d into the port map table for npu %d ",
-                                    p_idx, npu_id);
-                break; /*  from the for loop */
-            }
-        }
+        /*  Now add the sai ports and hw ports in the port map */
+        rc = ndi_port_map_sai_port_add_list(npu_id, sai_port_list, port_count, &added_count);
 
-        if (p_idx != port_count) {
+        if (added_count != port_count) {
             /*  Not all sai ports are added in the port map  */
             NDI_PORT_LOG_ERROR("unable to create the saiport map table size %lu \n", port_count);
         }
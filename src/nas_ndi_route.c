@@ -30,6 +30,7 @@
 #include "nas_ndi_route.h"
 #include "nas_ndi_utils.h"
 #include "nas_ndi_map.h"
+#include "nas_ndi_txn.h"
 #include "saistatus.h"
 #include "saitypes.h"
 #include "sainexthopgroupextensions.h"
@@ -326,72 +327,121 @@ static inline  sai_next_hop_group_api_t *ndi_next_hop_group_api_get(nas_ndi_db_t
 
 }
 
-static t_std_error ndi_route_nh_grp_members_create (nas_ndi_db_t    *ndi_db_ptr,
-                                                    sai_object_id_t  nh_grp_oid,
-                                                    uint32_t         nh_count,
-                                                    sai_object_id_t *nh_list)
+typedef struct {
+    ndi_txn_t         *txn;
+    ndi_txn_step_id_t  grp_step;
+    sai_object_id_t    nh_grp_oid;
+    ndi_txn_step_id_t  mbr_step;
+    uint32_t           nh_count;
+    sai_object_id_t   *nh_list;
+} ndi_route_nh_grp_mbr_txn_t;
+
+/* Last step of the member create transaction, records the created
+ * members in the NH group member map */
+static t_std_error ndi_route_nh_grp_members_map_insert (void *ctx)
 {
-    uint32_t           attr_idx;
-    uint32_t           i;
-    sai_status_t       sai_rc = SAI_STATUS_SUCCESS;
-    t_std_error        ndi_rc = STD_ERR_OK;
-    sai_attribute_t    sai_attr [NDI_MAX_GROUP_NEXT_HOP_MEMBER_ATTR];
+    ndi_route_nh_grp_mbr_txn_t *mbr_txn = (ndi_route_nh_grp_mbr_txn_t *)ctx;
     nas_ndi_map_data_t data [NDI_MAX_NH_ENTRIES_PER_GROUP];
-    sai_object_id_t    member_oid;
     nas_ndi_map_key_t  key;
     nas_ndi_map_val_t  value;
+    uint32_t           i;
 
     memset (&data, 0, sizeof (data));
 
-    for (i = 0; i < nh_count; i++) {
+    for (i = 0; i < mbr_txn->nh_count; i++) {
+        data [i].val1 = mbr_txn->nh_list[i];
+        data [i].val2 = ndi_txn_get_oid (mbr_txn->txn, mbr_txn->mbr_step + i);
+    }
+
+    memset (&key, 0, sizeof (key));
+    key.type = NAS_NDI_MAP_TYPE_NH_GRP_MEMBER;
+    key.id1  = (mbr_txn->grp_step != NDI_TXN_STEP_INVALID) ?
+        ndi_txn_get_oid (mbr_txn->txn, mbr_txn->grp_step) : mbr_txn->nh_grp_oid;
+
+    memset (&value, 0, sizeof (value));
+    value.count = mbr_txn->nh_count;
+    value.data  = &data [0];
+
+    return nas_ndi_map_insert (&key, &value);
+}
+
+/*
+ * Add the NH group member create steps to the transaction. If grp_step is
+ * valid, the members are added to the group created by that step, otherwise
+ * to the existing group nh_grp_oid. Members are created in one bulk call if
+ * supported by SAI.
+ */
+static t_std_error ndi_route_nh_grp_members_txn_add (nas_ndi_db_t    *ndi_db_ptr,
+                                                     ndi_route_nh_grp_mbr_txn_t *mbr_txn)
+{
+    uint32_t           attr_idx;
+    uint32_t           i;
+    sai_attribute_t    sai_attr [NDI_MAX_GROUP_NEXT_HOP_MEMBER_ATTR];
+    ndi_txn_step_id_t  step;
+    sai_next_hop_group_api_t *nh_grp_api = ndi_next_hop_group_api_get(ndi_db_ptr);
+
+    ndi_txn_set_bulk_fn (mbr_txn->txn, nh_grp_api->create_next_hop_group_member,
+                         nh_grp_api->create_next_hop_group_members,
+                         nh_grp_api->remove_next_hop_group_members);
+
+    for (i = 0; i < mbr_txn->nh_count; i++) {
         attr_idx = 0;
-        sai_attr[attr_idx].value.oid = nh_grp_oid;
+        sai_attr[attr_idx].value.oid = mbr_txn->nh_grp_oid;
         sai_attr[attr_idx].id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID;
         attr_idx++;
 
-        sai_attr[attr_idx].value.oid = nh_list[i];
+        sai_attr[attr_idx].value.oid = mbr_txn->nh_list[i];
         sai_attr[attr_idx].id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID;
         attr_idx++;
 
-        sai_rc = ndi_next_hop_group_api_get(ndi_db_ptr)->
-            create_next_hop_group_member (&member_oid,
-                    ndi_switch_id_get(),
-                    attr_idx, sai_attr);
-
-        if (sai_rc != SAI_STATUS_SUCCESS) {
-            break;
+        step = ndi_txn_add_sai_create (mbr_txn->txn,
+                                       nh_grp_api->create_next_hop_group_member,
+                                       nh_grp_api->remove_next_hop_group_member,
+                                       attr_idx, sai_attr, NULL);
+        if (step == NDI_TXN_STEP_INVALID) {
+            return STD_ERR (ROUTE, NOMEM, 0);
         }
-
-        data [i].val1 = nh_list[i];
-        data [i].val2 = member_oid;
-    }
-
-    if (sai_rc != SAI_STATUS_SUCCESS) {
-        /* on failure, remove the members from the NH group */
-        while (i) {
-            sai_rc = ndi_next_hop_group_api_get(ndi_db_ptr)->
-                remove_next_hop_group_member (data [i-1].val2);
-            --i;
+        if (i == 0) {
+            mbr_txn->mbr_step = step;
+        }
+        if ((mbr_txn->grp_step != NDI_TXN_STEP_INVALID) &&
+            (ndi_txn_bind_oid (mbr_txn->txn, step, 0, mbr_txn->grp_step) != STD_ERR_OK)) {
+            return STD_ERR (ROUTE, FAIL, 0);
         }
-
-        return STD_ERR (ROUTE, FAIL, sai_rc);
     }
 
-    memset (&key, 0, sizeof (key));
-    key.type = NAS_NDI_MAP_TYPE_NH_GRP_MEMBER;
-    key.id1  = nh_grp_oid;
+    if (ndi_txn_add_step (mbr_txn->txn, ndi_route_nh_grp_members_map_insert,
+                          NULL, mbr_txn) == NDI_TXN_STEP_INVALID) {
+        return STD_ERR (ROUTE, NOMEM, 0);
+    }
+    return STD_ERR_OK;
+}
 
-    memset (&value, 0, sizeof (value));
-    value.count = nh_count;
-    value.data  = &data [0];
+static t_std_error ndi_route_nh_grp_members_create (nas_ndi_db_t    *ndi_db_ptr,
+                                                    sai_object_id_t  nh_grp_oid,
+                                                    uint32_t         nh_count,
+                                                    sai_object_id_t *nh_list)
+{
+    t_std_error                 ndi_rc;
+    ndi_route_nh_grp_mbr_txn_t  mbr_txn;
 
-    ndi_rc = nas_ndi_map_insert (&key, &value);
+    memset (&mbr_txn, 0, sizeof (mbr_txn));
+    mbr_txn.txn = ndi_txn_create ();
+    if (mbr_txn.txn == NULL) {
+        return STD_ERR (ROUTE, NOMEM, 0);
+    }
+    mbr_txn.grp_step   = NDI_TXN_STEP_INVALID;
+    mbr_txn.nh_grp_oid = nh_grp_oid;
+    mbr_txn.nh_count   = nh_count;
+    mbr_txn.nh_list    = nh_list;
 
-    if (ndi_rc != STD_ERR_OK) {
-        return ndi_rc;
+    ndi_rc = ndi_route_nh_grp_members_txn_add (ndi_db_ptr, &mbr_txn);
+    if (ndi_rc == STD_ERR_OK) {
+        ndi_rc = ndi_txn_commit (mbr_txn.txn);
     }
+    ndi_txn_destroy (mbr_txn.txn);
 
-    return STD_ERR_OK;
+    return ndi_rc;
 }
 
 static t_std_error
@@ -586,16 +636,18 @@ t_std_error ndi_route_next_hop_group_create (ndi_nh_group_t *p_nh_group_entry,
                         next_hop_id_t *nh_group_handle)
 {
     uint32_t          attr_idx = 0;
-    sai_status_t      sai_ret = SAI_STATUS_FAILURE;
     t_std_error       ndi_ret = STD_ERR_OK;
-    sai_object_id_t   sai_nh_group_id;
+    sai_object_id_t   sai_nh_group_id = SAI_NULL_OBJECT_ID;
     sai_object_id_t   nexthops[NDI_MAX_NH_ENTRIES_PER_GROUP];
     sai_attribute_t   sai_attr[NDI_MAX_GROUP_NEXT_HOP_ATTR];
     uint32_t          nhop_count;
+    ndi_route_nh_grp_mbr_txn_t mbr_txn;
 
     nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(p_nh_group_entry->npu_id);
     STD_ASSERT(ndi_db_ptr != NULL);
 
+    memset (&mbr_txn, 0, sizeof (mbr_txn));
+
     sai_attr[attr_idx].value.s32 = SAI_NEXT_HOP_GROUP_TYPE_ECMP;
     sai_attr[attr_idx].id = SAI_NEXT_HOP_GROUP_ATTR_TYPE;
     attr_idx++;
@@ -607,30 +659,46 @@ t_std_error ndi_route_next_hop_group_create (ndi_nh_group_t *p_nh_group_entry,
         attr_idx++;
     }
 
-    if ((sai_ret = ndi_next_hop_group_api_get(ndi_db_ptr)->
-            create_next_hop_group(&sai_nh_group_id, g_nas_ndi_switch_id, attr_idx, sai_attr))
-            != SAI_STATUS_SUCCESS) {
-        return STD_ERR(ROUTE, FAIL, sai_ret);
+    /*
+     * Create the group and its members in one transaction, the group and
+     * any member already created are removed if a later step fails
+     */
+    mbr_txn.txn = ndi_txn_create ();
+    if (mbr_txn.txn == NULL) {
+        return STD_ERR(ROUTE, NOMEM, 0);
+    }
+
+    mbr_txn.grp_step = ndi_txn_add_sai_create(mbr_txn.txn,
+            ndi_next_hop_group_api_get(ndi_db_ptr)->create_next_hop_group,
+            ndi_next_hop_group_api_get(ndi_db_ptr)->remove_next_hop_group,
+            attr_idx, sai_attr, &sai_nh_group_id);
+    if (mbr_txn.grp_step == NDI_TXN_STEP_INVALID) {
+        ndi_txn_destroy (mbr_txn.txn);
+        return STD_ERR(ROUTE, NOMEM, 0);
     }
 
     nhop_count = p_nh_group_entry->nhop_count;
     /*
      * Add the nexthop id list to sai_next_hop_list_t
      */
-    if (nhop_count == 0) {
-        return STD_ERR_OK;
-    }
-
     int i;
     for (i = 0; i <nhop_count; i++) {
         nexthops[i] = p_nh_group_entry->nh_list[i].id;
     }
 
-    ndi_ret = ndi_route_nh_grp_members_create (ndi_db_ptr, sai_nh_group_id,
-                                               nhop_count, nexthops);
+    if (nhop_count != 0) {
+        mbr_txn.nh_grp_oid = SAI_NULL_OBJECT_ID;
+        mbr_txn.nh_count   = nhop_count;
+        mbr_txn.nh_list    = nexthops;
+        ndi_ret = ndi_route_nh_grp_members_txn_add (ndi_db_ptr, &mbr_txn);
+    }
+
+    if (ndi_ret == STD_ERR_OK) {
+        ndi_ret = ndi_txn_commit (mbr_txn.txn);
+    }
+    ndi_txn_destroy (mbr_txn.txn);
+
     if (ndi_ret != STD_ERR_OK) {
-        sai_ret = ndi_next_hop_group_api_get(ndi_db_ptr)->
-                       remove_next_hop_group(sai_nh_group_id);
         return ndi_ret;
     }
 
@@ -226,6 +226,46 @@ t_std_error ndi_rif_utl_rif_ref (ndi_rif_id_t rif_id, ndi_rif_utl_op_t op, uint3
     return STD_ERR_OK;
 }
 
+void ndi_rif_utl_walk(ndi_rif_walk_fn fn)
+{
+    for (auto& it: ndi_rif_id_db) {
+        if (it.second != NULL) {
+            fn(it.first, *it.second);
+        }
+    }
+}
+
+t_std_error ndi_rif_utl_restore_rif(ndi_rif_id_t rif_id, const ndi_rif_entry_db_t& rif_db_entry)
+{
+    if (ndi_rif_id_db.find(rif_id) != ndi_rif_id_db.end()) {
+        NDI_LOG_TRACE("NDI-ROUTE-RIF", "RIF entry is already present, "
+                "restore skipped for RIF:0x%lx", rif_id);
+        return STD_ERR(ROUTE, FAIL, 0);
+    }
+    ndi_rif_entry_db_t *rif_inst(new ndi_rif_entry_db_t);
+
+    memcpy(rif_inst, &rif_db_entry, sizeof(ndi_rif_entry_db_t));
+
+    ndi_rif_entry_db.insert(ndi_rif_entry_db_pair_t(*rif_inst, rif_id));
+    ndi_rif_id_db.insert(ndi_rif_id_db_pair_t(rif_id, rif_inst));
+
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_rif_utl_discard_rif(ndi_rif_id_t rif_id)
+{
+    auto it = ndi_rif_id_db.find(rif_id);
+    if (it == ndi_rif_id_db.end()) {
+        return STD_ERR(ROUTE, FAIL, 0);
+    }
+    ndi_rif_entry_db_t *rif_inst = it->second;
+    ndi_rif_id_db.erase(it);
+    if (rif_inst != NULL) {
+        ndi_rif_entry_db.erase(*rif_inst);
+        delete rif_inst;
+    }
+    return STD_ERR_OK;
+}
 
 void ndi_rif_utl_rif_cache_dump ()
 {
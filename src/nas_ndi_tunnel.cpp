@@ -21,6 +21,7 @@
 
 
 #include "nas_ndi_tunnel_map.h"
+#include "nas_ndi_txn.h"
 #include "std_error_codes.h"
 #include "std_assert.h"
 #include "nas_ndi_utils.h"
@@ -40,6 +41,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <vector>
 
 
 static std_mutex_lock_create_static_init_rec(_tun_lock); /* Syncronize remote_end point create or delete which accesses nas_ndi_tunnel_obj_map */
@@ -604,75 +606,249 @@ static t_std_error ndi_remove_tunnel_term_entry(npu_id_t npu, sai_object_id_t tu
     return STD_ERR_OK;
 }
 
+/*
+ * Transaction steps used to build the tunnel objects. Each step creates a
+ * SAI object and its undo handler removes it, so a partially built tunnel
+ * is removed in reverse order if a later step fails.
+ */
+typedef struct {
+    npu_id_t npu_id;
+    sai_object_id_t vrf_oid;
+    sai_object_id_t ulay_oid;
+    const hal_ip_addr_t *local_src_ip;
+    const hal_ip_addr_t *remote_src_ip;
+    sai_object_id_t encap_map_oid;
+    sai_object_id_t decap_map_oid;
+    sai_object_id_t tunnel_oid;
+    sai_object_id_t tunnel_term_oid;
+} ndi_tun_basic_txn_t;
+
+static t_std_error ndi_tun_txn_encap_map_create(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    return ndi_create_encap_tunnel_map(tun->npu_id, &tun->encap_map_oid);
+}
+
+static void ndi_tun_txn_encap_map_remove(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    ndi_remove_encap_tunnel_map(tun->npu_id, tun->encap_map_oid);
+}
+
+static t_std_error ndi_tun_txn_decap_map_create(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    return ndi_create_decap_tunnel_map(tun->npu_id, &tun->decap_map_oid);
+}
+
+static void ndi_tun_txn_decap_map_remove(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    ndi_remove_decap_tunnel_map(tun->npu_id, tun->decap_map_oid);
+}
+
+static t_std_error ndi_tun_txn_tunnel_create(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    return ndi_create_tunnel(tun->npu_id, &tun->tunnel_oid, tun->ulay_oid, tun->encap_map_oid,
+                             tun->decap_map_oid, tun->local_src_ip);
+}
+
+static void ndi_tun_txn_tunnel_remove(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    ndi_remove_tunnel(tun->npu_id, tun->tunnel_oid);
+}
+
+static t_std_error ndi_tun_txn_term_create(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    return ndi_create_tunnel_term_entry(tun->npu_id, &tun->tunnel_term_oid, tun->vrf_oid,
+                                        tun->tunnel_oid, tun->remote_src_ip, tun->local_src_ip);
+}
+
+static void ndi_tun_txn_term_remove(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    ndi_remove_tunnel_term_entry(tun->npu_id, tun->tunnel_term_oid);
+}
+
+static t_std_error ndi_tun_txn_obj_insert(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    TunnelObj *obj = new TunnelObj(tun->tunnel_oid, tun->encap_map_oid, tun->decap_map_oid,
+                                   tun->tunnel_term_oid, *tun->local_src_ip, *tun->remote_src_ip);
+
+    if (false == insert_tunnel_obj(tun->remote_src_ip, tun->local_src_ip, obj)) {
+        delete(obj);
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    return STD_ERR_OK;
+}
+
+static void ndi_tun_txn_obj_remove(void *ctx)
+{
+    auto tun = static_cast<ndi_tun_basic_txn_t *>(ctx);
+    remove_tunnel_obj(tun->remote_src_ip, tun->local_src_ip);
+}
+
 static t_std_error
 ndi_create_tunnel_basic_entries(npu_id_t npu_id, ndi_obj_id_t vrf_oid, ndi_obj_id_t ulay_oid,
 const hal_ip_addr_t *local_src_ip, const hal_ip_addr_t *remote_src_ip) {
 
-    sai_object_id_t tunnel_term_oid            = SAI_NULL_OBJECT_ID;
-    sai_object_id_t tunnel_oid                 = SAI_NULL_OBJECT_ID;
-    sai_object_id_t encap_tunnel_map_oid       = SAI_NULL_OBJECT_ID;
-    sai_object_id_t decap_tunnel_map_oid       = SAI_NULL_OBJECT_ID;
-    hal_ip_addr_t loc_ip, rem_ip;
+    ndi_tun_basic_txn_t tun;
+    memset(&tun, 0, sizeof(tun));
+    tun.npu_id = npu_id;
+    tun.vrf_oid = vrf_oid;
+    tun.ulay_oid = ulay_oid;
+    tun.local_src_ip = local_src_ip;
+    tun.remote_src_ip = remote_src_ip;
+
+    ndi_txn_t *txn = ndi_txn_create();
+    if (txn == NULL) {
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+
+    t_std_error rc = STD_ERR(NPU, NOMEM, 0);
+    if ((ndi_txn_add_step(txn, ndi_tun_txn_encap_map_create, ndi_tun_txn_encap_map_remove, &tun)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_decap_map_create, ndi_tun_txn_decap_map_remove, &tun)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_tunnel_create, ndi_tun_txn_tunnel_remove, &tun)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_term_create, ndi_tun_txn_term_remove, &tun)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_obj_insert, ndi_tun_txn_obj_remove, &tun)
+                != NDI_TXN_STEP_INVALID)) {
+        rc = ndi_txn_commit(txn);
+    }
+    ndi_txn_destroy(txn);
+    return rc;
+}
 
-    do {
-        if (STD_ERR_OK != ndi_create_encap_tunnel_map(npu_id, &encap_tunnel_map_oid)) {
-            break;
-        }
+typedef struct {
+    npu_id_t npu_id;
+    const tun_info_t *info;
+    TunnelObj *obj;
+    sai_object_id_t encap_map_entry_oid;
+    sai_object_id_t decap_map_entry_oid;
+    sai_object_id_t tun_brport_oid;
+} ndi_tun_endpoint_txn_t;
 
-        if (STD_ERR_OK != ndi_create_decap_tunnel_map(npu_id, &decap_tunnel_map_oid)){
-            break;
-        }
+static t_std_error ndi_tun_txn_decap_entry_create(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    t_std_error rc;
 
-        memcpy(&loc_ip , local_src_ip, sizeof (hal_ip_addr_t));
-        memcpy(&rem_ip, remote_src_ip, sizeof (hal_ip_addr_t));
+    /* Create decap tunnel entry for Bridge to VNI mapping & associate with the encap map above. */
+    if ((rc = ndi_create_decap_tunnel_map_entry(ep->npu_id, &ep->decap_map_entry_oid,
+                    ep->info->bridge_oid, ep->obj->get_decap_map_oid(), ep->info->vni)) != STD_ERR_OK) {
+        return rc;
+    }
+    if (false == ep->obj->insert_decap_map_entry(ep->info->bridge_oid, ep->info->vni,
+                                                 ep->decap_map_entry_oid)) {
+        NDI_IDBR_LOG_ERROR(" insert_decap_map_entry bridge %llu , vni %llu", ep->info->bridge_oid, ep->info->vni);
+        ndi_remove_decap_tunnel_map_entry(ep->npu_id, ep->decap_map_entry_oid);
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    return STD_ERR_OK;
+}
 
-        if (STD_ERR_OK != ndi_create_tunnel(npu_id, &tunnel_oid, ulay_oid, encap_tunnel_map_oid,
-                 decap_tunnel_map_oid, local_src_ip)) {
-            break;
-        }
-        if (STD_ERR_OK != ndi_create_tunnel_term_entry(npu_id, &tunnel_term_oid, vrf_oid, tunnel_oid,
-              remote_src_ip, local_src_ip)) {
-            break;
-        }
-        TunnelObj *obj = new TunnelObj(tunnel_oid, encap_tunnel_map_oid, decap_tunnel_map_oid,
-                                tunnel_term_oid, loc_ip, rem_ip);
+static void ndi_tun_txn_decap_entry_remove(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    ep->obj->remove_decap_map_entry(ep->info->bridge_oid);
+    ndi_remove_decap_tunnel_map_entry(ep->npu_id, ep->decap_map_entry_oid);
+}
 
-        if (false == insert_tunnel_obj(remote_src_ip, local_src_ip, (TunnelObj *)obj)) {
-            delete(obj);
-            break;
-        }
-        return STD_ERR_OK;
-    } while (0);
+static t_std_error ndi_tun_txn_encap_entry_create(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    t_std_error rc;
 
-    if(encap_tunnel_map_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_encap_tunnel_map(npu_id, encap_tunnel_map_oid);
+    /* Create encap tunnel entry for Bridge to VNI mapping & associate with the encap map above. */
+    if ((rc = ndi_create_encap_tunnel_map_entry(ep->npu_id, &ep->encap_map_entry_oid,
+                    ep->info->bridge_oid, ep->obj->get_encap_map_oid(), ep->info->vni)) != STD_ERR_OK) {
+        return rc;
+    }
+    if (false == ep->obj->insert_encap_map_entry(ep->info->bridge_oid, ep->info->vni,
+                                                 ep->encap_map_entry_oid)) {
+        NDI_IDBR_LOG_ERROR(" insert_encap_map_entry bridge %llu , vni %llu", ep->info->bridge_oid, ep->info->vni);
+        ndi_remove_encap_tunnel_map_entry(ep->npu_id, ep->encap_map_entry_oid);
+        return STD_ERR(NPU, FAIL, 0);
     }
+    return STD_ERR_OK;
+}
+
+static void ndi_tun_txn_encap_entry_remove(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    ep->obj->remove_encap_map_entry(ep->info->bridge_oid);
+    ndi_remove_encap_tunnel_map_entry(ep->npu_id, ep->encap_map_entry_oid);
+}
+
+static t_std_error ndi_tun_txn_brport_create(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    t_std_error rc;
+
+    if ((rc = ndi_1d_bridge_tunnel_port_add(ep->npu_id, ep->info->bridge_oid, ep->obj->get_tun_oid(),
+                                            &ep->tun_brport_oid)) != STD_ERR_OK) {
+        NDI_IDBR_LOG_ERROR(" Tunnel bridge port create  failure");
+        return rc;
+    }
+    if (false == ep->obj->insert_tunnel_bridge_port(ep->info->bridge_oid, ep->info->vni,
+                                                    ep->tun_brport_oid)) {
+        NDI_IDBR_LOG_ERROR(" Tunnel bridge port insert failure");
+        ndi_1d_bridge_tunnel_delete(ep->npu_id, ep->tun_brport_oid);
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    return STD_ERR_OK;
+}
+
+static void ndi_tun_txn_brport_remove(void *ctx)
+{
+    auto ep = static_cast<ndi_tun_endpoint_txn_t *>(ctx);
+    ep->obj->remove_tunnel_bridge_port(ep->info->bridge_oid);
+    ndi_1d_bridge_tunnel_delete(ep->npu_id, ep->tun_brport_oid);
+}
 
-    if(decap_tunnel_map_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_decap_tunnel_map(npu_id, decap_tunnel_map_oid);
+/*
+ * Get the tunnel object of the remote and local IP of the endpoint, the
+ * tunnel and its maps are created if not there yet. Caller must hold
+ * ndi_tun_mutex_lock().
+ */
+static TunnelObj *ndi_tunnel_obj_get_or_create(npu_id_t npu_id, const tun_info_t *info)
+{
+    auto obj = get_tunnel_obj(&info->remote_src_ip, &info->local_src_ip);
+    if (obj != NULL) {
+        return obj;
     }
 
-    if(tunnel_term_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_tunnel_term_entry(npu_id, tunnel_term_oid);
+    char buff2[HAL_INET6_TEXT_LEN+1];
+    char buff[HAL_INET6_TEXT_LEN + 1];
+    std_ip_to_string(&info->remote_src_ip, buff2, HAL_INET6_TEXT_LEN);
+    std_ip_to_string(&info->local_src_ip, buff, HAL_INET6_TEXT_LEN);
+
+    NDI_IDBR_LOG_TRACE("create basic tunnel for local src IP %s, dest_ip %s", buff, buff2);
+    if (ndi_create_tunnel_basic_entries(npu_id, info->vrf_oid, info->ulay_rif_oid,  &info->local_src_ip, &info->remote_src_ip)
+               != STD_ERR_OK) {
+        NDI_IDBR_LOG_ERROR("Basic tunnel entry failure for Src IP %s Dest IP %s vrf id %llu" , buff, buff2, info->vrf_oid);
+        return NULL;
     }
 
-    if(tunnel_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_tunnel(npu_id, tunnel_oid);
-        remove_tunnel_obj(remote_src_ip, local_src_ip);
+    /* Get tunnel object from the map */
+    obj = get_tunnel_obj(&info->remote_src_ip, &info->local_src_ip);
+    if (obj == NULL) {
+        NDI_IDBR_LOG_ERROR("SAI FAILURE: tunnel_create : no obj for ip %s", buff2);
     }
-    return STD_ERR(NPU, PARAM, 0);
+    return obj;
 }
 
-
 static bool ndi_handle_tunnel_creation(npu_id_t npu_id, const tun_info_t *info,  ndi_obj_id_t *tun_brport)
 
 {
 
-    sai_object_id_t encap_tunnel_map_oid       = SAI_NULL_OBJECT_ID;
-    sai_object_id_t decap_tunnel_map_oid       = SAI_NULL_OBJECT_ID;
-    sai_object_id_t tunnel_oid                 = SAI_NULL_OBJECT_ID;
-    sai_object_id_t encap_tunnel_map_entry_oid = SAI_NULL_OBJECT_ID;
-    sai_object_id_t decap_tunnel_map_entry_oid = SAI_NULL_OBJECT_ID;
     char buff2[HAL_INET6_TEXT_LEN+1];
     char buff[HAL_INET6_TEXT_LEN + 1];
 
@@ -683,20 +859,8 @@ static bool ndi_handle_tunnel_creation(npu_id_t npu_id, const tun_info_t *info,
 
     NDI_IDBR_LOG_TRACE("Handle tunnel ccreate for Src IP %s Dest IP %s vrf id %llu" , buff, buff2, info->vrf_oid);
 
-    if (has_tunnel_obj(&info->remote_src_ip, &info->local_src_ip) == false) {
-        NDI_IDBR_LOG_TRACE("create basic tunnel for local src IP %s, dest_ip %s", buff, buff2);
-        if (ndi_create_tunnel_basic_entries(npu_id, info->vrf_oid, info->ulay_rif_oid,  &info->local_src_ip, &info->remote_src_ip)
-                   != STD_ERR_OK) {
-            NDI_IDBR_LOG_ERROR("Basic tunnel entry failure for Src IP %s Dest IP %s vrf id %llu" , buff, buff2, info->vrf_oid);
-            return false;
-        }
-
-    }
-
-    /* Get tunnel object from the map */
-    auto obj = get_tunnel_obj((const hal_ip_addr_t *) &info->remote_src_ip,(const hal_ip_addr_t *) &info->local_src_ip);
+    auto obj = ndi_tunnel_obj_get_or_create(npu_id, info);
     if (obj == NULL) {
-        NDI_IDBR_LOG_ERROR("SAI FAILURE: tunnel_create : no obj for ip %s", buff);
         return false;
     }
 
@@ -706,65 +870,44 @@ static bool ndi_handle_tunnel_creation(npu_id_t npu_id, const tun_info_t *info,
     /* ONE BRIDGE WILL HAVE ONLY ONE  UNIQUE VNI /VTEP ASSOCIATED WITH 2 UNIQUE SRC AND DEST */
     /* So for unique  SRC AND DEST ip in a bridge do we need to create a new tunnel port for each new VNIi for that bridge */
 
-    encap_tunnel_map_oid = obj->get_encap_map_oid();
-    decap_tunnel_map_oid = obj->get_decap_map_oid();
-    do {
-        /* Create decap tunnel entry for Bridge to VNI mapping & associate with the encap map above. */
-        if (STD_ERR_OK != ndi_create_decap_tunnel_map_entry(npu_id, &decap_tunnel_map_entry_oid, info->bridge_oid, decap_tunnel_map_oid, info->vni)) {
-            break;
-        }
-        if(false == obj->insert_decap_map_entry(info->bridge_oid, info->vni, decap_tunnel_map_entry_oid)) {
-            NDI_IDBR_LOG_ERROR(" insert_decap_map_entry bridge %llu , vni %llu", info->bridge_oid,info-> vni);
-            break;
-        }
-
-        /* Create encap tunnel entry for Bridge to VNI mapping & associate with the encap map above. */
-        if (STD_ERR_OK != ndi_create_encap_tunnel_map_entry(npu_id, &encap_tunnel_map_entry_oid, info->bridge_oid, encap_tunnel_map_oid, info->vni)) {
-            break;
-        }
-        if(false == obj->insert_encap_map_entry(info->bridge_oid, info->vni, encap_tunnel_map_entry_oid)) {
-            NDI_IDBR_LOG_ERROR(" insert_encap_map_entry bridge %llu , vni %llu", info->bridge_oid, info->vni);
-            obj->remove_decap_map_entry(info->vni);
-            break;
-        }
-
-
-        /* NAS-MAC will update the remote MAC address in to SAI FDB for
-         * this particular Dot1dBridge with the Tunnel BridgePort and
-         * Remote MAC as Dest - sai_create_fdb_entry_fn() */
-
-
-        vni_s_oid_map_t key_val;
-        tunnel_oid  =  obj->get_tun_oid();
-        if (!obj->get_bridge_port(info->bridge_oid, &key_val)) {
-        /* If not create TunnelBridgePort and add to object */
-           sai_object_id_t tun_bridgeport_oid;
-           if ((ndi_1d_bridge_tunnel_port_add(npu_id, info->bridge_oid, tunnel_oid, &tun_bridgeport_oid) == STD_ERR_OK)) {
-                if  (false == obj->insert_tunnel_bridge_port(info->bridge_oid, info->vni, tun_bridgeport_oid)) {
-                    NDI_IDBR_LOG_ERROR(" Tunnel bridge port insert failure");
-                    break;
-                }
-            }else {
-                NDI_IDBR_LOG_ERROR(" Tunnel bridge port create  failure");
-                break;
-            }
-            *(tun_brport) = (ndi_obj_id_t)tun_bridgeport_oid;
-        } else {
-            NDI_IDBR_LOG_ERROR(" ERROR :Tunnel bridge port exist for tunnel brport %llu, tun oid %llu",key_val.oid , tunnel_oid);
-            break;
-        }
-        NDI_IDBR_LOG_TRACE("Handle  tunnel create  entry PASSED for Src IP %s Dest IP %s vrf id %llu" , buff, buff2, info->vrf_oid);
-        return true;
-    } while(0);
-
-    if(encap_tunnel_map_entry_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_encap_tunnel_map_entry(npu_id, encap_tunnel_map_entry_oid);
+    vni_s_oid_map_t key_val;
+    if (obj->get_bridge_port(info->bridge_oid, &key_val)) {
+        NDI_IDBR_LOG_ERROR(" ERROR :Tunnel bridge port exist for tunnel brport %llu, tun oid %llu",key_val.oid , obj->get_tun_oid());
+        return false;
     }
 
-    if(decap_tunnel_map_entry_oid != SAI_NULL_OBJECT_ID) {
-        ndi_remove_decap_tunnel_map_entry(npu_id, decap_tunnel_map_entry_oid);
+    /* Create decap and encap map entries for the Bridge to VNI mapping and
+     * the tunnel bridge port in one transaction.
+     * NAS-MAC will update the remote MAC address in to SAI FDB for
+     * this particular Dot1dBridge with the Tunnel BridgePort and
+     * Remote MAC as Dest - sai_create_fdb_entry_fn() */
+    ndi_tun_endpoint_txn_t ep;
+    memset(&ep, 0, sizeof(ep));
+    ep.npu_id = npu_id;
+    ep.info = info;
+    ep.obj = obj;
+
+    ndi_txn_t *txn = ndi_txn_create();
+    if (txn == NULL) {
+        return false;
+    }
+    t_std_error rc = STD_ERR(NPU, NOMEM, 0);
+    if ((ndi_txn_add_step(txn, ndi_tun_txn_decap_entry_create, ndi_tun_txn_decap_entry_remove, &ep)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_encap_entry_create, ndi_tun_txn_encap_entry_remove, &ep)
+                != NDI_TXN_STEP_INVALID) &&
+        (ndi_txn_add_step(txn, ndi_tun_txn_brport_create, ndi_tun_txn_brport_remove, &ep)
+                != NDI_TXN_STEP_INVALID)) {
+        rc = ndi_txn_commit(txn);
+    }
+    ndi_txn_destroy(txn);
+    if (rc != STD_ERR_OK) {
+        return false;
     }
-    return false;
+
+    *(tun_brport) = (ndi_obj_id_t)ep.tun_brport_oid;
+    NDI_IDBR_LOG_TRACE("Handle  tunnel create  entry PASSED for Src IP %s Dest IP %s vrf id %llu" , buff, buff2, info->vrf_oid);
+    return true;
 }
 
 extern "C" {
@@ -1134,3 +1277,181 @@ t_std_error ndi_create_underlay_rif(npu_id_t npu, ndi_obj_id_t *underlay_rif_oid
 }
 
 }
+
+/*
+ * Endpoints of a batch are attached in phases, all decap map entries, then all
+ * encap map entries and then all tunnel bridge ports. An endpoint failing a
+ * phase has its earlier steps undone and is skipped in the later phases.
+ */
+typedef struct {
+    ndi_txn_do_fn create;
+    ndi_txn_undo_fn remove;
+} ndi_tun_endpoint_phase_t;
+
+static const ndi_tun_endpoint_phase_t ndi_tun_endpoint_phases[] = {
+    {ndi_tun_txn_decap_entry_create, ndi_tun_txn_decap_entry_remove},
+    {ndi_tun_txn_encap_entry_create, ndi_tun_txn_encap_entry_remove},
+    {ndi_tun_txn_brport_create, ndi_tun_txn_brport_remove},
+};
+
+extern "C" {
+
+t_std_error nas_ndi_add_remote_endpoints(npu_id_t npu_id, ndi_obj_id_t vrf_oid, ndi_obj_id_t ulay_rif_oid,
+                                         ndi_tunnel_endpoint_t *ep_list, size_t count, t_std_error *rc_list)
+{
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    if (ep_list == NULL) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    std::vector<tun_info_t> info_list(count);
+    std::vector<ndi_tun_endpoint_txn_t> txn_list(count);
+    std::vector<t_std_error> rc_vec(count, STD_ERR_OK);
+
+    NDI_IDBR_LOG_TRACE("ADD %lu remote endpoints vrf_id %" PRIx64 " ulay_rif %" PRIx64,
+                       count, vrf_oid, ulay_rif_oid);
+
+    std_mutex_simple_lock_guard lock_t(ndi_tun_mutex_lock());
+
+    /* Existing tunnel objects are reused, each missing tunnel is created once */
+    for (size_t ix = 0; ix < count; ++ix) {
+        auto &info = info_list[ix];
+        memset(&info, 0, sizeof(info));
+        info.remote_src_ip = ep_list[ix].remote_ip;
+        info.local_src_ip = ep_list[ix].local_ip;
+        info.vni = ep_list[ix].vni;
+        info.vrf_oid = vrf_oid;
+        info.ulay_rif_oid = ulay_rif_oid;
+        info.bridge_oid = ep_list[ix].bridge_oid;
+        ep_list[ix].tun_brport_oid = 0;
+
+        auto &ep = txn_list[ix];
+        memset(&ep, 0, sizeof(ep));
+        ep.npu_id = npu_id;
+        ep.info = &info;
+        ep.obj = ndi_tunnel_obj_get_or_create(npu_id, &info);
+
+        vni_s_oid_map_t key_val;
+        if (ep.obj == NULL) {
+            rc_vec[ix] = STD_ERR(NPU, CFG, 0);
+        } else if (ep.obj->get_bridge_port(info.bridge_oid, &key_val)) {
+            NDI_IDBR_LOG_ERROR(" ERROR :Tunnel bridge port exist for tunnel brport %llu, tun oid %llu",
+                               key_val.oid, ep.obj->get_tun_oid());
+            rc_vec[ix] = STD_ERR(NPU, CFG, 0);
+        }
+    }
+
+    for (size_t phase = 0; phase < sizeof(ndi_tun_endpoint_phases) / sizeof(ndi_tun_endpoint_phases[0]);
+         ++phase) {
+        for (size_t ix = 0; ix < count; ++ix) {
+            if (rc_vec[ix] != STD_ERR_OK) {
+                continue;
+            }
+            if ((rc_vec[ix] = ndi_tun_endpoint_phases[phase].create(&txn_list[ix])) != STD_ERR_OK) {
+                NDI_IDBR_LOG_ERROR("Failed to add remote endpoint %lu for bridge %llu, vni %d",
+                                   ix, info_list[ix].bridge_oid, info_list[ix].vni);
+                for (size_t undo = phase; undo > 0; --undo) {
+                    ndi_tun_endpoint_phases[undo - 1].remove(&txn_list[ix]);
+                }
+            }
+        }
+    }
+
+    /* Tunnels left with no bridge port are removed, same as on endpoint removal */
+    for (size_t ix = 0; ix < count; ++ix) {
+        auto obj = txn_list[ix].obj;
+        if (rc_vec[ix] == STD_ERR_OK) {
+            ep_list[ix].tun_brport_oid = (ndi_obj_id_t)txn_list[ix].tun_brport_oid;
+        } else if ((obj != NULL) &&
+                   (get_tunnel_obj(&info_list[ix].remote_src_ip, &info_list[ix].local_src_ip) == obj) &&
+                   (obj->get_tunnel_bridge_ports_size() == 0)) {
+            if (ndi_delete_basic_tunnel_entry(npu_id, obj, info_list[ix].bridge_oid) == STD_ERR_OK) {
+                remove_tunnel_obj(&info_list[ix].remote_src_ip, &info_list[ix].local_src_ip);
+            }
+        }
+    }
+
+    t_std_error rc = STD_ERR_OK;
+    for (size_t ix = 0; ix < count; ++ix) {
+        if (rc_list != NULL) {
+            rc_list[ix] = rc_vec[ix];
+        }
+        if ((rc == STD_ERR_OK) && (rc_vec[ix] != STD_ERR_OK)) {
+            rc = rc_vec[ix];
+        }
+    }
+    return rc;
+}
+
+t_std_error ndi_tunnel_oid_list_get(const hal_ip_addr_t *remote_ip_list, const hal_ip_addr_t *local_ip_list,
+                                    size_t count, ndi_obj_id_t *tun_oid_list)
+{
+    if ((count > 0) && ((remote_ip_list == NULL) || (local_ip_list == NULL) || (tun_oid_list == NULL))) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    t_std_error rc = STD_ERR_OK;
+    std_mutex_simple_lock_guard lock_t(ndi_tun_mutex_lock());
+    for (size_t ix = 0; ix < count; ++ix) {
+        TunnelObj *obj = get_tunnel_obj(&remote_ip_list[ix], &local_ip_list[ix]);
+        if (obj == NULL) {
+            char buff[HAL_INET6_TEXT_LEN + 1];
+            std_ip_to_string(&remote_ip_list[ix], buff, HAL_INET6_TEXT_LEN);
+            NDI_IDBR_LOG_ERROR("No tunnel obj for remote ip %s\n", buff);
+            tun_oid_list[ix] = SAI_NULL_OBJECT_ID;
+            rc = STD_ERR(NPU, CFG, 0);
+            continue;
+        }
+        tun_oid_list[ix] = (ndi_obj_id_t)obj->get_tun_oid();
+    }
+    return rc;
+}
+
+/*
+ * SAI has no bulk stats call for tunnels, tunnels are read one per call with
+ * the SAI counter ids translated once in the handle. Counters of a tunnel that
+ * failed are zeroed.
+ */
+t_std_error ndi_tunnel_stats_bulk_get(npu_id_t npu_id, const ndi_obj_id_t *tun_oid_list,
+                                      size_t tun_count, const ndi_stat_handle_t *handle,
+                                      uint64_t *stats_val, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+
+    if (ndi_db_ptr == NULL) {
+        NDI_VLAN_LOG_ERROR("Invalid NPU Id %d passed",npu_id);
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((handle == NULL) || (handle->obj_type != NDI_STAT_OBJ_TUNNEL)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((tun_count > 0) && ((tun_oid_list == NULL) || (stats_val == NULL))) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    t_std_error rc = STD_ERR_OK;
+    for (size_t ix = 0; ix < tun_count; ++ix) {
+        t_std_error tun_rc = STD_ERR_OK;
+        uint64_t *tun_stats = &stats_val[ix * handle->len];
+        sai_status_t sai_ret;
+
+        if ((sai_ret = ndi_sai_tunnel_api(ndi_db_ptr)->get_tunnel_stats(tun_oid_list[ix],
+                        handle->len, handle->tunnel_ids.data(), tun_stats)) != SAI_STATUS_SUCCESS) {
+            NDI_IDBR_LOG_ERROR("Tunnel stats Get failed for npu %d, Tunnel %" PRIx64 ", ret %d",
+                               npu_id, tun_oid_list[ix], sai_ret);
+            tun_rc = STD_ERR(NPU, FAIL, sai_ret);
+            memset(tun_stats, 0, handle->len * sizeof(uint64_t));
+            if (rc == STD_ERR_OK) {
+                rc = tun_rc;
+            }
+        }
+        if (rc_list != NULL) {
+            rc_list[ix] = tun_rc;
+        }
+    }
+    return rc;
+}
+
+}
@@ -25,106 +25,219 @@
 #include "std_rw_lock.h"
 #include "std_ip_utils.h"
 
+#include <memory>
+#include <string.h>
+
+/* Minimum number of slots of the tunnel object index, power of 2 */
+#define NDI_TUNNEL_INDEX_MIN_SIZE   64
+
+/*
+ * Tunnel object key. Only the address bytes of the address family are
+ * copied, unused bytes are zero so keys could be compared with memcmp.
+ */
 typedef struct {
-  hal_ip_addr_t remote_ip; /* may need source_ip as key too */
-  hal_ip_addr_t local_ip;
+  uint32_t af_index;
+  uint8_t remote_ip[HAL_INET6_LEN];
+  uint8_t local_ip[HAL_INET6_LEN];
 } br_ip_key_t;
 
-typedef struct ndi_br_ip_addr_comp_less {
-     bool operator()(const br_ip_key_t& a, const br_ip_key_t& b)
-     {
-         if (memcmp(&a.remote_ip.u, &b.remote_ip.u, sizeof(in6_addr)) != 0) {
-             return (memcmp(&a.remote_ip.u, &b.remote_ip.u, sizeof(in6_addr)) <0);
-         } else {
-             return (memcmp(&a.local_ip.u, &b.local_ip.u, sizeof(in6_addr)) <0 );
-         }
-     }
-} ndi_br_ip_addr_comp_less_t;
+static void _tunnel_key_ip_copy(uint8_t *key_ip, const hal_ip_addr_t *ip)
+{
+    if (ip->af_index == HAL_INET4_FAMILY) {
+        memcpy(key_ip, &ip->u.v4_addr, sizeof(ip->u.v4_addr));
+    } else {
+        memcpy(key_ip, ip->u.v6_addr, HAL_INET6_LEN);
+    }
+}
 
-using _tunnel_obj_map_t = std::map <br_ip_key_t, TunnelObj *, ndi_br_ip_addr_comp_less_t>;
+static br_ip_key_t _tunnel_key(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip)
+{
+    br_ip_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.af_index = src_ip->af_index;
+    _tunnel_key_ip_copy(key.remote_ip, src_ip);
+    _tunnel_key_ip_copy(key.local_ip, loc_ip);
+    return key;
+}
 
-static _tunnel_obj_map_t nas_ndi_tunnel_obj_map;
+static inline uint64_t _tunnel_key_mix(uint64_t h_val, uint64_t word)
+{
+    h_val ^= word;
+    h_val *= 0xff51afd7ed558ccdULL;
+    h_val ^= h_val >> 33;
+    return h_val;
+}
 
+static uint64_t _tunnel_key_hash(const br_ip_key_t &key)
+{
+    uint64_t words[2 * HAL_INET6_LEN / sizeof(uint64_t)];
+    memcpy(&words[0], key.remote_ip, HAL_INET6_LEN);
+    memcpy(&words[HAL_INET6_LEN / sizeof(uint64_t)], key.local_ip, HAL_INET6_LEN);
+    uint64_t h_val = _tunnel_key_mix(0xc4ceb9fe1a85ec53ULL, key.af_index);
+    for (auto word: words) {
+        h_val = _tunnel_key_mix(h_val, word);
+    }
+    return h_val;
+}
 
+/*
+ * Open addressing hash index of tunnel objects with linear probing. Entries
+ * are removed with backward shift so there are no tombstones. Caller must
+ * hold ndi_tun_mutex_lock().
+ */
+class ndi_tunnel_obj_index {
+
+private:
+
+    typedef struct {
+        br_ip_key_t key;
+        TunnelObj *obj;
+    } slot_t;
+
+    std::unique_ptr<slot_t[]> _slots;
+    size_t _mask = 0;
+    size_t _count = 0;
+
+    bool grow();
+
+    slot_t *find_slot(const br_ip_key_t &key) const {
+        if (!_slots) return nullptr;
+        size_t pos = _tunnel_key_hash(key) & _mask;
+        while (_slots[pos].obj != nullptr) {
+            if (memcmp(&_slots[pos].key, &key, sizeof(key)) == 0) {
+                return &_slots[pos];
+            }
+            pos = (pos + 1) & _mask;
+        }
+        return nullptr;
+    }
 
-void print_tunnel_map()
+public:
+
+    TunnelObj *find(const br_ip_key_t &key) const {
+        auto slot = find_slot(key);
+        return (slot == nullptr) ? nullptr : slot->obj;
+    }
+
+    /* Add object, fails if an object with the same key exists */
+    bool insert(const br_ip_key_t &key, TunnelObj *obj);
+
+    /* Remove and return the object of the key if any */
+    TunnelObj *erase(const br_ip_key_t &key);
+
+    template <typename Fn> void for_each(Fn fn) const {
+        for (size_t ix = 0; _slots && ix <= _mask; ++ix) {
+            if (_slots[ix].obj != nullptr) fn(_slots[ix].key, _slots[ix].obj);
+        }
+    }
+};
+
+bool ndi_tunnel_obj_index::grow()
 {
-    char                    ip_str [HAL_INET6_TEXT_LEN] = {0};
-    std::cout << "\n Tunnel Objects Entries: ";
-    for(auto it = nas_ndi_tunnel_obj_map.begin();
-        it != nas_ndi_tunnel_obj_map.end(); ++it)
+    size_t size = (!_slots) ? NDI_TUNNEL_INDEX_MIN_SIZE : (_mask + 1) * 2;
+    std::unique_ptr<slot_t[]> slots(new (std::nothrow) slot_t[size]());
+    if (!slots) return false;
+
+    for (size_t ix = 0; _slots && ix <= _mask; ++ix) {
+        if (_slots[ix].obj == nullptr) continue;
+        size_t pos = _tunnel_key_hash(_slots[ix].key) & (size - 1);
+        while (slots[pos].obj != nullptr) {
+            pos = (pos + 1) & (size - 1);
+        }
+        slots[pos] = _slots[ix];
+    }
+    _slots = std::move(slots);
+    _mask = size - 1;
+    return true;
+}
 
-    {
-        std_ip_to_string (&it->first.remote_ip, ip_str,sizeof (ip_str));
+bool ndi_tunnel_obj_index::insert(const br_ip_key_t &key, TunnelObj *obj)
+{
+    if (obj == nullptr || find_slot(key) != nullptr) return false;
+    if (!_slots || (_count + 1) * 2 > _mask + 1) {
+        if (!grow()) return false;
+    }
 
-        std::cout << "Remote Source IP: " << ip_str << "\n";
-        (*(it->second)).print();
+    size_t pos = _tunnel_key_hash(key) & _mask;
+    while (_slots[pos].obj != nullptr) {
+        pos = (pos + 1) & _mask;
     }
+    _slots[pos].key = key;
+    _slots[pos].obj = obj;
+    ++_count;
+    return true;
 }
 
-bool insert_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip, TunnelObj *tunnel_obj)
+TunnelObj *ndi_tunnel_obj_index::erase(const br_ip_key_t &key)
 {
-    br_ip_key_t key;
+    auto slot = find_slot(key);
+    if (slot == nullptr) return nullptr;
+    TunnelObj *obj = slot->obj;
+
+    /* Shift back the following entries which probed past the hole */
+    size_t hole = slot - _slots.get();
+    size_t pos = hole;
+    while (true) {
+        pos = (pos + 1) & _mask;
+        if (_slots[pos].obj == nullptr) break;
+        size_t home = _tunnel_key_hash(_slots[pos].key) & _mask;
+        if (((pos - home) & _mask) >= ((pos - hole) & _mask)) {
+            _slots[hole] = _slots[pos];
+            hole = pos;
+        }
+    }
+    _slots[hole].obj = nullptr;
+    --_count;
+    return obj;
+}
 
-    memcpy(&key.remote_ip, src_ip, sizeof(hal_ip_addr_t));
-    memcpy(&key.local_ip, loc_ip, sizeof(hal_ip_addr_t));
+static ndi_tunnel_obj_index nas_ndi_tunnel_obj_map;
 
-    auto it = nas_ndi_tunnel_obj_map.find(key);
 
-    if (it != nas_ndi_tunnel_obj_map.end()) {
-        return false;
-    }
 
-    nas_ndi_tunnel_obj_map.insert(std::make_pair(key, tunnel_obj));
-    return true;
+void print_tunnel_map()
+{
+    char                    ip_str [HAL_INET6_TEXT_LEN] = {0};
+    std::cout << "\n Tunnel Objects Entries: ";
+    nas_ndi_tunnel_obj_map.for_each([&](const br_ip_key_t &key, TunnelObj *obj)
+    {
+        hal_ip_addr_t remote_ip;
+        obj->get_remote_src_ip(&remote_ip);
+        std_ip_to_string (&remote_ip, ip_str,sizeof (ip_str));
+
+        std::cout << "Remote Source IP: " << ip_str << "\n";
+        obj->print();
+    });
 }
 
-bool remove_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip)
+bool insert_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip, TunnelObj *tunnel_obj)
 {
-    br_ip_key_t key;
-    memcpy(&key.remote_ip, src_ip, sizeof(hal_ip_addr_t));
-    memcpy(&key.local_ip, loc_ip, sizeof(hal_ip_addr_t));
+    return nas_ndi_tunnel_obj_map.insert(_tunnel_key(src_ip, loc_ip), tunnel_obj);
+}
 
-    auto it = nas_ndi_tunnel_obj_map.find(key);
+bool remove_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip)
+{
+    TunnelObj *obj = nas_ndi_tunnel_obj_map.erase(_tunnel_key(src_ip, loc_ip));
 
-    if (it == nas_ndi_tunnel_obj_map.end()) {
-        return false;
-    }
-    TunnelObj *obj = it->second;
-    nas_ndi_tunnel_obj_map.erase(it);
     if (obj != nullptr) {
         delete obj;
-        return false;
     }
-    return true;
+    return false;
 }
 
 TunnelObj *get_tunnel_obj(const hal_ip_addr_t *src_ip, const hal_ip_addr_t *loc_ip)
 {
-    br_ip_key_t key;
-
-    memcpy(&key.remote_ip, src_ip, sizeof(hal_ip_addr_t));
-    memcpy(&key.local_ip, loc_ip, sizeof(hal_ip_addr_t));
-
-    auto it = nas_ndi_tunnel_obj_map.find(key);
-
-    if (it == nas_ndi_tunnel_obj_map.end()) {
-        return NULL;
-    }
-    return (it->second);
+    return nas_ndi_tunnel_obj_map.find(_tunnel_key(src_ip, loc_ip));
 }
 
 bool has_tunnel_obj(const hal_ip_addr_t *src_ip,const hal_ip_addr_t *loc_ip)
 {
-    br_ip_key_t key;
-
-    memcpy(&key.remote_ip, src_ip, sizeof(hal_ip_addr_t));
-    memcpy(&key.local_ip, loc_ip, sizeof(hal_ip_addr_t));
-
-    auto it = nas_ndi_tunnel_obj_map.find(key);
+    return (nas_ndi_tunnel_obj_map.find(_tunnel_key(src_ip, loc_ip)) != nullptr);
+}
 
-    if (it == nas_ndi_tunnel_obj_map.end()) {
-        return false;
-    }
-    return true;
+void walk_tunnel_obj(std::function<void (TunnelObj *)> fn)
+{
+    nas_ndi_tunnel_obj_map.for_each([&](const br_ip_key_t &key, TunnelObj *obj) {
+        fn(obj);
+    });
 }
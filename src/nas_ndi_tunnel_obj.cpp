@@ -23,42 +23,128 @@
 #include "nas_ndi_tunnel_obj.h"
 #include "std_ip_utils.h"
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+/* Number of TunnelObj records carved out of one pool chunk */
+#define NDI_TUNNEL_OBJ_CHUNK_SIZE   256
+
+/*
+ * Fixed size record pool for TunnelObj. Records are taken from chunks and
+ * returned to a free list on delete, chunks are never released.
+ */
+class ndi_tunnel_obj_pool {
+
+private:
+
+    union rec_t {
+        rec_t *next;
+        std::aligned_storage<sizeof(TunnelObj), alignof(TunnelObj)>::type obj;
+    };
+
+    std::mutex _lock;
+    std::vector<std::unique_ptr<rec_t[]>> _chunks;
+    rec_t *_free_list = nullptr;
+
+public:
+
+    void *alloc() {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_free_list == nullptr) {
+            std::unique_ptr<rec_t[]> chunk(new rec_t[NDI_TUNNEL_OBJ_CHUNK_SIZE]);
+            for (size_t ix = 0; ix < NDI_TUNNEL_OBJ_CHUNK_SIZE; ++ix) {
+                chunk[ix].next = _free_list;
+                _free_list = &chunk[ix];
+            }
+            _chunks.push_back(std::move(chunk));
+        }
+        rec_t *rec = _free_list;
+        _free_list = rec->next;
+        return rec;
+    }
+
+    void free(void *ptr) {
+        std::lock_guard<std::mutex> lock(_lock);
+        rec_t *rec = static_cast<rec_t *>(ptr);
+        rec->next = _free_list;
+        _free_list = rec;
+    }
+};
+
+static ndi_tunnel_obj_pool & _tunnel_obj_pool()
+{
+    static ndi_tunnel_obj_pool *pool = new ndi_tunnel_obj_pool{};
+    return *pool;
+}
+
+void *TunnelObj::operator new(size_t size)
+{
+    if (size != sizeof(TunnelObj)) {
+        return ::operator new(size);
+    }
+    return _tunnel_obj_pool().alloc();
+}
+
+void TunnelObj::operator delete(void *ptr, size_t size)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    if (size != sizeof(TunnelObj)) {
+        ::operator delete(ptr);
+        return;
+    }
+    _tunnel_obj_pool().free(ptr);
+}
+
+static _vni_sai_obj_map_t::iterator _vni_map_find(_vni_sai_obj_map_t *map, sai_object_id_t br_oid)
+{
+    auto it = std::lower_bound(map->begin(), map->end(), br_oid,
+                               [](const _vni_sai_obj_map_t::value_type &val, sai_object_id_t oid) {
+                                   return val.first < oid;
+                               });
+    return it;
+}
+
 bool TunnelObj::_insert(_vni_sai_obj_map_t *map, sai_object_id_t bridge_oid, uint32_t vni, sai_object_id_t oid)
 {
     vni_s_oid_map_t vni_sai_oid;
     vni_sai_oid.vni = vni;
     vni_sai_oid.oid = oid;
 
-    auto it = map->find(bridge_oid);
-
-    if (it != map->end()) {
-        return false;
-    }
-    auto ret = map->insert({bridge_oid, vni_sai_oid});
+    auto it = _vni_map_find(map, bridge_oid);
 
-    if (ret.second == false) {
+    if (it != map->end() && it->first == bridge_oid) {
         return false;
     }
+    map->insert(it, {bridge_oid, vni_sai_oid});
     return true;
 }
 
 bool TunnelObj::_remove(_vni_sai_obj_map_t *map, sai_object_id_t br_oid)
 {
-    auto it = map->find(br_oid);
+    auto it = _vni_map_find(map, br_oid);
 
-    if (it == map->end()) {
+    if (it == map->end() || it->first != br_oid) {
         return false;
     }
     map->erase(it);
+    /* Give back memory once most of the bridges are gone */
+    if (map->size() * 4 < map->capacity()) {
+        map->shrink_to_fit();
+    }
     return true;
 }
 
 
 bool TunnelObj::_get(_vni_sai_obj_map_t *map, sai_object_id_t br_oid, vni_s_oid_map_t *map_val)
 {
-    auto it = map->find(br_oid);
+    auto it = _vni_map_find(map, br_oid);
 
-    if (it == map->end()) {
+    if (it == map->end() || it->first != br_oid) {
         return false;
     }
     memcpy(map_val, &(it->second), sizeof(vni_s_oid_map_t));
@@ -147,6 +233,19 @@ int TunnelObj::get_tunnel_bridge_ports_size()
     return tunnel_bridge_ports.size();
 }
 
+void TunnelObj::walk_map_entries(tunnel_obj_map_walk_fn fn)
+{
+    for (auto &it : encap_map) {
+        fn(ndi_tunnel_obj_map_type_ENCAP, it.first, it.second);
+    }
+    for (auto &it : decap_map) {
+        fn(ndi_tunnel_obj_map_type_DECAP, it.first, it.second);
+    }
+    for (auto &it : tunnel_bridge_ports) {
+        fn(ndi_tunnel_obj_map_type_BRIDGE_PORT, it.first, it.second);
+    }
+}
+
 void TunnelObj::print()
 {
     std::cout << "\n Tunnel OID: " << tun_oid;
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_txn.cpp
+ */
+
+#include "nas_ndi_txn.h"
+#include "nas_ndi_int.h"
+#include "nas_ndi_event_logs.h"
+
+#include <new>
+#include <vector>
+
+typedef enum {
+    NDI_TXN_STEP_GENERIC,
+    NDI_TXN_STEP_SAI_CREATE,
+    NDI_TXN_STEP_SAI_SET,
+    NDI_TXN_STEP_SAI_REMOVE,
+} ndi_txn_step_type_t;
+
+typedef struct {
+    uint32_t attr_ix;
+    ndi_txn_step_id_t src_step;
+} ndi_txn_bind_t;
+
+typedef struct {
+    ndi_txn_sai_create_fn create_fn;
+    sai_bulk_object_create_fn bulk_create_fn;
+    sai_bulk_object_remove_fn bulk_remove_fn;
+} ndi_txn_bulk_fn_t;
+
+struct ndi_txn_step_t {
+    ndi_txn_step_type_t type;
+    bool done = false;
+
+    ndi_txn_do_fn do_fn = nullptr;
+    ndi_txn_undo_fn undo_fn = nullptr;
+    void *ctx = nullptr;
+
+    ndi_txn_sai_create_fn create_fn = nullptr;
+    ndi_txn_sai_remove_fn remove_fn = nullptr;
+    ndi_txn_sai_set_fn set_fn = nullptr;
+
+    std::vector<sai_attribute_t> attr_list;
+    std::vector<ndi_txn_bind_t> bind_list;
+    bool has_old_attr = false;
+    sai_attribute_t old_attr;
+
+    sai_object_id_t oid = SAI_NULL_OBJECT_ID;
+    sai_object_id_t *oid_out = nullptr;
+
+    ndi_txn_step_t(ndi_txn_step_type_t t) : type(t) {}
+};
+
+struct ndi_txn_s {
+    bool committed = false;
+    std::vector<ndi_txn_step_t> steps;
+    std::vector<ndi_txn_bulk_fn_t> bulk_fns;
+
+    const ndi_txn_bulk_fn_t *bulk_fn_get(ndi_txn_sai_create_fn create_fn) const {
+        for (auto &fn: bulk_fns) {
+            if (fn.create_fn == create_fn) return &fn;
+        }
+        return nullptr;
+    }
+};
+
+static bool ndi_txn_bulk_unsupported(sai_status_t sai_ret)
+{
+    return (sai_ret == SAI_STATUS_NOT_IMPLEMENTED) || (sai_ret == SAI_STATUS_NOT_SUPPORTED);
+}
+
+static bool ndi_txn_resolve_binds(ndi_txn_t *txn, ndi_txn_step_t &step)
+{
+    for (auto &bind: step.bind_list) {
+        sai_object_id_t oid = txn->steps[bind.src_step].oid;
+        if (oid == SAI_NULL_OBJECT_ID) {
+            return false;
+        }
+        step.attr_list[bind.attr_ix].value.oid = oid;
+    }
+    return true;
+}
+
+/* Steps [start, end) can go in one bulk create if none of them refers to
+ * an object created in the same run */
+static size_t ndi_txn_create_run_end(const ndi_txn_t *txn, size_t start)
+{
+    auto create_fn = txn->steps[start].create_fn;
+    size_t end = start + 1;
+    for (; end < txn->steps.size(); ++end) {
+        auto &step = txn->steps[end];
+        if ((step.type != NDI_TXN_STEP_SAI_CREATE) || (step.create_fn != create_fn)) {
+            break;
+        }
+        bool dep = false;
+        for (auto &bind: step.bind_list) {
+            if (bind.src_step >= start) dep = true;
+        }
+        if (dep) break;
+    }
+    return end;
+}
+
+static t_std_error ndi_txn_sai_create_one(ndi_txn_step_t &step)
+{
+    sai_status_t sai_ret = step.create_fn(&step.oid, ndi_switch_id_get(),
+                                          step.attr_list.size(), step.attr_list.data());
+    if (sai_ret != SAI_STATUS_SUCCESS) {
+        step.oid = SAI_NULL_OBJECT_ID;
+        NDI_LOG_ERROR("NDI-TXN", "SAI create failed, SAI-status:%d", sai_ret);
+        return STD_ERR(NPU, FAIL, sai_ret);
+    }
+    step.done = true;
+    return STD_ERR_OK;
+}
+
+/*
+ * Create steps [start, end) in one bulk call. Returns false in *handled if
+ * the bulk call is not supported and the steps have to be created one by one.
+ */
+static t_std_error ndi_txn_sai_create_bulk(ndi_txn_t *txn, size_t start, size_t end,
+                                           sai_bulk_object_create_fn bulk_create_fn,
+                                           bool *handled)
+{
+    size_t count = end - start;
+    std::vector<uint32_t> attr_count(count);
+    std::vector<const sai_attribute_t *> attr_list(count);
+    std::vector<sai_object_id_t> oid_list(count, SAI_NULL_OBJECT_ID);
+    std::vector<sai_status_t> status_list(count, SAI_STATUS_FAILURE);
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        auto &step = txn->steps[start + ix];
+        attr_count[ix] = step.attr_list.size();
+        attr_list[ix] = step.attr_list.data();
+    }
+
+    sai_status_t sai_ret = bulk_create_fn(ndi_switch_id_get(), count, attr_count.data(),
+                                          attr_list.data(), SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+                                          oid_list.data(), status_list.data());
+    if (ndi_txn_bulk_unsupported(sai_ret)) {
+        *handled = false;
+        return STD_ERR_OK;
+    }
+    *handled = true;
+
+    t_std_error rc = STD_ERR_OK;
+    for (size_t ix = 0; ix < count; ++ix) {
+        auto &step = txn->steps[start + ix];
+        if (status_list[ix] == SAI_STATUS_SUCCESS) {
+            step.oid = oid_list[ix];
+            step.done = true;
+        } else if (rc == STD_ERR_OK) {
+            NDI_LOG_ERROR("NDI-TXN", "SAI bulk create failed for object %lu of %lu,"
+                          " SAI-status:%d", ix, count, status_list[ix]);
+            rc = STD_ERR(NPU, FAIL, status_list[ix]);
+        }
+    }
+    if ((rc == STD_ERR_OK) && (sai_ret != SAI_STATUS_SUCCESS)) {
+        rc = STD_ERR(NPU, FAIL, sai_ret);
+    }
+    return rc;
+}
+
+static t_std_error ndi_txn_step_do(ndi_txn_step_t &step)
+{
+    sai_status_t sai_ret;
+    t_std_error rc;
+
+    switch (step.type) {
+    case NDI_TXN_STEP_GENERIC:
+        rc = step.do_fn(step.ctx);
+        if (rc != STD_ERR_OK) {
+            return rc;
+        }
+        break;
+    case NDI_TXN_STEP_SAI_CREATE:
+        return ndi_txn_sai_create_one(step);
+    case NDI_TXN_STEP_SAI_SET:
+        if ((sai_ret = step.set_fn(step.oid, step.attr_list.data())) != SAI_STATUS_SUCCESS) {
+            NDI_LOG_ERROR("NDI-TXN", "SAI set failed for oid 0x%lx attr %d, SAI-status:%d",
+                          step.oid, step.attr_list[0].id, sai_ret);
+            return STD_ERR(NPU, FAIL, sai_ret);
+        }
+        break;
+    case NDI_TXN_STEP_SAI_REMOVE:
+        if ((sai_ret = step.remove_fn(step.oid)) != SAI_STATUS_SUCCESS) {
+            NDI_LOG_ERROR("NDI-TXN", "SAI remove failed for oid 0x%lx, SAI-status:%d",
+                          step.oid, sai_ret);
+            return STD_ERR(NPU, FAIL, sai_ret);
+        }
+        break;
+    }
+    step.done = true;
+    return STD_ERR_OK;
+}
+
+static void ndi_txn_step_undo(ndi_txn_step_t &step)
+{
+    sai_status_t sai_ret;
+
+    switch (step.type) {
+    case NDI_TXN_STEP_GENERIC:
+        if (step.undo_fn != nullptr) {
+            step.undo_fn(step.ctx);
+        }
+        break;
+    case NDI_TXN_STEP_SAI_CREATE:
+        if ((sai_ret = step.remove_fn(step.oid)) != SAI_STATUS_SUCCESS) {
+            NDI_LOG_ERROR("NDI-TXN", "Rollback remove failed for oid 0x%lx, SAI-status:%d",
+                          step.oid, sai_ret);
+        }
+        step.oid = SAI_NULL_OBJECT_ID;
+        break;
+    case NDI_TXN_STEP_SAI_SET:
+        if (step.has_old_attr &&
+            (sai_ret = step.set_fn(step.oid, &step.old_attr)) != SAI_STATUS_SUCCESS) {
+            NDI_LOG_ERROR("NDI-TXN", "Rollback set failed for oid 0x%lx attr %d,"
+                          " SAI-status:%d", step.oid, step.old_attr.id, sai_ret);
+        }
+        break;
+    case NDI_TXN_STEP_SAI_REMOVE:
+        NDI_LOG_ERROR("NDI-TXN", "Can not restore removed oid 0x%lx", step.oid);
+        break;
+    }
+    step.done = false;
+}
+
+/* Undo all done steps in reverse order, removing runs of objects created
+ * with the same handler in one bulk call where possible */
+static void ndi_txn_rollback(ndi_txn_t *txn)
+{
+    size_t ix = txn->steps.size();
+    while (ix > 0) {
+        auto &step = txn->steps[ix - 1];
+        if (!step.done) {
+            --ix;
+            continue;
+        }
+        const ndi_txn_bulk_fn_t *bulk_fn = nullptr;
+        if (step.type == NDI_TXN_STEP_SAI_CREATE) {
+            bulk_fn = txn->bulk_fn_get(step.create_fn);
+        }
+        if ((bulk_fn == nullptr) || (bulk_fn->bulk_remove_fn == nullptr)) {
+            ndi_txn_step_undo(step);
+            --ix;
+            continue;
+        }
+
+        std::vector<sai_object_id_t> oid_list;
+        size_t start = ix;
+        while (start > 0) {
+            auto &prev = txn->steps[start - 1];
+            if (!prev.done || (prev.type != NDI_TXN_STEP_SAI_CREATE) ||
+                (prev.create_fn != step.create_fn)) {
+                break;
+            }
+            oid_list.push_back(prev.oid);
+            --start;
+        }
+        std::vector<sai_status_t> status_list(oid_list.size(), SAI_STATUS_FAILURE);
+        sai_status_t sai_ret = bulk_fn->bulk_remove_fn(oid_list.size(), oid_list.data(),
+                                                      SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+                                                      status_list.data());
+        bool unsupported = ndi_txn_bulk_unsupported(sai_ret);
+        /* oid_list is in reverse step order */
+        for (size_t oix = 0; oix < oid_list.size(); ++oix) {
+            auto &undo_step = txn->steps[ix - 1 - oix];
+            if (unsupported) {
+                ndi_txn_step_undo(undo_step);
+                continue;
+            }
+            if (status_list[oix] != SAI_STATUS_SUCCESS) {
+                NDI_LOG_ERROR("NDI-TXN", "Rollback remove failed for oid 0x%lx,"
+                              " SAI-status:%d", undo_step.oid, status_list[oix]);
+            }
+            undo_step.oid = SAI_NULL_OBJECT_ID;
+            undo_step.done = false;
+        }
+        ix = start;
+    }
+}
+
+static ndi_txn_step_id_t ndi_txn_step_add(ndi_txn_t *txn, ndi_txn_step_t &&step)
+{
+    if ((txn == nullptr) || txn->committed) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    try {
+        txn->steps.push_back(std::move(step));
+    } catch (std::exception &ex) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    return txn->steps.size() - 1;
+}
+
+extern "C" {
+
+ndi_txn_t *ndi_txn_create(void)
+{
+    return new (std::nothrow) ndi_txn_s;
+}
+
+void ndi_txn_destroy(ndi_txn_t *txn)
+{
+    delete txn;
+}
+
+t_std_error ndi_txn_set_bulk_fn(ndi_txn_t *txn, ndi_txn_sai_create_fn create_fn,
+                                sai_bulk_object_create_fn bulk_create_fn,
+                                sai_bulk_object_remove_fn bulk_remove_fn)
+{
+    if ((txn == nullptr) || (create_fn == nullptr)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    for (auto &fn: txn->bulk_fns) {
+        if (fn.create_fn == create_fn) {
+            fn.bulk_create_fn = bulk_create_fn;
+            fn.bulk_remove_fn = bulk_remove_fn;
+            return STD_ERR_OK;
+        }
+    }
+    try {
+        txn->bulk_fns.push_back({create_fn, bulk_create_fn, bulk_remove_fn});
+    } catch (std::exception &ex) {
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+    return STD_ERR_OK;
+}
+
+ndi_txn_step_id_t ndi_txn_add_step(ndi_txn_t *txn, ndi_txn_do_fn do_fn,
+                                   ndi_txn_undo_fn undo_fn, void *ctx)
+{
+    if (do_fn == nullptr) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    ndi_txn_step_t step(NDI_TXN_STEP_GENERIC);
+    step.do_fn = do_fn;
+    step.undo_fn = undo_fn;
+    step.ctx = ctx;
+    return ndi_txn_step_add(txn, std::move(step));
+}
+
+ndi_txn_step_id_t ndi_txn_add_sai_create(ndi_txn_t *txn,
+                                         ndi_txn_sai_create_fn create_fn,
+                                         ndi_txn_sai_remove_fn remove_fn,
+                                         uint32_t attr_count,
+                                         const sai_attribute_t *attr_list,
+                                         sai_object_id_t *object_id)
+{
+    if ((create_fn == nullptr) || (remove_fn == nullptr) ||
+        ((attr_list == nullptr) && (attr_count != 0))) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    ndi_txn_step_t step(NDI_TXN_STEP_SAI_CREATE);
+    step.create_fn = create_fn;
+    step.remove_fn = remove_fn;
+    step.oid_out = object_id;
+    try {
+        step.attr_list.assign(attr_list, attr_list + attr_count);
+    } catch (std::exception &ex) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    return ndi_txn_step_add(txn, std::move(step));
+}
+
+t_std_error ndi_txn_bind_oid(ndi_txn_t *txn, ndi_txn_step_id_t step,
+                             uint32_t attr_ix, ndi_txn_step_id_t src_step)
+{
+    if ((txn == nullptr) || txn->committed || (step >= txn->steps.size()) ||
+        (src_step >= step)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    auto &dst = txn->steps[step];
+    if ((dst.type != NDI_TXN_STEP_SAI_CREATE) || (attr_ix >= dst.attr_list.size()) ||
+        (txn->steps[src_step].type != NDI_TXN_STEP_SAI_CREATE)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    try {
+        dst.bind_list.push_back({attr_ix, src_step});
+    } catch (std::exception &ex) {
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+    return STD_ERR_OK;
+}
+
+ndi_txn_step_id_t ndi_txn_add_sai_set(ndi_txn_t *txn, ndi_txn_sai_set_fn set_fn,
+                                      sai_object_id_t object_id,
+                                      const sai_attribute_t *attr,
+                                      const sai_attribute_t *old_attr)
+{
+    if ((set_fn == nullptr) || (attr == nullptr)) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    ndi_txn_step_t step(NDI_TXN_STEP_SAI_SET);
+    step.set_fn = set_fn;
+    step.oid = object_id;
+    try {
+        step.attr_list.assign(attr, attr + 1);
+    } catch (std::exception &ex) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    if (old_attr != nullptr) {
+        step.has_old_attr = true;
+        step.old_attr = *old_attr;
+    }
+    return ndi_txn_step_add(txn, std::move(step));
+}
+
+ndi_txn_step_id_t ndi_txn_add_sai_remove(ndi_txn_t *txn, ndi_txn_sai_remove_fn remove_fn,
+                                         sai_object_id_t object_id)
+{
+    if (remove_fn == nullptr) {
+        return NDI_TXN_STEP_INVALID;
+    }
+    ndi_txn_step_t step(NDI_TXN_STEP_SAI_REMOVE);
+    step.remove_fn = remove_fn;
+    step.oid = object_id;
+    return ndi_txn_step_add(txn, std::move(step));
+}
+
+sai_object_id_t ndi_txn_get_oid(const ndi_txn_t *txn, ndi_txn_step_id_t step)
+{
+    if ((txn == nullptr) || (step >= txn->steps.size()) ||
+        (txn->steps[step].type != NDI_TXN_STEP_SAI_CREATE)) {
+        return SAI_NULL_OBJECT_ID;
+    }
+    return txn->steps[step].oid;
+}
+
+t_std_error ndi_txn_commit(ndi_txn_t *txn)
+{
+    if ((txn == nullptr) || txn->committed) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    txn->committed = true;
+
+    t_std_error rc = STD_ERR_OK;
+    size_t ix = 0;
+    while (ix < txn->steps.size()) {
+        auto &step = txn->steps[ix];
+        if (step.type != NDI_TXN_STEP_SAI_CREATE) {
+            if ((rc = ndi_txn_step_do(step)) != STD_ERR_OK) break;
+            ++ix;
+            continue;
+        }
+
+        size_t end = ndi_txn_create_run_end(txn, ix);
+        for (size_t rix = ix; rix < end; ++rix) {
+            if (!ndi_txn_resolve_binds(txn, txn->steps[rix])) {
+                rc = STD_ERR(NPU, PARAM, 0);
+                break;
+            }
+        }
+        if (rc != STD_ERR_OK) break;
+
+        bool handled = false;
+        auto bulk_fn = txn->bulk_fn_get(step.create_fn);
+        if ((end - ix > 1) && (bulk_fn != nullptr) && (bulk_fn->bulk_create_fn != nullptr)) {
+            rc = ndi_txn_sai_create_bulk(txn, ix, end, bulk_fn->bulk_create_fn, &handled);
+            if (rc != STD_ERR_OK) break;
+        }
+        for (; !handled && (ix < end); ++ix) {
+            if ((rc = ndi_txn_sai_create_one(txn->steps[ix])) != STD_ERR_OK) break;
+        }
+        if (rc != STD_ERR_OK) break;
+        ix = end;
+    }
+
+    if (rc != STD_ERR_OK) {
+        NDI_LOG_ERROR("NDI-TXN", "Transaction failed at step %lu of %lu, rolling back",
+                      ix, txn->steps.size());
+        ndi_txn_rollback(txn);
+        return rc;
+    }
+
+    for (auto &step: txn->steps) {
+        if ((step.type == NDI_TXN_STEP_SAI_CREATE) && (step.oid_out != nullptr)) {
+            *step.oid_out = step.oid;
+        }
+    }
+    return STD_ERR_OK;
+}
+
+}
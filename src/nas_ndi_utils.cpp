@@ -37,6 +37,7 @@
 #include "saitunnel.h"
 
 #include <map>
+#include <new>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -297,6 +298,102 @@ bool ndi_to_sai_bridge_1d_stats(ndi_stat_id_t ndi_id, sai_bridge_stat_t *sai_id)
     return true;
 }
 
+/* Tunnel bridge ports count the tunnel counters of the bridge */
+static bool ndi_to_sai_tunnel_bridge_port_stats(ndi_stat_id_t ndi_id, sai_bridge_port_stat_t *sai_id){
+    sai_tunnel_stat_t tunnel_id;
+    if (!ndi_to_sai_tunnel_stats(ndi_id, &tunnel_id) || (sai_id == NULL)) {
+        return false;
+    }
+
+    switch (tunnel_id) {
+    case SAI_TUNNEL_STAT_IN_OCTETS:
+        *sai_id = SAI_BRIDGE_PORT_STAT_IN_OCTETS;
+        break;
+    case SAI_TUNNEL_STAT_IN_PACKETS:
+        *sai_id = SAI_BRIDGE_PORT_STAT_IN_PACKETS;
+        break;
+    case SAI_TUNNEL_STAT_OUT_OCTETS:
+        *sai_id = SAI_BRIDGE_PORT_STAT_OUT_OCTETS;
+        break;
+    case SAI_TUNNEL_STAT_OUT_PACKETS:
+        *sai_id = SAI_BRIDGE_PORT_STAT_OUT_PACKETS;
+        break;
+    default:
+        NDI_LOG_ERROR("NAS-NDI-UTILS","No bridge port stat for tunnel stat id %d", ndi_id);
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+static bool ndi_stat_ids_translate(const ndi_stat_id_t *ndi_stat_ids, size_t len,
+                                   bool (*fn)(ndi_stat_id_t, T *), std::vector<T> &sai_ids)
+{
+    sai_ids.resize(len);
+    for (size_t ix = 0; ix < len; ++ix) {
+        if (!fn(ndi_stat_ids[ix], &sai_ids[ix])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ndi_stat_handle_t *ndi_stat_handle_create(ndi_stat_obj_type_t obj_type,
+                                          const ndi_stat_id_t *ndi_stat_ids, size_t len)
+{
+    if ((ndi_stat_ids == NULL) || (len == 0)) {
+        return NULL;
+    }
+
+    ndi_stat_handle_t *handle = new (std::nothrow) ndi_stat_handle_t;
+    if (handle == NULL) {
+        return NULL;
+    }
+    handle->obj_type = obj_type;
+    handle->len = len;
+
+    bool ok = false;
+    switch (obj_type) {
+    case NDI_STAT_OBJ_VLAN:
+        ok = ndi_stat_ids_translate(ndi_stat_ids, len, ndi_to_sai_vlan_stats, handle->vlan_ids);
+        break;
+    case NDI_STAT_OBJ_BRIDGE_1D:
+        ok = ndi_stat_ids_translate(ndi_stat_ids, len, ndi_to_sai_bridge_1d_stats,
+                                    handle->bridge_ids);
+        break;
+    case NDI_STAT_OBJ_BRIDGE_PORT:
+        ok = ndi_stat_ids_translate(ndi_stat_ids, len, ndi_to_sai_bridge_port_stats,
+                                    handle->brport_ids);
+        break;
+    case NDI_STAT_OBJ_TUNNEL:
+        ok = ndi_stat_ids_translate(ndi_stat_ids, len, ndi_to_sai_tunnel_stats,
+                                    handle->tunnel_ids);
+        break;
+    case NDI_STAT_OBJ_TUNNEL_BRIDGE_PORT:
+        ok = ndi_stat_ids_translate(ndi_stat_ids, len, ndi_to_sai_tunnel_bridge_port_stats,
+                                    handle->brport_ids);
+        break;
+    default:
+        break;
+    }
+
+    if (!ok) {
+        delete handle;
+        return NULL;
+    }
+    return handle;
+}
+
+void ndi_stat_handle_destroy(ndi_stat_handle_t *handle)
+{
+    delete handle;
+}
+
+size_t ndi_stat_handle_len(const ndi_stat_handle_t *handle)
+{
+    return (handle != NULL) ? handle->len : 0;
+}
+
 bool ndi_to_sai_tunnel_stats(ndi_stat_id_t ndi_id, sai_tunnel_stat_t *sai_id){
     static const auto ndi_to_sai_tunnel_stat_ids = new std::map<ndi_stat_id_t, sai_tunnel_stat_t>
     {
@@ -26,15 +26,21 @@
 #include "sai.h"
 #include "saivlan.h"
 #include "nas_vlan_consts.h"
-#include "nas_ndi_map.h"
+#include "nas_ndi_vlan_mbr_cache.h"
 #include "nas_ndi_obj_cache.h"
 #include "nas_ndi_bridge_port.h"
 #include "nas_ndi_mac_utl.h"
+#include "std_mutex_lock.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 static hal_vlan_id_t default_vlan_id = 1;
@@ -42,6 +48,21 @@ static hal_vlan_id_t default_vlan_id = 1;
 static std::unordered_map <hal_vlan_id_t, sai_object_id_t> g_ndi_vlan_map;
 static std_rw_lock_t ndi_vlan_map_rwlock;
 
+/* Default VLAN bridge port to VLAN member index, filled in a single pass over
+ * the default VLAN member list instead of scanning it for every bridge port */
+static std::unordered_map <sai_object_id_t, sai_object_id_t> g_default_vlan_mbr_map;
+static bool g_default_vlan_mbr_map_valid = false;
+static std_mutex_lock_create_static_init_fast(g_default_vlan_mbr_lock);
+
+static void ndi_vlan_default_mbr_map_invalidate(hal_vlan_id_t vlan_id)
+{
+    if (vlan_id != default_vlan_id) {
+        return;
+    }
+    std_mutex_simple_lock_guard lock(&g_default_vlan_mbr_lock);
+    g_default_vlan_mbr_map_valid = false;
+}
+
 extern "C" {
 
 
@@ -92,6 +113,33 @@ static t_std_error ndi_del_sai_vlan_obj_id(npu_id_t npu_id,
     return STD_ERR_OK;
 }
 
+t_std_error ndi_vlan_restore_sai_vlan_obj_id(npu_id_t npu_id,
+        hal_vlan_id_t vlan_id,
+        sai_object_id_t vlan_obj_id)
+{
+    t_std_error rc = ndi_add_sai_vlan_obj_id(npu_id, vlan_id, vlan_obj_id);
+    if (rc != STD_ERR_OK) {
+        NDI_VLAN_LOG_ERROR("VLAN restore failed for VLAN-id:%d", vlan_id);
+        return rc;
+    }
+    ndi_virtual_obj_t v_obj = {vlan_obj_id, vlan_id};
+    if (!nas_ndi_add_virtual_obj(&v_obj)) {
+        NDI_VLAN_LOG_ERROR("Failed to restore virtual obj cache mapping");
+        ndi_del_sai_vlan_obj_id(npu_id, vlan_id);
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_vlan_discard_sai_vlan_obj_id(npu_id_t npu_id,
+        hal_vlan_id_t vlan_id,
+        sai_object_id_t vlan_obj_id)
+{
+    ndi_virtual_obj_t v_obj = {vlan_obj_id, vlan_id};
+    nas_ndi_remove_virtual_obj(&v_obj);
+    return ndi_del_sai_vlan_obj_id(npu_id, vlan_id);
+}
+
 
 t_std_error ndi_get_vlan_member_info_from_cache(npu_id_t npu_id,
         hal_vlan_id_t vlan_id,
@@ -99,244 +147,398 @@ t_std_error ndi_get_vlan_member_info_from_cache(npu_id_t npu_id,
         sai_object_id_t *vlan_member_id,
         sai_vlan_tagging_mode_t *tagging_mode)
 {
-    nas_ndi_map_key_t map_key;
-    nas_ndi_map_data_t map_data;
-    nas_ndi_map_val_t map_val;
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
-
-    map_key.type = NAS_NDI_MAP_TYPE_VLAN_MEMBER_ID;
-    map_key.id1 = (((sai_object_id_t)npu_id << 32) |
-            ((sai_object_id_t)vlan_id));
-    map_key.id2 = port_id;
+    return ndi_vlan_mbr_cache_get(npu_id, vlan_id, port_id, vlan_member_id, tagging_mode);
+}
 
-    map_data.val1 = SAI_NULL_OBJECT_ID;
-    map_data.val2 = SAI_NULL_OBJECT_ID;
+t_std_error ndi_add_vlan_member_to_cache(npu_id_t npu_id,
+        hal_vlan_id_t vlan_id,
+        sai_object_id_t port_id,
+        sai_object_id_t vlan_member_id,
+        sai_vlan_tagging_mode_t tagging_mode)
+{
+    ndi_vlan_mbr_info_t mbr = {vlan_id, port_id, vlan_member_id, tagging_mode};
+    return ndi_vlan_mbr_cache_set(npu_id, &mbr, 1);
+}
 
-    map_val.count = 1;
-    map_val.data = &map_data;
+t_std_error ndi_del_vlan_member_from_cache(npu_id_t npu_id,
+        hal_vlan_id_t vlan_id,
+        sai_object_id_t port_id)
+{
+    ndi_vlan_mbr_info_t mbr = {vlan_id, port_id, SAI_NULL_OBJECT_ID,
+                               SAI_VLAN_TAGGING_MODE_UNTAGGED};
+    return ndi_vlan_mbr_cache_del(npu_id, &mbr, 1);
+}
 
-    if((rc = nas_ndi_map_get(&map_key,&map_val)) == STD_ERR_OK) {
-        if(vlan_member_id) {
-            *vlan_member_id = map_data.val1;
-        }
+static inline  sai_vlan_api_t *ndi_sai_vlan_api(nas_ndi_db_t *ndi_db_ptr)
+{
+     return(ndi_db_ptr->ndi_sai_api_tbl.n_sai_vlan_api_tbl);
+}
 
-        if(tagging_mode) {
-            *tagging_mode = (sai_vlan_tagging_mode_t)map_data.val2;
+/* VLAN membership change for one port or LAG */
+typedef struct {
+    hal_vlan_id_t vlan_id;
+    sai_object_id_t port_id;
+    bool tagged;
+} ndi_vlan_mbr_req_t;
+
+/* Create VLAN members in one bulk call, falls back to one call per member
+ * if bulk create is not supported by SAI */
+static void ndi_vlan_bulk_create_members(nas_ndi_db_t *ndi_db_ptr, uint32_t count,
+        const uint32_t *attr_count, const sai_attribute_t **attr_list,
+        sai_object_id_t *member_list, sai_status_t *status_list)
+{
+    if ((count > 1) && (ndi_sai_vlan_api(ndi_db_ptr)->create_vlan_members != NULL)) {
+        sai_status_t sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->create_vlan_members(
+                0, count, attr_count, attr_list,
+                SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, member_list, status_list);
+        if ((sai_ret != SAI_STATUS_NOT_IMPLEMENTED) && (sai_ret != SAI_STATUS_NOT_SUPPORTED)) {
+            return;
         }
     }
 
-    return rc;
+    for (uint32_t ix = 0; ix < count; ++ix) {
+        status_list[ix] = ndi_sai_vlan_api(ndi_db_ptr)->create_vlan_member(
+                &member_list[ix], 0, attr_count[ix], attr_list[ix]);
+    }
 }
 
-t_std_error ndi_add_vlan_member_to_cache(npu_id_t npu_id,
-        hal_vlan_id_t vlan_id,
-        sai_object_id_t port_id,
-        sai_object_id_t vlan_member_id,
-        sai_vlan_tagging_mode_t tagging_mode)
+/* Remove VLAN members in one bulk call, falls back to one call per member
+ * if bulk remove is not supported by SAI */
+static void ndi_vlan_bulk_remove_members(nas_ndi_db_t *ndi_db_ptr, uint32_t count,
+        const sai_object_id_t *member_list, sai_status_t *status_list)
 {
-    nas_ndi_map_key_t map_key;
-    nas_ndi_map_data_t map_data;
-    nas_ndi_map_val_t map_val;
-    sai_object_id_t tmp_vlan_member_id = SAI_NULL_OBJECT_ID;
-    sai_vlan_tagging_mode_t tmp_tagging_mode;
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
+    if ((count > 1) && (ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_members != NULL)) {
+        sai_status_t sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_members(
+                count, member_list, SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, status_list);
+        if ((sai_ret != SAI_STATUS_NOT_IMPLEMENTED) && (sai_ret != SAI_STATUS_NOT_SUPPORTED)) {
+            return;
+        }
+    }
 
-    if(ndi_get_vlan_member_info_from_cache(npu_id,vlan_id,port_id,&tmp_vlan_member_id,
-                &tmp_tagging_mode) != STD_ERR_OK) {
-        map_key.type = NAS_NDI_MAP_TYPE_VLAN_MEMBER_ID;
-        map_key.id1 = (((sai_object_id_t)npu_id << 32) |
-                ((sai_object_id_t)vlan_id));
-        map_key.id2 = port_id;
+    for (uint32_t ix = 0; ix < count; ++ix) {
+        status_list[ix] = ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_member(member_list[ix]);
+    }
+}
 
-        map_data.val1 = vlan_member_id;
-        map_data.val2 = tagging_mode;
+/*
+ * Remove VLAN members for a list of requests. Members are removed in one SAI
+ * bulk call and removed from the cache with one map lock. A member requested
+ * more than once is removed once.
+ */
+static t_std_error ndi_vlan_del_members(npu_id_t npu_id,
+        const std::vector<ndi_vlan_mbr_req_t> &reqs)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    t_std_error rc = STD_ERR_OK;
 
-        map_val.count = 1;
-        map_val.data = &map_data;
+    STD_ASSERT(ndi_db_ptr != NULL);
 
-        rc = nas_ndi_map_insert(&map_key,&map_val);
-        if(STD_ERR_OK != rc) {
-            return rc;
+    std::unordered_set<sai_object_id_t> member_set;
+    std::vector<size_t> req_ix;
+    std::vector<sai_object_id_t> member_list;
+    req_ix.reserve(reqs.size());
+    member_list.reserve(reqs.size());
+
+    for (size_t ix = 0; ix < reqs.size(); ++ix) {
+        sai_object_id_t vlan_member_id = SAI_NULL_OBJECT_ID;
+        ndi_get_vlan_member_info_from_cache(npu_id,reqs[ix].vlan_id,reqs[ix].port_id,
+                &vlan_member_id,NULL);
+        if (vlan_member_id == SAI_NULL_OBJECT_ID) {
+            NDI_VLAN_LOG_ERROR("VLAN member cache search failed for VLAN-id:%d"
+                    " SAI-port:%lu",
+                    reqs[ix].vlan_id, reqs[ix].port_id);
+            continue;
         }
-    } else {
-        if(tmp_tagging_mode != tagging_mode) {
-            map_key.type = NAS_NDI_MAP_TYPE_VLAN_MEMBER_ID;
-            map_key.id1 = (((sai_object_id_t)npu_id << 32) |
-                    ((sai_object_id_t)vlan_id));
-            map_key.id2 = port_id;
-
-            rc = nas_ndi_map_delete(&map_key);
-            if(STD_ERR_OK != rc) {
-                return rc;
-            }
+        if (!member_set.insert(vlan_member_id).second) {
+            continue;
+        }
+        req_ix.push_back(ix);
+        member_list.push_back(vlan_member_id);
+    }
 
-            map_data.val1 = vlan_member_id;
-            map_data.val2 = tagging_mode;
+    if (member_list.empty()) {
+        return STD_ERR_OK;
+    }
 
-            map_val.count = 1;
-            map_val.data = &map_data;
+    std::vector<sai_status_t> status_list(member_list.size(), SAI_STATUS_FAILURE);
+    ndi_vlan_bulk_remove_members(ndi_db_ptr, member_list.size(), member_list.data(),
+            status_list.data());
 
-            rc = nas_ndi_map_insert(&map_key,&map_val);
-            if(STD_ERR_OK != rc) {
-                return rc;
+    std::vector<ndi_vlan_mbr_info_t> cache_list;
+    cache_list.reserve(member_list.size());
+    for (size_t ix = 0; ix < member_list.size(); ++ix) {
+        const ndi_vlan_mbr_req_t &req = reqs[req_ix[ix]];
+        if (status_list[ix] != SAI_STATUS_SUCCESS) {
+            NDI_VLAN_LOG_ERROR("VLAN member del failed in SAI VLAN-id:%d"
+                    " SAI-port:%lu SAI-status:%d",
+                    req.vlan_id, req.port_id, status_list[ix]);
+            if (rc == STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, status_list[ix]);
             }
-        } else {
-            rc = STD_ERR_OK;
+            continue;
         }
+        ndi_vlan_default_mbr_map_invalidate(req.vlan_id);
+        cache_list.push_back({req.vlan_id, req.port_id, member_list[ix],
+                              SAI_VLAN_TAGGING_MODE_UNTAGGED});
     }
 
+    ndi_vlan_mbr_cache_del(npu_id, cache_list.data(), cache_list.size());
     return rc;
 }
 
-t_std_error ndi_del_vlan_member_from_cache(npu_id_t npu_id,
-        hal_vlan_id_t vlan_id,
-        sai_object_id_t port_id)
+/* Change tagging mode of an existing VLAN member */
+static t_std_error ndi_vlan_member_tagging_mode_set(npu_id_t npu_id,
+        const ndi_vlan_mbr_req_t &req, sai_object_id_t vlan_member_id,
+        sai_vlan_tagging_mode_t tagging_mode)
 {
-    nas_ndi_map_key_t map_key;
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    sai_status_t sai_ret = SAI_STATUS_FAILURE;
+    sai_attribute_t vlan_mem_attr;
     t_std_error rc = STD_ERR(NPU, FAIL, 0);
-    map_key.type = NAS_NDI_MAP_TYPE_VLAN_MEMBER_ID;
-    map_key.id1 = (((sai_object_id_t)npu_id << 32) |
-            ((sai_object_id_t)vlan_id));
-    map_key.id2 = port_id;
 
-    rc = nas_ndi_map_delete(&map_key);
-    if(STD_ERR_OK != rc) {
-        return rc;
+    vlan_mem_attr.id = SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
+    vlan_mem_attr.value.s32 = tagging_mode;
+
+    if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->set_vlan_member_attribute(
+                    vlan_member_id, &vlan_mem_attr)) != SAI_STATUS_SUCCESS) {
+        NDI_VLAN_LOG_ERROR("VLAN member tagging mode change failed in"
+                " SAI VLAN-id:%d SAI-port:%lu SAI-status:%d",
+                req.vlan_id, req.port_id, sai_ret);
+        return STD_ERR(NPU, FAIL, sai_ret);
     }
 
-    return rc;
+    if((rc = ndi_add_vlan_member_to_cache(npu_id,req.vlan_id,req.port_id,
+                vlan_member_id,tagging_mode)) != STD_ERR_OK) {
+        NDI_VLAN_LOG_ERROR("VLAN member cache modify failed for"
+                " VLAN-id:%d SAI-port:%lu",
+                req.vlan_id, req.port_id);
+        return rc;
+    }
+    return STD_ERR_OK;
 }
 
-static inline  sai_vlan_api_t *ndi_sai_vlan_api(nas_ndi_db_t *ndi_db_ptr)
+/*
+ * Add VLAN members for a list of requests. Bridge ports are resolved once per
+ * port, new members are created in one SAI bulk call and added to the cache
+ * with one map lock. Members already added with a different tagging mode are
+ * updated one by one. A port requested more than once for a VLAN is created
+ * once with the tagging mode of the last request, same as one call per request.
+ */
+static t_std_error ndi_vlan_add_members(npu_id_t npu_id,
+        const std::vector<ndi_vlan_mbr_req_t> &reqs)
 {
-     return(ndi_db_ptr->ndi_sai_api_tbl.n_sai_vlan_api_tbl);
-}
+    static const uint32_t vlan_mem_attr_count = 3;
+    typedef struct {
+        sai_attribute_t attr[vlan_mem_attr_count];
+    } ndi_vlan_mbr_attr_t;
 
-static t_std_error ndi_del_port_from_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
-        sai_object_id_t port_id)
-{
-    sai_status_t sai_ret = SAI_STATUS_FAILURE;
-    sai_object_id_t vlan_member_id = SAI_NULL_OBJECT_ID;
     nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
+    t_std_error rc = STD_ERR_OK;
 
     STD_ASSERT(ndi_db_ptr != NULL);
 
-    rc = ndi_get_vlan_member_info_from_cache(npu_id,vlan_id,port_id,&vlan_member_id,
-            NULL);
-    if(vlan_member_id != SAI_NULL_OBJECT_ID) {
-        if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_member(
-                        vlan_member_id))
-                != SAI_STATUS_SUCCESS) {
-            NDI_VLAN_LOG_ERROR("VLAN member del failed in SAI VLAN-id:%d"
-                    " SAI-port:%lu SAI-status:%d",
-                    vlan_id, port_id,sai_ret);
-            return STD_ERR(NPU, FAIL, sai_ret);
+    std::unordered_map<sai_object_id_t, sai_object_id_t> brport_map;
+    std::map<std::pair<hal_vlan_id_t, sai_object_id_t>, size_t> new_mbr_map;
+    std::vector<size_t> req_ix;
+    std::vector<ndi_vlan_mbr_attr_t> attr_list;
+    req_ix.reserve(reqs.size());
+    attr_list.reserve(reqs.size());
+
+    for (size_t ix = 0; ix < reqs.size(); ++ix) {
+        const ndi_vlan_mbr_req_t &req = reqs[ix];
+        sai_object_id_t vlan_member_id = SAI_NULL_OBJECT_ID;
+        sai_vlan_tagging_mode_t cur_tagging_mode;
+        sai_vlan_tagging_mode_t tagging_mode =
+            req.tagged?SAI_VLAN_TAGGING_MODE_TAGGED:SAI_VLAN_TAGGING_MODE_UNTAGGED;
+
+        /* Port already in the list of members to create */
+        auto mbr_it = new_mbr_map.find(std::make_pair(req.vlan_id, req.port_id));
+        if (mbr_it != new_mbr_map.end()) {
+            attr_list[mbr_it->second].attr[2].value.s32 = tagging_mode;
+            continue;
         }
 
-        if((rc = ndi_del_vlan_member_from_cache(npu_id,vlan_id,port_id)) !=
-                STD_ERR_OK) {
-            NDI_VLAN_LOG_ERROR("VLAN member cache del failed for VLAN-id:%d"
-                    " SAI-port:%lu",
-                    vlan_id, port_id);
-            return rc;
+        ndi_get_vlan_member_info_from_cache(npu_id,req.vlan_id,req.port_id,&vlan_member_id,
+                &cur_tagging_mode);
+        /* Return OK if port is already added and in same tagging mode */
+        if (vlan_member_id != SAI_NULL_OBJECT_ID) {
+            if (cur_tagging_mode == tagging_mode) {
+                NDI_VLAN_LOG_ERROR("VLAN member SAI-port:%lu already added to VLAN-id:%d",
+                        req.port_id,req.vlan_id);
+                continue;
+            }
+            if ((rc = ndi_vlan_member_tagging_mode_set(npu_id, req, vlan_member_id,
+                            tagging_mode)) != STD_ERR_OK) {
+                return rc;
+            }
+            continue;
         }
-    } else {
-        NDI_VLAN_LOG_ERROR("VLAN member cache search failed for VLAN-id:%d"
-                " SAI-port:%lu",
-                vlan_id, port_id);
-    }
-
-    return STD_ERR_OK;
-}
 
-static t_std_error ndi_add_port_to_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
-        sai_object_id_t port_id, bool istagged)
-{
-    sai_status_t sai_ret = SAI_STATUS_FAILURE;
-    sai_attribute_t vlan_mem_attr[SAI_VLAN_MEMBER_ATTR_END];
-    uint32_t attr_count=0;
-    sai_object_id_t vlan_member_id = SAI_NULL_OBJECT_ID;
-    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
-    sai_vlan_tagging_mode_t tagging_mode =
-        istagged?SAI_VLAN_TAGGING_MODE_TAGGED:SAI_VLAN_TAGGING_MODE_UNTAGGED;
-    sai_vlan_tagging_mode_t cur_tagging_mode;
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
+        /* Get bridge port id for sai port id */
+        sai_object_id_t brport_id;
+        auto it = brport_map.find(req.port_id);
+        if (it != brport_map.end()) {
+            brport_id = it->second;
+        } else {
+            if (!ndi_get_1q_bridge_port(&brport_id, req.port_id)) {
+                NDI_VLAN_LOG_ERROR("VLAN member : get bridge port failed for port %lu \n",
+                        req.port_id);
+                return STD_ERR(NPU, CFG, 0);
+            }
+            brport_map[req.port_id] = brport_id;
+        }
 
-    STD_ASSERT(ndi_db_ptr != NULL);
+        ndi_vlan_mbr_attr_t vlan_mem_attr;
+        vlan_mem_attr.attr[0].id = SAI_VLAN_MEMBER_ATTR_VLAN_ID;
+        vlan_mem_attr.attr[0].value.oid = ndi_get_sai_vlan_obj_id(npu_id,req.vlan_id);
+        vlan_mem_attr.attr[1].id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
+        vlan_mem_attr.attr[1].value.oid = brport_id;
+        vlan_mem_attr.attr[2].id = SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
+        vlan_mem_attr.attr[2].value.s32 = tagging_mode;
+
+        new_mbr_map[std::make_pair(req.vlan_id, req.port_id)] = attr_list.size();
+        req_ix.push_back(ix);
+        attr_list.push_back(vlan_mem_attr);
+    }
 
-    ndi_get_vlan_member_info_from_cache(npu_id,vlan_id,port_id,&vlan_member_id,
-            &cur_tagging_mode);
-    /* Return OK if port is already added and in same tagging mode */
-    if(SAI_NULL_OBJECT_ID == vlan_member_id) {
-        vlan_mem_attr[attr_count].id = SAI_VLAN_MEMBER_ATTR_VLAN_ID;
-        vlan_mem_attr[attr_count].value.oid =
-            ndi_get_sai_vlan_obj_id(npu_id,vlan_id);
-        attr_count++;
+    if (attr_list.empty()) {
+        return STD_ERR_OK;
+    }
 
-        /* Get bridge port id for sai port id */
-        sai_object_id_t  brport_id;
+    size_t count = attr_list.size();
+    std::vector<uint32_t> attr_count(count, vlan_mem_attr_count);
+    std::vector<const sai_attribute_t *> attr_ptr(count);
+    std::vector<sai_object_id_t> member_list(count, SAI_NULL_OBJECT_ID);
+    std::vector<sai_status_t> status_list(count, SAI_STATUS_FAILURE);
+    for (size_t ix = 0; ix < count; ++ix) {
+        attr_ptr[ix] = attr_list[ix].attr;
+    }
 
-        if (!ndi_get_1q_bridge_port(&brport_id, port_id)) {
-            NDI_VLAN_LOG_ERROR("VLAN member : get bridge port failed for port %lu \n", port_id);
-            return STD_ERR(NPU, CFG, 0);
-        }
-        vlan_mem_attr[attr_count].id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
-        vlan_mem_attr[attr_count].value.oid = brport_id;
-        attr_count++;
+    ndi_vlan_bulk_create_members(ndi_db_ptr, count, attr_count.data(), attr_ptr.data(),
+            member_list.data(), status_list.data());
 
-        vlan_mem_attr[attr_count].id =
-            SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
-        vlan_mem_attr[attr_count].value.s32 = tagging_mode;
-        attr_count++;
+    std::vector<ndi_vlan_mbr_info_t> cache_list;
+    cache_list.reserve(count);
 
-        if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->create_vlan_member(
-                        &vlan_member_id, 0, attr_count, vlan_mem_attr)) !=
-                SAI_STATUS_SUCCESS) {
+    for (size_t ix = 0; ix < count; ++ix) {
+        const ndi_vlan_mbr_req_t &req = reqs[req_ix[ix]];
+        if (status_list[ix] != SAI_STATUS_SUCCESS) {
             NDI_VLAN_LOG_ERROR("VLAN member add failed in SAI VLAN-id:%d"
                     " SAI-port:%lu SAI-status:%d",
-                    vlan_id, port_id,sai_ret);
-            return STD_ERR(NPU, FAIL, sai_ret);
+                    req.vlan_id, req.port_id, status_list[ix]);
+            if (rc == STD_ERR_OK) {
+                rc = STD_ERR(NPU, FAIL, status_list[ix]);
+            }
+            continue;
         }
+        ndi_vlan_default_mbr_map_invalidate(req.vlan_id);
+        cache_list.push_back({req.vlan_id, req.port_id, member_list[ix],
+                (sai_vlan_tagging_mode_t)attr_list[ix].attr[2].value.s32});
+    }
 
-        if((rc = ndi_add_vlan_member_to_cache(npu_id,vlan_id,port_id,
-                    vlan_member_id,tagging_mode)) != STD_ERR_OK) {
-            NDI_VLAN_LOG_ERROR("VLAN member cache add failed for VLAN-id:%d"
-                    " SAI-port:%lu",
-                    vlan_id, port_id);
-            ndi_del_port_from_vlan(npu_id,vlan_id,port_id);
-            return rc;
+    t_std_error cache_rc;
+    if ((cache_rc = ndi_vlan_mbr_cache_set(npu_id, cache_list.data(), cache_list.size()))
+            != STD_ERR_OK) {
+        NDI_VLAN_LOG_ERROR("VLAN member cache add failed for %lu members", cache_list.size());
+        /* Remove the members created to keep SAI and cache in sync */
+        std::vector<sai_object_id_t> created;
+        for (auto &mbr: cache_list) {
+            created.push_back(mbr.member_id);
         }
-    } else {
-        if(cur_tagging_mode != tagging_mode) {
-            attr_count = 0;
-            vlan_mem_attr[attr_count].id =
-                SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
-            vlan_mem_attr[attr_count].value.s32 = tagging_mode;
-
-            if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)-> \
-                        set_vlan_member_attribute(
-                            vlan_member_id, &vlan_mem_attr[attr_count])) !=
-                    SAI_STATUS_SUCCESS) {
-                NDI_VLAN_LOG_ERROR("VLAN member tagging mode change failed in"
-                        " SAI VLAN-id:%d SAI-port:%lu SAI-status:%d",
-                        vlan_id, port_id,sai_ret);
-                return STD_ERR(NPU, FAIL, sai_ret);
-            }
+        std::vector<sai_status_t> del_status(created.size(), SAI_STATUS_FAILURE);
+        ndi_vlan_bulk_remove_members(ndi_db_ptr, created.size(), created.data(),
+                del_status.data());
+        return cache_rc;
+    }
+    return rc;
+}
 
-            if((rc = ndi_add_vlan_member_to_cache(npu_id,vlan_id,port_id,
-                        vlan_member_id,tagging_mode)) != STD_ERR_OK) {
-                NDI_VLAN_LOG_ERROR("VLAN member cache modify failed for"
-                        " VLAN-id:%d SAI-port:%lu",
-                        vlan_id, port_id);
-                return rc;
+/* Build membership requests from the tagged and untagged port lists, in the
+ * same interleaved order they were programmed one by one */
+static void ndi_vlan_port_list_reqs(hal_vlan_id_t vlan_id,
+        ndi_port_list_t *p_t_port_list, ndi_port_list_t *p_ut_port_list,
+        std::vector<ndi_vlan_mbr_req_t> &reqs)
+{
+    size_t t_count = p_t_port_list?(p_t_port_list->port_count):0;
+    size_t ut_count = p_ut_port_list?(p_ut_port_list->port_count):0;
+    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
+    ndi_port_t *p_ndi_port = NULL;
+
+    reqs.reserve(t_count + ut_count);
+    for (size_t iter = 0; (iter < t_count) || (iter < ut_count); ++iter) {
+        for (int tagged = 1; tagged >= 0; --tagged) {
+            if (iter >= (tagged ? t_count : ut_count)) {
+                continue;
             }
-        } else {
-            NDI_VLAN_LOG_ERROR("VLAN member SAI-port:%lu already added to VLAN-id:%d",
-                    port_id,vlan_id);
+            p_ndi_port = tagged ? &(p_t_port_list->port_list[iter]) :
+                                  &(p_ut_port_list->port_list[iter]);
+            if (ndi_sai_port_id_get(p_ndi_port->npu_id,
+                            p_ndi_port->npu_port, &port_id) != STD_ERR_OK) {
+                NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
+                        " NPU-port:%d",
+                        p_ndi_port->npu_id, p_ndi_port->npu_port);
+                continue;
+            }
+            reqs.push_back({vlan_id, port_id, (tagged != 0)});
         }
     }
+}
 
+/* Build membership requests for LAG lists */
+static void ndi_vlan_lag_list_reqs(hal_vlan_id_t vlan_id,
+        ndi_obj_id_t *tagged_lag_list, size_t tagged_lag_cnt,
+        ndi_obj_id_t *untagged_lag_list, size_t untag_lag_cnt,
+        std::vector<ndi_vlan_mbr_req_t> &reqs)
+{
+    reqs.reserve(tagged_lag_cnt + untag_lag_cnt);
+    for (size_t iter = 0; (iter < tagged_lag_cnt) || (iter < untag_lag_cnt); ++iter) {
+        if (iter < tagged_lag_cnt) {
+            reqs.push_back({vlan_id, tagged_lag_list[iter], true});
+        }
+        if (iter < untag_lag_cnt) {
+            reqs.push_back({vlan_id, untagged_lag_list[iter], false});
+        }
+    }
+}
+
+static t_std_error ndi_vlan_range_port_id_get(ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max, sai_object_id_t *port_id)
+{
+    t_std_error rc;
+
+    if ((p_ndi_port == NULL) || (vlan_min > vlan_max)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((rc = ndi_sai_port_id_get(p_ndi_port->npu_id,
+                    p_ndi_port->npu_port, port_id)) != STD_ERR_OK) {
+        NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
+                " NPU-port:%d",
+                p_ndi_port->npu_id, p_ndi_port->npu_port);
+        return rc;
+    }
+    return STD_ERR_OK;
+}
+
+/* Build membership requests for one port and the created VLANs of a range */
+static t_std_error ndi_vlan_range_reqs(npu_id_t npu_id, ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max, bool tagged,
+        std::vector<ndi_vlan_mbr_req_t> &reqs)
+{
+    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
+    t_std_error rc;
+
+    if ((rc = ndi_vlan_range_port_id_get(p_ndi_port, vlan_min, vlan_max, &port_id))
+            != STD_ERR_OK) {
+        return rc;
+    }
+
+    reqs.reserve(vlan_max - vlan_min + 1);
+    for (uint32_t vlan_id = vlan_min; vlan_id <= vlan_max; ++vlan_id) {
+        if (ndi_get_sai_vlan_obj_id(npu_id, (hal_vlan_id_t)vlan_id) == SAI_NULL_OBJECT_ID) {
+            continue;
+        }
+        reqs.push_back({(hal_vlan_id_t)vlan_id, port_id, tagged});
+    }
     return STD_ERR_OK;
 }
 
@@ -423,104 +625,54 @@ t_std_error ndi_delete_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id)
 t_std_error ndi_add_ports_to_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,  \
         ndi_port_list_t *p_t_port_list, ndi_port_list_t *p_ut_port_list)
 {
-    int iter = 0;
-    int t_count, ut_count;
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
-    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
-    ndi_port_t *p_ndi_port = NULL;
-
-    t_count = p_t_port_list?(p_t_port_list->port_count):0;
-    ut_count = p_ut_port_list?(p_ut_port_list->port_count):0;
-
-    while((iter < t_count) || (iter < ut_count)) {
-        if(iter < t_count) {
-            p_ndi_port = &(p_t_port_list->port_list[iter]);
-            if ((rc = ndi_sai_port_id_get(p_ndi_port->npu_id,
-                            p_ndi_port->npu_port, &port_id)) != STD_ERR_OK) {
-                NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
-                        " NPU-port:%d",
-                        p_ndi_port->npu_id, p_ndi_port->npu_port);
-            } else {
-                if((rc = ndi_add_port_to_vlan(npu_id,vlan_id,port_id,true)) !=
-                    STD_ERR_OK) {
-                    return rc;
-                }
-            }
-        }
-
-        if(iter < ut_count) {
-            p_ndi_port = &(p_ut_port_list->port_list[iter]);
-            if ((rc = ndi_sai_port_id_get(p_ndi_port->npu_id,
-                            p_ndi_port->npu_port, &port_id)) != STD_ERR_OK) {
-                NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
-                        " NPU-port:%d",
-                        p_ndi_port->npu_id, p_ndi_port->npu_port);
-            } else {
-                if((rc = ndi_add_port_to_vlan(npu_id,vlan_id,port_id,false)) !=
-                    STD_ERR_OK) {
-                    return rc;
-                }
-            }
-        }
-
-        iter++;
-        if((iter >= t_count) && (iter >= ut_count)) {
-            break;
-        }
-    }
-
-    return STD_ERR_OK;
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    ndi_vlan_port_list_reqs(vlan_id, p_t_port_list, p_ut_port_list, reqs);
+    return ndi_vlan_add_members(npu_id, reqs);
 }
 
 t_std_error ndi_del_ports_from_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id, \
         ndi_port_list_t *p_t_port_list, ndi_port_list_t *p_ut_port_list)
 {
-    int iter = 0;
-    int t_count, ut_count;
-    t_std_error rc = STD_ERR(NPU, FAIL, 0);
-    ndi_port_t *p_ndi_port = NULL;
-    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    ndi_vlan_port_list_reqs(vlan_id, p_t_port_list, p_ut_port_list, reqs);
+    return ndi_vlan_del_members(npu_id, reqs);
+}
 
-    t_count = p_t_port_list?(p_t_port_list->port_count):0;
-    ut_count = p_ut_port_list?(p_ut_port_list->port_count):0;
+t_std_error ndi_add_port_to_vlan_range(npu_id_t npu_id, ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max, bool tagged)
+{
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    t_std_error rc;
+    if ((rc = ndi_vlan_range_reqs(npu_id, p_ndi_port, vlan_min, vlan_max, tagged, reqs))
+            != STD_ERR_OK) {
+        return rc;
+    }
+    return ndi_vlan_add_members(npu_id, reqs);
+}
 
-    while((iter < t_count) || (iter < ut_count)) {
-        if(iter < t_count) {
-            p_ndi_port = &(p_t_port_list->port_list[iter]);
-            if ((rc = ndi_sai_port_id_get(p_ndi_port->npu_id,
-                            p_ndi_port->npu_port, &port_id)) != STD_ERR_OK) {
-                NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
-                        " NPU-port:%d",
-                        p_ndi_port->npu_id, p_ndi_port->npu_port);
-            } else {
-                if((rc = ndi_del_port_from_vlan(npu_id,vlan_id,port_id)) !=
-                        STD_ERR_OK) {
-                    return rc;
-                }
-            }
-        }
+t_std_error ndi_del_port_from_vlan_range(npu_id_t npu_id, ndi_port_t *p_ndi_port,
+        hal_vlan_id_t vlan_min, hal_vlan_id_t vlan_max)
+{
+    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
+    t_std_error rc;
+    if ((rc = ndi_vlan_range_port_id_get(p_ndi_port, vlan_min, vlan_max, &port_id))
+            != STD_ERR_OK) {
+        return rc;
+    }
 
-        if(iter < ut_count) {
-            p_ndi_port = &(p_ut_port_list->port_list[iter]);
-            if ((rc = ndi_sai_port_id_get(p_ndi_port->npu_id,
-                            p_ndi_port->npu_port, &port_id)) != STD_ERR_OK) {
-                NDI_VLAN_LOG_ERROR("SAI port id get failed for NPU-id:%d"
-                        " NPU-port:%d",
-                        p_ndi_port->npu_id, p_ndi_port->npu_port);
-            } else {
-                if((rc = ndi_del_port_from_vlan(npu_id,vlan_id,port_id)) !=
-                        STD_ERR_OK) {
-                    return rc;
-                }
-            }
-        }
+    /* Only the VLANs the port is a member of are visited */
+    std::vector<ndi_vlan_mbr_info_t> mbr_list(
+            ndi_vlan_mbr_cache_port_get(npu_id, port_id, NULL, 0));
+    mbr_list.resize(std::min(mbr_list.size(), ndi_vlan_mbr_cache_port_get(npu_id, port_id,
+                    mbr_list.data(), mbr_list.size())));
 
-        iter++;
-        if((iter >= t_count) && (iter >= ut_count)) {
-            break;
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    for (auto &mbr: mbr_list) {
+        if ((mbr.vlan_id >= vlan_min) && (mbr.vlan_id <= vlan_max)) {
+            reqs.push_back({mbr.vlan_id, port_id, false});
         }
     }
-    return STD_ERR_OK;
+    return ndi_vlan_del_members(npu_id, reqs);
 }
 
 t_std_error ndi_vlan_stats_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
@@ -561,6 +713,51 @@ t_std_error ndi_vlan_stats_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
     return STD_ERR_OK;
 }
 
+t_std_error ndi_vlan_stats_bulk_get(npu_id_t npu_id, const hal_vlan_id_t *vlan_list,
+                                    size_t vlan_count, const ndi_stat_handle_t *handle,
+                                    uint64_t *stats_val, t_std_error *rc_list)
+{
+    nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
+    t_std_error rc = STD_ERR_OK;
+
+    if (ndi_db_ptr == NULL) {
+        NDI_VLAN_LOG_ERROR("Invalid NPU Id %d passed",npu_id);
+        return STD_ERR(NPU, PARAM, 0);
+    }
+    if ((handle == NULL) || (handle->obj_type != NDI_STAT_OBJ_VLAN)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    /* No SAI bulk stats call for VLANs, read one VLAN per call with the
+     * SAI counter ids translated once in the handle */
+    for (size_t ix = 0; ix < vlan_count; ++ix) {
+        t_std_error vlan_rc = STD_ERR_OK;
+        uint64_t *vlan_stats = &stats_val[ix * handle->len];
+        sai_object_id_t vlan_obj_id = ndi_get_sai_vlan_obj_id(npu_id, vlan_list[ix]);
+        sai_status_t sai_ret;
+
+        if (vlan_obj_id == SAI_NULL_OBJECT_ID) {
+            vlan_rc = STD_ERR(NPU, FAIL, SAI_STATUS_FAILURE);
+        } else if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_stats(vlan_obj_id,
+                        handle->len, handle->vlan_ids.data(), vlan_stats))
+                != SAI_STATUS_SUCCESS) {
+            NDI_VLAN_LOG_ERROR("Vlan stats Get failed for npu %d, vlan %d, ret %d \n",
+                                npu_id, vlan_list[ix], sai_ret);
+            vlan_rc = STD_ERR(NPU, FAIL, sai_ret);
+        }
+
+        if (vlan_rc != STD_ERR_OK) {
+            memset(vlan_stats, 0, handle->len * sizeof(uint64_t));
+            if (rc == STD_ERR_OK) {
+                rc = vlan_rc;
+            }
+        }
+        if (rc_list != NULL) {
+            rc_list[ix] = vlan_rc;
+        }
+    }
+    return rc;
+}
 
 t_std_error ndi_add_or_del_ports_to_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
                                          ndi_port_list_t *p_tagged_list,
@@ -672,6 +869,94 @@ bool ndi_vlan_get_default_obj_id(npu_id_t npu_id){
     return false;
 }
 
+static t_std_error ndi_vlan_member_list_get(nas_ndi_db_t *ndi_db_ptr, sai_object_id_t sai_vlan_id,
+        std::vector<sai_object_id_t> &member_list)
+{
+    sai_status_t sai_ret;
+    sai_attribute_t sai_attr;
+
+    sai_attr.id = SAI_VLAN_ATTR_MEMBER_LIST;
+    sai_attr.value.objlist.list = NULL;
+    sai_attr.value.objlist.count = 0;
+
+    sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_attribute(
+            sai_vlan_id,1,&sai_attr);
+
+    if((sai_ret != SAI_STATUS_BUFFER_OVERFLOW) &&
+        (sai_ret != SAI_STATUS_SUCCESS)) {
+        NDI_VLAN_LOG_ERROR("Vlan member list count get failed %d"
+                " for default VLAN",sai_ret);
+        return STD_ERR(NPU, FAIL, sai_ret);
+    }
+
+    member_list.resize(sai_attr.value.objlist.count);
+    if (member_list.empty()) {
+        return STD_ERR_OK;
+    }
+
+    sai_attr.value.objlist.list = member_list.data();
+    if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_attribute(
+                    sai_vlan_id,1,&sai_attr)) !=
+            SAI_STATUS_SUCCESS) {
+        NDI_VLAN_LOG_ERROR("Vlan member list get failed %d"
+                " for default VLAN",sai_ret);
+        return STD_ERR(NPU, FAIL, sai_ret);
+    }
+    member_list.resize(sai_attr.value.objlist.count);
+    return STD_ERR_OK;
+}
+
+/* Fill default VLAN member index, caller must hold g_default_vlan_mbr_lock */
+static t_std_error ndi_vlan_default_mbr_map_fill(nas_ndi_db_t *ndi_db_ptr, sai_object_id_t sai_vlan_id)
+{
+    std::vector<sai_object_id_t> member_list;
+    sai_status_t sai_ret;
+    sai_attribute_t sai_attr;
+    t_std_error rc;
+
+    if ((rc = ndi_vlan_member_list_get(ndi_db_ptr, sai_vlan_id, member_list)) != STD_ERR_OK) {
+        return rc;
+    }
+
+    g_default_vlan_mbr_map.clear();
+    sai_attr.id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
+    for (auto member_id: member_list) {
+        if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_member_attribute(
+                        member_id,1,&sai_attr)) !=
+                SAI_STATUS_SUCCESS) {
+            NDI_VLAN_LOG_ERROR("Vlan member port get failed %d"
+                    " for VLAN member ID %lu",sai_ret,member_id);
+            continue;
+        }
+        g_default_vlan_mbr_map[sai_attr.value.oid] = member_id;
+    }
+    g_default_vlan_mbr_map_valid = true;
+    return STD_ERR_OK;
+}
+
+/* Remove VLAN members in one bulk call, falls back to one call per member
+ * if bulk remove is not supported by SAI */
+static t_std_error ndi_vlan_remove_members(nas_ndi_db_t *ndi_db_ptr,
+        const std::vector<sai_object_id_t> &member_list)
+{
+    if (member_list.empty()) {
+        return STD_ERR_OK;
+    }
+
+    std::vector<sai_status_t> status_list(member_list.size(), SAI_STATUS_FAILURE);
+    ndi_vlan_bulk_remove_members(ndi_db_ptr, member_list.size(), member_list.data(),
+            status_list.data());
+    for (size_t ix = 0; ix < member_list.size(); ++ix) {
+        if (status_list[ix] != SAI_STATUS_SUCCESS) {
+            NDI_VLAN_LOG_ERROR("Default VLAN member del failed"
+                    " member:%lu SAI-status:%d",
+                    member_list[ix],status_list[ix]);
+            return STD_ERR(NPU, FAIL, status_list[ix]);
+        }
+    }
+    return STD_ERR_OK;
+}
+
 t_std_error ndi_vlan_delete_default_member_brports(npu_id_t npu_id, sai_object_id_t brport, bool del_all) {
 
     nas_ndi_db_t *ndi_db_ptr = ndi_db_ptr_get(npu_id);
@@ -680,74 +965,57 @@ t_std_error ndi_vlan_delete_default_member_brports(npu_id_t npu_id, sai_object_i
     }
 
     sai_status_t sai_ret;
-    sai_attribute_t sai_attr[2];
     hal_vlan_id_t vlan_id = (hal_vlan_id_t)default_vlan_id;
-    int count = 0;
     sai_object_id_t sai_vlan_id = SAI_NULL_OBJECT_ID;
+    t_std_error rc;
 
     if((sai_vlan_id = ndi_get_sai_vlan_obj_id(npu_id,vlan_id)) == SAI_NULL_OBJECT_ID) {
         NDI_VLAN_LOG_ERROR("Default VLAN SAI obj id is SAI_NULL_OBJECT_ID");
         return STD_ERR(NPU,FAIL,0);
     }
 
-    sai_attr[0].id = SAI_VLAN_ATTR_MEMBER_LIST;
-    sai_attr[0].value.objlist.list = NULL;
-    sai_attr[0].value.objlist.count = 0;
+    std_mutex_simple_lock_guard lock(&g_default_vlan_mbr_lock);
 
-    sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_attribute(
-            sai_vlan_id,1,&sai_attr[0]);
-
-    if((sai_ret != SAI_STATUS_BUFFER_OVERFLOW) &&
-        (sai_ret != SAI_STATUS_SUCCESS)) {
-        NDI_VLAN_LOG_ERROR("Vlan member list count get failed %d"
-                " for default VLAN",sai_ret);
-        return STD_ERR(NPU, FAIL, sai_ret);
+    if (del_all) {
+        std::vector<sai_object_id_t> member_list;
+        g_default_vlan_mbr_map.clear();
+        g_default_vlan_mbr_map_valid = false;
+        if ((rc = ndi_vlan_member_list_get(ndi_db_ptr, sai_vlan_id, member_list)) != STD_ERR_OK) {
+            return rc;
+        }
+        return ndi_vlan_remove_members(ndi_db_ptr, member_list);
     }
 
-    count = sai_attr[0].value.objlist.count;
-
-    if(count > 0)
-    {
-        sai_object_id_t member_list[count];
-        int iter=0;
-
-        sai_attr[0].value.objlist.list = member_list;
-
-        if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_attribute(
-                        sai_vlan_id,1,&sai_attr[0])) !=
-                SAI_STATUS_SUCCESS) {
-            NDI_VLAN_LOG_ERROR("Vlan member list get failed %d"
-                    " for default VLAN",sai_ret);
-            return STD_ERR(NPU, FAIL, sai_ret);
+    bool map_filled = false;
+    if (!g_default_vlan_mbr_map_valid) {
+        if ((rc = ndi_vlan_default_mbr_map_fill(ndi_db_ptr, sai_vlan_id)) != STD_ERR_OK) {
+            return rc;
         }
-        /* TODO: check if vlan member is correct */
-        sai_attr[0].id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
-        sai_attr[1].id = SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
-        for(iter=0; iter<count; iter++) {
-            if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->get_vlan_member_attribute(
-                            member_list[iter],2,sai_attr)) !=
-                    SAI_STATUS_SUCCESS) {
-                NDI_VLAN_LOG_ERROR("Vlan member port get failed %d"
-                        " for VLAN member ID %lu",sai_ret,member_list[iter]);
-                continue;
-            }
+        map_filled = true;
+    }
 
-            if((sai_attr[0].value.oid == brport) || del_all) {
-                if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_member(
-                                member_list[iter]))
-                        != SAI_STATUS_SUCCESS) {
-                    NDI_VLAN_LOG_ERROR("Default VLAN member del failed"
-                            " SAI-port:%lu SAI-status:%d",
-                            sai_attr[0].value.oid,sai_ret);
-                    return STD_ERR(NPU, FAIL, sai_ret);
-                }
-
-                if(!del_all){
-                    break;
-                }
-            }
+    auto it = g_default_vlan_mbr_map.find(brport);
+    if (it == g_default_vlan_mbr_map.end() && !map_filled) {
+        /* Member may have been added to default VLAN after the map was built */
+        if ((rc = ndi_vlan_default_mbr_map_fill(ndi_db_ptr, sai_vlan_id)) != STD_ERR_OK) {
+            return rc;
         }
+        it = g_default_vlan_mbr_map.find(brport);
+    }
+    if (it == g_default_vlan_mbr_map.end()) {
+        return STD_ERR_OK;
+    }
+
+    if ((sai_ret = ndi_sai_vlan_api(ndi_db_ptr)->remove_vlan_member(it->second))
+            != SAI_STATUS_SUCCESS) {
+        NDI_VLAN_LOG_ERROR("Default VLAN member del failed"
+                " SAI-port:%lu SAI-status:%d",
+                brport,sai_ret);
+        /* Member list may have changed underneath, rebuild on next delete */
+        g_default_vlan_mbr_map_valid = false;
+        return STD_ERR(NPU, FAIL, sai_ret);
     }
+    g_default_vlan_mbr_map.erase(it);
 
     return STD_ERR_OK;
 }
@@ -806,9 +1074,7 @@ t_std_error ndi_add_lag_to_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
                                            ndi_obj_id_t *tagged_lag_list, size_t  tagged_lag_cnt,
                                            ndi_obj_id_t *untagged_lag_list ,size_t untag_lag_cnt) {
 
-    size_t iter = 0;
     t_std_error rc;
-    sai_object_id_t lag_id = SAI_NULL_OBJECT_ID;
     sai_object_id_t vlan_obj_id = SAI_NULL_OBJECT_ID;
 
     if ((vlan_obj_id = ndi_get_sai_vlan_obj_id(npu_id,vlan_id))
@@ -816,27 +1082,13 @@ t_std_error ndi_add_lag_to_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
         return STD_ERR(NPU, FAIL, SAI_STATUS_FAILURE);
     }
 
-    while((iter < tagged_lag_cnt) || (iter < untag_lag_cnt )) {
-        if(iter < tagged_lag_cnt) {
-            lag_id = tagged_lag_list[iter];
-            if((rc = ndi_add_port_to_vlan(npu_id,vlan_id,lag_id,true)) !=
-                STD_ERR_OK) {
-                return rc;
-            }
-            NDI_LOG_TRACE("NDI_VLAN","Add Tag lag to vlan %d success for lagid 0x%lx",
-               vlan_id, lag_id);
-        }
-        if(iter < untag_lag_cnt) {
-            lag_id = untagged_lag_list[iter];
-            if((rc = ndi_add_port_to_vlan(npu_id,vlan_id,lag_id,false)) !=
-                STD_ERR_OK) {
-                return rc;
-            }
-            NDI_LOG_TRACE("NDI_VLAN","Add Untag lag to vlan %d success for lagid 0x%lx",
-               vlan_id, lag_id);
-        }
-        iter++;
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    ndi_vlan_lag_list_reqs(vlan_id, tagged_lag_list, tagged_lag_cnt,
+            untagged_lag_list, untag_lag_cnt, reqs);
+    if ((rc = ndi_vlan_add_members(npu_id, reqs)) != STD_ERR_OK) {
+        return rc;
     }
+    NDI_LOG_TRACE("NDI_VLAN","Add %lu lags to vlan %d success", reqs.size(), vlan_id);
     return STD_ERR_OK;
 }
 
@@ -844,8 +1096,6 @@ t_std_error ndi_del_lag_from_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
                                            ndi_obj_id_t *tagged_lag_list, size_t  tagged_lag_cnt,
                                            ndi_obj_id_t *untagged_lag_list ,size_t untag_lag_cnt) {
 
-    size_t iter = 0;
-    sai_object_id_t lag_id = SAI_NULL_OBJECT_ID;
     sai_object_id_t vlan_obj_id = SAI_NULL_OBJECT_ID;
     t_std_error rc;
 
@@ -854,28 +1104,13 @@ t_std_error ndi_del_lag_from_vlan(npu_id_t npu_id, hal_vlan_id_t vlan_id,
         return STD_ERR(NPU, FAIL, SAI_STATUS_FAILURE);
     }
 
-    while((iter < tagged_lag_cnt) || (iter < untag_lag_cnt )) {
-        if(iter < tagged_lag_cnt) {
-            lag_id = tagged_lag_list[iter];
-            if((rc = ndi_del_port_from_vlan(npu_id,vlan_id,lag_id)) !=
-                        STD_ERR_OK) {
-                return rc;
-            }
-            NDI_LOG_TRACE("NDI_VLAN","Del tag lag from vlan %d success for lagid 0x%lx",
-                            vlan_id, lag_id);
-        }
-        if(iter < untag_lag_cnt) {
-            lag_id = untagged_lag_list[iter];
-            if((rc = ndi_del_port_from_vlan(npu_id,vlan_id,lag_id)) !=
-                        STD_ERR_OK) {
-                return rc;
-            }
-            NDI_LOG_TRACE("NDI_VLAN","Del untag lag from vlan %d success for lagid 0x%lx",
-                            vlan_id, lag_id);
-        }
-        iter++;
+    std::vector<ndi_vlan_mbr_req_t> reqs;
+    ndi_vlan_lag_list_reqs(vlan_id, tagged_lag_list, tagged_lag_cnt,
+            untagged_lag_list, untag_lag_cnt, reqs);
+    if ((rc = ndi_vlan_del_members(npu_id, reqs)) != STD_ERR_OK) {
+        return rc;
     }
-
+    NDI_LOG_TRACE("NDI_VLAN","Del %lu lags from vlan %d success", reqs.size(), vlan_id);
     return STD_ERR_OK;
 }
 
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_vlan_mbr_cache.cpp
+ */
+
+#include "nas_ndi_vlan_mbr_cache.h"
+#include "std_rw_lock.h"
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Ports are given a dense index on their first membership and release it
+ * when they leave their last VLAN. VLAN records are indexed by VLAN ID and
+ * hold a port bitmap and a member array indexed by port index, port records
+ * hold a VLAN bitmap.
+ */
+static const size_t NDI_VLAN_MBR_VLAN_MAX = 4096;
+static const size_t NDI_VLAN_MBR_WORD_BITS = 64;
+
+typedef struct {
+    sai_object_id_t member_id;
+    sai_vlan_tagging_mode_t tagging_mode;
+} ndi_vlan_mbr_t;
+
+typedef struct {
+    std::vector<uint64_t> port_bits;
+    std::vector<ndi_vlan_mbr_t> mbrs;
+    size_t count;
+} ndi_vlan_mbr_vlan_t;
+
+typedef struct {
+    sai_object_id_t port_id;
+    std::array<uint64_t, NDI_VLAN_MBR_VLAN_MAX / NDI_VLAN_MBR_WORD_BITS> vlan_bits;
+    size_t count;
+} ndi_vlan_mbr_port_t;
+
+static inline bool bit_test(const uint64_t *bits, size_t ix)
+{
+    return (bits[ix / NDI_VLAN_MBR_WORD_BITS] >> (ix % NDI_VLAN_MBR_WORD_BITS)) & 1;
+}
+
+static inline void bit_set(uint64_t *bits, size_t ix)
+{
+    bits[ix / NDI_VLAN_MBR_WORD_BITS] |= (1ULL << (ix % NDI_VLAN_MBR_WORD_BITS));
+}
+
+static inline void bit_clear(uint64_t *bits, size_t ix)
+{
+    bits[ix / NDI_VLAN_MBR_WORD_BITS] &= ~(1ULL << (ix % NDI_VLAN_MBR_WORD_BITS));
+}
+
+class ndi_vlan_mbr_db {
+public:
+    bool get(hal_vlan_id_t vlan_id, sai_object_id_t port_id, ndi_vlan_mbr_t *mbr) const;
+    void set(const ndi_vlan_mbr_info_t &info);
+    void del(hal_vlan_id_t vlan_id, sai_object_id_t port_id);
+    size_t port_get(sai_object_id_t port_id, ndi_vlan_mbr_info_t *mbr_list,
+                    size_t max_count) const;
+    size_t vlan_get(hal_vlan_id_t vlan_id, ndi_vlan_mbr_info_t *mbr_list,
+                    size_t max_count) const;
+    void walk(npu_id_t npu_id, ndi_vlan_mbr_cache_walk_fn fn, void *context) const;
+
+private:
+    uint32_t port_index_alloc(sai_object_id_t port_id);
+
+    std::array<std::unique_ptr<ndi_vlan_mbr_vlan_t>, NDI_VLAN_MBR_VLAN_MAX> _vlans;
+    std::vector<ndi_vlan_mbr_port_t> _ports;
+    std::vector<uint32_t> _free_ports;
+    std::unordered_map<sai_object_id_t, uint32_t> _port_index;
+};
+
+uint32_t ndi_vlan_mbr_db::port_index_alloc(sai_object_id_t port_id)
+{
+    auto it = _port_index.find(port_id);
+    if (it != _port_index.end()) {
+        return it->second;
+    }
+
+    uint32_t ix;
+    if (!_free_ports.empty()) {
+        ix = _free_ports.back();
+        _free_ports.pop_back();
+    } else {
+        ix = _ports.size();
+        _ports.emplace_back();
+    }
+    _ports[ix].port_id = port_id;
+    _ports[ix].vlan_bits.fill(0);
+    _ports[ix].count = 0;
+    _port_index[port_id] = ix;
+    return ix;
+}
+
+bool ndi_vlan_mbr_db::get(hal_vlan_id_t vlan_id, sai_object_id_t port_id,
+                          ndi_vlan_mbr_t *mbr) const
+{
+    auto it = _port_index.find(port_id);
+    if (it == _port_index.end()) {
+        return false;
+    }
+    if (!bit_test(_ports[it->second].vlan_bits.data(), vlan_id)) {
+        return false;
+    }
+    *mbr = _vlans[vlan_id]->mbrs[it->second];
+    return true;
+}
+
+void ndi_vlan_mbr_db::set(const ndi_vlan_mbr_info_t &info)
+{
+    uint32_t ix = port_index_alloc(info.port_id);
+    ndi_vlan_mbr_port_t &port = _ports[ix];
+
+    auto &vlan = _vlans[info.vlan_id];
+    if (!vlan) {
+        vlan.reset(new ndi_vlan_mbr_vlan_t());
+        vlan->count = 0;
+    }
+    if (vlan->mbrs.size() <= ix) {
+        vlan->mbrs.resize(_ports.size());
+        vlan->port_bits.resize((_ports.size() + NDI_VLAN_MBR_WORD_BITS - 1) /
+                               NDI_VLAN_MBR_WORD_BITS, 0);
+    }
+
+    vlan->mbrs[ix] = {info.member_id, info.tagging_mode};
+    if (!bit_test(port.vlan_bits.data(), info.vlan_id)) {
+        bit_set(port.vlan_bits.data(), info.vlan_id);
+        bit_set(vlan->port_bits.data(), ix);
+        port.count++;
+        vlan->count++;
+    }
+}
+
+void ndi_vlan_mbr_db::del(hal_vlan_id_t vlan_id, sai_object_id_t port_id)
+{
+    auto it = _port_index.find(port_id);
+    if (it == _port_index.end()) {
+        return;
+    }
+    uint32_t ix = it->second;
+    ndi_vlan_mbr_port_t &port = _ports[ix];
+    if (!bit_test(port.vlan_bits.data(), vlan_id)) {
+        return;
+    }
+
+    auto &vlan = _vlans[vlan_id];
+    bit_clear(port.vlan_bits.data(), vlan_id);
+    bit_clear(vlan->port_bits.data(), ix);
+    if (--vlan->count == 0) {
+        vlan.reset();
+    }
+    if (--port.count == 0) {
+        _port_index.erase(it);
+        _free_ports.push_back(ix);
+    }
+}
+
+size_t ndi_vlan_mbr_db::port_get(sai_object_id_t port_id, ndi_vlan_mbr_info_t *mbr_list,
+                                 size_t max_count) const
+{
+    auto it = _port_index.find(port_id);
+    if (it == _port_index.end()) {
+        return 0;
+    }
+    uint32_t ix = it->second;
+    const ndi_vlan_mbr_port_t &port = _ports[ix];
+
+    size_t count = 0;
+    for (size_t w = 0; (w < port.vlan_bits.size()) && (count < max_count); ++w) {
+        for (uint64_t bits = port.vlan_bits[w]; (bits != 0) && (count < max_count);
+             bits &= bits - 1) {
+            hal_vlan_id_t vlan_id = (hal_vlan_id_t)(w * NDI_VLAN_MBR_WORD_BITS +
+                                                    __builtin_ctzll(bits));
+            const ndi_vlan_mbr_t &mbr = _vlans[vlan_id]->mbrs[ix];
+            mbr_list[count++] = {vlan_id, port_id, mbr.member_id, mbr.tagging_mode};
+        }
+    }
+    return port.count;
+}
+
+size_t ndi_vlan_mbr_db::vlan_get(hal_vlan_id_t vlan_id, ndi_vlan_mbr_info_t *mbr_list,
+                                 size_t max_count) const
+{
+    const auto &vlan = _vlans[vlan_id];
+    if (!vlan) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t w = 0; (w < vlan->port_bits.size()) && (count < max_count); ++w) {
+        for (uint64_t bits = vlan->port_bits[w]; (bits != 0) && (count < max_count);
+             bits &= bits - 1) {
+            size_t ix = w * NDI_VLAN_MBR_WORD_BITS + __builtin_ctzll(bits);
+            const ndi_vlan_mbr_t &mbr = vlan->mbrs[ix];
+            mbr_list[count++] = {vlan_id, _ports[ix].port_id, mbr.member_id,
+                                 mbr.tagging_mode};
+        }
+    }
+    return vlan->count;
+}
+
+void ndi_vlan_mbr_db::walk(npu_id_t npu_id, ndi_vlan_mbr_cache_walk_fn fn,
+                           void *context) const
+{
+    for (size_t vlan_id = 0; vlan_id < NDI_VLAN_MBR_VLAN_MAX; ++vlan_id) {
+        const auto &vlan = _vlans[vlan_id];
+        if (!vlan) {
+            continue;
+        }
+        for (size_t w = 0; w < vlan->port_bits.size(); ++w) {
+            for (uint64_t bits = vlan->port_bits[w]; bits != 0; bits &= bits - 1) {
+                size_t ix = w * NDI_VLAN_MBR_WORD_BITS + __builtin_ctzll(bits);
+                const ndi_vlan_mbr_t &mbr = vlan->mbrs[ix];
+                ndi_vlan_mbr_info_t info = {(hal_vlan_id_t)vlan_id, _ports[ix].port_id,
+                                            mbr.member_id, mbr.tagging_mode};
+                fn(npu_id, &info, context);
+            }
+        }
+    }
+}
+
+/* Per NPU membership, one lock for all the NPUs */
+class ndi_vlan_mbr_cache {
+public:
+    ndi_vlan_mbr_cache() {
+        std_rw_lock_create_default(&rw_lock);
+    }
+
+    ndi_vlan_mbr_db *db_get(npu_id_t npu_id, bool create) {
+        auto it = _dbs.find(npu_id);
+        if (it != _dbs.end()) {
+            return it->second.get();
+        }
+        if (!create) {
+            return NULL;
+        }
+        auto db = new ndi_vlan_mbr_db;
+        _dbs[npu_id].reset(db);
+        return db;
+    }
+
+    void walk(ndi_vlan_mbr_cache_walk_fn fn, void *context) const {
+        for (auto &it: _dbs) {
+            it.second->walk(it.first, fn, context);
+        }
+    }
+
+    std_rw_lock_t rw_lock;
+
+private:
+    std::unordered_map<npu_id_t, std::unique_ptr<ndi_vlan_mbr_db>> _dbs;
+};
+
+static auto _vlan_mbr_cache = new ndi_vlan_mbr_cache;
+
+static inline bool _vlan_id_valid(hal_vlan_id_t vlan_id)
+{
+    return vlan_id < NDI_VLAN_MBR_VLAN_MAX;
+}
+
+extern "C" {
+
+t_std_error ndi_vlan_mbr_cache_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        sai_object_id_t port_id, sai_object_id_t *member_id,
+        sai_vlan_tagging_mode_t *tagging_mode)
+{
+    if (!_vlan_id_valid(vlan_id)) {
+        return STD_ERR(NPU, PARAM, 0);
+    }
+
+    std_rw_lock_read_guard lg(&_vlan_mbr_cache->rw_lock);
+    ndi_vlan_mbr_db *db = _vlan_mbr_cache->db_get(npu_id, false);
+    ndi_vlan_mbr_t mbr;
+    if ((db == NULL) || !db->get(vlan_id, port_id, &mbr)) {
+        return STD_ERR(NPU, FAIL, 0);
+    }
+    if (member_id != NULL) {
+        *member_id = mbr.member_id;
+    }
+    if (tagging_mode != NULL) {
+        *tagging_mode = mbr.tagging_mode;
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_vlan_mbr_cache_set(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr_list,
+        size_t count)
+{
+    for (size_t ix = 0; ix < count; ++ix) {
+        if (!_vlan_id_valid(mbr_list[ix].vlan_id)) {
+            return STD_ERR(NPU, PARAM, 0);
+        }
+    }
+
+    std_rw_lock_write_guard lg(&_vlan_mbr_cache->rw_lock);
+    try {
+        ndi_vlan_mbr_db *db = _vlan_mbr_cache->db_get(npu_id, true);
+        for (size_t ix = 0; ix < count; ++ix) {
+            db->set(mbr_list[ix]);
+        }
+    } catch (std::exception &e) {
+        return STD_ERR(NPU, NOMEM, 0);
+    }
+    return STD_ERR_OK;
+}
+
+t_std_error ndi_vlan_mbr_cache_del(npu_id_t npu_id, const ndi_vlan_mbr_info_t *mbr_list,
+        size_t count)
+{
+    std_rw_lock_write_guard lg(&_vlan_mbr_cache->rw_lock);
+    ndi_vlan_mbr_db *db = _vlan_mbr_cache->db_get(npu_id, false);
+    if (db == NULL) {
+        return STD_ERR_OK;
+    }
+    for (size_t ix = 0; ix < count; ++ix) {
+        if (_vlan_id_valid(mbr_list[ix].vlan_id)) {
+            db->del(mbr_list[ix].vlan_id, mbr_list[ix].port_id);
+        }
+    }
+    return STD_ERR_OK;
+}
+
+size_t ndi_vlan_mbr_cache_port_get(npu_id_t npu_id, sai_object_id_t port_id,
+        ndi_vlan_mbr_info_t *mbr_list, size_t max_count)
+{
+    std_rw_lock_read_guard lg(&_vlan_mbr_cache->rw_lock);
+    ndi_vlan_mbr_db *db = _vlan_mbr_cache->db_get(npu_id, false);
+    return (db == NULL) ? 0 : db->port_get(port_id, mbr_list, max_count);
+}
+
+size_t ndi_vlan_mbr_cache_vlan_get(npu_id_t npu_id, hal_vlan_id_t vlan_id,
+        ndi_vlan_mbr_info_t *mbr_list, size_t max_count)
+{
+    if (!_vlan_id_valid(vlan_id)) {
+        return 0;
+    }
+    std_rw_lock_read_guard lg(&_vlan_mbr_cache->rw_lock);
+    ndi_vlan_mbr_db *db = _vlan_mbr_cache->db_get(npu_id, false);
+    return (db == NULL) ? 0 : db->vlan_get(vlan_id, mbr_list, max_count);
+}
+
+void ndi_vlan_mbr_cache_walk(ndi_vlan_mbr_cache_walk_fn fn, void *context)
+{
+    std_rw_lock_read_guard lg(&_vlan_mbr_cache->rw_lock);
+    _vlan_mbr_cache->walk(fn, context);
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_acl_resource_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_acl_resource.h"
+
+#include <vector>
+
+static const ndi_obj_id_t ut_table = 0x7000000001, ut_table2 = 0x7000000002;
+
+/* 2 pipelines with 2 ingress slices of 100 entries each, ut_table in the
+ * first slice of each pipeline, and one egress slice with 50 entries */
+static void ut_slices_set(npu_id_t npu)
+{
+    static const ndi_obj_id_t tables[] = {ut_table};
+    std::vector<ndi_acl_resource_slice_t> slices;
+    for (uint32_t pipe = 0; pipe < 2; ++pipe) {
+        for (size_t ix = 0; ix < 2; ++ix) {
+            ndi_acl_resource_slice_t slice = {0x7100000000 + pipe * 2 + ix,
+                                              BASE_ACL_STAGE_INGRESS, pipe, 0, 100,
+                                              tables, (ix == 0) ? 1U : 0U};
+            slices.push_back(slice);
+        }
+    }
+    ndi_acl_resource_slice_t egress = {0x7100000010, BASE_ACL_STAGE_EGRESS, 0, 10, 50, NULL, 0};
+    slices.push_back(egress);
+    ndi_acl_resource_slices_set(npu, slices.data(), slices.size());
+}
+
+TEST(std_nas_ndi_acl_resource_test, ndi_acl_resource_admit) {
+    size_t fit = 0;
+    ut_slices_set(0);
+    ndi_acl_resource_table_add(0, ut_table, BASE_ACL_STAGE_INGRESS, 0);
+
+    ASSERT_EQ(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, ut_table, 200, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 200);
+    ASSERT_NE(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, ut_table, 201, NULL), STD_ERR_OK);
+
+    /* table grows into the free slice of each pipeline */
+    ndi_acl_resource_entry_add(0, ut_table, 150);
+    ASSERT_EQ(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, ut_table, 50, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 50);
+    ASSERT_NE(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, 0, 1, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 0);
+    ASSERT_EQ(ndi_acl_resource_admit(0, BASE_ACL_STAGE_EGRESS, 0, 40, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 50);
+
+    ndi_acl_resource_entry_del(0, ut_table, 50);
+    ASSERT_EQ(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, ut_table, 100, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 100);
+
+    /* slices of a deleted table are free again for other tables */
+    ndi_acl_resource_table_del(0, ut_table);
+    ASSERT_EQ(ndi_acl_resource_admit(0, BASE_ACL_STAGE_INGRESS, 0, 100, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 100);
+
+    /* entry count beyond the model marks it out of date */
+    ASSERT_FALSE(ndi_acl_resource_sync_needed(0, 60000));
+    ndi_acl_resource_table_add(0, ut_table2, BASE_ACL_STAGE_EGRESS, 0);
+    ndi_acl_resource_entry_add(0, ut_table2, 60);
+    ASSERT_TRUE(ndi_acl_resource_sync_needed(0, 60000));
+}
+
+TEST(std_nas_ndi_acl_resource_test, ndi_acl_resource_table_size) {
+    size_t fit = 0;
+    ASSERT_TRUE(ndi_acl_resource_sync_needed(1, 60000));
+
+    /* no slice known, only the table size limits */
+    ndi_acl_resource_table_add(1, ut_table, BASE_ACL_STAGE_INGRESS, 10);
+    ndi_acl_resource_entry_add(1, ut_table, 4);
+    ASSERT_EQ(ndi_acl_resource_admit(1, BASE_ACL_STAGE_INGRESS, ut_table, 6, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 6);
+    ASSERT_NE(ndi_acl_resource_admit(1, BASE_ACL_STAGE_INGRESS, ut_table, 7, NULL), STD_ERR_OK);
+    ASSERT_EQ(ndi_acl_resource_admit(1, BASE_ACL_STAGE_INGRESS, 0, 100000, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, SIZE_MAX);
+
+    ut_slices_set(1);
+    ASSERT_FALSE(ndi_acl_resource_sync_needed(1, 60000));
+    ASSERT_EQ(ndi_acl_resource_admit(1, BASE_ACL_STAGE_INGRESS, ut_table, 6, &fit), STD_ERR_OK);
+    ASSERT_EQ(fit, 6);
+    ndi_acl_resource_invalidate(1);
+    ASSERT_TRUE(ndi_acl_resource_sync_needed(1, 60000));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -21,9 +21,19 @@
 #include "dell-base-acl.h"
 #include "std_error_codes.h"
 #include "nas_ndi_acl.h"
+#include "nas_ndi_acl_bulk.h"
 #include "nas_ndi_event_logs.h"
+#include "nas_ndi_int.h"
+#include "nas_ndi_acl_utl.h"
+#include "nas_ndi_acl_resource.h"
 #include <gtest/gtest.h>
 #include <arpa/inet.h>
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <stdio.h>
+#include <string>
+#include <vector>
 
 #define MY_ASSERT_TRUE(x) \
     if (!x) NDI_LOG_ERROR ("NDI-ACL", #x " Failed"); return;
@@ -171,6 +181,94 @@ void my_acltest_del ()
     MY_EXPECT_TRUE (ndi_acl_table_delete (0, tbl_id) == STD_ERR_OK);
 }
 
+/* Entry create/delete time, one call per entry against the bulk APIs */
+TEST(std_nas_ndi_acl_test, ndi_acl_entries_bulk_bench)
+{
+    ndi_obj_id_t  tbl_id;
+    BASE_ACL_MATCH_TYPE_t arr[] = {BASE_ACL_MATCH_TYPE_OUTER_VLAN_ID,
+        BASE_ACL_MATCH_TYPE_SRC_IP, BASE_ACL_MATCH_TYPE_IN_PORTS};
+    ndi_acl_table_t ndi_tbl = {BASE_ACL_STAGE_INGRESS, 30, 3, arr};
+    ASSERT_EQ (ndi_acl_table_create (0, &ndi_tbl, &tbl_id), STD_ERR_OK);
+
+    ndi_port_t plist[] = {{0,2},{0,4},{0,6}};
+    ndi_acl_entry_action_t action_drop;
+    action_drop.action_type = BASE_ACL_ACTION_TYPE_PACKET_ACTION;
+    action_drop.values_type = NDI_ACL_ACTION_PKT_ACTION;
+    action_drop.pkt_action = BASE_ACL_PACKET_ACTION_TYPE_DROP;
+
+    for (size_t size: {1000, 10000, 50000}) {
+        /* Runs are capped at the room left in the slices, every entry must be created */
+        size_t count = size;
+        ndi_acl_resource_admit (0, BASE_ACL_STAGE_INGRESS, tbl_id, size, &count);
+        count = std::min (count, size);
+        std::vector<ndi_acl_entry_filter_t> filters (count * 3);
+        std::vector<ndi_acl_entry_t> entries (count);
+        std::vector<ndi_obj_id_t> entry_ids (count);
+
+        for (size_t ix = 0; ix < count; ++ix) {
+            ndi_acl_entry_filter_t *f = &filters[ix * 3];
+            memset (f, 0, 3 * sizeof (*f));
+            f[0].filter_type = BASE_ACL_MATCH_TYPE_OUTER_VLAN_ID;
+            f[0].values_type = NDI_ACL_FILTER_U16;
+            f[0].data.values.u16 = 1 + (ix % 4000);
+            f[0].mask.values.u16 = 0xfff;
+            f[1].filter_type = BASE_ACL_MATCH_TYPE_SRC_IP;
+            f[1].values_type = NDI_ACL_FILTER_IPV4_ADDR;
+            f[1].data.values.ipv4.s_addr = htonl (0x0a000000 + ix);
+            f[1].mask.values.ipv4.s_addr = 0xffffffff;
+            f[2].filter_type = BASE_ACL_MATCH_TYPE_IN_PORTS;
+            f[2].values_type = NDI_ACL_FILTER_PORTLIST;
+            f[2].data.values.ndi_portlist = {3, plist};
+            entries[ix] = {tbl_id, (ndi_acl_priority_t)(ix + 1), 3, f, 1, &action_drop};
+        }
+
+        auto start = std::chrono::steady_clock::now ();
+        for (size_t ix = 0; ix < count; ++ix) {
+            ASSERT_EQ (ndi_acl_entry_create (0, &entries[ix], &entry_ids[ix]), STD_ERR_OK);
+        }
+        auto single_create = std::chrono::steady_clock::now () - start;
+        start = std::chrono::steady_clock::now ();
+        for (size_t ix = 0; ix < count; ++ix) {
+            ASSERT_EQ (ndi_acl_entry_delete (0, entry_ids[ix]), STD_ERR_OK);
+        }
+        auto single_delete = std::chrono::steady_clock::now () - start;
+
+        std::vector<t_std_error> rc_list (count, STD_ERR(ACL, FAIL, 0));
+        std::fill (entry_ids.begin (), entry_ids.end (), 0);
+        start = std::chrono::steady_clock::now ();
+        ASSERT_EQ (ndi_acl_entries_create_bulk (0, entries.data(), count, entry_ids.data(),
+                                                rc_list.data()), STD_ERR_OK);
+        auto bulk_create = std::chrono::steady_clock::now () - start;
+        std::set<ndi_obj_id_t> id_set;
+        for (size_t ix = 0; ix < count; ++ix) {
+            ASSERT_EQ (rc_list[ix], STD_ERR_OK) << "entry " << ix;
+            ASSERT_NE (entry_ids[ix], 0U) << "entry " << ix;
+            ASSERT_TRUE (id_set.insert (entry_ids[ix]).second) << "entry " << ix;
+        }
+        std::fill (rc_list.begin (), rc_list.end (), STD_ERR(ACL, FAIL, 0));
+        start = std::chrono::steady_clock::now ();
+        ASSERT_EQ (ndi_acl_entries_delete_bulk (0, entry_ids.data(), count, rc_list.data()),
+                   STD_ERR_OK);
+        auto bulk_delete = std::chrono::steady_clock::now () - start;
+        for (size_t ix = 0; ix < count; ++ix) {
+            ASSERT_EQ (rc_list[ix], STD_ERR_OK) << "entry " << ix;
+        }
+
+        using ms = std::chrono::milliseconds;
+        std::string key = "entries_" + std::to_string (size) + "_";
+        RecordProperty (key + "count", (int)count);
+        RecordProperty (key + "single_create_ms",
+                        (int)std::chrono::duration_cast<ms>(single_create).count());
+        RecordProperty (key + "single_delete_ms",
+                        (int)std::chrono::duration_cast<ms>(single_delete).count());
+        RecordProperty (key + "bulk_create_ms",
+                        (int)std::chrono::duration_cast<ms>(bulk_create).count());
+        RecordProperty (key + "bulk_delete_ms",
+                        (int)std::chrono::duration_cast<ms>(bulk_delete).count());
+    }
+
+    ASSERT_EQ (ndi_acl_table_delete (0, tbl_id), STD_ERR_OK);
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
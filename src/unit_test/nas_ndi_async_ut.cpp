@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_async_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_async.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef struct {
+    uint64_t key;
+    uint64_t seq;
+} ut_req_t;
+
+static mutex ut_mutex;
+static vector<ut_req_t> ut_done;
+static atomic<size_t> ut_batch_calls(0);
+static atomic<bool> ut_block(false);
+
+static t_std_error ut_req_fn(void *req_data, ndi_obj_id_t *obj_id)
+{
+    while (ut_block) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    auto req = static_cast<ut_req_t *>(req_data);
+    lock_guard<mutex> lock(ut_mutex);
+    ut_done.push_back(*req);
+    *obj_id = req->key * 1000 + req->seq;
+    return STD_ERR_OK;
+}
+
+static void ut_batch_fn(size_t count, void **req_data_list,
+                        t_std_error *rc_list, ndi_obj_id_t *obj_id_list)
+{
+    ut_batch_calls++;
+    for (size_t ix = 0; ix < count; ++ix) {
+        rc_list[ix] = ut_req_fn(req_data_list[ix], &obj_id_list[ix]);
+    }
+}
+
+TEST(std_nas_ndi_async_test, ndi_async_sync_mode) {
+    ut_req_t req = {1, 1};
+    ASSERT_FALSE(ndi_async_is_enabled());
+    auto fut = ndi_async_submit_future(NDI_ASYNC_OBJ_CLASS_ROUTE, req.key, ut_req_fn, &req);
+    auto res = fut.get();
+    ASSERT_EQ(res.rc, STD_ERR_OK);
+    ASSERT_EQ(res.obj_id, 1001);
+}
+
+TEST(std_nas_ndi_async_test, ndi_async_key_order) {
+    ndi_async_cfg_t cfg = {1024, 16, 4};
+    ASSERT_EQ(ndi_async_init(&cfg), STD_ERR_OK);
+    ASSERT_EQ(ndi_async_register_batch_fn(ut_req_fn, ut_batch_fn), STD_ERR_OK);
+    ut_done.clear();
+
+    const size_t keys = 8, seqs = 200;
+    vector<ut_req_t> reqs(keys * seqs);
+    for (size_t seq = 0; seq < seqs; ++seq) {
+        for (size_t key = 0; key < keys; ++key) {
+            auto& req = reqs[seq * keys + key];
+            req.key = key;
+            req.seq = seq;
+            ASSERT_EQ(ndi_async_submit(NDI_ASYNC_OBJ_CLASS_ACL, key, ut_req_fn, &req,
+                                       NULL, NULL, true), STD_ERR_OK);
+        }
+    }
+    ASSERT_EQ(ndi_async_flush(NDI_ASYNC_OBJ_CLASS_ACL), STD_ERR_OK);
+    ASSERT_EQ(ndi_async_pending_count(NDI_ASYNC_OBJ_CLASS_ACL), 0);
+    ASSERT_EQ(ut_done.size(), keys * seqs);
+    ASSERT_GT(ut_batch_calls, 0);
+
+    vector<uint64_t> last_seq(keys, 0);
+    vector<bool> seen(keys, false);
+    for (auto& req: ut_done) {
+        if (seen[req.key]) {
+            ASSERT_EQ(req.seq, last_seq[req.key] + 1);
+        }
+        seen[req.key] = true;
+        last_seq[req.key] = req.seq;
+    }
+    ndi_async_register_batch_fn(ut_req_fn, NULL);
+    ndi_async_deinit();
+}
+
+TEST(std_nas_ndi_async_test, ndi_async_back_pressure) {
+    ndi_async_cfg_t cfg = {4, 1, 1};
+    ASSERT_EQ(ndi_async_init(&cfg), STD_ERR_OK);
+    ut_done.clear();
+
+    vector<ut_req_t> reqs(16);
+    ut_block = true;
+    size_t queued = 0;
+    for (auto& req: reqs) {
+        if (ndi_async_submit(NDI_ASYNC_OBJ_CLASS_QOS, 0, ut_req_fn, &req,
+                             NULL, NULL, false) == STD_ERR_OK) {
+            queued++;
+        }
+    }
+    /* queue depth plus the request held by the worker */
+    ASSERT_LE(queued, cfg.queue_depth + 1);
+    ASSERT_LT(queued, reqs.size());
+
+    ut_block = false;
+    ndi_async_flush(NDI_ASYNC_OBJ_CLASS_QOS);
+    ASSERT_EQ(ut_done.size(), queued);
+    ndi_async_deinit();
+}
+
+static atomic<size_t> ut_cmpl_count(0);
+static atomic<bool> ut_flush_failed(false);
+
+/* Resubmits from the worker with wait set while the queue is full */
+static void ut_resubmit_cmpl(t_std_error rc, ndi_obj_id_t obj_id, void *cookie)
+{
+    auto req = static_cast<ut_req_t *>(cookie);
+    if (req->seq == 0) {
+        req->seq = 1;
+        for (size_t ix = 0; ix < 8; ++ix) {
+            ndi_async_submit(NDI_ASYNC_OBJ_CLASS_OTHER, 0, ut_req_fn, req, NULL, NULL, true);
+        }
+        ut_flush_failed = (ndi_async_flush(NDI_ASYNC_OBJ_CLASS_OTHER) != STD_ERR_OK);
+    }
+    ut_cmpl_count++;
+}
+
+TEST(std_nas_ndi_async_test, ndi_async_worker_context) {
+    ndi_async_cfg_t cfg = {2, 1, 1};
+    ASSERT_EQ(ndi_async_init(&cfg), STD_ERR_OK);
+    ut_done.clear();
+
+    ut_req_t req = {7, 0};
+    ASSERT_EQ(ndi_async_submit(NDI_ASYNC_OBJ_CLASS_OTHER, 0, ut_req_fn, &req,
+                               ut_resubmit_cmpl, &req, true), STD_ERR_OK);
+    ASSERT_EQ(ndi_async_flush(NDI_ASYNC_OBJ_CLASS_OTHER), STD_ERR_OK);
+    ASSERT_EQ(ut_cmpl_count, 1);
+    ASSERT_TRUE(ut_flush_failed);
+    ASSERT_EQ(ut_done.size(), 9);
+    ndi_async_deinit();
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
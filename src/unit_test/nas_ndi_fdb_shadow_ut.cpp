@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_fdb_shadow_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_fdb_shadow.h"
+
+#include <string.h>
+
+static const size_t ut_ports = 8, ut_vlans = 16, ut_macs = 64;
+
+static ndi_fdb_shadow_entry_t ut_entry(size_t port, size_t vlan, size_t mac)
+{
+    ndi_fdb_shadow_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.bv_id = 0x2600000000 + vlan;
+    entry.brport_id = 0x3a00000000 + port;
+    entry.mac[4] = (uint8_t)(mac >> 8);
+    entry.mac[5] = (uint8_t)mac;
+    entry.is_static = (mac % 2) == 0;
+    entry.action = SAI_PACKET_ACTION_FORWARD;
+    return entry;
+}
+
+static void ut_fill()
+{
+    ndi_fdb_shadow_enable(false);
+    ndi_fdb_shadow_enable(true);
+    for (size_t port = 0; port < ut_ports; ++port) {
+        for (size_t vlan = 0; vlan < ut_vlans; ++vlan) {
+            for (size_t mac = 0; mac < ut_macs; ++mac) {
+                auto entry = ut_entry(port, vlan, port * ut_macs + mac);
+                ASSERT_EQ(ndi_fdb_shadow_add(&entry), STD_ERR_OK);
+            }
+        }
+    }
+}
+
+static bool ut_count_fn(const ndi_fdb_shadow_entry_t *entry, void *ctx)
+{
+    (*static_cast<size_t *>(ctx))++;
+    return true;
+}
+
+TEST(std_nas_ndi_fdb_shadow_test, ndi_fdb_shadow_get) {
+    ut_fill();
+    ndi_fdb_shadow_filter_t all = {SAI_NULL_OBJECT_ID, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_ALL};
+    ASSERT_EQ(ndi_fdb_shadow_count(&all), ut_ports * ut_vlans * ut_macs);
+
+    auto entry = ut_entry(3, 5, 3 * ut_macs + 7);
+    ndi_fdb_shadow_entry_t key = entry;
+    key.brport_id = SAI_NULL_OBJECT_ID;
+    ASSERT_TRUE(ndi_fdb_shadow_get(&key));
+    ASSERT_EQ(key.brport_id, entry.brport_id);
+    ASSERT_EQ(key.is_static, entry.is_static);
+
+    /* station move updates the port lists */
+    entry.brport_id = ut_entry(4, 0, 0).brport_id;
+    ASSERT_EQ(ndi_fdb_shadow_add(&entry), STD_ERR_OK);
+    ndi_fdb_shadow_filter_t port3 = {ut_entry(3, 0, 0).brport_id, SAI_NULL_OBJECT_ID,
+                                     NDI_FDB_SHADOW_TYPE_ALL};
+    ndi_fdb_shadow_filter_t port4 = {entry.brport_id, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_ALL};
+    ASSERT_EQ(ndi_fdb_shadow_count(&port3), ut_vlans * ut_macs - 1);
+    ASSERT_EQ(ndi_fdb_shadow_count(&port4), ut_vlans * ut_macs + 1);
+
+    ASSERT_TRUE(ndi_fdb_shadow_del(entry.bv_id, entry.mac));
+    ASSERT_FALSE(ndi_fdb_shadow_get(&entry));
+    ASSERT_FALSE(ndi_fdb_shadow_del(entry.bv_id, entry.mac));
+    ASSERT_EQ(ndi_fdb_shadow_count(&port4), ut_vlans * ut_macs);
+    ASSERT_EQ(ndi_fdb_shadow_count(&all), ut_ports * ut_vlans * ut_macs - 1);
+}
+
+TEST(std_nas_ndi_fdb_shadow_test, ndi_fdb_shadow_filter) {
+    ut_fill();
+    sai_object_id_t port = ut_entry(2, 0, 0).brport_id;
+    sai_object_id_t vlan = ut_entry(0, 9, 0).bv_id;
+
+    ndi_fdb_shadow_filter_t filter = {port, vlan, NDI_FDB_SHADOW_TYPE_ALL};
+    ASSERT_EQ(ndi_fdb_shadow_count(&filter), ut_macs);
+    filter.type = NDI_FDB_SHADOW_TYPE_STATIC;
+    ASSERT_EQ(ndi_fdb_shadow_count(&filter), ut_macs / 2);
+
+    size_t visited = 0;
+    ndi_fdb_shadow_filter_t by_vlan = {SAI_NULL_OBJECT_ID, vlan, NDI_FDB_SHADOW_TYPE_DYNAMIC};
+    ASSERT_EQ(ndi_fdb_shadow_walk(&by_vlan, ut_count_fn, &visited), ut_ports * ut_macs / 2);
+    ASSERT_EQ(visited, ut_ports * ut_macs / 2);
+
+    /* dynamic flush on port leaves static entries */
+    ndi_fdb_shadow_filter_t by_port = {port, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_DYNAMIC};
+    ASSERT_EQ(ndi_fdb_shadow_flush(&by_port), ut_vlans * ut_macs / 2);
+    ASSERT_EQ(ndi_fdb_shadow_count(&by_port), 0);
+    by_port.type = NDI_FDB_SHADOW_TYPE_ALL;
+    ASSERT_EQ(ndi_fdb_shadow_count(&by_port), ut_vlans * ut_macs / 2);
+
+    /* remaining entries are still reachable through the hash */
+    for (size_t mac = 0; mac < ut_macs; ++mac) {
+        auto entry = ut_entry(5, 9, 5 * ut_macs + mac);
+        ASSERT_TRUE(ndi_fdb_shadow_get(&entry));
+    }
+
+    ndi_fdb_shadow_filter_t all = {SAI_NULL_OBJECT_ID, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_ALL};
+    ASSERT_EQ(ndi_fdb_shadow_flush(&all), ut_ports * ut_vlans * ut_macs - ut_vlans * ut_macs / 2);
+    ASSERT_EQ(ndi_fdb_shadow_count(&all), 0);
+
+    ndi_fdb_shadow_enable(false);
+    auto entry = ut_entry(0, 0, 0);
+    ASSERT_EQ(ndi_fdb_shadow_add(&entry), STD_ERR_OK);
+    ASSERT_FALSE(ndi_fdb_shadow_get(&entry));
+}
+
+TEST(std_nas_ndi_fdb_shadow_test, ndi_fdb_shadow_get_next) {
+    ut_fill();
+    sai_object_id_t vlan = ut_entry(0, 3, 0).bv_id;
+    ndi_fdb_shadow_filter_t filter = {SAI_NULL_OBJECT_ID, vlan, NDI_FDB_SHADOW_TYPE_ALL};
+    ndi_fdb_shadow_entry_t page[100];
+    size_t cursor = 0, total = 0, cnt;
+
+    /* entries removed between pages are skipped, the rest returned once */
+    auto removed = ut_entry(7, 3, 7 * ut_macs + 1);
+    while ((cnt = ndi_fdb_shadow_get_next(&filter, &cursor, page, 100)) != 0) {
+        ASSERT_LE(cnt, 100);
+        for (size_t ix = 0; ix < cnt; ++ix) {
+            ASSERT_EQ(page[ix].bv_id, vlan);
+        }
+        if (total == 0) {
+            ASSERT_TRUE(ndi_fdb_shadow_del(removed.bv_id, removed.mac));
+        }
+        total += cnt;
+    }
+    ASSERT_EQ(total, ut_ports * ut_macs - 1);
+
+    cursor = 0;
+    total = 0;
+    while ((cnt = ndi_fdb_shadow_get_next(NULL, &cursor, page, 100)) != 0) {
+        total += cnt;
+    }
+    ASSERT_EQ(total, ut_ports * ut_vlans * ut_macs - 1);
+}
+
+static bool ut_seed_ok = true;
+
+static bool ut_seed_fn()
+{
+    for (size_t mac = 0; mac < ut_macs; ++mac) {
+        auto entry = ut_entry(1, 2, mac);
+        ndi_fdb_shadow_add(&entry);
+    }
+    return ut_seed_ok;
+}
+
+TEST(std_nas_ndi_fdb_shadow_test, ndi_fdb_shadow_seed) {
+    ndi_fdb_shadow_filter_t all = {SAI_NULL_OBJECT_ID, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_ALL};
+
+    /* no seed function, shadow can not stand in for SAI */
+    ndi_fdb_shadow_enable(false);
+    ndi_fdb_shadow_seed_fn_set(NULL);
+    ndi_fdb_shadow_enable(true);
+    ASSERT_TRUE(ndi_fdb_shadow_is_enabled());
+    ASSERT_FALSE(ndi_fdb_shadow_is_seeded());
+
+    ndi_fdb_shadow_seed_fn_set(ut_seed_fn);
+    ndi_fdb_shadow_enable(true);
+    ASSERT_TRUE(ndi_fdb_shadow_is_seeded());
+    ASSERT_EQ(ndi_fdb_shadow_count(&all), ut_macs);
+
+    /* failed seed leaves the shadow enabled but not seeded */
+    ut_seed_ok = false;
+    ndi_fdb_shadow_enable(false);
+    ndi_fdb_shadow_enable(true);
+    ASSERT_TRUE(ndi_fdb_shadow_is_enabled());
+    ASSERT_FALSE(ndi_fdb_shadow_is_seeded());
+
+    ndi_fdb_shadow_enable(false);
+    ASSERT_FALSE(ndi_fdb_shadow_is_seeded());
+    ndi_fdb_shadow_seed_fn_set(NULL);
+    ut_seed_ok = true;
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
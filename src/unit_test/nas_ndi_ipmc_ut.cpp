@@ -30,6 +30,9 @@
 #include <ctime>
 #include <unordered_map>
 #include <tuple>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 enum obj_type_t {
     REPL_GRP,
@@ -451,6 +454,83 @@ TEST(nas_ndi_ipmc_test, check_repl_group_1)
     ipmc_ut_check_repl_grp();
 }
 
+TEST(nas_ndi_ipmc_test, set_repl_group_members)
+{
+    ndi_rif_id_t ipmc_rif_id = 700;
+    size_t ipmc_port_cnt = 8;
+
+    for (auto& grp_info: saved_repl_grp) {
+        auto repl_grp_id = std::get<0>(grp_info);
+        auto& ipmc_info = std::get<2>(grp_info);
+        ASSERT_TRUE(ipmc_info.size() > 2);
+        auto old_grp = ndi_ipmc_cache_get_repl_grp(0, repl_grp_id);
+
+        // Drop first member, change ports of second member, keep others and add a new one
+        auto del_rif_id = ipmc_info.begin()->first;
+        auto upd_rif_id = std::next(ipmc_info.begin())->first;
+        ipmc_info.erase(del_rif_id);
+        std::vector<std::unique_ptr<ndi_sw_port_t[]>> plist_ptr{};
+        std::vector<ndi_mc_grp_mbr_t> mbr_list{};
+        for (auto& mbr_info: ipmc_info) {
+            ndi_mc_grp_mbr_t ipmc_mbr{mbr_info.first};
+            if (mbr_info.first == upd_rif_id) {
+                plist_ptr.emplace_back(new ndi_sw_port_t[ipmc_port_cnt]);
+                ipmc_mbr.port_list = ndi_sw_port_list_t{ipmc_port_cnt, plist_ptr.back().get()};
+                generate_port_list(ipmc_mbr.port_list);
+                mbr_info.second.clear();
+                for (size_t idx = 0; idx < ipmc_port_cnt; idx ++) {
+                    mbr_info.second.insert(ipmc_mbr.port_list.list[idx]);
+                }
+            } else {
+                plist_ptr.emplace_back(new ndi_sw_port_t[mbr_info.second.size()]);
+                ipmc_mbr.port_list = ndi_sw_port_list_t{mbr_info.second.size(), plist_ptr.back().get()};
+                size_t idx = 0;
+                for (auto& sw_port: mbr_info.second) {
+                    ipmc_mbr.port_list.list[idx ++] = sw_port;
+                }
+            }
+            mbr_list.push_back(ipmc_mbr);
+        }
+        plist_ptr.emplace_back(new ndi_sw_port_t[ipmc_port_cnt]);
+        ndi_mc_grp_mbr_t new_mbr{ipmc_rif_id, ndi_sw_port_list_t{ipmc_port_cnt, plist_ptr.back().get()}};
+        generate_port_list(new_mbr.port_list);
+        mbr_list.push_back(new_mbr);
+        for (size_t idx = 0; idx < ipmc_port_cnt; idx ++) {
+            ipmc_info[ipmc_rif_id].insert(new_mbr.port_list.list[idx]);
+        }
+
+        ASSERT_EQ(ndi_set_repl_group_members(0, repl_grp_id, NDI_IPMC_GRP_MBR, mbr_list.size(), mbr_list.data()),
+                  STD_ERR_OK);
+        auto new_grp = ndi_ipmc_cache_get_repl_grp(0, repl_grp_id);
+        ASSERT_TRUE(new_grp.ipmc_mbr_list.find(del_rif_id) == new_grp.ipmc_mbr_list.end());
+        // Existing members, changed or not, are not re-created
+        for (auto& mbr_info: ipmc_info) {
+            if (mbr_info.first != ipmc_rif_id) {
+                ASSERT_EQ(new_grp.ipmc_mbr_list[mbr_info.first].mbr_id,
+                          old_grp.ipmc_mbr_list[mbr_info.first].mbr_id);
+            }
+        }
+
+        // Same membership again is no change
+        ASSERT_EQ(ndi_set_repl_group_members(0, repl_grp_id, NDI_IPMC_GRP_MBR, mbr_list.size(), mbr_list.data()),
+                  STD_ERR_OK);
+        auto same_grp = ndi_ipmc_cache_get_repl_grp(0, repl_grp_id);
+        ASSERT_EQ(same_grp.ipmc_mbr_list.size(), new_grp.ipmc_mbr_list.size());
+        for (auto& mbr: new_grp.ipmc_mbr_list) {
+            ASSERT_EQ(same_grp.ipmc_mbr_list[mbr.first].mbr_id, mbr.second.mbr_id);
+        }
+
+        // Duplicate RIF and multiple RPF members are rejected
+        mbr_list.push_back(new_mbr);
+        ASSERT_NE(ndi_set_repl_group_members(0, repl_grp_id, NDI_IPMC_GRP_MBR, mbr_list.size(), mbr_list.data()),
+                  STD_ERR_OK);
+        ASSERT_NE(ndi_set_repl_group_members(0, repl_grp_id, NDI_RPF_GRP_MBR, 2, mbr_list.data()),
+                  STD_ERR_OK);
+        ipmc_rif_id ++;
+    }
+    ipmc_ut_check_repl_grp();
+}
+
 
 std::unordered_map<ndi_obj_id_t, std::vector<ndi_ipmc_entry_t>> saved_ipmc_entry{};
 ndi_vrf_id_t test_vrf_id = 100;
@@ -664,6 +744,63 @@ TEST(nas_ndi_ipmc_test, delete_ipmc_entry)
     }
 }
 
+TEST(nas_ndi_ipmc_test, bulk_ipmc_entry)
+{
+    const size_t entry_cnt = 64;
+    hal_ip_addr_t grp_ip, src_ip;
+    ASSERT_TRUE(std_str_to_ip("234.1.1.1", &grp_ip));
+    ASSERT_TRUE(std_str_to_ip("3.3.3.3", &src_ip));
+
+    std::vector<ndi_ipmc_entry_t> entry_list{};
+    for (size_t idx = 0; idx < entry_cnt; idx ++) {
+        auto repl_grp_id = std::get<0>(saved_repl_grp[idx % saved_repl_grp.size()]);
+        ndi_ipmc_entry_t entry{test_vrf_id, NAS_NDI_IPMC_ENTRY_TYPE_SG, grp_ip, src_ip, repl_grp_id, false};
+        entry.dst_ip.u.v4_addr += (idx << 24);
+        entry_list.push_back(entry);
+    }
+    std::vector<t_std_error> rc_list(entry_cnt, STD_ERR(MCAST, FAIL, 0));
+    ASSERT_EQ(ndi_ipmc_entries_create(0, entry_list.data(), entry_cnt, rc_list.data()), STD_ERR_OK);
+    for (auto rc: rc_list) {
+        ASSERT_EQ(rc, STD_ERR_OK);
+    }
+
+    for (auto& entry: entry_list) {
+        entry.copy_to_cpu = true;
+    }
+    ASSERT_EQ(ndi_ipmc_entries_update(0, entry_list.data(), entry_cnt, NAS_NDI_IPMC_UPD_COPY_TO_CPU,
+                                      nullptr), STD_ERR_OK);
+    auto repl_grp_id = std::get<0>(saved_repl_grp[0]);
+    for (auto& entry: entry_list) {
+        entry.repl_group_id = repl_grp_id;
+    }
+    ASSERT_EQ(ndi_ipmc_entries_update(0, entry_list.data(), entry_cnt, NAS_NDI_IPMC_UPD_REPL_GRP,
+                                      nullptr), STD_ERR_OK);
+    for (auto& entry: entry_list) {
+        ndi_ipmc_entry_t rd_entry{entry};
+        rd_entry.repl_group_id = 0;
+        rd_entry.copy_to_cpu = false;
+        ASSERT_EQ(ndi_ipmc_cache_get_entry(0, rd_entry), STD_ERR_OK);
+        ASSERT_EQ(rd_entry.repl_group_id, repl_grp_id);
+        ASSERT_TRUE(rd_entry.copy_to_cpu);
+    }
+    ASSERT_EQ(ndi_ipmc_cache_get_repl_grp(0, repl_grp_id).ipmc_ipv4_entry_list.size(), entry_cnt);
+
+    // Entries of unknown replication group fail, others are still created
+    ndi_ipmc_entry_t bad_entry{entry_list[0]};
+    bad_entry.dst_ip.u.v4_addr += 1;
+    bad_entry.repl_group_id = 0xdead;
+    ASSERT_EQ(ndi_ipmc_entries_delete(0, entry_list.data(), entry_cnt, nullptr), STD_ERR_OK);
+    ndi_ipmc_entry_t mixed_list[2] = {bad_entry, entry_list[0]};
+    ASSERT_NE(ndi_ipmc_entries_create(0, mixed_list, 2, rc_list.data()), STD_ERR_OK);
+    ASSERT_NE(rc_list[0], STD_ERR_OK);
+    ASSERT_EQ(rc_list[1], STD_ERR_OK);
+    ASSERT_EQ(ndi_ipmc_entries_delete(0, &mixed_list[1], 1, nullptr), STD_ERR_OK);
+    for (auto& grp_info: saved_repl_grp) {
+        auto repl_grp = ndi_ipmc_cache_get_repl_grp(0, std::get<0>(grp_info));
+        ASSERT_TRUE(repl_grp.ipmc_ipv4_entry_list.empty());
+    }
+}
+
 TEST(nas_ndi_ipmc_test, delete_repl_group)
 {
     for (auto grp_info: saved_repl_grp) {
@@ -680,6 +817,115 @@ TEST(nas_ndi_ipmc_test, delete_repl_group)
     saved_repl_grp.clear();
 }
 
+/*
+ * Cache contention: lookups of 64k (S,G) entries in parallel with continuous
+ * join/prune of group members and (S,G) entries
+ */
+static const size_t bench_grp_cnt = 1024;
+static const size_t bench_entry_cnt = 64 * 1024;
+static const size_t bench_reader_cnt = 4;
+static const size_t bench_churn_cnt = 2;
+static const ndi_rif_id_t bench_churn_rif_id = 5000;
+
+static ndi_obj_id_t bench_grp_id(size_t grp_idx)
+{
+    return 0x10000 + grp_idx;
+}
+
+static ndi_ipmc_entry_t bench_sg_entry(size_t idx)
+{
+    ndi_ipmc_entry_t entry{};
+    entry.vrf_id = test_vrf_id;
+    entry.type = NAS_NDI_IPMC_ENTRY_TYPE_SG;
+    entry.dst_ip.af_index = HAL_INET4_FAMILY;
+    entry.dst_ip.u.v4_addr = 0xe0000000 + (idx % bench_grp_cnt);
+    entry.src_ip.af_index = HAL_INET4_FAMILY;
+    entry.src_ip.u.v4_addr = 0x0a000000 + idx;
+    entry.repl_group_id = bench_grp_id(idx % bench_grp_cnt);
+    return entry;
+}
+
+TEST(nas_ndi_ipmc_test, cache_contention)
+{
+    std::unique_ptr<repl_group_cache> cache{new repl_group_cache{}};
+    ndi_sw_port_t port{};
+    port.port_type = NDI_SW_PORT_NPU_PORT;
+    for (size_t idx = 0; idx < bench_grp_cnt; idx ++) {
+        auto grp_id = bench_grp_id(idx);
+        ASSERT_TRUE(cache->add_repl_group(0, grp_id, grp_id + 0x10000, grp_id + 0x20000));
+        ndi_mc_grp_mbr_t rpf_mbr{rpf_rif_id, {1, &port}};
+        ASSERT_TRUE(cache->add_rpf_group_member(0, grp_id, grp_id + 0x30000, rpf_mbr));
+    }
+    for (size_t idx = 0; idx < bench_entry_cnt; idx ++) {
+        ASSERT_TRUE(cache->add_ipmc_entry(0, bench_sg_entry(idx)));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> lookup_cnt{0}, miss_cnt{0}, churn_cnt{0}, churn_fail{0};
+    std::vector<std::thread> threads{};
+    for (size_t tid = 0; tid < bench_reader_cnt; tid ++) {
+        threads.emplace_back([&, tid]() {
+            size_t cnt = 0, miss = 0, idx = tid;
+            while (!stop.load(std::memory_order_relaxed)) {
+                idx = (idx * 1103515245 + 12345) % bench_entry_cnt;
+                auto entry = bench_sg_entry(idx);
+                auto exp_grp_id = entry.repl_group_id;
+                entry.repl_group_id = 0;
+                ndi_obj_id_t rpf_grp_id, ipmc_grp_id;
+                if (!cache->get_ipmc_entry(0, entry) || entry.repl_group_id != exp_grp_id ||
+                    !cache->get_sub_group_id(0, exp_grp_id, rpf_grp_id, ipmc_grp_id)) {
+                    miss ++;
+                }
+                cnt ++;
+            }
+            lookup_cnt += cnt;
+            miss_cnt += miss;
+        });
+    }
+    for (size_t tid = 0; tid < bench_churn_cnt; tid ++) {
+        threads.emplace_back([&, tid]() {
+            size_t cnt = 0, fail = 0, grp_idx = tid;
+            ndi_sw_port_t mbr_port{};
+            mbr_port.port_type = NDI_SW_PORT_NPU_PORT;
+            mbr_port.u.npu_port.npu_port = tid;
+            ndi_mc_grp_mbr_t mbr{bench_churn_rif_id + tid, {1, &mbr_port}};
+            while (!stop.load(std::memory_order_relaxed)) {
+                grp_idx = (grp_idx + bench_churn_cnt) % bench_grp_cnt;
+                auto grp_id = bench_grp_id(grp_idx);
+                auto entry = bench_sg_entry(bench_entry_cnt * (tid + 1) + grp_idx);
+                entry.repl_group_id = grp_id;
+                // Join
+                fail += !cache->add_ipmc_group_member(0, grp_id, grp_id + 0x40000, mbr);
+                fail += !cache->add_ipmc_entry(0, entry);
+                // Prune
+                fail += !cache->del_ipmc_entry(0, entry);
+                fail += !cache->del_group_member(0, grp_id, NDI_IPMC_GRP_MBR, mbr.rif_id);
+                cnt ++;
+            }
+            churn_cnt += cnt;
+            churn_fail += fail;
+        });
+    }
+
+    auto duration = std::chrono::seconds(1);
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    std::cout << "IPMC cache: " << bench_entry_cnt << " entries, "
+              << bench_reader_cnt << " readers " << lookup_cnt / duration.count() << " lookups/s, "
+              << bench_churn_cnt << " writers " << churn_cnt / duration.count() << " join/prune/s"
+              << std::endl;
+    ASSERT_EQ(miss_cnt, 0);
+    ASSERT_EQ(churn_fail, 0);
+    for (size_t idx = 0; idx < bench_grp_cnt; idx ++) {
+        ASSERT_TRUE(cache->get_group_member_list(0, bench_grp_id(idx), NDI_IPMC_GRP_MBR).empty());
+        ASSERT_TRUE(cache->is_repl_group_used(0, bench_grp_id(idx)));
+    }
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_mac_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_mac.h"
+#include "nas_ndi_mac_utl.h"
+#include "nas_ndi_utils.h"
+#include "nas_ndi_fdb_shadow.h"
+#include "nas_ndi_obj_cache.h"
+#include "sai.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/* FDB entries as SAI has them, a flush reports the entries it removes as
+ * flushed FDB events */
+typedef struct {
+    sai_object_id_t bv_id;
+    sai_object_id_t brport_id;
+    uint8_t mac_lo;
+} ut_hw_entry_t;
+
+static std::vector<ut_hw_entry_t> ut_hw_fdb;
+/* Flushed events reported from within one SAI flush, the rest are kept in
+ * ut_late_events for the test to report later */
+static size_t ut_flush_event_max = 0;
+static std::vector<ut_hw_entry_t> ut_late_events;
+
+static void ut_send_events(sai_fdb_event_t event_type, const std::vector<ut_hw_entry_t> & entries)
+{
+    std::vector<sai_fdb_event_notification_data_t> data(entries.size());
+    std::vector<sai_attribute_t> attrs(2 * entries.size());
+    for (size_t ix = 0; ix < entries.size(); ++ix) {
+        memset(&data[ix], 0, sizeof(data[ix]));
+        data[ix].event_type = event_type;
+        data[ix].fdb_entry.bv_id = entries[ix].bv_id;
+        data[ix].fdb_entry.mac_address[5] = entries[ix].mac_lo;
+        data[ix].attr = &attrs[2 * ix];
+        data[ix].attr_count = 2;
+        memset(data[ix].attr, 0, 2 * sizeof(sai_attribute_t));
+        data[ix].attr[0].id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
+        data[ix].attr[0].value.oid = entries[ix].brport_id;
+        data[ix].attr[1].id = SAI_FDB_ENTRY_ATTR_TYPE;
+        data[ix].attr[1].value.s32 = SAI_FDB_ENTRY_TYPE_DYNAMIC;
+    }
+    ndi_fdb_event_cb(data.size(), data.data());
+}
+
+/* SAI FDB API, counts the calls and records the flush attributes */
+static size_t ut_set_cnt = 0;
+static size_t ut_get_cnt = 0;
+static std::vector<sai_object_id_t> ut_flush_brports;
+static std::vector<sai_object_id_t> ut_flush_bv_ids;
+
+static sai_status_t ut_set_fdb_entry_attribute(const sai_fdb_entry_t *fdb_entry,
+                                               const sai_attribute_t *attr)
+{
+    ut_set_cnt++;
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t ut_get_fdb_entry_attribute(const sai_fdb_entry_t *fdb_entry,
+                                               uint32_t attr_count, sai_attribute_t *attr_list)
+{
+    ut_get_cnt++;
+    return SAI_STATUS_ITEM_NOT_FOUND;
+}
+
+static sai_status_t ut_flush_fdb_entries(sai_object_id_t switch_id, uint32_t attr_count,
+                                         const sai_attribute_t *attr_list)
+{
+    sai_object_id_t brport = SAI_NULL_OBJECT_ID;
+    sai_object_id_t bv_id = SAI_NULL_OBJECT_ID;
+    for (uint32_t ix = 0; ix < attr_count; ++ix) {
+        if (attr_list[ix].id == SAI_FDB_FLUSH_ATTR_BRIDGE_PORT_ID) {
+            brport = attr_list[ix].value.oid;
+        } else if (attr_list[ix].id == SAI_FDB_FLUSH_ATTR_BV_ID) {
+            bv_id = attr_list[ix].value.oid;
+        }
+    }
+    ut_flush_brports.push_back(brport);
+    ut_flush_bv_ids.push_back(bv_id);
+
+    std::vector<ut_hw_entry_t> flushed;
+    for (auto it = ut_hw_fdb.begin(); it != ut_hw_fdb.end(); ) {
+        if (((brport != SAI_NULL_OBJECT_ID) && (it->brport_id != brport)) ||
+            ((bv_id != SAI_NULL_OBJECT_ID) && (it->bv_id != bv_id))) {
+            ++it;
+            continue;
+        }
+        if (flushed.size() < ut_flush_event_max) {
+            flushed.push_back(*it);
+        } else {
+            ut_late_events.push_back(*it);
+        }
+        it = ut_hw_fdb.erase(it);
+    }
+    /* SAI reports the flushed entries in one notification */
+    if (!flushed.empty()) {
+        ut_send_events(SAI_FDB_EVENT_FLUSHED, flushed);
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+/* MAC events that reached NAS */
+static size_t ut_notify_cnt = 0;
+static ndi_switch_notification_t ut_switch_notification;
+
+static void ut_mac_event_cb(npu_id_t npu_id, ndi_mac_event_type_t ev_type,
+                            ndi_mac_entry_t *mac_entry, bool is_lag_index)
+{
+    ut_notify_cnt++;
+}
+
+static sai_fdb_api_t ut_fdb_api;
+
+static bool ut_seed_fn()
+{
+    return true;
+}
+
+static void ut_mac_setup()
+{
+    ASSERT_EQ(ndi_db_global_tbl_alloc(1), STD_ERR_OK);
+    auto ndi_db_ptr = ndi_db_ptr_get(0);
+    ASSERT_NE(ndi_db_ptr, nullptr);
+
+    memset(&ut_fdb_api, 0, sizeof(ut_fdb_api));
+    ut_fdb_api.set_fdb_entry_attribute = ut_set_fdb_entry_attribute;
+    ut_fdb_api.get_fdb_entry_attribute = ut_get_fdb_entry_attribute;
+    ut_fdb_api.flush_fdb_entries = ut_flush_fdb_entries;
+    ndi_db_ptr->ndi_sai_api_tbl.n_sai_fdb_api_tbl = &ut_fdb_api;
+
+    memset(&ut_switch_notification, 0, sizeof(ut_switch_notification));
+    ndi_db_ptr->switch_notification = &ut_switch_notification;
+    ASSERT_EQ(ndi_mac_event_notify_register(ut_mac_event_cb), STD_ERR_OK);
+
+    ut_set_cnt = ut_get_cnt = ut_notify_cnt = 0;
+    ut_flush_brports.clear();
+    ut_flush_bv_ids.clear();
+    ut_hw_fdb.clear();
+    ut_late_events.clear();
+    ut_flush_event_max = SIZE_MAX;
+}
+
+/* Seeded shadow, entries are added as if learned */
+static void ut_shadow_setup()
+{
+    ndi_fdb_shadow_seed_fn_set(ut_seed_fn);
+    ndi_fdb_shadow_enable(false);
+    ndi_fdb_shadow_enable(true);
+    ASSERT_TRUE(ndi_fdb_shadow_is_seeded());
+}
+
+static const sai_object_id_t ut_bridge = 0x2600000000001ULL;
+static const sai_object_id_t ut_old_brport = 0x3a00000000001ULL;
+static const sai_object_id_t ut_new_brport = 0x3a00000000002ULL;
+
+static size_t ut_port_count(sai_object_id_t brport)
+{
+    ndi_fdb_shadow_filter_t filter = {brport, SAI_NULL_OBJECT_ID, NDI_FDB_SHADOW_TYPE_ALL};
+    return ndi_fdb_shadow_count(&filter);
+}
+
+TEST(std_nas_ndi_mac_test, ndi_mac_update_shadow) {
+    ut_mac_setup();
+    ut_shadow_setup();
+
+    ndi_fdb_shadow_entry_t shadow;
+    memset(&shadow, 0, sizeof(shadow));
+    shadow.bv_id = ut_bridge;
+    shadow.mac[5] = 0x11;
+    shadow.brport_id = ut_old_brport;
+    shadow.action = SAI_PACKET_ACTION_FORWARD;
+    shadow.is_remote = true;
+    ASSERT_EQ(ndi_fdb_shadow_add(&shadow), STD_ERR_OK);
+
+    /* Move the entry to another bridge port and drop its traffic */
+    ndi_mac_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.npu_id = 0;
+    memcpy(entry.mac_addr, shadow.mac, HAL_MAC_ADDR_LEN);
+    entry.mac_entry_type = NDI_MAC_ENTRY_TYPE_1D_REMOTE;
+    entry.bridge_id = ut_bridge;
+    entry.endpoint_ip_port = ut_new_brport;
+    ASSERT_EQ(ndi_update_mac_entry(&entry, NDI_MAC_ENTRY_ATTR_PORT_ID), STD_ERR_OK);
+    entry.action = BASE_MAC_PACKET_ACTION_DROP;
+    ASSERT_EQ(ndi_update_mac_entry(&entry, NDI_MAC_ENTRY_ATTR_PKT_ACTION), STD_ERR_OK);
+    ASSERT_EQ(ut_set_cnt, 2U);
+
+    /* Get is answered from the shadow with the new port and action */
+    ndi_mac_entry_t get_entry;
+    memset(&get_entry, 0, sizeof(get_entry));
+    get_entry.npu_id = 0;
+    memcpy(get_entry.mac_addr, shadow.mac, HAL_MAC_ADDR_LEN);
+    get_entry.mac_entry_type = NDI_MAC_ENTRY_TYPE_1D_REMOTE;
+    get_entry.bridge_id = ut_bridge;
+    ASSERT_EQ(ndi_get_mac_entry_attr(&get_entry), STD_ERR_OK);
+    ASSERT_EQ(ut_get_cnt, 0U);
+    ASSERT_EQ(get_entry.endpoint_ip_port, ut_new_brport);
+    ASSERT_EQ(get_entry.action, BASE_MAC_PACKET_ACTION_DROP);
+
+    ASSERT_EQ(ut_port_count(ut_old_brport), 0U);
+    ASSERT_EQ(ut_port_count(ut_new_brport), 1U);
+
+    /* Old port has nothing left, new port flush must reach SAI */
+    ASSERT_EQ(ndi_flush_bridge_port_entry(ut_old_brport), STD_ERR_OK);
+    ASSERT_TRUE(ut_flush_brports.empty());
+    ASSERT_EQ(ndi_flush_bridge_port_entry(ut_new_brport), STD_ERR_OK);
+    ASSERT_EQ(ut_flush_brports.size(), 1U);
+    ASSERT_EQ(ut_flush_brports[0], ut_new_brport);
+    ASSERT_EQ(ut_port_count(ut_new_brport), 0U);
+
+    ndi_fdb_shadow_enable(false);
+}
+
+/* LAGs in the flush requests with their bridge ports, and the VLANs */
+static const sai_object_id_t ut_lag_a = 0x2000000000001ULL;
+static const sai_object_id_t ut_lag_b = 0x2000000000002ULL;
+static const sai_object_id_t ut_brport_a = 0x3a00000000011ULL;
+static const sai_object_id_t ut_brport_b = 0x3a00000000012ULL;
+static const sai_object_id_t ut_brport_c = 0x3a00000000013ULL;
+static const sai_object_id_t ut_vlan_10 = 0x2600000000010ULL;
+static const sai_object_id_t ut_vlan_11 = 0x2600000000011ULL;
+
+static void ut_flush_setup()
+{
+    static bool cache_done = false;
+    if (!cache_done) {
+        const sai_object_id_t lags[] = {ut_lag_a, ut_lag_b};
+        const sai_object_id_t brports[] = {ut_brport_a, ut_brport_b};
+        for (size_t ix = 0; ix < 2; ++ix) {
+            ndi_brport_obj_t brport_obj;
+            memset(&brport_obj, 0, sizeof(brport_obj));
+            brport_obj.brport_obj_id = brports[ix];
+            brport_obj.port_obj_id = lags[ix];
+            brport_obj.port_type = ndi_port_type_LAG;
+            brport_obj.brport_type = ndi_brport_type_PORT;
+            ASSERT_TRUE(nas_ndi_add_bridge_port_obj(&brport_obj));
+        }
+        /* VLAN 12 is not created */
+        ndi_virtual_obj_t obj = {ut_vlan_10, 10};
+        ASSERT_TRUE(nas_ndi_add_virtual_obj(&obj));
+        obj = {ut_vlan_11, 11};
+        ASSERT_TRUE(nas_ndi_add_virtual_obj(&obj));
+        cache_done = true;
+    }
+    ut_mac_setup();
+}
+
+/* Learned entries, in SAI and in the shadow */
+static void ut_fdb_learn(const std::vector<ut_hw_entry_t> & entries)
+{
+    for (auto & hw : entries) {
+        ut_hw_fdb.push_back(hw);
+        ndi_fdb_shadow_entry_t shadow;
+        memset(&shadow, 0, sizeof(shadow));
+        shadow.bv_id = hw.bv_id;
+        shadow.mac[5] = hw.mac_lo;
+        shadow.brport_id = hw.brport_id;
+        shadow.action = SAI_PACKET_ACTION_FORWARD;
+        if (ndi_fdb_shadow_is_enabled()) {
+            ASSERT_EQ(ndi_fdb_shadow_add(&shadow), STD_ERR_OK);
+        }
+    }
+}
+
+static size_t ut_cmpl_cnt = 0;
+static ndi_mac_flush_result_t ut_cmpl_result;
+
+static void ut_flush_cmpl(const ndi_mac_flush_req_t *req, const ndi_mac_flush_result_t *result,
+                          void *cookie)
+{
+    ut_cmpl_cnt++;
+    ut_cmpl_result = *result;
+}
+
+static t_std_error ut_flush(const std::vector<sai_object_id_t> & lags, hal_vlan_id_t vlan_min,
+                            hal_vlan_id_t vlan_max)
+{
+    std::vector<ndi_mac_flush_port_t> port_list(lags.size());
+    for (size_t ix = 0; ix < lags.size(); ++ix) {
+        memset(&port_list[ix], 0, sizeof(port_list[ix]));
+        port_list[ix].ndi_lag_id = lags[ix];
+    }
+    ndi_mac_flush_req_t req;
+    memset(&req, 0, sizeof(req));
+    req.npu_id = 0;
+    req.port_list = port_list.data();
+    req.port_count = port_list.size();
+    req.vlan_min = vlan_min;
+    req.vlan_max = vlan_max;
+
+    ut_cmpl_cnt = 0;
+    memset(&ut_cmpl_result, 0, sizeof(ut_cmpl_result));
+    /* Async mode is not started, the flush completes in this thread */
+    return ndi_mac_flush_async(&req, ut_flush_cmpl, NULL);
+}
+
+TEST(std_nas_ndi_mac_test, ndi_mac_flush_cross_product) {
+    ut_flush_setup();
+    ut_shadow_setup();
+
+    ut_fdb_learn({{ut_vlan_10, ut_brport_a, 1}, {ut_vlan_10, ut_brport_a, 2},
+                  {ut_vlan_11, ut_brport_a, 3}, {ut_vlan_10, ut_brport_b, 4},
+                  {ut_vlan_10, ut_brport_c, 5}});
+
+    /* 2 ports by VLANs 10 to 12, VLAN 12 does not exist */
+    ASSERT_EQ(ut_flush({ut_lag_a, ut_lag_b}, 10, 12), STD_ERR_OK);
+    ASSERT_EQ(ut_cmpl_cnt, 1U);
+    ASSERT_EQ(ut_cmpl_result.rc, STD_ERR_OK);
+    ASSERT_EQ(ut_cmpl_result.sai_flush_count, 4U);
+    ASSERT_TRUE(ut_cmpl_result.entry_count_known);
+    ASSERT_EQ(ut_cmpl_result.entry_count, 4U);
+
+    /* Port B has nothing in VLAN 11, its SAI flush is skipped */
+    std::vector<std::pair<sai_object_id_t, sai_object_id_t>> pairs;
+    for (size_t ix = 0; ix < ut_flush_brports.size(); ++ix) {
+        pairs.push_back({ut_flush_brports[ix], ut_flush_bv_ids[ix]});
+    }
+    std::vector<std::pair<sai_object_id_t, sai_object_id_t>> want =
+        {{ut_brport_a, ut_vlan_10}, {ut_brport_a, ut_vlan_11}, {ut_brport_b, ut_vlan_10}};
+    ASSERT_EQ(pairs, want);
+
+    /* Flushed events are reported in the completion only */
+    ASSERT_EQ(ut_notify_cnt, 0U);
+    ASSERT_EQ(ut_port_count(ut_brport_a), 0U);
+    ASSERT_EQ(ut_port_count(ut_brport_b), 0U);
+    ASSERT_EQ(ut_port_count(ut_brport_c), 1U);
+    ASSERT_EQ(ut_hw_fdb.size(), 1U);
+
+    /* All pairs have ended, later events go to NAS */
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_10, ut_brport_a, 1}});
+    ASSERT_EQ(ut_notify_cnt, 1U);
+
+    ndi_fdb_shadow_enable(false);
+}
+
+TEST(std_nas_ndi_mac_test, ndi_mac_flush_pair_expected) {
+    ut_flush_setup();
+    ut_shadow_setup();
+
+    ut_fdb_learn({{ut_vlan_10, ut_brport_a, 1}, {ut_vlan_10, ut_brport_a, 2},
+                  {ut_vlan_11, ut_brport_a, 3}, {ut_vlan_10, ut_brport_b, 4}});
+
+    /* SAI reports one entry of each pair during the flush */
+    ut_flush_event_max = 1;
+    ASSERT_EQ(ut_flush({ut_lag_a, ut_lag_b}, 10, 11), STD_ERR_OK);
+    ASSERT_EQ(ut_cmpl_cnt, 1U);
+    ASSERT_TRUE(ut_cmpl_result.entry_count_known);
+    ASSERT_EQ(ut_cmpl_result.entry_count, 4U);
+    ASSERT_EQ(ut_notify_cnt, 0U);
+    ASSERT_EQ(ut_late_events.size(), 1U);
+
+    /* Port A VLAN 11 has seen its one entry and ended, VLAN 10 waits for one more */
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_11, ut_brport_a, 3}});
+    ASSERT_EQ(ut_notify_cnt, 1U);
+    ut_send_events(SAI_FDB_EVENT_FLUSHED, ut_late_events);
+    ASSERT_EQ(ut_notify_cnt, 1U);
+    ut_send_events(SAI_FDB_EVENT_AGED, ut_late_events);
+    ASSERT_EQ(ut_notify_cnt, 2U);
+
+    ndi_fdb_shadow_enable(false);
+}
+
+TEST(std_nas_ndi_mac_test, ndi_mac_flush_uncounted) {
+    ut_flush_setup();
+    ndi_fdb_shadow_enable(false);
+
+    ut_fdb_learn({{ut_vlan_10, ut_brport_a, 1}, {ut_vlan_10, ut_brport_a, 2}});
+
+    /* Completes once SAI is done, without waiting for the end of the pair */
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(ut_flush({ut_lag_a}, 10, 10), STD_ERR_OK);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    ASSERT_EQ(ut_cmpl_cnt, 1U);
+    ASSERT_EQ(ut_flush_brports.size(), 1U);
+    ASSERT_FALSE(ut_cmpl_result.entry_count_known);
+    ASSERT_EQ(ut_cmpl_result.entry_count, 0U);
+    ASSERT_EQ(ut_notify_cnt, 0U);
+
+    /* Events of the pair are held back until SAI ends the flush */
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_10, ut_brport_a, 9}});
+    ASSERT_EQ(ut_notify_cnt, 0U);
+    ut_send_events(SAI_FDB_EVENT_FLUSHED, {{ut_vlan_10, ut_brport_a, 0}});
+    ASSERT_EQ(ut_notify_cnt, 0U);
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_10, ut_brport_a, 9}});
+    ASSERT_EQ(ut_notify_cnt, 1U);
+}
+
+TEST(std_nas_ndi_mac_test, ndi_mac_flush_drain_timeout) {
+    ut_flush_setup();
+    ndi_fdb_shadow_enable(false);
+
+    /* SAI never ends the flush */
+    ASSERT_EQ(ut_flush({ut_lag_a}, 11, 11), STD_ERR_OK);
+    ASSERT_EQ(ut_cmpl_cnt, 1U);
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_11, ut_brport_a, 1}});
+    ASSERT_EQ(ut_notify_cnt, 0U);
+
+    /* Tracking stops at the drain time */
+    std::this_thread::sleep_for(std::chrono::seconds(6));
+    ut_send_events(SAI_FDB_EVENT_AGED, {{ut_vlan_11, ut_brport_a, 1}});
+    ASSERT_EQ(ut_notify_cnt, 1U);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -21,6 +21,14 @@
 #include <gtest/gtest.h>
 #include "nas_ndi_obj_cache.h"
 #include "nas_ndi_obj_cache_utils.h"
+#include "nas_ndi_checkpoint.h"
+#include "nas_ndi_vlan_mbr_cache.h"
+#include "nas_ndi_tunnel_map.h"
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 using namespace std;
 
 
@@ -135,6 +143,243 @@ TEST(std_nas_ndi_obj_cache_test, ndi_virtual_obj_cache_test) {
 
 }
 
+TEST(std_nas_ndi_obj_cache_test, ndi_checkpoint_test) {
+
+    const char *ckpt_file = "/tmp/nas_ndi_obj_cache_ut.ckpt";
+
+    ndi_brport_obj_t port_obj;
+    memset(&port_obj, 0, sizeof(port_obj));
+    port_obj.brport_obj_id = 300;
+    port_obj.port_obj_id = 5000;
+    port_obj.brport_type = ndi_brport_type_PORT;
+
+    ASSERT_TRUE(nas_ndi_add_bridge_port_obj(&port_obj));
+    ASSERT_EQ(nas_ndi_checkpoint_save(ckpt_file), STD_ERR_OK);
+    ASSERT_TRUE(nas_ndi_remove_bridge_port_obj(&port_obj));
+
+    ndi_brport_obj_t obj_get;
+    obj_get.brport_obj_id = 300;
+    ASSERT_FALSE(nas_ndi_get_bridge_port_obj(&obj_get, ndi_brport_query_type_FROM_BRPORT));
+
+    ASSERT_EQ(nas_ndi_checkpoint_restore(ckpt_file), STD_ERR_OK);
+    ASSERT_TRUE(nas_ndi_get_bridge_port_obj(&obj_get, ndi_brport_query_type_FROM_BRPORT));
+    ASSERT_EQ(obj_get.port_obj_id, 5000);
+
+    /* Checkpoint is consumed by the restore */
+    ASSERT_NE(access(ckpt_file, F_OK), 0);
+    ASSERT_NE(nas_ndi_checkpoint_restore(ckpt_file), STD_ERR_OK);
+
+    ASSERT_TRUE(nas_ndi_remove_bridge_port_obj(&port_obj));
+}
+
+TEST(std_nas_ndi_obj_cache_test, ndi_checkpoint_rollback_test) {
+
+    const char *ckpt_file = "/tmp/nas_ndi_obj_cache_ut_rollback.ckpt";
+
+    ndi_brport_obj_t port_obj;
+    memset(&port_obj, 0, sizeof(port_obj));
+    port_obj.brport_obj_id = 310;
+    port_obj.port_obj_id = 5010;
+    port_obj.brport_type = ndi_brport_type_PORT;
+
+    hal_ip_addr_t loc_ip, rem_ip;
+    memset(&loc_ip, 0, sizeof(loc_ip));
+    memset(&rem_ip, 0, sizeof(rem_ip));
+    loc_ip.af_index = AF_INET;
+    loc_ip.u.v4_addr = 0x01010c0a;
+    rem_ip.af_index = AF_INET;
+    rem_ip.u.v4_addr = 0x01010c0b;
+
+    ASSERT_TRUE(nas_ndi_add_bridge_port_obj(&port_obj));
+    ASSERT_TRUE(insert_tunnel_obj(&rem_ip, &loc_ip, new TunnelObj(11, 12, 13, 14, loc_ip, rem_ip)));
+    ASSERT_EQ(nas_ndi_checkpoint_save(ckpt_file), STD_ERR_OK);
+    ASSERT_TRUE(nas_ndi_remove_bridge_port_obj(&port_obj));
+
+    /* Tunnel left in the cache makes the tunnel restore fail after the
+     * bridge port was restored */
+    ASSERT_NE(nas_ndi_checkpoint_restore(ckpt_file), STD_ERR_OK);
+
+    ndi_brport_obj_t obj_get;
+    obj_get.brport_obj_id = 310;
+    ASSERT_FALSE(nas_ndi_get_bridge_port_obj(&obj_get, ndi_brport_query_type_FROM_BRPORT));
+    ASSERT_TRUE(has_tunnel_obj(&rem_ip, &loc_ip));
+    ASSERT_EQ(get_tunnel_obj(&rem_ip, &loc_ip)->get_tun_oid(), 11);
+    ASSERT_NE(access(ckpt_file, F_OK), 0);
+
+    remove_tunnel_obj(&rem_ip, &loc_ip);
+}
+
+TEST(std_nas_ndi_obj_cache_test, ndi_checkpoint_vlan_mbr_test) {
+
+    const char *ckpt_file = "/tmp/nas_ndi_obj_cache_ut_vlan_mbr.ckpt";
+
+    std::vector<ndi_vlan_mbr_info_t> mbrs;
+    for (sai_object_id_t port = 0x1000; port < 0x1010; ++port) {
+        for (hal_vlan_id_t vlan = 1; vlan <= 20; ++vlan) {
+            mbrs.push_back({vlan, port, 0x2700000000ULL + port * 4096 + vlan,
+                            (vlan % 2) ? SAI_VLAN_TAGGING_MODE_TAGGED :
+                                         SAI_VLAN_TAGGING_MODE_UNTAGGED});
+        }
+    }
+    ndi_vlan_mbr_info_t npu1_mbr = {100, 0x2000, 0x2700000001ULL, SAI_VLAN_TAGGING_MODE_TAGGED};
+
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(1, &npu1_mbr, 1), STD_ERR_OK);
+    ASSERT_EQ(nas_ndi_checkpoint_save(ckpt_file), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(1, &npu1_mbr, 1), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_vlan_get(0, 1, NULL, 0), 0);
+
+    ASSERT_EQ(nas_ndi_checkpoint_restore(ckpt_file), STD_ERR_OK);
+    for (auto &mbr: mbrs) {
+        sai_object_id_t member_id = 0;
+        sai_vlan_tagging_mode_t mode;
+        ASSERT_EQ(ndi_vlan_mbr_cache_get(0, mbr.vlan_id, mbr.port_id, &member_id, &mode),
+                  STD_ERR_OK);
+        ASSERT_EQ(member_id, mbr.member_id);
+        ASSERT_EQ(mode, mbr.tagging_mode);
+    }
+    ASSERT_EQ(ndi_vlan_mbr_cache_vlan_get(0, 1, NULL, 0), 16);
+    ASSERT_EQ(ndi_vlan_mbr_cache_get(1, 100, 0x2000, NULL, NULL), STD_ERR_OK);
+    ASSERT_NE(ndi_vlan_mbr_cache_get(0, 100, 0x2000, NULL, NULL), STD_ERR_OK);
+
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(1, &npu1_mbr, 1), STD_ERR_OK);
+}
+
+TEST(std_nas_ndi_obj_cache_test, ndi_virtual_obj_table_test) {
+
+    ndi_virtual_obj_t obj, obj_get;
+
+    for (hal_vlan_id_t vid = 1; vid < 4095; ++vid) {
+        obj.oid = 0x26000000000ULL + vid;
+        obj.vid = vid;
+        ASSERT_TRUE(nas_ndi_add_virtual_obj(&obj));
+    }
+    for (hal_vlan_id_t vid = 1; vid < 4095; ++vid) {
+        obj_get.oid = 0x26000000000ULL + vid;
+        ASSERT_TRUE(nas_ndi_get_virtual_obj(&obj_get, ndi_virtual_obj_query_type_FROM_OBJ));
+        ASSERT_EQ(obj_get.vid, vid);
+        obj_get.vid = vid;
+        ASSERT_TRUE(nas_ndi_get_virtual_obj(&obj_get, ndi_virtual_obj_query_type_FROM_VLAN));
+        ASSERT_EQ(obj_get.oid, 0x26000000000ULL + vid);
+    }
+
+    /* New oid for a VLAN id replaces the old mapping */
+    obj.oid = 0x26000001000ULL;
+    obj.vid = 100;
+    ASSERT_TRUE(nas_ndi_add_virtual_obj(&obj));
+    obj_get.oid = 0x26000000000ULL + 100;
+    ASSERT_FALSE(nas_ndi_get_virtual_obj(&obj_get, ndi_virtual_obj_query_type_FROM_OBJ));
+    obj_get.vid = 100;
+    ASSERT_TRUE(nas_ndi_get_virtual_obj(&obj_get, ndi_virtual_obj_query_type_FROM_VLAN));
+    ASSERT_EQ(obj_get.oid, obj.oid);
+    ASSERT_TRUE(nas_ndi_remove_virtual_obj(&obj));
+
+    for (hal_vlan_id_t vid = 1; vid < 4095; ++vid) {
+        obj.oid = 0x26000000000ULL + vid;
+        ASSERT_EQ(nas_ndi_remove_virtual_obj(&obj), vid != 100);
+        obj_get.vid = vid;
+        ASSERT_FALSE(nas_ndi_get_virtual_obj(&obj_get, ndi_virtual_obj_query_type_FROM_VLAN));
+    }
+}
+
+TEST(std_nas_ndi_obj_cache_test, ndi_brport_cache_scale_test) {
+
+    const size_t ports = 64, vlans = 256;
+    ndi_brport_obj_t obj;
+    memset(&obj, 0, sizeof(obj));
+
+    for (size_t vid = 1; vid <= vlans; ++vid) {
+        for (size_t port = 0; port < ports; ++port) {
+            obj.brport_obj_id = 0x100000 + port * 0x1000 + vid;
+            obj.port_obj_id = 0x5000 + port;
+            obj.vlan_id = vid;
+            obj.brport_type = ndi_brport_type_SUBPORT_TAG;
+            ASSERT_TRUE(nas_ndi_add_bridge_port_obj(&obj));
+        }
+    }
+
+    /* Remove every other vlan, port chains keep add order */
+    for (size_t vid = 2; vid <= vlans; vid += 2) {
+        for (size_t port = 0; port < ports; ++port) {
+            obj.brport_obj_id = 0x100000 + port * 0x1000 + vid;
+            obj.brport_type = ndi_brport_type_SUBPORT_TAG;
+            ASSERT_TRUE(nas_ndi_remove_bridge_port_obj(&obj));
+            ASSERT_EQ(obj.port_obj_id, 0x5000 + port);
+        }
+    }
+
+    for (size_t port = 0; port < ports; ++port) {
+        brport_list lst;
+        ASSERT_TRUE(nas_ndi_get_bridge_port_obj_list(0x5000 + port, lst));
+        ASSERT_EQ(lst.size(), vlans / 2);
+        size_t vid = 1;
+        for (auto brport : lst) {
+            ASSERT_EQ(brport, 0x100000 + port * 0x1000 + vid);
+            vid += 2;
+        }
+        for (vid = 1; vid <= vlans; ++vid) {
+            ndi_brport_obj_t obj_get;
+            obj_get.port_obj_id = 0x5000 + port;
+            obj_get.vlan_id = vid;
+            ASSERT_EQ(nas_ndi_get_bridge_port_obj(&obj_get, ndi_brport_query_type_FROM_PORT_VLAN),
+                      (vid % 2) == 1);
+        }
+    }
+
+    for (size_t vid = 1; vid <= vlans; vid += 2) {
+        for (size_t port = 0; port < ports; ++port) {
+            obj.brport_obj_id = 0x100000 + port * 0x1000 + vid;
+            ASSERT_TRUE(nas_ndi_remove_bridge_port_obj(&obj));
+        }
+    }
+    brport_list lst;
+    ASSERT_FALSE(nas_ndi_get_bridge_port_obj_list(0x5000, lst));
+}
+
+TEST(std_nas_ndi_obj_cache_test, ndi_brport_cache_concurrent_read_test) {
+
+    const size_t count = 4096;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> bad(0);
+
+    /* Readers must only see complete records while the writer churns */
+    auto reader = [&]() {
+        while (!done) {
+            for (size_t ix = 0; ix < count; ++ix) {
+                ndi_brport_obj_t obj_get;
+                obj_get.brport_obj_id = 0x200000 + ix;
+                if (nas_ndi_get_bridge_port_obj(&obj_get, ndi_brport_query_type_FROM_BRPORT) &&
+                    (obj_get.port_obj_id != 0x6000 + ix || obj_get.vlan_id != ix % 4094 + 1)) {
+                    bad++;
+                }
+            }
+        }
+    };
+    std::thread t1(reader), t2(reader);
+
+    ndi_brport_obj_t obj;
+    memset(&obj, 0, sizeof(obj));
+    for (size_t round = 0; round < 8; ++round) {
+        for (size_t ix = 0; ix < count; ++ix) {
+            obj.brport_obj_id = 0x200000 + ix;
+            obj.port_obj_id = 0x6000 + ix;
+            obj.vlan_id = ix % 4094 + 1;
+            obj.brport_type = ndi_brport_type_SUBPORT_UNTAG;
+            nas_ndi_add_bridge_port_obj(&obj);
+        }
+        for (size_t ix = 0; ix < count; ++ix) {
+            obj.brport_obj_id = 0x200000 + ix;
+            nas_ndi_remove_bridge_port_obj(&obj);
+        }
+    }
+    done = true;
+    t1.join();
+    t2.join();
+    ASSERT_EQ(bad, 0);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
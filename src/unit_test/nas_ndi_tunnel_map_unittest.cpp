@@ -22,6 +22,15 @@
 #include "ds_common_types.h"
 #include "nas_ndi_tunnel_map.h"
 #include "nas_ndi_tunnel_obj.h"
+#include "nas_ndi_utils.h"
+#include "sai.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <set>
+#include <vector>
 
 using namespace std;
 
@@ -95,6 +104,315 @@ TEST(std_nas_tunnel_map, ndi_tunnel_obj_map_test) {
 }
 
 
+TEST(std_nas_tunnel_map, ndi_tunnel_obj_af_key_test) {
+
+    hal_ip_addr_t loc_ip, rem_ip, rem_ip6, key_ip;
+    struct in_addr ins = {0x01010b0a};
+    std_ip_from_inet(&loc_ip,&ins);
+    struct in_addr inr = {0x01010b0b};
+    std_ip_from_inet(&rem_ip,&inr);
+
+    /* IPv6 remote with same leading bytes as the IPv4 one */
+    memset(&rem_ip6, 0, sizeof(rem_ip6));
+    rem_ip6.af_index = AF_INET6;
+    memcpy(rem_ip6.u.v6_addr, &rem_ip.u.v4_addr, sizeof(rem_ip.u.v4_addr));
+
+    ASSERT_TRUE(insert_tunnel_obj(&rem_ip, &loc_ip, new TunnelObj(1, 2, 3, 4, loc_ip, rem_ip)));
+    ASSERT_FALSE(insert_tunnel_obj(&rem_ip, &loc_ip, nullptr));
+    ASSERT_FALSE(has_tunnel_obj(&rem_ip6, &loc_ip));
+    ASSERT_TRUE(insert_tunnel_obj(&rem_ip6, &loc_ip, new TunnelObj(5, 6, 7, 8, loc_ip, rem_ip6)));
+    ASSERT_EQ(get_tunnel_obj(&rem_ip, &loc_ip)->get_tun_oid(), 1);
+    ASSERT_EQ(get_tunnel_obj(&rem_ip6, &loc_ip)->get_tun_oid(), 5);
+
+    /* Bytes after the IPv4 address are not part of the key */
+    key_ip = rem_ip;
+    memset(key_ip.u.v6_addr + sizeof(key_ip.u.v4_addr), 0xff,
+           sizeof(key_ip.u.v6_addr) - sizeof(key_ip.u.v4_addr));
+    ASSERT_TRUE(has_tunnel_obj(&key_ip, &loc_ip));
+
+    remove_tunnel_obj(&rem_ip, &loc_ip);
+    ASSERT_FALSE(has_tunnel_obj(&rem_ip, &loc_ip));
+    ASSERT_TRUE(has_tunnel_obj(&rem_ip6, &loc_ip));
+    remove_tunnel_obj(&rem_ip6, &loc_ip);
+    ASSERT_FALSE(has_tunnel_obj(&rem_ip6, &loc_ip));
+}
+
+TEST(std_nas_tunnel_map, ndi_tunnel_obj_vni_map_test) {
+
+    hal_ip_addr_t loc_ip, rem_ip;
+    struct in_addr ins = {0x01010b0a};
+    std_ip_from_inet(&loc_ip,&ins);
+    struct in_addr inr = {0x01010b0b};
+    std_ip_from_inet(&rem_ip,&inr);
+    TunnelObj obj(1, 2, 3, 4, loc_ip, rem_ip);
+
+    std::vector<sai_object_id_t> br_list = {30, 10, 50, 20, 40};
+    for (auto br_oid: br_list) {
+        ASSERT_TRUE(obj.insert_encap_map_entry(br_oid, br_oid + 1000, br_oid + 2000));
+        ASSERT_TRUE(obj.insert_tunnel_bridge_port(br_oid, br_oid + 1000, br_oid + 3000));
+    }
+    ASSERT_FALSE(obj.insert_encap_map_entry(30, 0, 0));
+    ASSERT_TRUE(obj.insert_decap_map_entry(20, 1020, 4020));
+    ASSERT_EQ(obj.get_tunnel_bridge_ports_size(), br_list.size());
+
+    vni_s_oid_map_t map_val;
+    ASSERT_TRUE(obj.get_encap_map_entry(40, &map_val));
+    ASSERT_EQ(map_val.vni, 1040);
+    ASSERT_EQ(map_val.oid, 2040);
+    ASSERT_FALSE(obj.get_decap_map_entry(40, &map_val));
+    ASSERT_FALSE(obj.get_bridge_port(35, &map_val));
+
+    ASSERT_TRUE(obj.remove_tunnel_bridge_port(10));
+    ASSERT_FALSE(obj.remove_tunnel_bridge_port(10));
+    ASSERT_FALSE(obj.get_bridge_port(10, &map_val));
+    ASSERT_TRUE(obj.get_bridge_port(50, &map_val));
+    ASSERT_EQ(map_val.oid, 3050);
+
+    /* Entries are walked in bridge order */
+    std::vector<sai_object_id_t> encap_list{};
+    size_t entry_cnt = 0;
+    obj.walk_map_entries([&](ndi_tunnel_obj_map_type_t map_type, sai_object_id_t br_oid,
+                             const vni_s_oid_map_t &val) {
+        if (map_type == ndi_tunnel_obj_map_type_ENCAP) encap_list.push_back(br_oid);
+        entry_cnt ++;
+    });
+    ASSERT_EQ(encap_list, std::vector<sai_object_id_t>({10, 20, 30, 40, 50}));
+    ASSERT_EQ(entry_cnt, 10);
+}
+
+static size_t ndi_tunnel_ut_rss_kb()
+{
+    size_t pages = 0, rss = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void ndi_tunnel_ut_vtep_ip(hal_ip_addr_t *ip, size_t idx)
+{
+    memset(ip, 0, sizeof(hal_ip_addr_t));
+    if (idx % 2) {
+        ip->af_index = AF_INET6;
+        ip->u.v6_addr[0] = 0x20;
+        ip->u.v6_addr[1] = 0x01;
+        ip->u.v6_addr[14] = (idx >> 8) & 0xff;
+        ip->u.v6_addr[15] = idx & 0xff;
+    } else {
+        ip->af_index = AF_INET;
+        ip->u.v4_addr = htonl(0x0a000000 + idx);
+    }
+}
+
+/*
+ * Lookup and memory benchmark, 4k remote VTEPs with NDI_TUNNEL_UT_VNI_COUNT
+ * VNIs each, default is 256 VNIs, set it to 4096 for the full scale run.
+ * Bridges are added in a shuffled order, rotated for each VTEP, same as
+ * VNIs configured over time, not in the sorted order of the maps.
+ */
+TEST(std_nas_tunnel_map, ndi_tunnel_obj_bench) {
+
+    const size_t vtep_cnt = 4096;
+    size_t vni_cnt = 256;
+    const char *env_val = getenv("NDI_TUNNEL_UT_VNI_COUNT");
+    if (env_val != nullptr && atoi(env_val) > 0) {
+        vni_cnt = atoi(env_val);
+    }
+
+    hal_ip_addr_t loc_ip, rem_ip;
+    struct in_addr ins = {0x01010b0a};
+    std_ip_from_inet(&loc_ip,&ins);
+
+    std::vector<size_t> vni_order(vni_cnt);
+    for (size_t vni = 0; vni < vni_cnt; vni ++) {
+        vni_order[vni] = vni;
+    }
+    std::mt19937 rng(0x5eed);
+    std::shuffle(vni_order.begin(), vni_order.end(), rng);
+
+    auto rss_start = ndi_tunnel_ut_rss_kb();
+    auto t_start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < vtep_cnt; idx ++) {
+        ndi_tunnel_ut_vtep_ip(&rem_ip, idx);
+        auto obj = new TunnelObj(idx + 1, 0, 0, 0, loc_ip, rem_ip);
+        ASSERT_TRUE(insert_tunnel_obj(&rem_ip, &loc_ip, obj));
+        for (size_t pos = 0; pos < vni_cnt; pos ++) {
+            size_t vni = vni_order[(pos + idx) % vni_cnt];
+            sai_object_id_t br_oid = 0x26000000000000ULL + vni;
+            obj->insert_encap_map_entry(br_oid, vni + 1, br_oid + 1);
+            obj->insert_decap_map_entry(br_oid, vni + 1, br_oid + 2);
+            obj->insert_tunnel_bridge_port(br_oid, vni + 1, br_oid + 3);
+        }
+    }
+    auto t_insert = std::chrono::steady_clock::now();
+    auto rss_end = ndi_tunnel_ut_rss_kb();
+
+    const size_t lookup_cnt = 1000000;
+    vni_s_oid_map_t map_val;
+    size_t found = 0;
+    for (size_t idx = 0; idx < lookup_cnt; idx ++) {
+        size_t vtep_idx = (idx * 7919) % vtep_cnt;
+        sai_object_id_t br_oid = 0x26000000000000ULL + vni_order[(idx * 31) % vni_cnt];
+        ndi_tunnel_ut_vtep_ip(&rem_ip, vtep_idx);
+        auto obj = get_tunnel_obj(&rem_ip, &loc_ip);
+        if (obj != nullptr && obj->get_bridge_port(br_oid, &map_val) &&
+            map_val.oid == br_oid + 3) {
+            found ++;
+        }
+    }
+    auto t_lookup = std::chrono::steady_clock::now();
+    ASSERT_EQ(found, lookup_cnt);
+
+    for (size_t idx = 0; idx < vtep_cnt; idx ++) {
+        ndi_tunnel_ut_vtep_ip(&rem_ip, idx);
+        remove_tunnel_obj(&rem_ip, &loc_ip);
+        ASSERT_FALSE(has_tunnel_obj(&rem_ip, &loc_ip));
+    }
+
+    cout << "VTEPs " << vtep_cnt << " VNIs " << vni_cnt << " (shuffled bridge order)"
+         << " memory " << (rss_end - rss_start) / 1024 << " MB"
+         << " insert " << std::chrono::duration_cast<std::chrono::milliseconds>(t_insert - t_start).count()
+         << " ms, lookup "
+         << std::chrono::duration_cast<std::chrono::nanoseconds>(t_lookup - t_insert).count() / lookup_cnt
+         << " ns" << endl;
+}
+
+/* SAI tunnel, bridge and FDB APIs for the remote endpoint batch test */
+static std::set<sai_object_id_t> ut_sai_objs;
+static sai_object_id_t ut_sai_next_oid = 0x50000;
+static sai_object_id_t ut_fail_bridge_oid = 0;
+static size_t ut_tunnel_create_cnt = 0;
+
+static sai_status_t ut_sai_create(sai_object_id_t *oid, sai_object_id_t switch_id,
+                                  uint32_t attr_count, const sai_attribute_t *attr_list)
+{
+    *oid = ut_sai_next_oid++;
+    ut_sai_objs.insert(*oid);
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t ut_sai_remove(sai_object_id_t oid)
+{
+    return (ut_sai_objs.erase(oid) == 1) ? SAI_STATUS_SUCCESS : SAI_STATUS_ITEM_NOT_FOUND;
+}
+
+static sai_status_t ut_sai_create_tunnel(sai_object_id_t *oid, sai_object_id_t switch_id,
+                                         uint32_t attr_count, const sai_attribute_t *attr_list)
+{
+    ut_tunnel_create_cnt++;
+    return ut_sai_create(oid, switch_id, attr_count, attr_list);
+}
+
+static sai_status_t ut_sai_create_bridge_port(sai_object_id_t *oid, sai_object_id_t switch_id,
+                                              uint32_t attr_count, const sai_attribute_t *attr_list)
+{
+    for (uint32_t idx = 0; idx < attr_count; idx++) {
+        if ((attr_list[idx].id == SAI_BRIDGE_PORT_ATTR_BRIDGE_ID) &&
+            (attr_list[idx].value.oid == ut_fail_bridge_oid)) {
+            return SAI_STATUS_INSUFFICIENT_RESOURCES;
+        }
+    }
+    return ut_sai_create(oid, switch_id, attr_count, attr_list);
+}
+
+static sai_status_t ut_sai_set_bridge_port_attr(sai_object_id_t oid, const sai_attribute_t *attr)
+{
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t ut_sai_flush_fdb_entries(sai_object_id_t switch_id, uint32_t attr_count,
+                                             const sai_attribute_t *attr_list)
+{
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_tunnel_api_t ut_tunnel_api;
+static sai_bridge_api_t ut_bridge_api;
+static sai_fdb_api_t ut_fdb_api;
+
+TEST(std_nas_tunnel_map, ndi_tunnel_add_remote_endpoints) {
+    ASSERT_EQ(ndi_db_global_tbl_alloc(1), STD_ERR_OK);
+    auto ndi_db_ptr = ndi_db_ptr_get(0);
+    ASSERT_NE(ndi_db_ptr, nullptr);
+
+    memset(&ut_tunnel_api, 0, sizeof(ut_tunnel_api));
+    ut_tunnel_api.create_tunnel_map = ut_sai_create;
+    ut_tunnel_api.remove_tunnel_map = ut_sai_remove;
+    ut_tunnel_api.create_tunnel = ut_sai_create_tunnel;
+    ut_tunnel_api.remove_tunnel = ut_sai_remove;
+    ut_tunnel_api.create_tunnel_term_table_entry = ut_sai_create;
+    ut_tunnel_api.remove_tunnel_term_table_entry = ut_sai_remove;
+    ut_tunnel_api.create_tunnel_map_entry = ut_sai_create;
+    ut_tunnel_api.remove_tunnel_map_entry = ut_sai_remove;
+    memset(&ut_bridge_api, 0, sizeof(ut_bridge_api));
+    ut_bridge_api.create_bridge_port = ut_sai_create_bridge_port;
+    ut_bridge_api.remove_bridge_port = ut_sai_remove;
+    ut_bridge_api.set_bridge_port_attribute = ut_sai_set_bridge_port_attr;
+    memset(&ut_fdb_api, 0, sizeof(ut_fdb_api));
+    ut_fdb_api.flush_fdb_entries = ut_sai_flush_fdb_entries;
+    ndi_db_ptr->ndi_sai_api_tbl.n_sai_tunnel_api_tbl = &ut_tunnel_api;
+    ndi_db_ptr->ndi_sai_api_tbl.n_sai_bridge_api_tbl = &ut_bridge_api;
+    ndi_db_ptr->ndi_sai_api_tbl.n_sai_fdb_api_tbl = &ut_fdb_api;
+
+    hal_ip_addr_t loc_ip, rem_ip1, rem_ip2;
+    struct in_addr ins = {0x01010d0a};
+    std_ip_from_inet(&loc_ip, &ins);
+    struct in_addr inr = {0x01010d0b};
+    std_ip_from_inet(&rem_ip1, &inr);
+    inr = {0x01010d0c};
+    std_ip_from_inet(&rem_ip2, &inr);
+
+    const ndi_obj_id_t bridge1 = 0x2600000000001ULL;
+    const ndi_obj_id_t bridge2 = 0x2600000000002ULL;
+    const ndi_obj_id_t bridge3 = 0x2600000000003ULL;
+    ut_fail_bridge_oid = bridge2;
+
+    /* Endpoints 0, 1 and 3 share the tunnel to rem_ip1, endpoints 1 and 2
+     * fail in the bridge port phase after their map entries were created */
+    ndi_tunnel_endpoint_t ep_list[] = {
+        {rem_ip1, loc_ip, 1001, bridge1, 0},
+        {rem_ip1, loc_ip, 1002, bridge2, 0},
+        {rem_ip2, loc_ip, 1002, bridge2, 0},
+        {rem_ip1, loc_ip, 1003, bridge3, 0},
+    };
+    const size_t ep_cnt = sizeof(ep_list) / sizeof(ep_list[0]);
+    t_std_error rc_list[ep_cnt];
+
+    ASSERT_NE(nas_ndi_add_remote_endpoints(0, 0x3000000000001ULL, 0x6000000000001ULL,
+                                           ep_list, ep_cnt, rc_list), STD_ERR_OK);
+    ASSERT_EQ(rc_list[0], STD_ERR_OK);
+    ASSERT_NE(rc_list[1], STD_ERR_OK);
+    ASSERT_NE(rc_list[2], STD_ERR_OK);
+    ASSERT_EQ(rc_list[3], STD_ERR_OK);
+    ASSERT_EQ(ep_list[1].tun_brport_oid, 0U);
+    ASSERT_EQ(ep_list[2].tun_brport_oid, 0U);
+    ASSERT_NE(ep_list[0].tun_brport_oid, 0U);
+    ASSERT_NE(ep_list[3].tun_brport_oid, 0U);
+    ASSERT_NE(ep_list[0].tun_brport_oid, ep_list[3].tun_brport_oid);
+
+    /* Shared tunnel is created once and keeps the endpoints that succeeded */
+    ASSERT_EQ(ut_tunnel_create_cnt, 2U);
+    TunnelObj *obj = get_tunnel_obj(&rem_ip1, &loc_ip);
+    ASSERT_NE(obj, nullptr);
+    ASSERT_EQ(obj->get_tunnel_bridge_ports_size(), 2);
+    vni_s_oid_map_t map_val;
+    ASSERT_TRUE(obj->get_bridge_port(bridge1, &map_val));
+    ASSERT_EQ(map_val.oid, ep_list[0].tun_brport_oid);
+    ASSERT_FALSE(obj->get_bridge_port(bridge2, &map_val));
+    ASSERT_TRUE(obj->get_bridge_port(bridge3, &map_val));
+
+    /* Tunnel left with no bridge port is removed with its SAI objects */
+    ASSERT_FALSE(has_tunnel_obj(&rem_ip2, &loc_ip));
+
+    /* 2 maps, tunnel and term entry of the shared tunnel, 2 map entries and
+     * a bridge port for each endpoint added */
+    ASSERT_EQ(ut_sai_objs.size(), 4U + 2 * 3);
+    for (size_t ix: {0U, 3U}) {
+        ASSERT_EQ(ut_sai_objs.count(ep_list[ix].tun_brport_oid), 1U);
+    }
+
+    remove_tunnel_obj(&rem_ip1, &loc_ip);
+    ut_fail_bridge_oid = 0;
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
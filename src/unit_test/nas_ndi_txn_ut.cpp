@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_txn_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_txn.h"
+
+#include <set>
+#include <vector>
+
+using namespace std;
+
+/* Fake SAI object handlers. Objects are created with increasing ids and
+ * creation fails once ut_fail_at objects exist. */
+static sai_object_id_t ut_next_oid = 1;
+static size_t ut_fail_at = 0;
+static set<sai_object_id_t> ut_objs;
+static vector<sai_object_id_t> ut_removed;
+static vector<sai_object_id_t> ut_parent;
+static size_t ut_bulk_creates = 0;
+static size_t ut_bulk_removes = 0;
+static bool ut_bulk_supported = true;
+
+static void ut_reset()
+{
+    ut_next_oid = 1;
+    ut_fail_at = 0;
+    ut_objs.clear();
+    ut_removed.clear();
+    ut_parent.clear();
+    ut_bulk_creates = 0;
+    ut_bulk_removes = 0;
+    ut_bulk_supported = true;
+}
+
+static sai_status_t ut_create(sai_object_id_t *oid, sai_object_id_t switch_id,
+                              uint32_t attr_count, const sai_attribute_t *attr_list)
+{
+    if ((ut_fail_at != 0) && (ut_objs.size() + 1 >= ut_fail_at)) {
+        return SAI_STATUS_FAILURE;
+    }
+    *oid = ut_next_oid++;
+    ut_objs.insert(*oid);
+    ut_parent.push_back((attr_count > 0) ? attr_list[0].value.oid : SAI_NULL_OBJECT_ID);
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t ut_remove(sai_object_id_t oid)
+{
+    if (ut_objs.erase(oid) == 0) {
+        return SAI_STATUS_FAILURE;
+    }
+    ut_removed.push_back(oid);
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t ut_mbr_create(sai_object_id_t *oid, sai_object_id_t switch_id,
+                                  uint32_t attr_count, const sai_attribute_t *attr_list)
+{
+    return ut_create(oid, switch_id, attr_count, attr_list);
+}
+
+static sai_status_t ut_bulk_create(sai_object_id_t switch_id, uint32_t count,
+                                   const uint32_t *attr_count, const sai_attribute_t **attr_list,
+                                   sai_bulk_op_error_mode_t mode, sai_object_id_t *oid_list,
+                                   sai_status_t *status_list)
+{
+    if (!ut_bulk_supported) {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    ut_bulk_creates++;
+    sai_status_t sai_ret = SAI_STATUS_SUCCESS;
+    for (uint32_t ix = 0; ix < count; ++ix) {
+        status_list[ix] = ut_create(&oid_list[ix], switch_id, attr_count[ix], attr_list[ix]);
+        if (status_list[ix] != SAI_STATUS_SUCCESS) sai_ret = SAI_STATUS_FAILURE;
+    }
+    return sai_ret;
+}
+
+static sai_status_t ut_bulk_remove(uint32_t count, const sai_object_id_t *oid_list,
+                                   sai_bulk_op_error_mode_t mode, sai_status_t *status_list)
+{
+    ut_bulk_removes++;
+    for (uint32_t ix = 0; ix < count; ++ix) {
+        status_list[ix] = ut_remove(oid_list[ix]);
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+static t_std_error ut_generic_do(void *ctx)
+{
+    return (*static_cast<bool *>(ctx)) ? STD_ERR_OK : STD_ERR(NPU, FAIL, 0);
+}
+
+/* Group with members bound to the group object id */
+static void ut_add_group(ndi_txn_t *txn, size_t mbr_count, sai_object_id_t *grp_oid)
+{
+    sai_attribute_t attr;
+    attr.id = 0;
+    attr.value.oid = SAI_NULL_OBJECT_ID;
+
+    auto grp_step = ndi_txn_add_sai_create(txn, ut_create, ut_remove, 0, NULL, grp_oid);
+    ASSERT_NE(grp_step, NDI_TXN_STEP_INVALID);
+    for (size_t ix = 0; ix < mbr_count; ++ix) {
+        auto step = ndi_txn_add_sai_create(txn, ut_mbr_create, ut_remove, 1, &attr, NULL);
+        ASSERT_NE(step, NDI_TXN_STEP_INVALID);
+        ASSERT_EQ(ndi_txn_bind_oid(txn, step, 0, grp_step), STD_ERR_OK);
+    }
+}
+
+TEST(std_nas_ndi_txn_test, ndi_txn_commit) {
+    ut_reset();
+    sai_object_id_t grp_oid = SAI_NULL_OBJECT_ID;
+    ndi_txn_t *txn = ndi_txn_create();
+    ASSERT_TRUE(txn != NULL);
+    ut_add_group(txn, 4, &grp_oid);
+
+    ASSERT_EQ(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_NE(grp_oid, SAI_NULL_OBJECT_ID);
+    ASSERT_EQ(ut_objs.size(), 5);
+    for (size_t ix = 1; ix < ut_parent.size(); ++ix) {
+        ASSERT_EQ(ut_parent[ix], grp_oid);
+    }
+    /* committed only once */
+    ASSERT_NE(ndi_txn_commit(txn), STD_ERR_OK);
+    ndi_txn_destroy(txn);
+}
+
+TEST(std_nas_ndi_txn_test, ndi_txn_rollback) {
+    ut_reset();
+    ut_fail_at = 4;
+    sai_object_id_t grp_oid = SAI_NULL_OBJECT_ID;
+    ndi_txn_t *txn = ndi_txn_create();
+    ut_add_group(txn, 4, &grp_oid);
+
+    ASSERT_NE(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_EQ(grp_oid, SAI_NULL_OBJECT_ID);
+    ASSERT_TRUE(ut_objs.empty());
+    /* members removed before the group, in reverse order */
+    ASSERT_EQ(ut_removed, vector<sai_object_id_t>({3, 2, 1}));
+    ndi_txn_destroy(txn);
+
+    /* failed generic step undoes the creates before it */
+    ut_reset();
+    bool ok = false;
+    txn = ndi_txn_create();
+    ut_add_group(txn, 2, &grp_oid);
+    ASSERT_NE(ndi_txn_add_step(txn, ut_generic_do, NULL, &ok), NDI_TXN_STEP_INVALID);
+    ASSERT_NE(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_TRUE(ut_objs.empty());
+    ndi_txn_destroy(txn);
+}
+
+TEST(std_nas_ndi_txn_test, ndi_txn_bulk) {
+    ut_reset();
+    sai_object_id_t grp_oid = SAI_NULL_OBJECT_ID;
+    ndi_txn_t *txn = ndi_txn_create();
+    ASSERT_EQ(ndi_txn_set_bulk_fn(txn, ut_mbr_create, ut_bulk_create, ut_bulk_remove), STD_ERR_OK);
+    ut_add_group(txn, 8, &grp_oid);
+    ASSERT_EQ(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_EQ(ut_bulk_creates, 1);
+    ASSERT_EQ(ut_objs.size(), 9);
+    ndi_txn_destroy(txn);
+
+    /* bulk member create fails midway, group and members rolled back */
+    ut_reset();
+    ut_fail_at = 6;
+    txn = ndi_txn_create();
+    ndi_txn_set_bulk_fn(txn, ut_mbr_create, ut_bulk_create, ut_bulk_remove);
+    ut_add_group(txn, 8, &grp_oid);
+    ASSERT_NE(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_EQ(ut_bulk_removes, 1);
+    ASSERT_TRUE(ut_objs.empty());
+    ndi_txn_destroy(txn);
+
+    /* bulk not supported, falls back to one create per member */
+    ut_reset();
+    ut_bulk_supported = false;
+    txn = ndi_txn_create();
+    ndi_txn_set_bulk_fn(txn, ut_mbr_create, ut_bulk_create, NULL);
+    ut_add_group(txn, 8, &grp_oid);
+    ASSERT_EQ(ndi_txn_commit(txn), STD_ERR_OK);
+    ASSERT_EQ(ut_bulk_creates, 0);
+    ASSERT_EQ(ut_objs.size(), 9);
+    ndi_txn_destroy(txn);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_ndi_vlan_mbr_cache_ut.cpp
+ */
+
+#include <gtest/gtest.h>
+#include "nas_ndi_vlan_mbr_cache.h"
+
+#include <vector>
+
+static const size_t ut_ports = 100, ut_vlans = 300;
+
+static ndi_vlan_mbr_info_t ut_mbr(size_t port, hal_vlan_id_t vlan)
+{
+    ndi_vlan_mbr_info_t mbr;
+    mbr.vlan_id = vlan;
+    mbr.port_id = 0x1000000000 + port;
+    mbr.member_id = 0x2700000000 + port * 4096 + vlan;
+    mbr.tagging_mode = (port % 2) ? SAI_VLAN_TAGGING_MODE_TAGGED : SAI_VLAN_TAGGING_MODE_UNTAGGED;
+    return mbr;
+}
+
+TEST(std_nas_ndi_vlan_mbr_cache_test, ndi_vlan_mbr_cache_get) {
+    std::vector<ndi_vlan_mbr_info_t> mbrs;
+    for (size_t port = 0; port < ut_ports; ++port) {
+        for (hal_vlan_id_t vlan = 1; vlan <= ut_vlans; ++vlan) {
+            mbrs.push_back(ut_mbr(port, vlan));
+        }
+    }
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+
+    sai_object_id_t member_id;
+    sai_vlan_tagging_mode_t mode;
+    auto mbr = ut_mbr(7, 42);
+    ASSERT_EQ(ndi_vlan_mbr_cache_get(0, 42, mbr.port_id, &member_id, &mode), STD_ERR_OK);
+    ASSERT_EQ(member_id, mbr.member_id);
+    ASSERT_EQ(mode, SAI_VLAN_TAGGING_MODE_TAGGED);
+    ASSERT_NE(ndi_vlan_mbr_cache_get(0, ut_vlans + 1, mbr.port_id, NULL, NULL), STD_ERR_OK);
+    ASSERT_NE(ndi_vlan_mbr_cache_get(1, 42, mbr.port_id, NULL, NULL), STD_ERR_OK);
+
+    /* tagging mode change in place */
+    mbr.tagging_mode = SAI_VLAN_TAGGING_MODE_UNTAGGED;
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(0, &mbr, 1), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_get(0, 42, mbr.port_id, NULL, &mode), STD_ERR_OK);
+    ASSERT_EQ(mode, SAI_VLAN_TAGGING_MODE_UNTAGGED);
+    ASSERT_EQ(ndi_vlan_mbr_cache_vlan_get(0, 42, NULL, 0), ut_ports);
+
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+    ASSERT_NE(ndi_vlan_mbr_cache_get(0, 42, mbr.port_id, NULL, NULL), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_vlan_get(0, 42, NULL, 0), 0);
+}
+
+TEST(std_nas_ndi_vlan_mbr_cache_test, ndi_vlan_mbr_cache_list) {
+    std::vector<ndi_vlan_mbr_info_t> mbrs;
+    for (size_t port = 0; port < ut_ports; ++port) {
+        for (hal_vlan_id_t vlan = 1; vlan <= ut_vlans; vlan += (port % 3) + 1) {
+            mbrs.push_back(ut_mbr(port, vlan));
+        }
+    }
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(0, mbrs.data(), mbrs.size()), STD_ERR_OK);
+
+    /* port 2 is in every third VLAN, returned in VLAN order */
+    std::vector<ndi_vlan_mbr_info_t> list(ut_vlans);
+    auto port2 = ut_mbr(2, 0).port_id;
+    size_t count = ndi_vlan_mbr_cache_port_get(0, port2, list.data(), list.size());
+    ASSERT_EQ(count, ut_vlans / 3);
+    for (size_t ix = 0; ix < count; ++ix) {
+        ASSERT_EQ(list[ix].vlan_id, 1 + ix * 3);
+        ASSERT_EQ(list[ix].member_id, ut_mbr(2, list[ix].vlan_id).member_id);
+    }
+    ASSERT_EQ(ndi_vlan_mbr_cache_port_get(0, port2, list.data(), 5), count);
+
+    /* VLAN 4 has the ports with (port % 3) != 1 */
+    count = ndi_vlan_mbr_cache_vlan_get(0, 4, list.data(), list.size());
+    ASSERT_EQ(count, ut_ports - ut_ports / 3);
+    for (size_t ix = 0; ix < count; ++ix) {
+        ASSERT_NE((list[ix].port_id - ut_mbr(0, 0).port_id) % 3, 1);
+    }
+
+    /* removed port leaves no VLAN, its index is reused */
+    std::vector<ndi_vlan_mbr_info_t> port0;
+    for (auto &mbr: mbrs) {
+        if (mbr.port_id == ut_mbr(0, 0).port_id) port0.push_back(mbr);
+    }
+    ASSERT_EQ(ndi_vlan_mbr_cache_del(0, port0.data(), port0.size()), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_port_get(0, ut_mbr(0, 0).port_id, NULL, 0), 0);
+    auto new_mbr = ut_mbr(ut_ports, 10);
+    ASSERT_EQ(ndi_vlan_mbr_cache_set(0, &new_mbr, 1), STD_ERR_OK);
+    ASSERT_EQ(ndi_vlan_mbr_cache_port_get(0, new_mbr.port_id, list.data(), list.size()), 1);
+    ASSERT_EQ(list[0].vlan_id, 10);
+    ASSERT_EQ(ndi_vlan_mbr_cache_vlan_get(0, 10, NULL, 0), ut_ports - ut_ports / 3);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}